@@ -0,0 +1,239 @@
+#include "benchMetadata.h"
+
+/** Number of packets or records timed by each measure. */
+#define BENCH_METADATA_ITERATIONS   200000
+
+/** Number of records of the track encoded by g_BenchKlvEncode(). */
+#define BENCH_METADATA_TRACK_SIZE   64
+
+/** Packets between two complete packets in g_BenchKlvEncode(). */
+#define BENCH_METADATA_KEY_INTERVAL 16
+
+/** Number of records appended by g_BenchLogAppend(). */
+#define BENCH_METADATA_LOG_SIZE     10240
+
+/******************************************************************************/
+static void _BuildExample(std::vector<uint8_t>& p_rvPacket)
+{
+    /* Items of the example of ST 0601, except the checksum. */
+    static const uint8_t    s_aucItems[] =
+    {
+        2, 8, 0x00, 0x04, 0x59, 0xF4, 0xA6, 0xAA, 0x4A, 0xA8,
+        3, 9, 'M', 'I', 'S', 'S', 'I', 'O', 'N', '0', '1',
+        4, 6, 'A', 'F', '-', '1', '0', '1',
+        5, 2, 0x71, 0xC2,
+        6, 2, 0xFD, 0x3D,
+        7, 2, 0x08, 0xB8,
+        8, 1, 0x93,
+        10, 5, 'M', 'Q', '1', '-', 'B',
+        11, 2, 'E', 'O',
+        12, 6, 'W', 'G', 'S', '-', '8', '4',
+        13, 4, 0x55, 0x95, 0xB6, 0x6D,
+        14, 4, 0x5B, 0x53, 0x60, 0xC4,
+        15, 2, 0xC2, 0x21,
+        16, 2, 0xCD, 0x9C,
+        17, 2, 0xD9, 0x17,
+        18, 4, 0x72, 0x4A, 0x0A, 0x20,
+        19, 4, 0x87, 0xF8, 0x4B, 0x86,
+        20, 4, 0x7D, 0xC5, 0x5E, 0xCE,
+        21, 4, 0x03, 0x83, 0x09, 0x26,
+        22, 2, 0x12, 0x81,
+        23, 4, 0xF1, 0x01, 0xA2, 0x29,
+        24, 4, 0x14, 0xBC, 0x08, 0x2B,
+        25, 2, 0x34, 0xF3,
+        35, 2, 0xA7, 0xC4,
+        36, 1, 0xB2,
+        65, 1, 0x08
+    };
+    uint8_t     l_aucLength[8];
+    size_t      l_sLengthSize;
+    uint16_t    l_usChecksum;
+
+    l_sLengthSize = Klv::WriteBerLength(sizeof(s_aucItems) + 4, l_aucLength);
+
+    p_rvPacket.assign(Klv::GetKey(), Klv::GetKey() + KLV_KEY_SIZE);
+    p_rvPacket.insert(p_rvPacket.end(),
+                      l_aucLength,
+                      l_aucLength + l_sLengthSize);
+    p_rvPacket.insert(p_rvPacket.end(),
+                      s_aucItems,
+                      s_aucItems + sizeof(s_aucItems));
+    p_rvPacket.push_back(KLV_TAG_CHECKSUM);
+    p_rvPacket.push_back(2);
+
+    l_usChecksum = Klv::Checksum(&p_rvPacket[0], p_rvPacket.size());
+
+    p_rvPacket.push_back(static_cast<uint8_t>(l_usChecksum >> 8));
+    p_rvPacket.push_back(static_cast<uint8_t>(l_usChecksum & 0xFF));
+}
+
+/******************************************************************************/
+static void _BuildTrack(std::vector<Metadata>&  p_rvTrack,
+                        const size_t            p_sSize)
+{
+    Metadata*   l_pMetadata;
+    size_t      l_s;
+
+    p_rvTrack.resize(p_sSize);
+
+    /* A platform flying straight, with a slowly turning sensor. */
+    for (l_s = 0; l_s < p_rvTrack.size(); l_s++)
+    {
+        l_pMetadata = &p_rvTrack[l_s];
+
+        l_pMetadata->m_llTimestamp = 1224807209913000LL +
+                                     40000LL * static_cast<long long>(l_s);
+        l_pMetadata->m_sMissionID = "MISSION01";
+        l_pMetadata->m_sPlatformTailNumber = "AF-101";
+        l_pMetadata->m_fPlatformHeading_deg = 159.97f;
+        l_pMetadata->m_fPlatformPitch_deg = -0.43f + 0.01f * (l_s % 8);
+        l_pMetadata->m_fPlatformRoll_deg = 3.4f;
+        l_pMetadata->m_fPlatformTrueAirSpeed_m_s = 147.0f;
+        l_pMetadata->m_sPlatformDesignation = "MQ1-B";
+        l_pMetadata->m_sImageSourceSensor = "EO";
+        l_pMetadata->m_sImageCoordinateSystem = "WGS-84";
+        l_pMetadata->m_dSensorLat_deg = 60.17682296 - 2.5e-6 * l_s;
+        l_pMetadata->m_dSensorLon_deg = 128.42675904 + 1.1e-6 * l_s;
+        l_pMetadata->m_dSensorAlt_m = 14190.72;
+        l_pMetadata->m_fSensorHFOV_deg = 144.57f;
+        l_pMetadata->m_fSensorVFOV_deg = 152.64f;
+        l_pMetadata->m_fSensorAzimuth_deg = 160.7192f + 0.05f * l_s;
+        l_pMetadata->m_fSensorElevation_deg = -168.7923f;
+        l_pMetadata->m_fSensorRoll_deg = 176.8654f;
+        l_pMetadata->m_fSlantRange_m = 68590.98f - 1.5f * l_s;
+        l_pMetadata->m_fTargetWidth_m = 722.82f;
+        l_pMetadata->m_dFrameCenterLat_deg = -10.54238863 - 2.5e-6 * l_s;
+        l_pMetadata->m_dFrameCenterLon_deg = 29.15789012 + 1.1e-6 * l_s;
+        l_pMetadata->m_dFrameCenterAlt_m = 3216.04;
+        l_pMetadata->m_fWindDirection_deg = 235.92f;
+        l_pMetadata->m_fWindSpeed_m_s = 69.8f;
+        l_pMetadata->m_sPlatformCallSign = "FLYSIGHT";
+    }
+}
+
+/******************************************************************************/
+benchRate g_BenchKlvDecode()
+{
+    MetadataKlvDecoder      l_Decoder;
+    Metadata                l_Metadata;
+    benchRate               l_Rate;
+    std::vector<uint8_t>    l_vPacket;
+    QElapsedTimer           l_Timer;
+    size_t                  l_sConsumed;
+    int                     l_i;
+
+    _BuildExample(l_vPacket);
+
+    /* The values are checked by testMetadata: only make sure that the timed
+     * path is the decoding of a valid packet. */
+    if (l_Decoder.Decode(&l_vPacket[0],
+                         l_vPacket.size(),
+                         l_Metadata,
+                         l_sConsumed) != KLV_OK)
+    {
+        return l_Rate;
+    }
+
+    l_Timer.start();
+
+    for (l_i = 0; l_i < BENCH_METADATA_ITERATIONS; l_i++)
+    {
+        l_Decoder.Decode(&l_vPacket[0],
+                         l_vPacket.size(),
+                         l_Metadata,
+                         l_sConsumed);
+    }
+
+    l_Rate.m_llItems = BENCH_METADATA_ITERATIONS;
+    l_Rate.m_dRate = 1e9 * l_Rate.m_llItems /
+                     std::max(l_Timer.nsecsElapsed(), qint64(1));
+
+    return l_Rate;
+}
+
+/******************************************************************************/
+benchRate g_BenchKlvEncode()
+{
+    MetadataKlvEncoder      l_Encoder;
+    benchRate               l_Rate;
+    std::vector<Metadata>   l_vTrack;
+    std::vector<uint8_t>    l_vBuffer;
+    QElapsedTimer           l_Timer;
+    size_t                  l_sEncoded;
+    qint64                  l_llNumEncoded;
+
+    _BuildTrack(l_vTrack, BENCH_METADATA_TRACK_SIZE);
+
+    l_Encoder.SetDeltaEnabled(true);
+    l_Encoder.SetKeyInterval(BENCH_METADATA_KEY_INTERVAL);
+
+    l_vBuffer.resize(KLV_MAX_ENCODED_SIZE * l_vTrack.size());
+    l_llNumEncoded = 0;
+
+    l_Timer.start();
+
+    while (l_llNumEncoded < BENCH_METADATA_ITERATIONS)
+    {
+        l_Encoder.EncodeBatch(&l_vTrack[0],
+                              l_vTrack.size(),
+                              &l_vBuffer[0],
+                              l_vBuffer.size(),
+                              &l_sEncoded);
+
+        /* The round trip is checked by testMetadata. */
+        if (l_sEncoded == 0)
+        {
+            return benchRate();
+        }
+
+        l_llNumEncoded += static_cast<qint64>(l_sEncoded);
+    }
+
+    l_Rate.m_llItems = l_llNumEncoded;
+    l_Rate.m_dRate = 1e9 * l_Rate.m_llItems /
+                     std::max(l_Timer.nsecsElapsed(), qint64(1));
+
+    return l_Rate;
+}
+
+/******************************************************************************/
+benchRate g_BenchLogAppend()
+{
+    MetadataLogWriter       l_Writer;
+    benchRate               l_Rate;
+    std::vector<Metadata>   l_vTrack;
+    QString                 l_sFilePath;
+    QElapsedTimer           l_Timer;
+    qint64                  l_llElapsed_ns;
+    size_t                  l_s;
+    bool                    l_bOk;
+
+    _BuildTrack(l_vTrack, BENCH_METADATA_LOG_SIZE);
+
+    l_sFilePath = QDir::temp().filePath("benchMetadata.log");
+
+    l_bOk = l_Writer.Open(l_sFilePath.toLocal8Bit().constData());
+    l_s = 0;
+
+    l_Timer.start();
+
+    while (l_bOk && l_s < l_vTrack.size())
+    {
+        l_bOk = l_Writer.Append(l_vTrack[l_s++]);
+    }
+
+    l_llElapsed_ns = l_Timer.nsecsElapsed();
+    l_bOk = l_Writer.Close() && l_bOk;
+
+    /* The log round trip is checked by testMetadata. */
+    QFile::remove(l_sFilePath);
+
+    if (l_bOk)
+    {
+        l_Rate.m_llItems = static_cast<qint64>(l_vTrack.size());
+        l_Rate.m_dRate = 1e9 * l_Rate.m_llItems /
+                         std::max(l_llElapsed_ns, qint64(1));
+    }
+
+    return l_Rate;
+}
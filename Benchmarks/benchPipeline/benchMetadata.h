@@ -0,0 +1,53 @@
+#ifndef BENCHMETADATA_H
+#define BENCHMETADATA_H
+
+/** @file benchMetadata.h
+ *
+ * @brief Measures the throughput of the metadata codecs of the core library
+ * on a single core. Their results are checked by testMetadata.
+ */
+
+#include "benchModules.h"
+
+/******************************************************************************/
+/**
+ * @struct benchRate
+ *
+ * @brief Result of a metadata measure.
+ */
+struct benchRate
+{
+    benchRate()
+        : m_llItems(0),
+          m_dRate(0.0)
+    {
+        /* Empty. */
+    }
+
+    qint64  m_llItems; /**< Number of items (packets or records) timed, 0 if
+                        * the measure could not run. */
+
+    double  m_dRate; /**< Items per second. */
+
+}; // end struct benchRate.
+
+/******************************************************************************/
+/**
+ * @brief g_BenchKlvDecode measures the rate at which the example packet of
+ * ST 0601 is decoded.
+ */
+benchRate g_BenchKlvDecode();
+
+/**
+ * @brief g_BenchKlvEncode measures the rate at which a track of Metadata is
+ * encoded with the delta encoding.
+ */
+benchRate g_BenchKlvEncode();
+
+/**
+ * @brief g_BenchLogAppend measures the rate at which a track of Metadata is
+ * appended to a new log.
+ */
+benchRate g_BenchLogAppend();
+
+#endif // BENCHMETADATA_H
@@ -0,0 +1,332 @@
+#include "benchModules.h"
+
+/******************************************************************************/
+/* benchContext. */
+
+benchContext::benchContext()
+    : m_pSource(NULL),
+      m_iArrivalsPerFrame(1),
+      m_iArrivals(0),
+      m_llFrames(0),
+      m_llWarmupFrames(0),
+      m_llTotalFrames(0),
+      m_llStart_ns(0),
+      m_llStop_ns(0),
+      m_bDone(true)
+{
+    m_Clock.start();
+}
+
+void benchContext::Arrived(const qint64 p_llStamp_ns)
+{
+    qint64  l_llNow_ns;
+    bool    l_bEmit;
+
+    l_llNow_ns = Now_ns();
+    l_bEmit = false;
+
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        if (m_bDone)
+        {
+            return;
+        }
+
+        if (m_llFrames >= m_llWarmupFrames)
+        {
+            m_Latency.RecordCall(0, l_llNow_ns - p_llStamp_ns);
+        }
+
+        m_iArrivals++;
+
+        if (m_iArrivals < m_iArrivalsPerFrame)
+        {
+            return;
+        }
+
+        m_iArrivals = 0;
+        m_llFrames++;
+
+        if (m_llFrames == m_llWarmupFrames)
+        {
+            m_llStart_ns = Now_ns();
+        }
+
+        if (m_llFrames >= m_llTotalFrames)
+        {
+            m_llStop_ns = Now_ns();
+
+            m_bDone = true;
+
+            m_condDone.wakeAll();
+        }
+        else
+        {
+            l_bEmit = true;
+        }
+    }
+
+    if (l_bEmit)
+    {
+        m_pSource->Emit();
+    }
+}
+
+qint64 benchContext::GetElapsed_ns() const
+{
+    QMutexLocker    l_Lock(&m_Mutex);
+
+    return m_llStop_ns - m_llStart_ns;
+}
+
+ModuleStats benchContext::GetLatency() const
+{
+    ModuleStats     l_Result;
+
+    m_Latency.GetStats(l_Result);
+
+    return l_Result;
+}
+
+void benchContext::Start(benchSource*   p_pSource,
+                         const int      p_iArrivalsPerFrame,
+                         const qint64   p_llWarmupFrames,
+                         const qint64   p_llFrames)
+{
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_pSource = p_pSource;
+        m_iArrivalsPerFrame = p_iArrivalsPerFrame;
+        m_iArrivals = 0;
+        m_llFrames = 0;
+        m_llWarmupFrames = p_llWarmupFrames;
+        m_llTotalFrames = p_llWarmupFrames + p_llFrames;
+        m_llStart_ns = Now_ns();
+        m_llStop_ns = m_llStart_ns;
+        m_bDone = false;
+
+        m_Latency.Reset();
+    }
+
+    m_pSource->Emit();
+}
+
+bool benchContext::WaitDone(const int p_iWait_ms)
+{
+    QMutexLocker    l_Lock(&m_Mutex);
+
+    if (!m_bDone)
+    {
+        m_condDone.wait(&m_Mutex, p_iWait_ms);
+    }
+
+    return m_bDone;
+}
+
+/******************************************************************************/
+/* benchSource. */
+
+benchSource::benchSource(ModuleExecMode     p_Mode,
+                         benchContext*      p_pContext,
+                         const int          p_iWidth,
+                         const int          p_iHeight)
+    : Module(p_Mode),
+      m_pContext(p_pContext),
+      m_iWidth(p_iWidth),
+      m_iHeight(p_iHeight),
+      m_iCount(0)
+{
+    /* Empty. */
+}
+
+benchSource::~benchSource()
+{
+    _CloseExecution();
+}
+
+void benchSource::Emit()
+{
+    _Post(TRIGGERED_EVENT_PORT_ID);
+}
+
+RetFlag benchSource::Init(ModuleExecMode p_Mode)
+{
+    RetFlag     l_Result;
+
+    l_Result = Module::Init(p_Mode);
+
+    AddTypedOutput(m_Out, benchFramePtr(new benchFrame));
+
+    _LockOutputPortNum();
+
+    return l_Result;
+}
+
+RetFlag benchSource::_ThreadFunction(const int p_iPortId)
+{
+    benchFramePtr   l_pFrame;
+    uchar*          l_pucData;
+
+    Q_UNUSED(p_iPortId);
+
+    l_pFrame = m_Out.Get();
+
+    /* The zero-copy methods of DataFrame lock its mutex. */
+    l_pucData = l_pFrame->AllocFrame(*GetFramePool(), m_iWidth, m_iHeight, 1);
+
+    memset(l_pucData, m_iCount & 0xFF, l_pFrame->GetBufferSize());
+
+    {
+        LOCK_WRITE(&l_pFrame->m_Mutex, l_Lock);
+
+        l_pFrame->m_llStamp_ns = m_pContext->Now_ns();
+    }
+
+    m_iCount++;
+
+    m_Out.Notify();
+
+    return RET_SUCCESS;
+}
+
+/******************************************************************************/
+/* benchFanOut. */
+
+benchFanOut::benchFanOut(ModuleExecMode     p_Mode,
+                         const int          p_iNumOutputs)
+    : Module(p_Mode),
+      m_vOut(p_iNumOutputs)
+{
+    /* Empty. */
+}
+
+benchFanOut::~benchFanOut()
+{
+    _CloseExecution();
+}
+
+RetFlag benchFanOut::Init(ModuleExecMode p_Mode)
+{
+    RetFlag     l_Result;
+    size_t      l_s;
+
+    l_Result = Module::Init(p_Mode);
+
+    AddTypedInput(m_In);
+
+    for (l_s = 0; l_s < m_vOut.size(); l_s++)
+    {
+        AddTypedOutput(m_vOut[l_s], benchFramePtr(new benchFrame));
+    }
+
+    _LockInputPortNum();
+    _LockOutputPortNum();
+
+    return l_Result;
+}
+
+RetFlag benchFanOut::_ThreadFunction(const int p_iPortId)
+{
+    benchFramePtr   l_pIn;
+    benchFramePtr   l_pOut;
+    qint64          l_llStamp_ns;
+    size_t          l_s;
+
+    Q_UNUSED(p_iPortId);
+
+    l_pIn = m_In.Get();
+
+    if (!l_pIn)
+    {
+        return RET_ERROR;
+    }
+
+    {
+        LOCK_READ(&l_pIn->m_Mutex, l_Lock);
+
+        l_llStamp_ns = l_pIn->m_llStamp_ns;
+    }
+
+    for (l_s = 0; l_s < m_vOut.size(); l_s++)
+    {
+        l_pOut = m_vOut[l_s].Get();
+
+        /* Shares the pixel buffer of the input frame. */
+        l_pOut->CopyFrame(*l_pIn);
+
+        {
+            LOCK_WRITE(&l_pOut->m_Mutex, l_Lock);
+
+            l_pOut->m_llStamp_ns = l_llStamp_ns;
+        }
+
+        m_vOut[l_s].Notify();
+    }
+
+    return RET_SUCCESS;
+}
+
+/******************************************************************************/
+/* benchSink. */
+
+benchSink::benchSink(ModuleExecMode     p_Mode,
+                     benchContext*      p_pContext,
+                     const int          p_iNumInputs)
+    : Module(p_Mode),
+      m_pContext(p_pContext),
+      m_vIn(p_iNumInputs)
+{
+    /* Empty. */
+}
+
+benchSink::~benchSink()
+{
+    _CloseExecution();
+}
+
+RetFlag benchSink::Init(ModuleExecMode p_Mode)
+{
+    RetFlag     l_Result;
+    size_t      l_s;
+
+    l_Result = Module::Init(p_Mode);
+
+    for (l_s = 0; l_s < m_vIn.size(); l_s++)
+    {
+        AddTypedInput(m_vIn[l_s]);
+    }
+
+    _LockInputPortNum();
+
+    return l_Result;
+}
+
+RetFlag benchSink::_ThreadFunction(const int p_iPortId)
+{
+    benchFramePtr   l_pIn;
+    qint64          l_llStamp_ns;
+
+    if (p_iPortId < 0 || p_iPortId >= static_cast<int>(m_vIn.size()))
+    {
+        return RET_ERROR;
+    }
+
+    l_pIn = m_vIn[p_iPortId].Get();
+
+    if (!l_pIn)
+    {
+        return RET_ERROR;
+    }
+
+    {
+        LOCK_READ(&l_pIn->m_Mutex, l_Lock);
+
+        l_llStamp_ns = l_pIn->m_llStamp_ns;
+    }
+
+    m_pContext->Arrived(l_llStamp_ns);
+
+    return RET_SUCCESS;
+}
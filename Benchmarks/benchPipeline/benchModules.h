@@ -0,0 +1,250 @@
+#ifndef BENCHMODULES_H
+#define BENCHMODULES_H
+
+/** @file benchModules.h
+ *
+ * @brief Synthetic modules used to measure the cost of moving frames along a
+ * pipeline: a source, a pass-through, a fan-out and a sink. The modules do no
+ * processing, so that the measures only reflect Module, ModulePort and Data.
+ */
+
+#include <core>
+#include <core_app>
+
+using namespace fby;
+
+/******************************************************************************/
+/**
+ * @class benchFrame
+ *
+ * @brief DataFrame stamped with the time it has been emitted by the source.
+ */
+class benchFrame : public DataFrame
+{
+public:
+
+    benchFrame()
+        : m_llStamp_ns(0)
+    {
+        /* Empty. */
+    }
+
+    qint64  m_llStamp_ns; /**< Emission time (benchContext clock). */
+
+}; // end class benchFrame.
+
+DEF_PTR(benchFrame);
+
+class benchSource;
+
+/******************************************************************************/
+/**
+ * @class benchContext
+ *
+ * @brief Shared state of a benchmark run. The source emits a new frame only
+ * when the previous one has reached all the sinks, so that each run executes
+ * exactly the same sequence of notifications and its results are
+ * reproducible.
+ */
+class benchContext
+{
+public:
+
+    benchContext();
+
+    /**
+     * @brief Arrived is called by the sinks for each received frame.
+     *
+     * @param[in]   p_llStamp_ns    Emission time of the frame.
+     */
+    void Arrived(const qint64 p_llStamp_ns);
+
+    /** @return the wall time of the measured frames (ns). */
+    qint64 GetElapsed_ns() const;
+
+    /** @return the end-to-end latency statistics of the measured frames. */
+    ModuleStats GetLatency() const;
+
+    /** @return the current time of the clock used to stamp the frames. */
+    inline qint64 Now_ns() const
+    {
+        return m_Clock.nsecsElapsed();
+    }
+
+    /**
+     * @brief Start starts a run and emits the first frame.
+     *
+     * @param[in]   p_pSource           Source of the pipeline.
+     * @param[in]   p_iArrivalsPerFrame Number of sink executions per frame.
+     * @param[in]   p_llWarmupFrames    Frames excluded from the measures.
+     * @param[in]   p_llFrames          Measured frames.
+     */
+    void Start(benchSource*     p_pSource,
+               const int        p_iArrivalsPerFrame,
+               const qint64     p_llWarmupFrames,
+               const qint64     p_llFrames);
+
+    /**
+     * @brief WaitDone waits for the end of the run.
+     *
+     * @return true if the run has ended.
+     */
+    bool WaitDone(const int p_iWait_ms);
+
+protected:
+
+    mutable QMutex  m_Mutex;
+
+    QWaitCondition  m_condDone;
+
+    QElapsedTimer   m_Clock;
+
+    ModuleProfiler  m_Latency; /**< End-to-end latency histogram. */
+
+    benchSource*    m_pSource;
+
+    int     m_iArrivalsPerFrame;
+
+    int     m_iArrivals;
+
+    qint64  m_llFrames;
+
+    qint64  m_llWarmupFrames;
+
+    qint64  m_llTotalFrames;
+
+    qint64  m_llStart_ns;
+
+    qint64  m_llStop_ns;
+
+    bool    m_bDone;
+
+}; // end class benchContext.
+
+/******************************************************************************/
+/**
+ * @class benchSource
+ *
+ * @brief Emits a frame of the configured size from the FramePool of the
+ * pipeline, filling all the pixels, for each execution.
+ */
+class benchSource : public Module
+{
+    Q_OBJECT
+
+public:
+
+    benchSource(ModuleExecMode  p_Mode,
+                benchContext*   p_pContext,
+                const int       p_iWidth,
+                const int       p_iHeight);
+
+    ~benchSource();
+
+    /** @brief Emit requests the emission of the next frame. */
+    void Emit();
+
+    RetFlag Init(ModuleExecMode p_Mode);
+
+protected:
+
+    RetFlag _ThreadFunction(const int p_iPortId);
+
+protected:
+
+    benchContext*   m_pContext;
+
+    ModuleOutput<benchFrame>    m_Out;
+
+    int     m_iWidth;
+
+    int     m_iHeight;
+
+    int     m_iCount;
+
+}; // end class benchSource.
+
+/******************************************************************************/
+/**
+ * @class benchFanOut
+ *
+ * @brief Forwards the frame received on its input port to a number of output
+ * ports, sharing the pixel buffer. With one output it is a pass-through.
+ */
+class benchFanOut : public Module
+{
+    Q_OBJECT
+
+public:
+
+    benchFanOut(ModuleExecMode  p_Mode,
+                const int       p_iNumOutputs = 1);
+
+    ~benchFanOut();
+
+    RetFlag Init(ModuleExecMode p_Mode);
+
+protected:
+
+    RetFlag _ThreadFunction(const int p_iPortId);
+
+protected:
+
+    ModuleInput<benchFrame>     m_In;
+
+    std::vector<ModuleOutput<benchFrame> >  m_vOut;
+
+}; // end class benchFanOut.
+
+/******************************************************************************/
+/**
+ * @class benchPass
+ *
+ * @brief Forwards the frame received on its input port to its output port.
+ */
+class benchPass : public benchFanOut
+{
+public:
+
+    benchPass(ModuleExecMode p_Mode)
+        : benchFanOut(p_Mode, 1)
+    {
+        /* Empty. */
+    }
+
+}; // end class benchPass.
+
+/******************************************************************************/
+/**
+ * @class benchSink
+ *
+ * @brief Receives frames on a number of input ports and reports their
+ * end-to-end latency to the benchContext.
+ */
+class benchSink : public Module
+{
+    Q_OBJECT
+
+public:
+
+    benchSink(ModuleExecMode    p_Mode,
+              benchContext*     p_pContext,
+              const int         p_iNumInputs = 1);
+
+    ~benchSink();
+
+    RetFlag Init(ModuleExecMode p_Mode);
+
+protected:
+
+    RetFlag _ThreadFunction(const int p_iPortId);
+
+protected:
+
+    benchContext*   m_pContext;
+
+    std::vector<ModuleInput<benchFrame> >   m_vIn;
+
+}; // end class benchSink.
+
+#endif // BENCHMODULES_H
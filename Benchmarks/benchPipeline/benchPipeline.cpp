@@ -0,0 +1,218 @@
+#include "benchPipeline.h"
+
+/** Maximum duration of a single run (ms). */
+#define BENCH_RUN_TIMEOUT_MS    120000
+
+/******************************************************************************/
+static ModulePtr _InitModule(ModulePtr                  p_pModule,
+                             std::vector<ModulePtr>&    p_rvModules)
+{
+    p_pModule->Init(MODULE_MODE_CONSOLE);
+    p_pModule->InitOptions();
+
+    p_rvModules.push_back(p_pModule);
+
+    return p_pModule;
+}
+
+/******************************************************************************/
+static RetFlag _Link(const benchConfig&    p_rConfig,
+                     ModulePtr              p_pModule1,
+                     const int              p_iOutPort1,
+                     ModulePtr              p_pModule2,
+                     const int              p_iInPort2)
+{
+    if (p_rConfig.m_bExecutor)
+    {
+        return g_LinkModulesDirect(p_pModule1,
+                                   p_iOutPort1,
+                                   p_pModule2,
+                                   p_iInPort2);
+    }
+
+    return g_LinkModulesChecked(p_pModule1,
+                                p_iOutPort1,
+                                p_pModule2,
+                                p_iInPort2);
+}
+
+/******************************************************************************/
+const char* g_BenchGraphName(benchGraph p_Graph)
+{
+    switch (p_Graph)
+    {
+    case BENCH_GRAPH_LINEAR:
+        return "linear";
+
+    case BENCH_GRAPH_DIAMOND:
+        return "diamond";
+
+    case BENCH_GRAPH_WIDE:
+        return "wide";
+
+    default:
+        return "unknown";
+    } // end switch.
+}
+
+/******************************************************************************/
+benchResult g_BenchRun(const benchConfig& p_rConfig)
+{
+    benchContext            l_Context;
+    benchResult             l_Result;
+    ModuleExecutorPtr       l_pExecutor;
+    std::vector<ModulePtr>  l_vModules;
+    SHARED_PTR<benchSource> l_pSource;
+    ModulePtr               l_pPrev;
+    ModulePtr               l_pModule;
+    ModulePtr               l_pSink;
+    ModuleStats             l_Latency;
+    int                     l_iArrivals;
+    int                     l_i;
+    size_t                  l_s;
+    qint64                  l_llElapsed_ns;
+
+    l_pSource.reset(new benchSource(MODULE_MODE_CONSOLE,
+                                    &l_Context,
+                                    p_rConfig.m_iWidth,
+                                    p_rConfig.m_iHeight));
+
+    _InitModule(l_pSource, l_vModules);
+
+    l_iArrivals = 1;
+
+    switch (p_rConfig.m_Graph)
+    {
+    case BENCH_GRAPH_LINEAR:
+        l_pPrev = l_pSource;
+
+        for (l_i = 0; l_i < p_rConfig.m_iSize; l_i++)
+        {
+            l_pModule = _InitModule(ModulePtr(new benchPass(
+                                                  MODULE_MODE_CONSOLE)),
+                                    l_vModules);
+
+            _Link(p_rConfig, l_pPrev, 0, l_pModule, 0);
+
+            l_pPrev = l_pModule;
+        }
+
+        l_pSink = _InitModule(ModulePtr(new benchSink(MODULE_MODE_CONSOLE,
+                                                      &l_Context)),
+                              l_vModules);
+
+        _Link(p_rConfig, l_pPrev, 0, l_pSink, 0);
+
+        l_Result.m_iHops = p_rConfig.m_iSize + 1;
+        break;
+
+    case BENCH_GRAPH_DIAMOND:
+        l_pPrev = _InitModule(ModulePtr(new benchFanOut(MODULE_MODE_CONSOLE,
+                                                        p_rConfig.m_iSize)),
+                              l_vModules);
+
+        _Link(p_rConfig, l_pSource, 0, l_pPrev, 0);
+
+        l_pSink = _InitModule(ModulePtr(new benchSink(MODULE_MODE_CONSOLE,
+                                                      &l_Context,
+                                                      p_rConfig.m_iSize)),
+                              l_vModules);
+
+        for (l_i = 0; l_i < p_rConfig.m_iSize; l_i++)
+        {
+            l_pModule = _InitModule(ModulePtr(new benchPass(
+                                                  MODULE_MODE_CONSOLE)),
+                                    l_vModules);
+
+            _Link(p_rConfig, l_pPrev, l_i, l_pModule, 0);
+            _Link(p_rConfig, l_pModule, 0, l_pSink, l_i);
+        }
+
+        l_iArrivals = p_rConfig.m_iSize;
+        l_Result.m_iHops = 3;
+        break;
+
+    case BENCH_GRAPH_WIDE:
+    default:
+        for (l_i = 0; l_i < p_rConfig.m_iSize; l_i++)
+        {
+            l_pModule = _InitModule(ModulePtr(new benchPass(
+                                                  MODULE_MODE_CONSOLE)),
+                                    l_vModules);
+
+            l_pSink = _InitModule(ModulePtr(new benchSink(MODULE_MODE_CONSOLE,
+                                                          &l_Context)),
+                                  l_vModules);
+
+            _Link(p_rConfig, l_pSource, 0, l_pModule, 0);
+            _Link(p_rConfig, l_pModule, 0, l_pSink, 0);
+        }
+
+        l_iArrivals = p_rConfig.m_iSize;
+        l_Result.m_iHops = 2;
+        break;
+    } // end switch.
+
+    if (p_rConfig.m_bExecutor)
+    {
+        l_pExecutor.reset(new ModuleExecutor(p_rConfig.m_iNumThreads));
+    }
+
+    for (l_s = 0; l_s < l_vModules.size(); l_s++)
+    {
+        if (l_pExecutor)
+        {
+            l_vModules[l_s]->SetExecutor(l_pExecutor);
+        }
+        else
+        {
+            l_vModules[l_s]->InitThread();
+        }
+
+        l_vModules[l_s]->Start(0);
+    }
+
+    l_Context.Start(GET_PTR(l_pSource),
+                    l_iArrivals,
+                    p_rConfig.m_llWarmupFrames,
+                    p_rConfig.m_llFrames);
+
+    /* The thread-per-module links are delivered through queued signals: keep
+     * the event loop of the main thread running while waiting. */
+    for (l_i = 0; l_i < BENCH_RUN_TIMEOUT_MS; l_i++)
+    {
+        QCoreApplication::processEvents();
+
+        if (l_Context.WaitDone(1))
+        {
+            l_Result.m_bCompleted = true;
+            break;
+        }
+    }
+
+    for (l_s = 0; l_s < l_vModules.size(); l_s++)
+    {
+        l_vModules[l_s]->Stop(1000);
+        l_vModules[l_s]->SetExecutor(ModuleExecutorPtr());
+        l_vModules[l_s]->Close();
+    }
+
+    if (!l_Result.m_bCompleted)
+    {
+        return l_Result;
+    }
+
+    l_llElapsed_ns = std::max(l_Context.GetElapsed_ns(), qint64(1));
+    l_Latency = l_Context.GetLatency();
+
+    l_Result.m_dFps = (p_rConfig.m_llFrames * 1.0e9) / l_llElapsed_ns;
+    l_Result.m_dLatencyMean_us = l_Latency.m_llLatencyMean_ns / 1000.0;
+    l_Result.m_dLatencyP50_us = l_Latency.m_llLatencyP50_ns / 1000.0;
+    l_Result.m_dLatencyP99_us = l_Latency.m_llLatencyP99_ns / 1000.0;
+    l_Result.m_dLatencyMax_us = l_Latency.m_llLatencyMax_ns / 1000.0;
+    l_Result.m_dHop_us = l_Result.m_dLatencyMean_us / l_Result.m_iHops;
+    l_Result.m_dTimePerFrame_us = (l_llElapsed_ns / 1000.0) /
+                                  p_rConfig.m_llFrames;
+
+    return l_Result;
+}
@@ -0,0 +1,128 @@
+#ifndef BENCHPIPELINE_H
+#define BENCHPIPELINE_H
+
+/** @file benchPipeline.h
+ *
+ * @brief Builds the benchmark graphs out of the synthetic modules, runs them
+ * and reports throughput, latency and time per frame.
+ */
+
+#include "benchModules.h"
+
+/******************************************************************************/
+/**
+ * @enum benchGraph
+ *
+ * @brief Enumerates the benchmark topologies.
+ */
+enum benchGraph
+{
+    BENCH_GRAPH_LINEAR = 0, /**< source -> N pass -> sink. */
+    BENCH_GRAPH_DIAMOND, /**< source -> fan-out(N) -> N pass -> sink(N). */
+    BENCH_GRAPH_WIDE /**< source -> N x (pass -> sink), all linked to the
+                      * same output port of the source. */
+
+}; // end enum benchGraph.
+
+/******************************************************************************/
+/**
+ * @struct benchConfig
+ *
+ * @brief Parameters of a single benchmark run.
+ */
+struct benchConfig
+{
+    benchConfig()
+        : m_Graph(BENCH_GRAPH_LINEAR),
+          m_iSize(1),
+          m_iWidth(640),
+          m_iHeight(480),
+          m_llWarmupFrames(100),
+          m_llFrames(2000),
+          m_bExecutor(false),
+          m_iNumThreads(0)
+    {
+        /* Empty. */
+    }
+
+    benchGraph  m_Graph; /**< Topology. */
+
+    int     m_iSize; /**< Depth (linear) or width (diamond, wide). */
+
+    int     m_iWidth; /**< Frame width (pixels). */
+
+    int     m_iHeight; /**< Frame height (pixels). */
+
+    qint64  m_llWarmupFrames; /**< Frames excluded from the measures. */
+
+    qint64  m_llFrames; /**< Measured frames. */
+
+    bool    m_bExecutor; /**< If true the modules run on a ModuleExecutor and
+                          * are linked with g_LinkModulesDirect(), otherwise
+                          * each module runs in its own thread. */
+
+    int     m_iNumThreads; /**< Number of executor threads (0: cores). */
+
+}; // end struct benchConfig.
+
+/******************************************************************************/
+/**
+ * @struct benchResult
+ *
+ * @brief Measures of a benchmark run.
+ */
+struct benchResult
+{
+    benchResult()
+        : m_bCompleted(false),
+          m_iHops(0),
+          m_dFps(0.0),
+          m_dLatencyMean_us(0.0),
+          m_dLatencyP50_us(0.0),
+          m_dLatencyP99_us(0.0),
+          m_dLatencyMax_us(0.0),
+          m_dHop_us(0.0),
+          m_dTimePerFrame_us(0.0)
+    {
+        /* Empty. */
+    }
+
+    bool    m_bCompleted; /**< False if the run timed out. */
+
+    int     m_iHops; /**< Number of links from the source to a sink. */
+
+    double  m_dFps; /**< Frames per second. */
+
+    double  m_dLatencyMean_us; /**< Mean source-to-sink latency. */
+
+    double  m_dLatencyP50_us; /**< Median source-to-sink latency. */
+
+    double  m_dLatencyP99_us; /**< 99th percentile of the latency. */
+
+    double  m_dLatencyMax_us; /**< Maximum latency. */
+
+    double  m_dHop_us; /**< Mean latency of a single link. */
+
+    double  m_dTimePerFrame_us; /**< Wall time per frame, measured with
+                                 * QElapsedTimer. */
+
+}; // end struct benchResult.
+
+/******************************************************************************/
+/**
+ * @brief g_BenchGraphName returns the name of a topology, as used on the
+ * command line and in the report.
+ */
+const char* g_BenchGraphName(benchGraph p_Graph);
+
+/**
+ * @brief g_BenchRun builds the graph described by the input configuration,
+ * runs it and returns its measures.
+ *
+ * @param[in]   p_rConfig   Configuration of the run.
+ *
+ * @return the measures of the run.
+ */
+benchResult g_BenchRun(const benchConfig& p_rConfig);
+
+#endif // BENCHPIPELINE_H
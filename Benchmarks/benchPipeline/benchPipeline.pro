@@ -0,0 +1,20 @@
+QT       += core
+
+TARGET = benchPipeline
+TEMPLATE = app
+
+CONFIG *= bench console
+CONFIG -= app_bundle
+
+FLYSIGHT_DEPEND *= core core_app
+
+include($$PWD/../../FlysightConfig.pri)
+
+SOURCES += main.cpp\
+        benchMetadata.cpp\
+        benchModules.cpp\
+        benchPipeline.cpp
+
+HEADERS  += benchMetadata.h\
+        benchModules.h\
+        benchPipeline.h
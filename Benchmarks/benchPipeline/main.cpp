@@ -0,0 +1,235 @@
+#include "benchMetadata.h"
+#include "benchPipeline.h"
+#include <QCoreApplication>
+
+/*
+ * Usage: benchPipeline [options]
+ *
+ *   --frames N         Measured frames per run (default 2000).
+ *   --warmup N         Warm-up frames per run (default 100).
+ *   --executor         Run the modules on a ModuleExecutor with direct links.
+ *   --threads N        Number of executor threads (default: cores).
+ *   --graph NAME       Run only linear, diamond or wide.
+ *   --csv FILE         Also write the results to a CSV file.
+ *   --metadata         Only time the metadata codecs (their results are
+ *                      checked by testMetadata).
+ *
+ * Each run emits the next frame only when the previous one has reached all
+ * the sinks, so the sequence of executions is the same on every run and the
+ * results can be compared across builds.
+ */
+
+static const int    g_aiSizes[][2] = { { 320, 240 },
+                                       { 1280, 720 },
+                                       { 1920, 1080 } };
+
+static const int    g_aiLinearDepths[] = { 1, 4, 16 };
+static const int    g_aiWidths[] = { 2, 4, 16 };
+
+#define BENCH_ARRAY_SIZE(a)     (sizeof(a) / sizeof(a[0]))
+
+static const struct
+{
+    const char*     m_pcName;
+    benchRate       (*m_pfnBench)();
+} g_aMetadata[] =
+{
+    { "klv_decode", g_BenchKlvDecode },
+    { "klv_encode", g_BenchKlvEncode },
+    { "log_append", g_BenchLogAppend }
+};
+
+static void _Report(FILE*               p_pFile,
+                    const benchConfig&  p_rConfig,
+                    const benchResult&  p_rResult)
+{
+    fprintf(p_pFile,
+            "%s,%d,%dx%d,%s,%lld,%s,%.1f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+            g_BenchGraphName(p_rConfig.m_Graph),
+            p_rConfig.m_iSize,
+            p_rConfig.m_iWidth,
+            p_rConfig.m_iHeight,
+            (p_rConfig.m_bExecutor ? "executor" : "threads"),
+            static_cast<long long>(p_rConfig.m_llFrames),
+            (p_rResult.m_bCompleted ? "ok" : "timeout"),
+            p_rResult.m_dFps,
+            p_rResult.m_dLatencyMean_us,
+            p_rResult.m_dLatencyP50_us,
+            p_rResult.m_dLatencyP99_us,
+            p_rResult.m_dLatencyMax_us,
+            p_rResult.m_dHop_us,
+            p_rResult.m_dTimePerFrame_us);
+
+    fflush(p_pFile);
+}
+
+static void _RunMetadata(FILE* p_pCsv)
+{
+    benchRate   l_Rate;
+    const char* l_pcHeader;
+    size_t      l_s;
+
+    l_pcHeader = "bench,status,items,rate_per_s\n";
+
+    fprintf(stdout, "%s", l_pcHeader);
+
+    if (p_pCsv)
+    {
+        fprintf(p_pCsv, "%s", l_pcHeader);
+    }
+
+    for (l_s = 0; l_s < BENCH_ARRAY_SIZE(g_aMetadata); l_s++)
+    {
+        l_Rate = g_aMetadata[l_s].m_pfnBench();
+
+        fprintf(stdout,
+                "%s,%s,%lld,%.0f\n",
+                g_aMetadata[l_s].m_pcName,
+                (l_Rate.m_llItems > 0 ? "ok" : "error"),
+                static_cast<long long>(l_Rate.m_llItems),
+                l_Rate.m_dRate);
+
+        if (p_pCsv)
+        {
+            fprintf(p_pCsv,
+                    "%s,%s,%lld,%.0f\n",
+                    g_aMetadata[l_s].m_pcName,
+                    (l_Rate.m_llItems > 0 ? "ok" : "error"),
+                    static_cast<long long>(l_Rate.m_llItems),
+                    l_Rate.m_dRate);
+        }
+    }
+
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication    a(argc, argv);
+    benchConfig         l_Config;
+    benchResult         l_Result;
+    FILE*               l_pCsv;
+    QStringList         l_lArgs;
+    QString             l_sGraph;
+    const char*         l_pcHeader;
+    int                 l_i;
+    size_t              l_sSize;
+    size_t              l_sParam;
+    int                 l_iGraph;
+    bool                l_bMetadata;
+
+    l_pCsv = NULL;
+    l_bMetadata = false;
+    l_lArgs = QCoreApplication::arguments();
+
+    for (l_i = 1; l_i < l_lArgs.size(); l_i++)
+    {
+        if (l_lArgs[l_i] == "--frames" && l_i + 1 < l_lArgs.size())
+        {
+            l_Config.m_llFrames = l_lArgs[++l_i].toLongLong();
+        }
+        else if (l_lArgs[l_i] == "--warmup" && l_i + 1 < l_lArgs.size())
+        {
+            l_Config.m_llWarmupFrames = l_lArgs[++l_i].toLongLong();
+        }
+        else if (l_lArgs[l_i] == "--executor")
+        {
+            l_Config.m_bExecutor = true;
+        }
+        else if (l_lArgs[l_i] == "--threads" && l_i + 1 < l_lArgs.size())
+        {
+            l_Config.m_iNumThreads = l_lArgs[++l_i].toInt();
+        }
+        else if (l_lArgs[l_i] == "--graph" && l_i + 1 < l_lArgs.size())
+        {
+            l_sGraph = l_lArgs[++l_i];
+        }
+        else if (l_lArgs[l_i] == "--csv" && l_i + 1 < l_lArgs.size())
+        {
+            l_pCsv = fopen(l_lArgs[++l_i].toLocal8Bit().constData(), "w");
+        }
+        else if (l_lArgs[l_i] == "--metadata")
+        {
+            l_bMetadata = true;
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Usage: %s [--frames N] [--warmup N] [--executor] "
+                    "[--threads N] [--graph linear|diamond|wide] "
+                    "[--csv FILE] [--metadata]\n",
+                    argv[0]);
+
+            return -1;
+        }
+    }
+
+    if (l_bMetadata)
+    {
+        _RunMetadata(l_pCsv);
+
+        if (l_pCsv)
+        {
+            fclose(l_pCsv);
+        }
+
+        return 0;
+    }
+
+    l_Config.m_llFrames = std::max(l_Config.m_llFrames, qint64(1));
+    l_Config.m_llWarmupFrames = std::max(l_Config.m_llWarmupFrames, qint64(0));
+
+    l_pcHeader = "graph,size,frame,mode,frames,status,fps,latency_mean_us,"
+                 "latency_p50_us,latency_p99_us,latency_max_us,hop_us,"
+                 "time_per_frame_us\n";
+
+    fprintf(stdout, "%s", l_pcHeader);
+
+    if (l_pCsv)
+    {
+        fprintf(l_pCsv, "%s", l_pcHeader);
+    }
+
+    for (l_iGraph = BENCH_GRAPH_LINEAR; l_iGraph <= BENCH_GRAPH_WIDE; l_iGraph++)
+    {
+        l_Config.m_Graph = static_cast<benchGraph>(l_iGraph);
+
+        if (!l_sGraph.isEmpty() && l_sGraph != g_BenchGraphName(l_Config.m_Graph))
+        {
+            continue;
+        }
+
+        for (l_sSize = 0; l_sSize < BENCH_ARRAY_SIZE(g_aiSizes); l_sSize++)
+        {
+            l_Config.m_iWidth = g_aiSizes[l_sSize][0];
+            l_Config.m_iHeight = g_aiSizes[l_sSize][1];
+
+            for (l_sParam = 0;
+                 l_sParam < (l_Config.m_Graph == BENCH_GRAPH_LINEAR ?
+                                 BENCH_ARRAY_SIZE(g_aiLinearDepths) :
+                                 BENCH_ARRAY_SIZE(g_aiWidths));
+                 l_sParam++)
+            {
+                l_Config.m_iSize = (l_Config.m_Graph == BENCH_GRAPH_LINEAR ?
+                                        g_aiLinearDepths[l_sParam] :
+                                        g_aiWidths[l_sParam]);
+
+                l_Result = g_BenchRun(l_Config);
+
+                _Report(stdout, l_Config, l_Result);
+
+                if (l_pCsv)
+                {
+                    _Report(l_pCsv, l_Config, l_Result);
+                }
+            }
+        }
+    }
+
+    if (l_pCsv)
+    {
+        fclose(l_pCsv);
+    }
+
+    return 0;
+}
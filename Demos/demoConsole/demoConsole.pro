@@ -0,0 +1,15 @@
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = demoConsole
+TEMPLATE = app
+
+CONFIG *= demo console
+CONFIG -= app_bundle
+
+FLYSIGHT_DEPEND *= core core_app
+
+include($$PWD/../../FlysightConfig.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,62 @@
+#include <core>
+#include <core_app>
+#include <QCoreApplication>
+
+using namespace fby;
+
+/*
+ * Usage: demoConsole [pipeline.ini] [--duration ms]
+ *
+ * Loads the pipeline described in the *.ini file (see AppConsole), runs it on
+ * the event loop of a QCoreApplication and, if a duration is given, quits
+ * after the given time.
+ */
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication    a(argc, argv);
+    AppConsole          l_App;
+    QStringList         l_lArgs;
+    QString             l_sFile;
+    int                 l_iDuration_ms;
+    int                 l_i;
+    int                 l_iResult;
+
+    l_sFile = "demoConsole.ini";
+    l_iDuration_ms = 0;
+    l_lArgs = QCoreApplication::arguments();
+
+    for (l_i = 1; l_i < l_lArgs.size(); l_i++)
+    {
+        if (l_lArgs[l_i] == "--duration" && l_i + 1 < l_lArgs.size())
+        {
+            l_iDuration_ms = l_lArgs[++l_i].toInt();
+        }
+        else
+        {
+            l_sFile = l_lArgs[l_i];
+        }
+    }
+
+    if (l_App.LoadPipeline(l_sFile) != RET_SUCCESS)
+    {
+        return -1;
+    }
+
+    if (l_App.Start() != RET_SUCCESS)
+    {
+        return -1;
+    }
+
+    if (l_iDuration_ms > 0)
+    {
+        QTimer::singleShot(l_iDuration_ms, &a, SLOT(quit()));
+    }
+
+    l_iResult = a.exec();
+
+    l_App.Stop(1000);
+    l_App.Close();
+
+    return l_iResult;
+}
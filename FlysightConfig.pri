@@ -57,11 +57,15 @@ equals(TEMPLATE, app) {
       test {
          DESTDIR = $$PWD/$$BIN_PATH/tests/$$TARGET/$$QT_SUFFIX
       } else {
-         extern {
-            DESTDIR = $$PWD/ext/$$EXTERN_ROOT_NAME/$$BIN_PATH/$$QT_SUFFIX
+         bench {
+            DESTDIR = $$PWD/$$BIN_PATH/benchmarks/$$TARGET/$$QT_SUFFIX
          } else {
-            DESTDIR = $$PWD/$$BIN_PATH/$$TARGET/$$QT_SUFFIX
-         } # end extern
+            extern {
+               DESTDIR = $$PWD/ext/$$EXTERN_ROOT_NAME/$$BIN_PATH/$$QT_SUFFIX
+            } else {
+               DESTDIR = $$PWD/$$BIN_PATH/$$TARGET/$$QT_SUFFIX
+            } # end extern
+         } # end bench
       } # end test
    } # end demo
 
@@ -112,11 +116,13 @@ equals(TEMPLATE, lib) {
             CONFIG *= dll
             DEFINES *= MODULE_LIBRARY_SHARED
          } else {
+            # The Module registers itself in the ModuleRegistry of the
+            # application, which links it whole.
+            CONFIG -= dll
             CONFIG *= staticlib
             DEFINES *= MODULE_LIBRARY_STATIC
          }
 
-         CONFIG *= dll
          DESTDIR = $$PWD/$$MOD_PATH/$$QT_SUFFIX
          windows: DLLDESTDIR = $$PWD/$$MOD_PATH/$$QT_SUFFIX
 
@@ -0,0 +1,216 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <core_pch.h>
+
+namespace fby
+{
+/******************************************************************************/
+/* Forward declarations. */
+class FrameBufferReleaser;
+DEF_PTR(FrameBufferReleaser);
+
+/******************************************************************************/
+/**
+ * @class FrameBufferReleaser
+ *
+ * @brief Interface to be implemented by the owners of an external pixel
+ * storage that is wrapped by a FrameBuffer. The Release() method is called
+ * when the last FrameBuffer that references the storage is destroyed.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class FrameBufferReleaser
+{
+public:
+
+    virtual ~FrameBufferReleaser()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Release gives the wrapped storage back to its owner.
+     *
+     * @param[in]   p_pucData   Pointer to the wrapped storage.
+     * @param[in]   p_sSize     Size of the wrapped storage (bytes).
+     */
+    virtual void Release(uint8_t*       p_pucData,
+                         const size_t   p_sSize) = 0;
+
+}; // end class FrameBufferReleaser.
+
+/******************************************************************************/
+/**
+ * @class FrameBuffer
+ *
+ * @brief The FrameBuffer class holds the pixel data of a video frame. A
+ * FrameBuffer is meant to be shared through a FrameBufferPtr among all the
+ * frames that refer to the same pixels, so that passing a frame from a
+ * producer to its consumers never copies the pixel data. The pixel storage may
+ * be:
+ *
+ *  - owned by the FrameBuffer (allocated or adopted from a std::vector);
+ *
+ *  - wrapped from an external owner, which is notified through a
+ *    FrameBufferReleaser when the FrameBuffer is destroyed.
+ *
+ * @warning A FrameBuffer that has been shared must be considered immutable.
+ * DataFrame::GetMutableData() performs the copy-on-write detach that is
+ * required before writing.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class FrameBuffer
+{
+public:
+
+    /**
+     * @brief Allocates a new owned buffer of the specified size. The content of
+     * the buffer is zero-initialized.
+     *
+     * @param[in]   p_sSize     Size of the buffer (bytes).
+     */
+    explicit FrameBuffer(const size_t p_sSize)
+        : m_vStorage(p_sSize),
+          m_pucData(p_sSize > 0 ? &m_vStorage[0] : NULL),
+          m_sSize(p_sSize)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Allocates a new owned buffer and copies the input bytes.
+     *
+     * @param[in]   p_pucData   Input bytes.
+     * @param[in]   p_sSize     Number of bytes to be copied.
+     */
+    FrameBuffer(const uint8_t*  p_pucData,
+                const size_t    p_sSize)
+        : m_vStorage(p_pucData, p_pucData + p_sSize),
+          m_pucData(p_sSize > 0 ? &m_vStorage[0] : NULL),
+          m_sSize(p_sSize)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Adopts the content of the input vector without copying it.
+     *
+     * @note On return the input vector is empty.
+     *
+     * @param[in,out]   p_rvBuffer  Vector whose content is adopted.
+     */
+    explicit FrameBuffer(std::vector<uint8_t>& p_rvBuffer)
+        : m_pucData(NULL),
+          m_sSize(0)
+    {
+        m_vStorage.swap(p_rvBuffer);
+
+        m_sSize = m_vStorage.size();
+
+        if (m_sSize > 0)
+        {
+            m_pucData = &m_vStorage[0];
+        }
+    }
+
+    /**
+     * @brief Wraps an external storage without copying it.
+     *
+     * @param[in]   p_pucData   External storage.
+     * @param[in]   p_sSize     Size of the external storage (bytes).
+     * @param[in]   p_pReleaser Object to be notified when this FrameBuffer is
+     *                          destroyed. If null, the caller must guarantee
+     *                          that the storage outlives this FrameBuffer.
+     */
+    FrameBuffer(uint8_t*                p_pucData,
+                const size_t            p_sSize,
+                FrameBufferReleaserPtr  p_pReleaser)
+        : m_pucData(p_pucData),
+          m_sSize(p_sSize),
+          m_pReleaser(p_pReleaser)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Destructor: gives a wrapped storage back to its owner.
+     */
+    ~FrameBuffer()
+    {
+        if (m_pReleaser)
+        {
+            m_pReleaser->Release(m_pucData, m_sSize);
+        }
+    }
+
+    /**
+     * @return a const pointer to the pixel data, or NULL if the buffer is
+     * empty.
+     */
+    inline const uint8_t* GetData() const
+    {
+        return m_pucData;
+    }
+
+    /**
+     * @return a pointer to the pixel data, or NULL if the buffer is empty.
+     *
+     * @warning Writing through this pointer is allowed only while the buffer
+     * is referenced by a single owner (e.g. a producer that is filling a
+     * buffer it has just allocated).
+     */
+    inline uint8_t* GetData()
+    {
+        return m_pucData;
+    }
+
+    /**
+     * @return the size of the buffer (bytes).
+     */
+    inline size_t GetSize() const
+    {
+        return m_sSize;
+    }
+
+    /**
+     * @return true if the buffer does not contain any byte.
+     */
+    inline bool IsEmpty() const
+    {
+        return (m_sSize == 0);
+    }
+
+private:
+
+    /* Non-copyable: FrameBuffer objects are shared through FrameBufferPtr. */
+    FrameBuffer(const FrameBuffer&);
+    FrameBuffer& operator = (const FrameBuffer&);
+
+private:
+
+    std::vector<uint8_t>    m_vStorage; /**< Owned storage. Empty if the
+                                         * storage is wrapped. */
+
+    uint8_t*    m_pucData; /**< Pointer to the first byte of the storage. */
+
+    size_t      m_sSize; /**< Size of the storage (bytes). */
+
+    FrameBufferReleaserPtr  m_pReleaser; /**< Owner of a wrapped storage. */
+
+}; // end class FrameBuffer.
+
+DEF_PTR(FrameBuffer);
+
+} // end namespace fby.
+
+#endif // FRAMEBUFFER_H
@@ -0,0 +1,1469 @@
+#ifndef METADATA_KLV_H
+#define METADATA_KLV_H
+
+/** @file MetadataKlv.h
+ *
+ * @brief Contains the classes to decode the metadata of a video from the
+ * KLV packets of the MISB ST 0601 UAS Datalink Local Set, and to encode it
+ * back.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Metadata.h>
+
+/** Size of the Universal Label key of a KLV packet (bytes). */
+#define KLV_KEY_SIZE            16
+
+/** Maximum size of a KLV packet accepted by the decoder (bytes). */
+#define KLV_MAX_PACKET_SIZE     65536
+
+/** Size of a buffer that always holds a packet written by the encoder
+ * (bytes). */
+#define KLV_MAX_ENCODED_SIZE    1024
+
+/** Version of ST 0601 written by the encoder (tag 65). */
+#define KLV_LS_VERSION          17
+
+/** Default number of packets between two complete packets, when the encoder
+ * only writes the changed tags. */
+#define KLV_DEFAULT_KEY_INTERVAL    30
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @enum KlvTag
+ *
+ * @brief Tags of the ST 0601 local set mapped onto the fields of a Metadata.
+ */
+enum KlvTag
+{
+    KLV_TAG_CHECKSUM = 1,
+    KLV_TAG_TIMESTAMP = 2,
+    KLV_TAG_MISSION_ID = 3,
+    KLV_TAG_PLATFORM_TAIL_NUMBER = 4,
+    KLV_TAG_PLATFORM_HEADING = 5,
+    KLV_TAG_PLATFORM_PITCH = 6,
+    KLV_TAG_PLATFORM_ROLL = 7,
+    KLV_TAG_PLATFORM_TRUE_AIRSPEED = 8,
+    KLV_TAG_PLATFORM_DESIGNATION = 10,
+    KLV_TAG_IMAGE_SOURCE_SENSOR = 11,
+    KLV_TAG_IMAGE_COORDINATE_SYSTEM = 12,
+    KLV_TAG_SENSOR_LAT = 13,
+    KLV_TAG_SENSOR_LON = 14,
+    KLV_TAG_SENSOR_ALT = 15,
+    KLV_TAG_SENSOR_HFOV = 16,
+    KLV_TAG_SENSOR_VFOV = 17,
+    KLV_TAG_SENSOR_AZIMUTH = 18,
+    KLV_TAG_SENSOR_ELEVATION = 19,
+    KLV_TAG_SENSOR_ROLL = 20,
+    KLV_TAG_SLANT_RANGE = 21,
+    KLV_TAG_TARGET_WIDTH = 22,
+    KLV_TAG_FRAME_CENTER_LAT = 23,
+    KLV_TAG_FRAME_CENTER_LON = 24,
+    KLV_TAG_FRAME_CENTER_ALT = 25,
+    KLV_TAG_WIND_DIRECTION = 35,
+    KLV_TAG_WIND_SPEED = 36,
+    KLV_TAG_PLATFORM_CALL_SIGN = 59,
+    KLV_TAG_VERSION = 65,
+    KLV_TAG_TARGET_WIDTH_EXTENDED = 96
+
+}; // end enum KlvTag.
+
+/******************************************************************************/
+/**
+ * @enum KlvStatus
+ *
+ * @brief Result of the decoding of a KLV packet.
+ */
+enum KlvStatus
+{
+    KLV_OK = 0,             /**< Packet decoded. */
+    KLV_INCOMPLETE,         /**< The packet is not complete yet. */
+    KLV_INVALID_KEY,        /**< Not a UAS Datalink Local Set. */
+    KLV_INVALID_LENGTH,     /**< Malformed length or tag. */
+    KLV_INVALID_CHECKSUM    /**< Missing or wrong checksum. */
+
+}; // end enum KlvStatus.
+
+/******************************************************************************/
+/**
+ * @enum KlvFormatType
+ *
+ * @brief Encodings of the values of the local set.
+ */
+enum KlvFormatType
+{
+    KLV_FORMAT_NONE = 0,    /**< Tag not mapped onto Metadata. */
+    KLV_FORMAT_STRING,      /**< ISO 646 string. */
+    KLV_FORMAT_UINT,        /**< Unsigned integer, not scaled. */
+    KLV_FORMAT_UMAP,        /**< Unsigned integer mapped onto [min, max]. */
+    KLV_FORMAT_SMAP,        /**< Signed integer mapped onto [min, max], the
+                             * smallest value being the error value. */
+    KLV_FORMAT_IMAPB        /**< ST 1201 IMAPB of [min, max]. */
+
+}; // end enum KlvFormatType.
+
+/******************************************************************************/
+/**
+ * @struct KlvFormat
+ *
+ * @brief Encoding of the value of a tag.
+ */
+struct KlvFormat
+{
+    KlvFormatType   m_Type; /**< Encoding. */
+
+    int     m_iLength; /**< Length of the value (bytes), 0 if variable. The
+                        * IMAPB values are read with any length and written
+                        * with this one. */
+
+    double  m_dMin; /**< Smallest value of a mapped integer. */
+
+    double  m_dMax; /**< Largest value of a mapped integer. */
+};
+
+/******************************************************************************/
+/**
+ * @class Klv
+ *
+ * @brief Low-level functions of the KLV encoding of the ST 0601 local set:
+ * BER lengths, BER-OID tags, checksum and mapping of the integer values onto
+ * their physical ranges. None of them allocates memory.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class Klv
+{
+public:
+
+    /**
+     * @return the 16-bit checksum of ST 0601, computed from the first byte of
+     * the key up to the length of the checksum item included.
+     */
+    static uint16_t Checksum(const uint8_t* p_pucData, const size_t p_sSize)
+    {
+        uint16_t    l_usSum;
+        size_t      l_s;
+
+        l_usSum = 0;
+
+        for (l_s = 0; l_s < p_sSize; l_s++)
+        {
+            l_usSum = static_cast<uint16_t>(
+                        l_usSum +
+                        (p_pucData[l_s] << ((l_s & 1) == 0 ? 8 : 0)));
+        }
+
+        return l_usSum;
+    }
+
+    /**
+     * @brief GetFormat returns the encoding of a tag mapped onto Metadata.
+     *
+     * @return false if the tag is not mapped.
+     */
+    static bool GetFormat(const uint32_t p_uiTag, KlvFormat& p_rFormat)
+    {
+        static const struct
+        {
+            uint32_t        m_uiTag;
+            KlvFormat       m_Format;
+        } s_Formats[] =
+        {
+            { KLV_TAG_TIMESTAMP, { KLV_FORMAT_UINT, 8, 0, 0 } },
+            { KLV_TAG_MISSION_ID, { KLV_FORMAT_STRING, 0, 0, 0 } },
+            { KLV_TAG_PLATFORM_TAIL_NUMBER, { KLV_FORMAT_STRING, 0, 0, 0 } },
+            { KLV_TAG_PLATFORM_HEADING, { KLV_FORMAT_UMAP, 2, 0, 360 } },
+            { KLV_TAG_PLATFORM_PITCH, { KLV_FORMAT_SMAP, 2, -20, 20 } },
+            { KLV_TAG_PLATFORM_ROLL, { KLV_FORMAT_SMAP, 2, -50, 50 } },
+            { KLV_TAG_PLATFORM_TRUE_AIRSPEED, { KLV_FORMAT_UMAP, 1, 0, 255 } },
+            { KLV_TAG_PLATFORM_DESIGNATION, { KLV_FORMAT_STRING, 0, 0, 0 } },
+            { KLV_TAG_IMAGE_SOURCE_SENSOR, { KLV_FORMAT_STRING, 0, 0, 0 } },
+            { KLV_TAG_IMAGE_COORDINATE_SYSTEM, { KLV_FORMAT_STRING, 0, 0, 0 } },
+            { KLV_TAG_SENSOR_LAT, { KLV_FORMAT_SMAP, 4, -90, 90 } },
+            { KLV_TAG_SENSOR_LON, { KLV_FORMAT_SMAP, 4, -180, 180 } },
+            { KLV_TAG_SENSOR_ALT, { KLV_FORMAT_UMAP, 2, -900, 19000 } },
+            { KLV_TAG_SENSOR_HFOV, { KLV_FORMAT_UMAP, 2, 0, 180 } },
+            { KLV_TAG_SENSOR_VFOV, { KLV_FORMAT_UMAP, 2, 0, 180 } },
+            { KLV_TAG_SENSOR_AZIMUTH, { KLV_FORMAT_UMAP, 4, 0, 360 } },
+            { KLV_TAG_SENSOR_ELEVATION, { KLV_FORMAT_SMAP, 4, -180, 180 } },
+            { KLV_TAG_SENSOR_ROLL, { KLV_FORMAT_UMAP, 4, 0, 360 } },
+            { KLV_TAG_SLANT_RANGE, { KLV_FORMAT_UMAP, 4, 0, 5000000 } },
+            { KLV_TAG_TARGET_WIDTH, { KLV_FORMAT_UMAP, 2, 0, 10000 } },
+            { KLV_TAG_FRAME_CENTER_LAT, { KLV_FORMAT_SMAP, 4, -90, 90 } },
+            { KLV_TAG_FRAME_CENTER_LON, { KLV_FORMAT_SMAP, 4, -180, 180 } },
+            { KLV_TAG_FRAME_CENTER_ALT, { KLV_FORMAT_UMAP, 2, -900, 19000 } },
+            { KLV_TAG_WIND_DIRECTION, { KLV_FORMAT_UMAP, 2, 0, 360 } },
+            { KLV_TAG_WIND_SPEED, { KLV_FORMAT_UMAP, 1, 0, 100 } },
+            { KLV_TAG_PLATFORM_CALL_SIGN, { KLV_FORMAT_STRING, 0, 0, 0 } },
+            { KLV_TAG_TARGET_WIDTH_EXTENDED,
+              { KLV_FORMAT_IMAPB, 3, 0, 1500000 } }
+        };
+        size_t  l_s;
+
+        for (l_s = 0; l_s < sizeof(s_Formats) / sizeof(s_Formats[0]); l_s++)
+        {
+            if (s_Formats[l_s].m_uiTag == p_uiTag)
+            {
+                p_rFormat = s_Formats[l_s].m_Format;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @return the Universal Label key of the UAS Datalink Local Set.
+     */
+    static const uint8_t* GetKey()
+    {
+        static const uint8_t    s_aucKey[KLV_KEY_SIZE] =
+        {
+            0x06, 0x0E, 0x2B, 0x34, 0x02, 0x0B, 0x01, 0x01,
+            0x0E, 0x01, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00
+        };
+
+        return s_aucKey;
+    }
+
+    /**
+     * @return true if the input bytes are the key of the UAS Datalink Local
+     * Set. The version byte of the registry (byte 7) is not compared.
+     */
+    static bool IsKey(const uint8_t* p_pucData)
+    {
+        return memcmp(p_pucData, GetKey(), 7) == 0 &&
+               memcmp(p_pucData + 8, GetKey() + 8, KLV_KEY_SIZE - 8) == 0;
+    }
+
+    /**
+     * @brief ReadBerLength reads a BER length, in short or long form.
+     *
+     * @param[in,out]   p_rpucData  Current position, moved past the length.
+     * @param[in]       p_pucEnd    End of the data.
+     * @param[out]      p_rsLength  Length.
+     *
+     * @retval  KLV_OK              if the length has been read.
+     * @retval  KLV_INCOMPLETE      if the data end before the length.
+     * @retval  KLV_INVALID_LENGTH  if the length is malformed.
+     */
+    static KlvStatus ReadBerLength(const uint8_t*&  p_rpucData,
+                                   const uint8_t*   p_pucEnd,
+                                   size_t&          p_rsLength)
+    {
+        const uint8_t*  l_pucData;
+        uint64_t        l_ullLength;
+        int             l_iNumBytes;
+        int             l_i;
+
+        l_pucData = p_rpucData;
+
+        if (l_pucData >= p_pucEnd)
+        {
+            return KLV_INCOMPLETE;
+        }
+
+        if (*l_pucData < 0x80)
+        {
+            p_rsLength = *l_pucData;
+            p_rpucData = l_pucData + 1;
+
+            return KLV_OK;
+        }
+
+        l_iNumBytes = *l_pucData & 0x7F;
+        l_pucData++;
+
+        if (l_iNumBytes == 0 || l_iNumBytes > 8)
+        {
+            return KLV_INVALID_LENGTH;
+        }
+
+        if (p_pucEnd - l_pucData < l_iNumBytes)
+        {
+            return KLV_INCOMPLETE;
+        }
+
+        l_ullLength = 0;
+
+        for (l_i = 0; l_i < l_iNumBytes; l_i++)
+        {
+            l_ullLength = (l_ullLength << 8) | l_pucData[l_i];
+        }
+
+        if (l_ullLength > KLV_MAX_PACKET_SIZE)
+        {
+            return KLV_INVALID_LENGTH;
+        }
+
+        p_rsLength = static_cast<size_t>(l_ullLength);
+        p_rpucData = l_pucData + l_iNumBytes;
+
+        return KLV_OK;
+    }
+
+    /**
+     * @brief ReadBerOid reads a BER-OID tag (7 bits per byte, most
+     * significant first, the high bit set on all the bytes but the last).
+     *
+     * @param[in,out]   p_rpucData  Current position, moved past the tag.
+     * @param[in]       p_pucEnd    End of the data.
+     * @param[out]      p_ruiTag    Tag.
+     *
+     * @return false if the tag is malformed or truncated.
+     */
+    static bool ReadBerOid(const uint8_t*&  p_rpucData,
+                           const uint8_t*   p_pucEnd,
+                           uint32_t&        p_ruiTag)
+    {
+        const uint8_t*  l_pucData;
+        int             l_i;
+
+        l_pucData = p_rpucData;
+        p_ruiTag = 0;
+
+        for (l_i = 0; l_i < 4 && l_pucData < p_pucEnd; l_i++)
+        {
+            p_ruiTag = (p_ruiTag << 7) | (*l_pucData & 0x7F);
+
+            if ((*l_pucData++ & 0x80) == 0)
+            {
+                p_rpucData = l_pucData;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief ReadValue reads a numeric value and maps it onto its physical
+     * range.
+     *
+     * @param[in]   p_rFormat   Encoding of the value.
+     * @param[in]   p_pucData   Value.
+     * @param[in]   p_sLength   Length of the value (bytes).
+     * @param[out]  p_rdValue   Physical value.
+     *
+     * @return false if the length does not match the format or the value is
+     * an error value.
+     */
+    static bool ReadValue(const KlvFormat&  p_rFormat,
+                          const uint8_t*    p_pucData,
+                          const size_t      p_sLength,
+                          double&           p_rdValue)
+    {
+        uint64_t    l_ullValue;
+        int64_t     l_llValue;
+        double      l_dScale;
+        size_t      l_s;
+        int         l_iShift;
+
+        if (p_sLength == 0 || p_sLength > 8 ||
+            (p_rFormat.m_iLength > 0 &&
+             p_rFormat.m_Type != KLV_FORMAT_IMAPB &&
+             p_sLength != static_cast<size_t>(p_rFormat.m_iLength)))
+        {
+            return false;
+        }
+
+        l_ullValue = 0;
+
+        for (l_s = 0; l_s < p_sLength; l_s++)
+        {
+            l_ullValue = (l_ullValue << 8) | p_pucData[l_s];
+        }
+
+        switch (p_rFormat.m_Type)
+        {
+        case KLV_FORMAT_UINT:
+            p_rdValue = static_cast<double>(l_ullValue);
+            return true;
+
+        case KLV_FORMAT_UMAP:
+            l_dScale = _MaxUnsigned(p_sLength);
+            p_rdValue = p_rFormat.m_dMin +
+                        static_cast<double>(l_ullValue) *
+                        (p_rFormat.m_dMax - p_rFormat.m_dMin) / l_dScale;
+            return true;
+
+        case KLV_FORMAT_SMAP:
+            /* Sign extension, then the smallest value means "error". */
+            l_iShift = 64 - 8 * static_cast<int>(p_sLength);
+            l_llValue = static_cast<int64_t>(l_ullValue << l_iShift) >>
+                        l_iShift;
+
+            if (l_llValue == -static_cast<int64_t>(
+                    (static_cast<uint64_t>(1) << (8 * p_sLength - 1))))
+            {
+                return false;
+            }
+
+            l_dScale = _MaxUnsigned(p_sLength) - 1.0;
+            p_rdValue = static_cast<double>(l_llValue) *
+                        (p_rFormat.m_dMax - p_rFormat.m_dMin) / l_dScale;
+            return true;
+
+        case KLV_FORMAT_IMAPB:
+            return ReadImapb(p_rFormat.m_dMin,
+                             p_rFormat.m_dMax,
+                             l_ullValue,
+                             p_sLength,
+                             p_rdValue);
+
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief ReadImapb maps an ST 1201 IMAPB integer onto [min, max].
+     *
+     * @return false if the integer is a special value (most significant bit
+     * set).
+     */
+    static bool ReadImapb(const double      p_dMin,
+                          const double      p_dMax,
+                          const uint64_t    p_ullValue,
+                          const size_t      p_sLength,
+                          double&           p_rdValue)
+    {
+        double  l_dScaleRev;
+        double  l_dOffset;
+        int     l_iDataPow;
+
+        if (p_ullValue >> (8 * p_sLength - 1))
+        {
+            return false;
+        }
+
+        l_iDataPow = 8 * static_cast<int>(p_sLength) - 1;
+        l_dScaleRev = ldexp(1.0, _ImapbPow(p_dMin, p_dMax) - l_iDataPow);
+        l_dOffset = _ImapbOffset(p_dMin, p_dMax, p_sLength);
+
+        p_rdValue = l_dScaleRev * (static_cast<double>(p_ullValue) - l_dOffset)
+                    + p_dMin;
+
+        return true;
+    }
+
+    /**
+     * @brief WriteBerLength writes a BER length in its shortest form.
+     *
+     * @param[in]   p_sLength   Length.
+     * @param[out]  p_pucData   Destination, at least 9 bytes.
+     *
+     * @return the number of bytes written.
+     */
+    static size_t WriteBerLength(const size_t p_sLength, uint8_t* p_pucData)
+    {
+        size_t  l_sNumBytes;
+        size_t  l_s;
+
+        if (p_sLength < 0x80)
+        {
+            p_pucData[0] = static_cast<uint8_t>(p_sLength);
+
+            return 1;
+        }
+
+        for (l_sNumBytes = 1;
+             l_sNumBytes < sizeof(size_t) &&
+             (p_sLength >> (8 * l_sNumBytes)) != 0;
+             l_sNumBytes++)
+        {
+            /* Empty. */
+        }
+
+        p_pucData[0] = static_cast<uint8_t>(0x80 | l_sNumBytes);
+
+        for (l_s = 0; l_s < l_sNumBytes; l_s++)
+        {
+            p_pucData[l_sNumBytes - l_s] =
+                    static_cast<uint8_t>(p_sLength >> (8 * l_s));
+        }
+
+        return l_sNumBytes + 1;
+    }
+
+    /**
+     * @brief WriteValue maps a physical value onto the integer of its format,
+     * clamped to the range of the format. The inverse of ReadValue().
+     *
+     * @param[in]   p_rFormat   Encoding of the value.
+     * @param[in]   p_dValue    Physical value. Must fit a double exactly
+     *                          for KLV_FORMAT_UINT.
+     * @param[out]  p_pucData   Destination, at least m_iLength bytes.
+     *
+     * @return the number of bytes written, 0 if the value is NaN or the
+     * format is not numeric.
+     */
+    static size_t WriteValue(const KlvFormat&   p_rFormat,
+                             const double       p_dValue,
+                             uint8_t*           p_pucData)
+    {
+        uint64_t    l_ullValue;
+        double      l_dScaled;
+        double      l_dMax;
+        size_t      l_sLength;
+        size_t      l_s;
+
+        if (p_dValue != p_dValue || p_rFormat.m_iLength <= 0)
+        {
+            return 0;
+        }
+
+        l_sLength = static_cast<size_t>(p_rFormat.m_iLength);
+
+        switch (p_rFormat.m_Type)
+        {
+        case KLV_FORMAT_UINT:
+            l_ullValue = static_cast<uint64_t>(std::max(p_dValue, 0.0));
+            break;
+
+        case KLV_FORMAT_UMAP:
+            l_dMax = _MaxUnsigned(l_sLength);
+            l_dScaled = (p_dValue - p_rFormat.m_dMin) * l_dMax /
+                        (p_rFormat.m_dMax - p_rFormat.m_dMin);
+            l_dScaled = std::max(0.0, std::min(floor(l_dScaled + 0.5), l_dMax));
+            l_ullValue = static_cast<uint64_t>(l_dScaled);
+            break;
+
+        case KLV_FORMAT_SMAP:
+            /* The smallest value is left to the error value. */
+            l_dMax = ldexp(1.0, 8 * static_cast<int>(l_sLength) - 1) - 1.0;
+            l_dScaled = p_dValue * (_MaxUnsigned(l_sLength) - 1.0) /
+                        (p_rFormat.m_dMax - p_rFormat.m_dMin);
+            l_dScaled = std::max(-l_dMax,
+                                 std::min(floor(l_dScaled + 0.5), l_dMax));
+            l_ullValue = static_cast<uint64_t>(
+                        static_cast<int64_t>(l_dScaled));
+            break;
+
+        case KLV_FORMAT_IMAPB:
+            /* The values with the most significant bit set are special. */
+            l_dMax = ldexp(1.0, 8 * static_cast<int>(l_sLength) - 1) - 1.0;
+            l_dScaled = ldexp(1.0,
+                              8 * static_cast<int>(l_sLength) - 1 -
+                              _ImapbPow(p_rFormat.m_dMin, p_rFormat.m_dMax)) *
+                        (p_dValue - p_rFormat.m_dMin) +
+                        _ImapbOffset(p_rFormat.m_dMin,
+                                     p_rFormat.m_dMax,
+                                     l_sLength);
+            l_ullValue = static_cast<uint64_t>(
+                        std::max(0.0, std::min(floor(l_dScaled), l_dMax)));
+            break;
+
+        default:
+            return 0;
+        }
+
+        for (l_s = l_sLength; l_s > 0; l_s--)
+        {
+            p_pucData[l_s - 1] = static_cast<uint8_t>(l_ullValue & 0xFF);
+            l_ullValue >>= 8;
+        }
+
+        return l_sLength;
+    }
+
+protected:
+
+    /**
+     * @return the zero offset of an IMAPB of [min, max], which makes 0 an
+     * exact value of a range that contains it.
+     */
+    static double _ImapbOffset(const double p_dMin,
+                               const double p_dMax,
+                               const size_t p_sLength)
+    {
+        double  l_dScale;
+        double  l_dMin;
+
+        if (p_dMin >= 0 || p_dMax <= 0)
+        {
+            return 0;
+        }
+
+        l_dScale = ldexp(1.0, 8 * static_cast<int>(p_sLength) - 1 -
+                              _ImapbPow(p_dMin, p_dMax));
+        l_dMin = l_dScale * p_dMin;
+
+        return l_dMin - floor(l_dMin);
+    }
+
+    /**
+     * @return the power of 2 that covers the range of an IMAPB.
+     */
+    static int _ImapbPow(const double p_dMin, const double p_dMax)
+    {
+        return static_cast<int>(ceil(log(p_dMax - p_dMin) / log(2.0)));
+    }
+
+    /**
+     * @return the largest unsigned integer of the input length (bytes).
+     */
+    static double _MaxUnsigned(const size_t p_sLength)
+    {
+        return ldexp(1.0, 8 * static_cast<int>(p_sLength)) - 1.0;
+    }
+
+}; // end class Klv.
+
+/******************************************************************************/
+/**
+ * @class MetadataKlvDecoder
+ *
+ * @brief Decodes the KLV packets of the ST 0601 UAS Datalink Local Set into
+ * Metadata objects. A single packet is decoded with Decode(); a stream (e.g.
+ * the payload of the KLV elementary stream of a MPEG-TS) is pushed in chunks
+ * of any size with Push(), then the complete packets are taken with Next(),
+ * which skips the bytes that do not belong to a valid packet.
+ *
+ * The values are written directly into the fields of the Metadata; the
+ * fields of the tags not present in a packet keep their values, since the
+ * senders usually omit the tags that have not changed. The decoder does not
+ * allocate memory per packet: the strings are assigned in place, and the
+ * buffer of the stream only grows up to the size of the largest packet.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class MetadataKlvDecoder
+{
+public:
+
+    MetadataKlvDecoder()
+        : m_sBegin(0),
+          m_llNumDecoded(0),
+          m_llNumErrors(0),
+          m_bChecksumEnabled(true)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Clear discards the bytes pushed and not decoded yet.
+     */
+    void Clear()
+    {
+        m_vBuffer.clear();
+        m_sBegin = 0;
+    }
+
+    /**
+     * @brief Decode decodes the packet at the beginning of the input data.
+     *
+     * @param[in]   p_pucData       Data.
+     * @param[in]   p_sSize         Size of the data (bytes).
+     * @param[out]  p_rMetadata     Metadata updated with the values of the
+     *                              packet. Not modified on error.
+     * @param[out]  p_rsConsumed    Size of the packet (bytes), if it is
+     *                              complete.
+     *
+     * @return the result of the decoding.
+     */
+    KlvStatus Decode(const uint8_t* p_pucData,
+                     const size_t   p_sSize,
+                     Metadata&      p_rMetadata,
+                     size_t&        p_rsConsumed)
+    {
+        const uint8_t*  l_pucData;
+        const uint8_t*  l_pucEnd;
+        size_t          l_sLength;
+        KlvStatus       l_Status;
+
+        if (p_sSize < KLV_KEY_SIZE)
+        {
+            return KLV_INCOMPLETE;
+        }
+
+        if (!Klv::IsKey(p_pucData))
+        {
+            return KLV_INVALID_KEY;
+        }
+
+        l_pucData = p_pucData + KLV_KEY_SIZE;
+
+        l_Status = Klv::ReadBerLength(l_pucData,
+                                      p_pucData + p_sSize,
+                                      l_sLength);
+
+        if (l_Status != KLV_OK)
+        {
+            return l_Status;
+        }
+
+        if (static_cast<size_t>(p_pucData + p_sSize - l_pucData) < l_sLength)
+        {
+            return KLV_INCOMPLETE;
+        }
+
+        l_pucEnd = l_pucData + l_sLength;
+        p_rsConsumed = static_cast<size_t>(l_pucEnd - p_pucData);
+
+        /* The checksum is the last item: tag 1, length 2. */
+        if (m_bChecksumEnabled &&
+            (l_sLength < 4 ||
+             l_pucEnd[-4] != KLV_TAG_CHECKSUM ||
+             l_pucEnd[-3] != 2 ||
+             Klv::Checksum(p_pucData, p_rsConsumed - 2) !=
+                ((l_pucEnd[-2] << 8) | l_pucEnd[-1])))
+        {
+            m_llNumErrors++;
+
+            return KLV_INVALID_CHECKSUM;
+        }
+
+        /* Validated before any field is written. */
+        l_Status = _DecodeItems(l_pucData, l_pucEnd, NULL);
+
+        if (l_Status != KLV_OK)
+        {
+            m_llNumErrors++;
+
+            return l_Status;
+        }
+
+        _DecodeItems(l_pucData, l_pucEnd, &p_rMetadata);
+
+        m_llNumDecoded++;
+
+        return KLV_OK;
+    }
+
+    /** @return the number of packets decoded. */
+    inline long long GetNumDecoded() const
+    {
+        return m_llNumDecoded;
+    }
+
+    /** @return the number of packets rejected. */
+    inline long long GetNumErrors() const
+    {
+        return m_llNumErrors;
+    }
+
+    /**
+     * @brief Next decodes the next complete packet of the stream.
+     *
+     * @param[out]  p_rMetadata     Metadata updated with the values of the
+     *                              packet.
+     *
+     * @return false if no complete packet is available.
+     */
+    bool Next(Metadata& p_rMetadata)
+    {
+        const uint8_t*  l_pucData;
+        size_t          l_sSize;
+        size_t          l_sConsumed;
+        size_t          l_s;
+
+        for (;;)
+        {
+            l_pucData = m_vBuffer.empty() ? NULL : &m_vBuffer[0] + m_sBegin;
+            l_sSize = m_vBuffer.size() - m_sBegin;
+
+            /* Resynchronizes on the first bytes of the key. */
+            for (l_s = 0;
+                 l_s + 4 <= l_sSize &&
+                 memcmp(l_pucData + l_s, Klv::GetKey(), 4) != 0;
+                 l_s++)
+            {
+                /* Empty. */
+            }
+
+            if (l_s + 4 > l_sSize)
+            {
+                l_s = (l_sSize > 3 ? l_sSize - 3 : 0);
+            }
+
+            m_sBegin += l_s;
+            l_pucData += l_s;
+            l_sSize -= l_s;
+
+            switch (Decode(l_pucData, l_sSize, p_rMetadata, l_sConsumed))
+            {
+            case KLV_OK:
+                m_sBegin += l_sConsumed;
+                _Compact();
+                return true;
+
+            case KLV_INCOMPLETE:
+                _Compact();
+                return false;
+
+            default:
+                m_sBegin++;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Push appends a chunk of the stream to the bytes to be decoded.
+     */
+    void Push(const uint8_t* p_pucData, const size_t p_sSize)
+    {
+        m_vBuffer.insert(m_vBuffer.end(), p_pucData, p_pucData + p_sSize);
+    }
+
+    /**
+     * @brief SetChecksumEnabled enables or disables the validation of the
+     * checksum (enabled by default). Some encoders omit it.
+     */
+    inline void SetChecksumEnabled(const bool p_bEnabled)
+    {
+        m_bChecksumEnabled = p_bEnabled;
+    }
+
+protected:
+
+    /**
+     * @brief _Compact moves the bytes not decoded yet to the beginning of the
+     * buffer, once they are less than the decoded ones.
+     */
+    void _Compact()
+    {
+        if (m_sBegin > 0 && m_sBegin >= m_vBuffer.size() - m_sBegin)
+        {
+            m_vBuffer.erase(m_vBuffer.begin(), m_vBuffer.begin() + m_sBegin);
+            m_sBegin = 0;
+        }
+    }
+
+    /**
+     * @brief _DecodeItems walks the items of a local set and, if a Metadata
+     * is given, writes their values.
+     *
+     * @return KLV_INVALID_LENGTH if an item is malformed.
+     */
+    static KlvStatus _DecodeItems(const uint8_t*    p_pucData,
+                                  const uint8_t*    p_pucEnd,
+                                  Metadata*         p_pMetadata)
+    {
+        KlvFormat   l_Format;
+        uint32_t    l_uiTag;
+        size_t      l_sLength;
+        double      l_dValue;
+
+        while (p_pucData < p_pucEnd)
+        {
+            if (!Klv::ReadBerOid(p_pucData, p_pucEnd, l_uiTag) ||
+                Klv::ReadBerLength(p_pucData,
+                                   p_pucEnd,
+                                   l_sLength) != KLV_OK ||
+                static_cast<size_t>(p_pucEnd - p_pucData) < l_sLength)
+            {
+                return KLV_INVALID_LENGTH;
+            }
+
+            if (p_pMetadata && Klv::GetFormat(l_uiTag, l_Format))
+            {
+                if (l_Format.m_Type == KLV_FORMAT_STRING)
+                {
+                    _SetString(l_uiTag,
+                               reinterpret_cast<const char*>(p_pucData),
+                               l_sLength,
+                               *p_pMetadata);
+                }
+                else if (Klv::ReadValue(l_Format,
+                                        p_pucData,
+                                        l_sLength,
+                                        l_dValue))
+                {
+                    _SetValue(l_uiTag, p_pucData, l_dValue, *p_pMetadata);
+                }
+            }
+
+            p_pucData += l_sLength;
+        }
+
+        return KLV_OK;
+    }
+
+    /**
+     * @brief _SetString writes the value of a string tag.
+     */
+    static void _SetString(const uint32_t   p_uiTag,
+                           const char*      p_pszValue,
+                           const size_t     p_sLength,
+                           Metadata&        p_rMetadata)
+    {
+        std::string*    l_psField;
+
+        switch (p_uiTag)
+        {
+        case KLV_TAG_MISSION_ID:
+            l_psField = &p_rMetadata.m_sMissionID;
+            break;
+        case KLV_TAG_PLATFORM_TAIL_NUMBER:
+            l_psField = &p_rMetadata.m_sPlatformTailNumber;
+            break;
+        case KLV_TAG_PLATFORM_DESIGNATION:
+            l_psField = &p_rMetadata.m_sPlatformDesignation;
+            break;
+        case KLV_TAG_IMAGE_SOURCE_SENSOR:
+            l_psField = &p_rMetadata.m_sImageSourceSensor;
+            break;
+        case KLV_TAG_IMAGE_COORDINATE_SYSTEM:
+            l_psField = &p_rMetadata.m_sImageCoordinateSystem;
+            break;
+        case KLV_TAG_PLATFORM_CALL_SIGN:
+            l_psField = &p_rMetadata.m_sPlatformCallSign;
+            break;
+        default:
+            return;
+        }
+
+        /* Reuses the capacity of the string. */
+        l_psField->assign(p_pszValue, p_sLength);
+    }
+
+    /**
+     * @brief _SetValue writes the value of a numeric tag.
+     */
+    static void _SetValue(const uint32_t    p_uiTag,
+                          const uint8_t*    p_pucData,
+                          const double      p_dValue,
+                          Metadata&         p_rMetadata)
+    {
+        uint64_t    l_ullTimestamp;
+        int         l_i;
+
+        switch (p_uiTag)
+        {
+        case KLV_TAG_TIMESTAMP:
+            /* Read again: a double does not hold 64 bits. */
+            l_ullTimestamp = 0;
+
+            for (l_i = 0; l_i < 8; l_i++)
+            {
+                l_ullTimestamp = (l_ullTimestamp << 8) | p_pucData[l_i];
+            }
+
+            p_rMetadata.m_llTimestamp = static_cast<long long>(l_ullTimestamp);
+            break;
+        case KLV_TAG_PLATFORM_HEADING:
+            p_rMetadata.m_fPlatformHeading_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_PLATFORM_PITCH:
+            p_rMetadata.m_fPlatformPitch_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_PLATFORM_ROLL:
+            p_rMetadata.m_fPlatformRoll_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_PLATFORM_TRUE_AIRSPEED:
+            p_rMetadata.m_fPlatformTrueAirSpeed_m_s =
+                    static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_SENSOR_LAT:
+            p_rMetadata.m_dSensorLat_deg = p_dValue;
+            break;
+        case KLV_TAG_SENSOR_LON:
+            p_rMetadata.m_dSensorLon_deg = p_dValue;
+            break;
+        case KLV_TAG_SENSOR_ALT:
+            p_rMetadata.m_dSensorAlt_m = p_dValue;
+            break;
+        case KLV_TAG_SENSOR_HFOV:
+            p_rMetadata.m_fSensorHFOV_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_SENSOR_VFOV:
+            p_rMetadata.m_fSensorVFOV_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_SENSOR_AZIMUTH:
+            p_rMetadata.m_fSensorAzimuth_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_SENSOR_ELEVATION:
+            p_rMetadata.m_fSensorElevation_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_SENSOR_ROLL:
+            p_rMetadata.m_fSensorRoll_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_SLANT_RANGE:
+            p_rMetadata.m_fSlantRange_m = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_TARGET_WIDTH:
+        case KLV_TAG_TARGET_WIDTH_EXTENDED:
+            p_rMetadata.m_fTargetWidth_m = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_FRAME_CENTER_LAT:
+            p_rMetadata.m_dFrameCenterLat_deg = p_dValue;
+            break;
+        case KLV_TAG_FRAME_CENTER_LON:
+            p_rMetadata.m_dFrameCenterLon_deg = p_dValue;
+            break;
+        case KLV_TAG_FRAME_CENTER_ALT:
+            p_rMetadata.m_dFrameCenterAlt_m = p_dValue;
+            break;
+        case KLV_TAG_WIND_DIRECTION:
+            p_rMetadata.m_fWindDirection_deg = static_cast<float>(p_dValue);
+            break;
+        case KLV_TAG_WIND_SPEED:
+            p_rMetadata.m_fWindSpeed_m_s = static_cast<float>(p_dValue);
+            break;
+        default:
+            break;
+        }
+    }
+
+protected:
+
+    std::vector<uint8_t>    m_vBuffer; /**< Bytes of the stream. */
+
+    size_t  m_sBegin; /**< First byte of m_vBuffer not decoded yet. */
+
+    long long  m_llNumDecoded; /**< Number of packets decoded. */
+
+    long long  m_llNumErrors; /**< Number of packets rejected. */
+
+    bool    m_bChecksumEnabled; /**< True if the checksum is validated. */
+
+}; // end class MetadataKlvDecoder.
+
+/******************************************************************************/
+/**
+ * @class MetadataKlvEncoder
+ *
+ * @brief Encodes Metadata objects as KLV packets of the ST 0601 UAS Datalink
+ * Local Set, with checksum, into a buffer provided by the caller. A buffer
+ * of KLV_MAX_ENCODED_SIZE bytes always holds a packet.
+ *
+ * With SetDeltaEnabled(true) a packet only contains the time stamp, the
+ * version of the Local Set (tag 65, mandatory in every packet) and the
+ * tags whose encoded value has changed since the previous packet (so that
+ * changes below the resolution of a tag are not sent), and a complete packet
+ * is written every SetKeyInterval() packets for the receivers that join the
+ * stream later. EncodeBatch() writes many records in a single call.
+ *
+ * The NaN values and the empty strings are not written. No memory is
+ * allocated per packet.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class MetadataKlvEncoder
+{
+public:
+
+    MetadataKlvEncoder()
+        : m_iKeyInterval(KLV_DEFAULT_KEY_INTERVAL),
+          m_iSinceKey(0),
+          m_bDeltaEnabled(false),
+          m_bHasLast(false)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Encode writes a Metadata as a packet of the local set.
+     *
+     * @param[in]   p_rMetadata     Metadata.
+     * @param[out]  p_pucBuffer     Destination.
+     * @param[in]   p_sCapacity     Size of the destination (bytes).
+     *
+     * @return the size of the packet (bytes), or 0 if it does not fit the
+     * destination. In this case the state of the delta encoding is not
+     * changed.
+     */
+    size_t Encode(const Metadata&   p_rMetadata,
+                  uint8_t*          p_pucBuffer,
+                  const size_t      p_sCapacity)
+    {
+        static const uint32_t   s_auiTags[] =
+        {
+            KLV_TAG_MISSION_ID,
+            KLV_TAG_PLATFORM_TAIL_NUMBER,
+            KLV_TAG_PLATFORM_HEADING,
+            KLV_TAG_PLATFORM_PITCH,
+            KLV_TAG_PLATFORM_ROLL,
+            KLV_TAG_PLATFORM_TRUE_AIRSPEED,
+            KLV_TAG_PLATFORM_DESIGNATION,
+            KLV_TAG_IMAGE_SOURCE_SENSOR,
+            KLV_TAG_IMAGE_COORDINATE_SYSTEM,
+            KLV_TAG_SENSOR_LAT,
+            KLV_TAG_SENSOR_LON,
+            KLV_TAG_SENSOR_ALT,
+            KLV_TAG_SENSOR_HFOV,
+            KLV_TAG_SENSOR_VFOV,
+            KLV_TAG_SENSOR_AZIMUTH,
+            KLV_TAG_SENSOR_ELEVATION,
+            KLV_TAG_SENSOR_ROLL,
+            KLV_TAG_SLANT_RANGE,
+            KLV_TAG_TARGET_WIDTH,
+            KLV_TAG_FRAME_CENTER_LAT,
+            KLV_TAG_FRAME_CENTER_LON,
+            KLV_TAG_FRAME_CENTER_ALT,
+            KLV_TAG_WIND_DIRECTION,
+            KLV_TAG_WIND_SPEED,
+            KLV_TAG_PLATFORM_CALL_SIGN,
+            KLV_TAG_TARGET_WIDTH_EXTENDED
+        };
+        const uint8_t*  l_pucEnd;
+        uint8_t*        l_pucItems;
+        uint8_t*        l_pucData;
+        uint64_t        l_ullTimestamp;
+        uint16_t        l_usChecksum;
+        size_t          l_sItems;
+        size_t          l_sLengthSize;
+        size_t          l_s;
+        bool            l_bComplete;
+
+        l_bComplete = (!m_bDeltaEnabled || !m_bHasLast ||
+                       (m_iKeyInterval > 0 && m_iSinceKey >= m_iKeyInterval));
+
+        /* The items are written after the longest length of a packet (3
+         * bytes), then moved next to the actual length. */
+        l_pucEnd = p_pucBuffer + p_sCapacity;
+        l_pucItems = p_pucBuffer + KLV_KEY_SIZE + 3;
+        l_pucData = l_pucItems;
+
+        if (p_sCapacity < KLV_KEY_SIZE + 3 + 10)
+        {
+            return 0;
+        }
+
+        /* The time stamp is always the first item. */
+        l_ullTimestamp = static_cast<uint64_t>(p_rMetadata.m_llTimestamp);
+
+        *l_pucData++ = KLV_TAG_TIMESTAMP;
+        *l_pucData++ = 8;
+
+        for (l_s = 8; l_s > 0; l_s--)
+        {
+            l_pucData[l_s - 1] = static_cast<uint8_t>(l_ullTimestamp & 0xFF);
+            l_ullTimestamp >>= 8;
+        }
+
+        l_pucData += 8;
+
+        for (l_s = 0; l_s < sizeof(s_auiTags) / sizeof(s_auiTags[0]); l_s++)
+        {
+            if (!_WriteItem(s_auiTags[l_s],
+                            p_rMetadata,
+                            l_bComplete,
+                            l_pucData,
+                            l_pucEnd))
+            {
+                return 0;
+            }
+        }
+
+        /* Version, in every packet (ST 0601 mandatory item), and
+         * checksum. */
+        if (l_pucEnd - l_pucData < 3 + 4)
+        {
+            return 0;
+        }
+
+        *l_pucData++ = KLV_TAG_VERSION;
+        *l_pucData++ = 1;
+        *l_pucData++ = KLV_LS_VERSION;
+
+        l_sItems = static_cast<size_t>(l_pucData - l_pucItems) + 4;
+        l_sLengthSize = Klv::WriteBerLength(l_sItems,
+                                            p_pucBuffer + KLV_KEY_SIZE);
+
+        if (l_sLengthSize < 3)
+        {
+            memmove(p_pucBuffer + KLV_KEY_SIZE + l_sLengthSize,
+                    l_pucItems,
+                    l_sItems - 4);
+        }
+
+        memcpy(p_pucBuffer, Klv::GetKey(), KLV_KEY_SIZE);
+
+        l_pucData = p_pucBuffer + KLV_KEY_SIZE + l_sLengthSize + l_sItems - 4;
+
+        *l_pucData++ = KLV_TAG_CHECKSUM;
+        *l_pucData++ = 2;
+
+        l_usChecksum = Klv::Checksum(p_pucBuffer,
+                                     static_cast<size_t>(l_pucData -
+                                                         p_pucBuffer));
+
+        *l_pucData++ = static_cast<uint8_t>(l_usChecksum >> 8);
+        *l_pucData++ = static_cast<uint8_t>(l_usChecksum & 0xFF);
+
+        /* Reuses the capacity of the strings of m_Last. */
+        m_Last = p_rMetadata;
+        m_bHasLast = true;
+        m_iSinceKey = (l_bComplete ? 1 : m_iSinceKey + 1);
+
+        return static_cast<size_t>(l_pucData - p_pucBuffer);
+    }
+
+    /**
+     * @brief EncodeBatch writes consecutive Metadata as consecutive packets,
+     * delta encoded one against the other if enabled.
+     *
+     * @param[in]   p_pMetadata     Array of Metadata.
+     * @param[in]   p_sNumMetadata  Number of Metadata.
+     * @param[out]  p_pucBuffer     Destination.
+     * @param[in]   p_sCapacity     Size of the destination (bytes).
+     * @param[out]  p_psNumEncoded  If not NULL, number of Metadata written.
+     *                              The encoding stops at the first packet that
+     *                              does not fit the destination.
+     *
+     * @return the number of bytes written.
+     */
+    size_t EncodeBatch(const Metadata*  p_pMetadata,
+                       const size_t     p_sNumMetadata,
+                       uint8_t*         p_pucBuffer,
+                       const size_t     p_sCapacity,
+                       size_t*          p_psNumEncoded = NULL)
+    {
+        size_t  l_sSize;
+        size_t  l_sPacket;
+        size_t  l_s;
+
+        l_sSize = 0;
+
+        for (l_s = 0; l_s < p_sNumMetadata; l_s++)
+        {
+            l_sPacket = Encode(p_pMetadata[l_s],
+                               p_pucBuffer + l_sSize,
+                               p_sCapacity - l_sSize);
+
+            if (l_sPacket == 0)
+            {
+                break;
+            }
+
+            l_sSize += l_sPacket;
+        }
+
+        if (p_psNumEncoded)
+        {
+            *p_psNumEncoded = l_s;
+        }
+
+        return l_sSize;
+    }
+
+    /**
+     * @brief Reset makes the next packet complete, e.g. when a receiver
+     * joins the stream.
+     */
+    void Reset()
+    {
+        m_bHasLast = false;
+        m_iSinceKey = 0;
+    }
+
+    /**
+     * @brief SetDeltaEnabled enables or disables the delta encoding (disabled
+     * by default): only the changed tags are written.
+     */
+    inline void SetDeltaEnabled(const bool p_bEnabled)
+    {
+        m_bDeltaEnabled = p_bEnabled;
+    }
+
+    /**
+     * @brief SetKeyInterval sets the number of packets between two complete
+     * packets, when the delta encoding is enabled. If not positive, only the
+     * first packet is complete.
+     */
+    inline void SetKeyInterval(const int p_iKeyInterval)
+    {
+        m_iKeyInterval = p_iKeyInterval;
+    }
+
+protected:
+
+    /**
+     * @return the string of a tag.
+     */
+    static const std::string& _GetString(const uint32_t   p_uiTag,
+                                         const Metadata&  p_rMetadata)
+    {
+        switch (p_uiTag)
+        {
+        case KLV_TAG_MISSION_ID:
+            return p_rMetadata.m_sMissionID;
+        case KLV_TAG_PLATFORM_TAIL_NUMBER:
+            return p_rMetadata.m_sPlatformTailNumber;
+        case KLV_TAG_PLATFORM_DESIGNATION:
+            return p_rMetadata.m_sPlatformDesignation;
+        case KLV_TAG_IMAGE_SOURCE_SENSOR:
+            return p_rMetadata.m_sImageSourceSensor;
+        case KLV_TAG_IMAGE_COORDINATE_SYSTEM:
+            return p_rMetadata.m_sImageCoordinateSystem;
+        default:
+            return p_rMetadata.m_sPlatformCallSign;
+        }
+    }
+
+    /**
+     * @return the value of a numeric tag, or NaN if it must not be written.
+     */
+    static double _GetValue(const uint32_t  p_uiTag,
+                            const Metadata& p_rMetadata)
+    {
+        switch (p_uiTag)
+        {
+        case KLV_TAG_PLATFORM_HEADING:
+            return p_rMetadata.m_fPlatformHeading_deg;
+        case KLV_TAG_PLATFORM_PITCH:
+            return p_rMetadata.m_fPlatformPitch_deg;
+        case KLV_TAG_PLATFORM_ROLL:
+            return p_rMetadata.m_fPlatformRoll_deg;
+        case KLV_TAG_PLATFORM_TRUE_AIRSPEED:
+            return p_rMetadata.m_fPlatformTrueAirSpeed_m_s;
+        case KLV_TAG_SENSOR_LAT:
+            return p_rMetadata.m_dSensorLat_deg;
+        case KLV_TAG_SENSOR_LON:
+            return p_rMetadata.m_dSensorLon_deg;
+        case KLV_TAG_SENSOR_ALT:
+            return p_rMetadata.m_dSensorAlt_m;
+        case KLV_TAG_SENSOR_HFOV:
+            return p_rMetadata.m_fSensorHFOV_deg;
+        case KLV_TAG_SENSOR_VFOV:
+            return p_rMetadata.m_fSensorVFOV_deg;
+        case KLV_TAG_SENSOR_AZIMUTH:
+            return p_rMetadata.m_fSensorAzimuth_deg;
+        case KLV_TAG_SENSOR_ELEVATION:
+            return p_rMetadata.m_fSensorElevation_deg;
+        case KLV_TAG_SENSOR_ROLL:
+            return p_rMetadata.m_fSensorRoll_deg;
+        case KLV_TAG_SLANT_RANGE:
+            return p_rMetadata.m_fSlantRange_m;
+        case KLV_TAG_FRAME_CENTER_LAT:
+            return p_rMetadata.m_dFrameCenterLat_deg;
+        case KLV_TAG_FRAME_CENTER_LON:
+            return p_rMetadata.m_dFrameCenterLon_deg;
+        case KLV_TAG_FRAME_CENTER_ALT:
+            return p_rMetadata.m_dFrameCenterAlt_m;
+        case KLV_TAG_WIND_DIRECTION:
+            return p_rMetadata.m_fWindDirection_deg;
+        case KLV_TAG_WIND_SPEED:
+            return p_rMetadata.m_fWindSpeed_m_s;
+        default:
+            break;
+        }
+
+        /* The target width uses the extended tag beyond the range of the
+         * short one. */
+        if (p_uiTag == KLV_TAG_TARGET_WIDTH &&
+            p_rMetadata.m_fTargetWidth_m <= 10000)
+        {
+            return p_rMetadata.m_fTargetWidth_m;
+        }
+
+        if (p_uiTag == KLV_TAG_TARGET_WIDTH_EXTENDED &&
+            p_rMetadata.m_fTargetWidth_m > 10000)
+        {
+            return p_rMetadata.m_fTargetWidth_m;
+        }
+
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /**
+     * @brief _WriteItem writes the item of a tag, unless its value is not
+     * set or, in a delta packet, has not changed.
+     *
+     * @return false if the item does not fit the destination.
+     */
+    bool _WriteItem(const uint32_t  p_uiTag,
+                    const Metadata& p_rMetadata,
+                    const bool      p_bComplete,
+                    uint8_t*&       p_rpucData,
+                    const uint8_t*  p_pucEnd) const
+    {
+        uint8_t     l_aucLast[8];
+        KlvFormat   l_Format;
+        size_t      l_sLength;
+
+        Klv::GetFormat(p_uiTag, l_Format);
+
+        /* All the tags written are below 128: their BER-OID is one byte. */
+        if (l_Format.m_Type == KLV_FORMAT_STRING)
+        {
+            const std::string&  l_rsValue = _GetString(p_uiTag, p_rMetadata);
+
+            if (l_rsValue.empty() ||
+                (!p_bComplete && l_rsValue == _GetString(p_uiTag, m_Last)))
+            {
+                return true;
+            }
+
+            l_sLength = std::min(l_rsValue.size(), static_cast<size_t>(127));
+
+            if (static_cast<size_t>(p_pucEnd - p_rpucData) < l_sLength + 2)
+            {
+                return false;
+            }
+
+            *p_rpucData++ = static_cast<uint8_t>(p_uiTag);
+            *p_rpucData++ = static_cast<uint8_t>(l_sLength);
+
+            memcpy(p_rpucData, l_rsValue.data(), l_sLength);
+            p_rpucData += l_sLength;
+
+            return true;
+        }
+
+        if (p_pucEnd - p_rpucData < l_Format.m_iLength + 2)
+        {
+            return false;
+        }
+
+        l_sLength = Klv::WriteValue(l_Format,
+                                    _GetValue(p_uiTag, p_rMetadata),
+                                    p_rpucData + 2);
+
+        if (l_sLength == 0 ||
+            (!p_bComplete &&
+             Klv::WriteValue(l_Format,
+                             _GetValue(p_uiTag, m_Last),
+                             l_aucLast) == l_sLength &&
+             memcmp(l_aucLast, p_rpucData + 2, l_sLength) == 0))
+        {
+            return true;
+        }
+
+        p_rpucData[0] = static_cast<uint8_t>(p_uiTag);
+        p_rpucData[1] = static_cast<uint8_t>(l_sLength);
+        p_rpucData += l_sLength + 2;
+
+        return true;
+    }
+
+protected:
+
+    Metadata    m_Last; /**< Last Metadata written. */
+
+    int     m_iKeyInterval; /**< Packets between two complete packets. */
+
+    int     m_iSinceKey; /**< Packets since the last complete packet. */
+
+    bool    m_bDeltaEnabled; /**< True if only the changed tags are
+                              * written. */
+
+    bool    m_bHasLast; /**< True if m_Last holds the previous packet. */
+
+}; // end class MetadataKlvEncoder.
+
+} // end namespace fby.
+
+#endif // METADATA_KLV_H
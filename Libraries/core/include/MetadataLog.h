@@ -0,0 +1,1708 @@
+#ifndef METADATA_LOG_H
+#define METADATA_LOG_H
+
+/** @file MetadataLog.h
+ *
+ * @brief Contains the classes to write a stream of Metadata to an append-only
+ * columnar log, and to read it back through a memory mapping of the file.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Metadata.h>
+
+#ifndef WIN32
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/** Number of records in a block of the log. */
+#define METADATA_LOG_BLOCK_SIZE     4096
+
+/** Version of the log format. */
+#define METADATA_LOG_VERSION        2
+
+/** Size of the header of the log file (bytes). */
+#define METADATA_LOG_HEADER_SIZE    16
+
+/** Size of an entry of the time stamp index (bytes). */
+#define METADATA_LOG_INDEX_SIZE     32
+
+/** Size of the trailer of the log file, after the index (bytes). */
+#define METADATA_LOG_TRAILER_SIZE   24
+
+/** Quantization of the latitudes and longitudes (units per degree). */
+#define METADATA_LOG_DEG_SCALE      1e9
+
+/** Quantization of the altitudes (units per meter). */
+#define METADATA_LOG_M_SCALE        1e3
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @enum MetadataLogColumn
+ *
+ * @brief Columns of the log. The time stamp and the positions are stored as
+ * zigzag varint deltas, the strings as varint indices in the dictionary and
+ * the other fields as arrays of float.
+ */
+enum MetadataLogColumn
+{
+    METADATA_LOG_TIMESTAMP = 0,
+    METADATA_LOG_SENSOR_LAT,
+    METADATA_LOG_SENSOR_LON,
+    METADATA_LOG_SENSOR_ALT,
+    METADATA_LOG_FRAME_CENTER_LAT,
+    METADATA_LOG_FRAME_CENTER_LON,
+    METADATA_LOG_FRAME_CENTER_ALT,
+    METADATA_LOG_MISSION_ID,
+    METADATA_LOG_PLATFORM_TAIL_NUMBER,
+    METADATA_LOG_PLATFORM_DESIGNATION,
+    METADATA_LOG_IMAGE_SOURCE_SENSOR,
+    METADATA_LOG_IMAGE_COORDINATE_SYSTEM,
+    METADATA_LOG_PLATFORM_CALL_SIGN,
+    METADATA_LOG_PLATFORM_HEADING,
+    METADATA_LOG_PLATFORM_PITCH,
+    METADATA_LOG_PLATFORM_ROLL,
+    METADATA_LOG_PLATFORM_TRUE_AIRSPEED,
+    METADATA_LOG_SENSOR_HFOV,
+    METADATA_LOG_SENSOR_VFOV,
+    METADATA_LOG_SENSOR_AZIMUTH,
+    METADATA_LOG_SENSOR_ELEVATION,
+    METADATA_LOG_SENSOR_ROLL,
+    METADATA_LOG_SLANT_RANGE,
+    METADATA_LOG_TARGET_WIDTH,
+    METADATA_LOG_WIND_DIRECTION,
+    METADATA_LOG_WIND_SPEED,
+    METADATA_LOG_NUM_COLUMNS
+
+}; // end enum MetadataLogColumn.
+
+/******************************************************************************/
+/**
+ * @class MetadataLogFormat
+ *
+ * @brief Layout of the log shared by the writer and the reader.
+ *
+ * A log is a header ("FBYMDLOG", version, number of columns) followed by
+ * blocks of up to METADATA_LOG_BLOCK_SIZE records. A block starts with its
+ * record count, its first and last time stamp, the strings added to the
+ * dictionary by the block and the size of each column, and is followed by
+ * the columns, each aligned to 8 bytes. The deltas restart at every block, so
+ * that a block is decoded on its own. Close() appends the time stamp index
+ * of the blocks and a trailer. A log whose writer has not been closed is
+ * still read, by walking the block headers.
+ *
+ * The positions are quantized to 1e-9 deg and 1 mm, below the resolution of
+ * the 4-byte positions of ST 0601 (about 4.2e-8 deg for the latitudes and
+ * 8.4e-8 deg for the longitudes), so that the positions decoded from KLV are
+ * logged without loss. The other fields keep the values of Metadata. The
+ * integers are little endian, the float columns are in the byte order of the
+ * host.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class MetadataLogFormat
+{
+public:
+
+    /**
+     * @brief IsVarint returns true if a column is stored as varints.
+     */
+    static inline bool IsVarint(const MetadataLogColumn p_eColumn)
+    {
+        return p_eColumn < METADATA_LOG_PLATFORM_HEADING;
+    }
+
+    /**
+     * @brief IsPosition returns true if a column holds a quantized position.
+     */
+    static inline bool IsPosition(const MetadataLogColumn p_eColumn)
+    {
+        return p_eColumn >= METADATA_LOG_SENSOR_LAT &&
+               p_eColumn <= METADATA_LOG_FRAME_CENTER_ALT;
+    }
+
+    /**
+     * @brief IsString returns true if a column holds dictionary indices.
+     */
+    static inline bool IsString(const MetadataLogColumn p_eColumn)
+    {
+        return p_eColumn >= METADATA_LOG_MISSION_ID &&
+               p_eColumn <= METADATA_LOG_PLATFORM_CALL_SIGN;
+    }
+
+protected:
+
+    /** Bytes of an encoded column. */
+    typedef std::vector<uint8_t>    Column;
+
+    /** Values of a decoded varint column. */
+    typedef std::vector<long long>  Values;
+
+    /** Header of a block: magic, count, time stamps, dictionary size and
+     * column sizes (bytes). */
+    static const size_t s_sBlockHeaderSize =
+        32 + 4 * METADATA_LOG_NUM_COLUMNS;
+
+    /** Magic number of a block ("MLBK"). */
+    static const uint32_t s_uiBlockMagic = 0x4B424C4D;
+
+    /** Quantized value of a NaN position. */
+    static const long long s_llNoPosition = -0x7FFFFFFFFFFFFFFFLL - 1;
+
+    /**
+     * @brief _Align rounds a size up to a multiple of 8 bytes.
+     */
+    static inline size_t _Align(const size_t p_sSize)
+    {
+        return (p_sSize + 7) & ~static_cast<size_t>(7);
+    }
+
+    /**
+     * @brief _Position returns the field of a position column.
+     */
+    static inline double Metadata::* _Position(const MetadataLogColumn p_eCol)
+    {
+        static double Metadata::* const s_apPositions[] =
+        {
+            &Metadata::m_dSensorLat_deg,
+            &Metadata::m_dSensorLon_deg,
+            &Metadata::m_dSensorAlt_m,
+            &Metadata::m_dFrameCenterLat_deg,
+            &Metadata::m_dFrameCenterLon_deg,
+            &Metadata::m_dFrameCenterAlt_m
+        };
+
+        return s_apPositions[p_eCol - METADATA_LOG_SENSOR_LAT];
+    }
+
+    /**
+     * @brief _Scale returns the quantization of a position column.
+     */
+    static inline double _Scale(const MetadataLogColumn p_eColumn)
+    {
+        return (p_eColumn == METADATA_LOG_SENSOR_ALT ||
+                p_eColumn == METADATA_LOG_FRAME_CENTER_ALT) ?
+                    METADATA_LOG_M_SCALE : METADATA_LOG_DEG_SCALE;
+    }
+
+    /**
+     * @brief _String returns the field of a string column.
+     */
+    static inline std::string Metadata::* _String(
+        const MetadataLogColumn p_eColumn)
+    {
+        static std::string Metadata::* const s_apStrings[] =
+        {
+            &Metadata::m_sMissionID,
+            &Metadata::m_sPlatformTailNumber,
+            &Metadata::m_sPlatformDesignation,
+            &Metadata::m_sImageSourceSensor,
+            &Metadata::m_sImageCoordinateSystem,
+            &Metadata::m_sPlatformCallSign
+        };
+
+        return s_apStrings[p_eColumn - METADATA_LOG_MISSION_ID];
+    }
+
+    /**
+     * @brief _Float returns the field of a float column.
+     */
+    static inline float Metadata::* _Float(const MetadataLogColumn p_eColumn)
+    {
+        static float Metadata::* const s_apFloats[] =
+        {
+            &Metadata::m_fPlatformHeading_deg,
+            &Metadata::m_fPlatformPitch_deg,
+            &Metadata::m_fPlatformRoll_deg,
+            &Metadata::m_fPlatformTrueAirSpeed_m_s,
+            &Metadata::m_fSensorHFOV_deg,
+            &Metadata::m_fSensorVFOV_deg,
+            &Metadata::m_fSensorAzimuth_deg,
+            &Metadata::m_fSensorElevation_deg,
+            &Metadata::m_fSensorRoll_deg,
+            &Metadata::m_fSlantRange_m,
+            &Metadata::m_fTargetWidth_m,
+            &Metadata::m_fWindDirection_deg,
+            &Metadata::m_fWindSpeed_m_s
+        };
+
+        return s_apFloats[p_eColumn - METADATA_LOG_PLATFORM_HEADING];
+    }
+
+    /**
+     * @brief _Quantize converts a position to fixed point.
+     */
+    static inline long long _Quantize(const double p_dValue,
+                                      const double p_dScale)
+    {
+        if (!(fabs(p_dValue) < 1e9))
+        {
+            return s_llNoPosition;
+        }
+
+        return static_cast<long long>(floor(p_dValue * p_dScale + 0.5));
+    }
+
+    /**
+     * @brief _Dequantize converts a fixed point position back.
+     */
+    static inline double _Dequantize(const long long p_llValue,
+                                     const double p_dScale)
+    {
+        if (p_llValue == s_llNoPosition)
+        {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        return static_cast<double>(p_llValue) / p_dScale;
+    }
+
+    /**
+     * @brief _ZigZag maps a signed delta onto an unsigned integer, so that
+     * the small deltas of both signs take few varint bytes.
+     */
+    static inline uint64_t _ZigZag(const long long p_llValue)
+    {
+        return (static_cast<uint64_t>(p_llValue) << 1) ^
+               static_cast<uint64_t>(p_llValue >> 63);
+    }
+
+    /**
+     * @brief _UnZigZag is the inverse of _ZigZag.
+     */
+    static inline long long _UnZigZag(const uint64_t p_ullValue)
+    {
+        return static_cast<long long>((p_ullValue >> 1) ^
+                                      (~(p_ullValue & 1) + 1));
+    }
+
+    /**
+     * @brief _PutVarint appends an unsigned LEB128 varint.
+     */
+    static inline void _PutVarint(Column&   p_rvBuffer,
+                                  uint64_t  p_ullValue)
+    {
+        while (p_ullValue >= 0x80)
+        {
+            p_rvBuffer.push_back(static_cast<uint8_t>(p_ullValue | 0x80));
+            p_ullValue >>= 7;
+        }
+
+        p_rvBuffer.push_back(static_cast<uint8_t>(p_ullValue));
+    }
+
+    /**
+     * @brief _GetVarint reads an unsigned LEB128 varint.
+     *
+     * @return false if the varint is truncated or longer than 64 bits.
+     */
+    static inline bool _GetVarint(const uint8_t*&   p_rpucData,
+                                  const uint8_t*    p_pucEnd,
+                                  uint64_t&         p_rullValue)
+    {
+        uint8_t     l_ucByte;
+        int         l_iShift;
+
+        p_rullValue = 0;
+
+        for (l_iShift = 0; l_iShift < 64; l_iShift += 7)
+        {
+            if (p_rpucData >= p_pucEnd)
+            {
+                return false;
+            }
+
+            l_ucByte = *p_rpucData++;
+
+            p_rullValue |= static_cast<uint64_t>(l_ucByte & 0x7F) << l_iShift;
+
+            if (!(l_ucByte & 0x80))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief _Put writes a little endian integer of p_sSize bytes.
+     */
+    static inline void _Put(uint8_t*        p_pucData,
+                            uint64_t        p_ullValue,
+                            const size_t    p_sSize)
+    {
+        size_t  l_s;
+
+        for (l_s = 0; l_s < p_sSize; l_s++)
+        {
+            p_pucData[l_s] = static_cast<uint8_t>(p_ullValue);
+            p_ullValue >>= 8;
+        }
+    }
+
+    /**
+     * @brief _Get reads a little endian integer of p_sSize bytes.
+     */
+    static inline uint64_t _Get(const uint8_t*  p_pucData,
+                                const size_t    p_sSize)
+    {
+        uint64_t    l_ullValue;
+        size_t      l_s;
+
+        l_ullValue = 0;
+
+        for (l_s = p_sSize; l_s > 0; l_s--)
+        {
+            l_ullValue = (l_ullValue << 8) | p_pucData[l_s - 1];
+        }
+
+        return l_ullValue;
+    }
+
+    /**
+     * @brief _Magic returns the magic string of the header or the trailer.
+     */
+    static inline const char* _Magic(const bool p_bTrailer)
+    {
+        return p_bTrailer ? "FBYMDIDX" : "FBYMDLOG";
+    }
+
+}; // end class MetadataLogFormat.
+
+/******************************************************************************/
+/**
+ * @class MappedFile
+ *
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class MappedFile
+{
+public:
+
+    MappedFile()
+        : m_pucData(NULL),
+          m_sSize(0)
+#ifdef WIN32
+          , m_hFile(INVALID_HANDLE_VALUE),
+          m_hMapping(NULL)
+#endif
+    {
+        /* Empty. */
+    }
+
+    ~MappedFile()
+    {
+        Close();
+    }
+
+    /**
+     * @brief Open maps a file.
+     *
+     * @return false if the file does not exist, is empty or can not be
+     * mapped.
+     */
+    bool Open(const std::string& p_sFileName)
+    {
+#ifdef WIN32
+        LARGE_INTEGER   l_Size;
+#else
+        struct stat     l_Stat;
+        FILE*           l_pFile;
+        void*           l_pData;
+#endif
+
+        Close();
+
+#ifdef WIN32
+        m_hFile = CreateFileA(p_sFileName.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        if (m_hFile == INVALID_HANDLE_VALUE ||
+            !GetFileSizeEx(m_hFile, &l_Size) || l_Size.QuadPart == 0)
+        {
+            Close();
+
+            return false;
+        }
+
+        m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0,
+                                        NULL);
+
+        if (m_hMapping != NULL)
+        {
+            m_pucData = static_cast<const uint8_t*>(
+                MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        m_sSize = static_cast<size_t>(l_Size.QuadPart);
+#else
+        l_pFile = fopen(p_sFileName.c_str(), "rb");
+
+        if (l_pFile == NULL)
+        {
+            return false;
+        }
+
+        if (fstat(fileno(l_pFile), &l_Stat) == 0 && l_Stat.st_size > 0)
+        {
+            l_pData = mmap(NULL, static_cast<size_t>(l_Stat.st_size),
+                           PROT_READ, MAP_SHARED, fileno(l_pFile), 0);
+
+            if (l_pData != MAP_FAILED)
+            {
+                m_pucData = static_cast<const uint8_t*>(l_pData);
+                m_sSize = static_cast<size_t>(l_Stat.st_size);
+            }
+        }
+
+        /* The mapping keeps its own reference to the file. */
+        fclose(l_pFile);
+#endif
+
+        if (m_pucData == NULL)
+        {
+            Close();
+
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Close unmaps the file.
+     */
+    void Close()
+    {
+#ifdef WIN32
+        if (m_pucData != NULL)
+        {
+            UnmapViewOfFile(m_pucData);
+        }
+
+        if (m_hMapping != NULL)
+        {
+            CloseHandle(m_hMapping);
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+        }
+
+        m_hFile = INVALID_HANDLE_VALUE;
+        m_hMapping = NULL;
+#else
+        if (m_pucData != NULL)
+        {
+            munmap(const_cast<uint8_t*>(m_pucData), m_sSize);
+        }
+#endif
+
+        m_pucData = NULL;
+        m_sSize = 0;
+    }
+
+    /**
+     * @brief GetData returns the first byte of the file, or NULL.
+     */
+    inline const uint8_t* GetData() const
+    {
+        return m_pucData;
+    }
+
+    /**
+     * @brief GetSize returns the size of the file (bytes).
+     */
+    inline size_t GetSize() const
+    {
+        return m_sSize;
+    }
+
+private:
+
+    MappedFile(const MappedFile&);
+
+    MappedFile& operator=(const MappedFile&);
+
+protected:
+
+    const uint8_t*  m_pucData; /**< Mapped file. */
+
+    size_t  m_sSize; /**< Size of the file (bytes). */
+
+#ifdef WIN32
+    HANDLE  m_hFile; /**< File. */
+
+    HANDLE  m_hMapping; /**< File mapping. */
+#endif
+
+}; // end class MappedFile.
+
+/******************************************************************************/
+/**
+ * @class MetadataLogReader
+ *
+ * @brief Reads a log written by MetadataLogWriter through a memory mapping.
+ *
+ * Seek() finds a time stamp with a binary search on the block index and one
+ * in the block. Read() returns any record; the varint columns of the last
+ * block visited are kept decoded, so that sequential reads decode each block
+ * once. ReadColumn() scans a single column into an array, and
+ * GetFloatColumn() returns the float columns of a block straight from the
+ * mapping.
+ *
+ * A log that is still being written is read up to its last complete block;
+ * Open() it again to see the blocks written since.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class MetadataLogReader : public MetadataLogFormat
+{
+public:
+
+    /**
+     * @struct Block
+     *
+     * @brief Location of a block of the log.
+     */
+    struct Block
+    {
+        long long   m_llFirstTimestamp; /**< First time stamp. */
+
+        long long   m_llLastTimestamp; /**< Last time stamp. */
+
+        size_t  m_sFirstRecord; /**< Index of the first record. */
+
+        size_t  m_sNumRecords; /**< Number of records. */
+
+        size_t  m_sOffset; /**< Offset of the block. */
+
+        size_t  m_sEnd; /**< Offset of the end of the block. */
+
+        size_t  m_asOffset[METADATA_LOG_NUM_COLUMNS]; /**< Offset of each
+                                                       * column. */
+
+        size_t  m_asSize[METADATA_LOG_NUM_COLUMNS]; /**< Size of each column
+                                                     * (bytes). */
+
+    }; // end struct Block.
+
+    MetadataLogReader()
+        : m_sNumRecords(0)
+    {
+        Close();
+    }
+
+    /**
+     * @brief Open maps a log and loads its index and dictionary.
+     *
+     * @return false if the file is not a log.
+     */
+    bool Open(const std::string& p_sFileName)
+    {
+        Close();
+
+        if (!m_File.Open(p_sFileName) ||
+            m_File.GetSize() < METADATA_LOG_HEADER_SIZE ||
+            memcmp(m_File.GetData(), _Magic(false), 8) != 0 ||
+            _Get(m_File.GetData() + 8, 4) != METADATA_LOG_VERSION ||
+            _Get(m_File.GetData() + 12, 4) != METADATA_LOG_NUM_COLUMNS)
+        {
+            Close();
+
+            return false;
+        }
+
+        if (!_LoadIndex())
+        {
+            _ScanBlocks();
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Close unmaps the log.
+     */
+    void Close()
+    {
+        int     l_iCol;
+
+        m_File.Close();
+        m_vBlocks.clear();
+        m_vDictionary.clear();
+        m_sNumRecords = 0;
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            m_asCacheBlock[l_iCol] = static_cast<size_t>(-1);
+        }
+    }
+
+    /**
+     * @brief GetNumRecords returns the number of records of the log.
+     */
+    inline size_t GetNumRecords() const
+    {
+        return m_sNumRecords;
+    }
+
+    /**
+     * @brief GetBlocks returns the blocks of the log.
+     */
+    inline const std::vector<Block>& GetBlocks() const
+    {
+        return m_vBlocks;
+    }
+
+    /**
+     * @brief GetDictionary returns the strings referenced by the string
+     * columns.
+     */
+    inline const std::vector<std::string>& GetDictionary() const
+    {
+        return m_vDictionary;
+    }
+
+    /**
+     * @brief Seek returns the index of the first record whose time stamp is
+     * not earlier than p_llTimestamp, or GetNumRecords() if there is none.
+     */
+    size_t Seek(const long long p_llTimestamp)
+    {
+        const Values*   l_pvTimestamps;
+        size_t          l_sLow;
+        size_t          l_sHigh;
+        size_t          l_sMid;
+
+        l_sLow = 0;
+        l_sHigh = m_vBlocks.size();
+
+        while (l_sLow < l_sHigh)
+        {
+            l_sMid = l_sLow + (l_sHigh - l_sLow) / 2;
+
+            if (m_vBlocks[l_sMid].m_llLastTimestamp < p_llTimestamp)
+            {
+                l_sLow = l_sMid + 1;
+            }
+            else
+            {
+                l_sHigh = l_sMid;
+            }
+        }
+
+        if (l_sLow == m_vBlocks.size())
+        {
+            return m_sNumRecords;
+        }
+
+        l_pvTimestamps = &_Decode(l_sLow, METADATA_LOG_TIMESTAMP);
+
+        return m_vBlocks[l_sLow].m_sFirstRecord +
+               static_cast<size_t>(std::lower_bound(l_pvTimestamps->begin(),
+                                                    l_pvTimestamps->end(),
+                                                    p_llTimestamp) -
+                                   l_pvTimestamps->begin());
+    }
+
+    /**
+     * @brief Read decodes a record.
+     *
+     * @param[in]   p_sIndex        Index of the record.
+     * @param[out]  p_rMetadata     Record.
+     *
+     * @return false if the index is out of range or the block is corrupted.
+     */
+    bool Read(const size_t p_sIndex, Metadata& p_rMetadata)
+    {
+        const Values*       l_pvValues;
+        MetadataLogColumn   l_eCol;
+        long long           l_llValue;
+        size_t              l_sBlock;
+        size_t              l_sRecord;
+        int                 l_iCol;
+
+        if (!_Locate(p_sIndex, l_sBlock, l_sRecord))
+        {
+            return false;
+        }
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            l_eCol = static_cast<MetadataLogColumn>(l_iCol);
+
+            if (!IsVarint(l_eCol))
+            {
+                memcpy(&(p_rMetadata.*_Float(l_eCol)),
+                       m_File.GetData() +
+                           m_vBlocks[l_sBlock].m_asOffset[l_iCol] +
+                           l_sRecord * sizeof(float),
+                       sizeof(float));
+
+                continue;
+            }
+
+            l_pvValues = &_Decode(l_sBlock, l_eCol);
+
+            if (l_pvValues->size() <= l_sRecord)
+            {
+                return false;
+            }
+
+            l_llValue = (*l_pvValues)[l_sRecord];
+
+            if (l_eCol == METADATA_LOG_TIMESTAMP)
+            {
+                p_rMetadata.m_llTimestamp = l_llValue;
+            }
+            else if (IsPosition(l_eCol))
+            {
+                p_rMetadata.*_Position(l_eCol) =
+                    _Dequantize(l_llValue, _Scale(l_eCol));
+            }
+            else if (static_cast<size_t>(l_llValue) < m_vDictionary.size())
+            {
+                p_rMetadata.*_String(l_eCol) =
+                    m_vDictionary[static_cast<size_t>(l_llValue)];
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief ReadColumn scans a column of consecutive records. The strings
+     * are returned as their index in the dictionary.
+     *
+     * @param[in]   p_eColumn   Column.
+     * @param[in]   p_sFirst    Index of the first record.
+     * @param[in]   p_sCount    Number of records.
+     * @param[out]  p_pdValues  Values, p_sCount at least.
+     *
+     * @return the number of values read, less than p_sCount at the end of
+     * the log or at a corrupted block.
+     */
+    size_t ReadColumn(const MetadataLogColumn   p_eColumn,
+                      const size_t              p_sFirst,
+                      const size_t              p_sCount,
+                      double*                   p_pdValues)
+    {
+        const Values*       l_pvValues;
+        const long long*    l_pllValues;
+        const float*        l_pfValues;
+        double*             l_pdOut;
+        double              l_dScale;
+        size_t              l_sBlock;
+        size_t              l_sRecord;
+        size_t              l_sNum;
+        size_t              l_sCount;
+        size_t              l_sDone;
+        size_t              l_s;
+
+        l_sDone = 0;
+
+        if (p_eColumn >= METADATA_LOG_NUM_COLUMNS ||
+            !_Locate(p_sFirst, l_sBlock, l_sRecord))
+        {
+            return 0;
+        }
+
+        while (l_sDone < p_sCount && l_sBlock < m_vBlocks.size())
+        {
+            l_sNum = std::min(p_sCount - l_sDone,
+                              m_vBlocks[l_sBlock].m_sNumRecords - l_sRecord);
+            l_pdOut = p_pdValues + l_sDone;
+
+            if (!IsVarint(p_eColumn))
+            {
+                l_pfValues = GetFloatColumn(l_sBlock, p_eColumn, l_sCount) +
+                             l_sRecord;
+
+                for (l_s = 0; l_s < l_sNum; l_s++)
+                {
+                    l_pdOut[l_s] = l_pfValues[l_s];
+                }
+            }
+            else
+            {
+                l_pvValues = &_Decode(l_sBlock, p_eColumn);
+
+                if (l_pvValues->size() < l_sRecord + l_sNum)
+                {
+                    break;
+                }
+
+                l_pllValues = (l_pvValues->empty() ?
+                                   NULL : &(*l_pvValues)[0] + l_sRecord);
+
+                if (IsPosition(p_eColumn))
+                {
+                    l_dScale = _Scale(p_eColumn);
+
+                    for (l_s = 0; l_s < l_sNum; l_s++)
+                    {
+                        l_pdOut[l_s] = _Dequantize(l_pllValues[l_s],
+                                                   l_dScale);
+                    }
+                }
+                else
+                {
+                    for (l_s = 0; l_s < l_sNum; l_s++)
+                    {
+                        l_pdOut[l_s] = static_cast<double>(l_pllValues[l_s]);
+                    }
+                }
+            }
+
+            l_sDone += l_sNum;
+            l_sBlock++;
+            l_sRecord = 0;
+        }
+
+        return l_sDone;
+    }
+
+    /**
+     * @brief GetFloatColumn returns a float column of a block, without
+     * copying it out of the mapping.
+     *
+     * @param[in]   p_sBlock    Index of the block.
+     * @param[in]   p_eColumn   Float column.
+     * @param[out]  p_rsCount   Number of values.
+     *
+     * @return the values, or NULL if the column is not a float column.
+     */
+    const float* GetFloatColumn(const size_t            p_sBlock,
+                                const MetadataLogColumn p_eColumn,
+                                size_t&                 p_rsCount) const
+    {
+        if (p_sBlock >= m_vBlocks.size() || IsVarint(p_eColumn) ||
+            p_eColumn >= METADATA_LOG_NUM_COLUMNS)
+        {
+            p_rsCount = 0;
+
+            return NULL;
+        }
+
+        p_rsCount = m_vBlocks[p_sBlock].m_sNumRecords;
+
+        /* The columns are aligned to 8 bytes and the mapping to a page. */
+        return reinterpret_cast<const float*>(
+            m_File.GetData() + m_vBlocks[p_sBlock].m_asOffset[p_eColumn]);
+    }
+
+protected:
+
+    /**
+     * @brief _ParseBlock reads the header of the block at p_sOffset and the
+     * strings it adds to the dictionary.
+     *
+     * @return false if there is no valid block at p_sOffset.
+     */
+    bool _ParseBlock(const size_t p_sOffset, Block& p_rBlock)
+    {
+        const uint8_t*  l_pucData;
+        const uint8_t*  l_pucString;
+        const uint8_t*  l_pucEnd;
+        uint64_t        l_ullLength;
+        size_t          l_sSize;
+        size_t          l_sOffset;
+        size_t          l_sNumStrings;
+        size_t          l_sDictionary;
+        size_t          l_sColumn;
+        size_t          l_s;
+        int             l_iCol;
+
+        l_sSize = m_File.GetSize();
+
+        if (p_sOffset > l_sSize || l_sSize - p_sOffset < s_sBlockHeaderSize ||
+            _Get(m_File.GetData() + p_sOffset, 4) != s_uiBlockMagic)
+        {
+            return false;
+        }
+
+        l_pucData = m_File.GetData() + p_sOffset;
+        l_sOffset = p_sOffset + s_sBlockHeaderSize;
+        l_sNumStrings = static_cast<size_t>(_Get(l_pucData + 24, 4));
+        l_sDictionary = static_cast<size_t>(_Get(l_pucData + 28, 4));
+
+        p_rBlock.m_sNumRecords = static_cast<size_t>(_Get(l_pucData + 4, 4));
+        p_rBlock.m_llFirstTimestamp =
+            static_cast<long long>(_Get(l_pucData + 8, 8));
+        p_rBlock.m_llLastTimestamp =
+            static_cast<long long>(_Get(l_pucData + 16, 8));
+        p_rBlock.m_sFirstRecord = m_sNumRecords;
+        p_rBlock.m_sOffset = p_sOffset;
+
+        if (l_sSize - l_sOffset < l_sDictionary)
+        {
+            return false;
+        }
+
+        l_pucString = m_File.GetData() + l_sOffset;
+        l_pucEnd = l_pucString + l_sDictionary;
+        l_sOffset += _Align(l_sDictionary);
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            l_sColumn =
+                static_cast<size_t>(_Get(l_pucData + 32 + 4 * l_iCol, 4));
+
+            p_rBlock.m_asOffset[l_iCol] = l_sOffset;
+            p_rBlock.m_asSize[l_iCol] = l_sColumn;
+
+            if (l_sOffset > l_sSize || l_sSize - l_sOffset < l_sColumn ||
+                (!IsVarint(static_cast<MetadataLogColumn>(l_iCol)) &&
+                 l_sColumn != p_rBlock.m_sNumRecords * sizeof(float)))
+            {
+                return false;
+            }
+
+            l_sOffset += _Align(l_sColumn);
+        }
+
+        p_rBlock.m_sEnd = std::min(l_sOffset, l_sSize);
+
+        /* The strings are added once the whole block has been validated. */
+        for (l_s = 0; l_s < l_sNumStrings; l_s++)
+        {
+            if (!_GetVarint(l_pucString, l_pucEnd, l_ullLength) ||
+                static_cast<uint64_t>(l_pucEnd - l_pucString) < l_ullLength)
+            {
+                return false;
+            }
+
+            m_vDictionary.push_back(std::string(
+                reinterpret_cast<const char*>(l_pucString),
+                static_cast<size_t>(l_ullLength)));
+            l_pucString += l_ullLength;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief _AddBlock parses the block at p_sOffset and appends it.
+     */
+    bool _AddBlock(const size_t p_sOffset)
+    {
+        Block   l_Block;
+
+        if (!_ParseBlock(p_sOffset, l_Block))
+        {
+            return false;
+        }
+
+        m_vBlocks.push_back(l_Block);
+        m_sNumRecords += l_Block.m_sNumRecords;
+
+        return true;
+    }
+
+    /**
+     * @brief _LoadIndex loads the blocks listed in the index of a closed
+     * log.
+     *
+     * @return false if the log has no valid index.
+     */
+    bool _LoadIndex()
+    {
+        const uint8_t*  l_pucTrailer;
+        const uint8_t*  l_pucEntry;
+        uint64_t        l_ullIndex;
+        uint64_t        l_ullNumBlocks;
+        uint64_t        l_ull;
+        size_t          l_sSize;
+
+        l_sSize = m_File.GetSize();
+
+        if (l_sSize < METADATA_LOG_HEADER_SIZE + METADATA_LOG_TRAILER_SIZE)
+        {
+            return false;
+        }
+
+        l_pucTrailer = m_File.GetData() + l_sSize - METADATA_LOG_TRAILER_SIZE;
+        l_ullIndex = _Get(l_pucTrailer, 8);
+        l_ullNumBlocks = _Get(l_pucTrailer + 8, 8);
+
+        if (memcmp(l_pucTrailer + 16, _Magic(true), 8) != 0 ||
+            l_ullIndex > l_sSize - METADATA_LOG_TRAILER_SIZE ||
+            (l_sSize - METADATA_LOG_TRAILER_SIZE - l_ullIndex) /
+                METADATA_LOG_INDEX_SIZE != l_ullNumBlocks)
+        {
+            return false;
+        }
+
+        m_vBlocks.reserve(static_cast<size_t>(l_ullNumBlocks));
+
+        for (l_ull = 0; l_ull < l_ullNumBlocks; l_ull++)
+        {
+            l_pucEntry = m_File.GetData() + l_ullIndex +
+                         l_ull * METADATA_LOG_INDEX_SIZE;
+
+            if (_Get(l_pucEntry + 24, 8) != m_sNumRecords ||
+                !_AddBlock(static_cast<size_t>(_Get(l_pucEntry, 8))))
+            {
+                m_vBlocks.clear();
+                m_vDictionary.clear();
+                m_sNumRecords = 0;
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief _ScanBlocks walks the block headers of a log that has no index,
+     * up to the first incomplete block.
+     */
+    void _ScanBlocks()
+    {
+        size_t  l_sOffset;
+
+        l_sOffset = METADATA_LOG_HEADER_SIZE;
+
+        while (_AddBlock(l_sOffset))
+        {
+            l_sOffset = m_vBlocks.back().m_sEnd;
+        }
+    }
+
+    /**
+     * @brief _Locate finds the block of a record.
+     */
+    bool _Locate(const size_t   p_sIndex,
+                 size_t&        p_rsBlock,
+                 size_t&        p_rsRecord) const
+    {
+        size_t  l_sLow;
+        size_t  l_sHigh;
+        size_t  l_sMid;
+
+        if (p_sIndex >= m_sNumRecords)
+        {
+            return false;
+        }
+
+        l_sLow = 0;
+        l_sHigh = m_vBlocks.size();
+
+        while (l_sHigh - l_sLow > 1)
+        {
+            l_sMid = l_sLow + (l_sHigh - l_sLow) / 2;
+
+            if (m_vBlocks[l_sMid].m_sFirstRecord <= p_sIndex)
+            {
+                l_sLow = l_sMid;
+            }
+            else
+            {
+                l_sHigh = l_sMid;
+            }
+        }
+
+        p_rsBlock = l_sLow;
+        p_rsRecord = p_sIndex - m_vBlocks[l_sLow].m_sFirstRecord;
+
+        return true;
+    }
+
+    /**
+     * @brief _Decode returns a varint column of a block, decoding it unless
+     * it is the block decoded last for this column.
+     *
+     * @return the values, fewer than the records of the block if it is
+     * corrupted.
+     */
+    const Values& _Decode(const size_t              p_sBlock,
+                          const MetadataLogColumn   p_eColumn)
+    {
+        Values*         l_pvValues;
+        const Block*    l_pBlock;
+        const uint8_t*  l_pucData;
+        const uint8_t*  l_pucEnd;
+        uint64_t        l_ullValue;
+        uint64_t        l_ullDelta;
+        size_t          l_s;
+
+        l_pvValues = &m_avCache[p_eColumn];
+
+        if (m_asCacheBlock[p_eColumn] == p_sBlock)
+        {
+            return *l_pvValues;
+        }
+
+        l_pBlock = &m_vBlocks[p_sBlock];
+        l_pucData = m_File.GetData() + l_pBlock->m_asOffset[p_eColumn];
+        l_pucEnd = l_pucData + l_pBlock->m_asSize[p_eColumn];
+        l_ullValue = (p_eColumn == METADATA_LOG_TIMESTAMP ?
+                          static_cast<uint64_t>(l_pBlock->m_llFirstTimestamp) :
+                          0);
+
+        l_pvValues->resize(l_pBlock->m_sNumRecords);
+
+        for (l_s = 0; l_s < l_pBlock->m_sNumRecords; l_s++)
+        {
+            if (!_GetVarint(l_pucData, l_pucEnd, l_ullDelta))
+            {
+                l_pvValues->resize(l_s);
+
+                break;
+            }
+
+            if (IsString(p_eColumn))
+            {
+                l_ullValue = l_ullDelta;
+            }
+            else
+            {
+                l_ullValue += static_cast<uint64_t>(_UnZigZag(l_ullDelta));
+            }
+
+            (*l_pvValues)[l_s] = static_cast<long long>(l_ullValue);
+        }
+
+        m_asCacheBlock[p_eColumn] = p_sBlock;
+
+        return *l_pvValues;
+    }
+
+protected:
+
+    MappedFile  m_File; /**< Mapping of the log. */
+
+    std::vector<Block>  m_vBlocks; /**< Blocks of the log. */
+
+    std::vector<std::string>    m_vDictionary; /**< Strings of the log. */
+
+    size_t  m_sNumRecords; /**< Number of records of the log. */
+
+    Values  m_avCache[METADATA_LOG_NUM_COLUMNS]; /**< Decoded varint
+                                                  * columns. */
+
+    size_t  m_asCacheBlock[METADATA_LOG_NUM_COLUMNS]; /**< Block of each
+                                                       * decoded column. */
+
+}; // end class MetadataLogReader.
+
+/******************************************************************************/
+/**
+ * @class MetadataLogWriter
+ *
+ * @brief Appends Metadata records to a columnar log, new or existing. The
+ * records are buffered column by column and a block is written every
+ * METADATA_LOG_BLOCK_SIZE records, so that a crash loses at most the block in
+ * progress. The strings are written once, in the block that first uses them.
+ *
+ * The records are expected in time stamp order, which MetadataLogReader::Seek
+ * relies on. No memory is allocated per record once the first block has been
+ * written, except for the new strings.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class MetadataLogWriter : public MetadataLogFormat
+{
+public:
+
+    MetadataLogWriter()
+        : m_llOffset(0),
+          m_llNumRecords(0),
+          m_llFirstTimestamp(0),
+          m_llLastTimestamp(0),
+          m_sBlockRecords(0)
+    {
+        /* Empty. */
+    }
+
+    ~MetadataLogWriter()
+    {
+        Close();
+    }
+
+    /**
+     * @brief Open creates a log, or opens an existing one to append records
+     * to it.
+     *
+     * To append, the blocks of the log are found as MetadataLogReader does:
+     * from the index of a closed log, or by walking the block headers of a
+     * log whose writer has not been closed. The index and the trailer, or the
+     * incomplete block of a writer that has crashed, are cut off and the new
+     * blocks follow the last complete one. The dictionary is kept, so that
+     * the strings of the log are not written again. The records appended are
+     * expected not to be earlier than the ones of the log.
+     *
+     * @param[in]   p_sFileName     Path of the log.
+     * @param[in]   p_bAppend       If true, an existing log is extended and a
+     *                              missing or empty file is created. If false
+     *                              (default), an existing file is replaced.
+     *
+     * @return false if the file can not be written or, when appending, is
+     * not a log.
+     */
+    bool Open(const std::string& p_sFileName, const bool p_bAppend = false)
+    {
+        uint8_t     l_aucHeader[METADATA_LOG_HEADER_SIZE];
+
+        Close();
+
+        if (p_bAppend && _HasData(p_sFileName))
+        {
+            return _Reopen(p_sFileName);
+        }
+
+        m_File.open(p_sFileName.c_str(),
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!m_File.is_open())
+        {
+            return false;
+        }
+
+        memcpy(l_aucHeader, _Magic(false), 8);
+        _Put(l_aucHeader + 8, METADATA_LOG_VERSION, 4);
+        _Put(l_aucHeader + 12, METADATA_LOG_NUM_COLUMNS, 4);
+
+        return _Write(l_aucHeader, METADATA_LOG_HEADER_SIZE);
+    }
+
+    /**
+     * @brief IsOpen returns true if the log is open.
+     */
+    inline bool IsOpen() const
+    {
+        return m_File.is_open();
+    }
+
+    /**
+     * @brief Append adds a record to the block in progress, and writes the
+     * block when it is full.
+     *
+     * @return false if the log is not open or can not be written.
+     */
+    bool Append(const Metadata& p_rMetadata)
+    {
+        const uint8_t*      l_pucValue;
+        Column*             l_pvColumn;
+        MetadataLogColumn   l_eCol;
+        long long           l_llValue;
+        float               l_fValue;
+        int                 l_iCol;
+
+        if (!m_File.is_open())
+        {
+            return false;
+        }
+
+        if (m_sBlockRecords == 0)
+        {
+            m_llFirstTimestamp = p_rMetadata.m_llTimestamp;
+            memset(m_allPrevious, 0, sizeof(m_allPrevious));
+            m_allPrevious[METADATA_LOG_TIMESTAMP] = m_llFirstTimestamp;
+        }
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            l_eCol = static_cast<MetadataLogColumn>(l_iCol);
+            l_pvColumn = &m_avColumns[l_iCol];
+
+            if (IsString(l_eCol))
+            {
+                _PutVarint(*l_pvColumn,
+                           _Intern(p_rMetadata.*_String(l_eCol)));
+            }
+            else if (IsVarint(l_eCol))
+            {
+                if (l_eCol == METADATA_LOG_TIMESTAMP)
+                {
+                    l_llValue = p_rMetadata.m_llTimestamp;
+                }
+                else
+                {
+                    l_llValue = _Quantize(p_rMetadata.*_Position(l_eCol),
+                                          _Scale(l_eCol));
+                }
+
+                /* The delta wraps around, as the decoder does. */
+                _PutVarint(*l_pvColumn,
+                           _ZigZag(static_cast<long long>(
+                               static_cast<uint64_t>(l_llValue) -
+                               static_cast<uint64_t>(m_allPrevious[l_iCol]))));
+
+                m_allPrevious[l_iCol] = l_llValue;
+            }
+            else
+            {
+                l_fValue = p_rMetadata.*_Float(l_eCol);
+                l_pucValue = reinterpret_cast<const uint8_t*>(&l_fValue);
+
+                l_pvColumn->insert(l_pvColumn->end(),
+                                   l_pucValue,
+                                   l_pucValue + sizeof(float));
+            }
+        }
+
+        m_llLastTimestamp = p_rMetadata.m_llTimestamp;
+        m_llNumRecords++;
+        m_sBlockRecords++;
+
+        if (m_sBlockRecords == METADATA_LOG_BLOCK_SIZE)
+        {
+            return Flush();
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Flush writes the block in progress, even if it is not full.
+     *
+     * @return false if the log can not be written.
+     */
+    bool Flush()
+    {
+        static const uint8_t    s_aucPadding[8] = { 0 };
+        Column                  l_vDictionary;
+        uint8_t                 l_aucHeader[s_sBlockHeaderSize];
+        uint8_t                 l_aucIndex[METADATA_LOG_INDEX_SIZE];
+        size_t                  l_s;
+        int                     l_iCol;
+        bool                    l_bOk;
+
+        if (!m_File.is_open() || m_sBlockRecords == 0)
+        {
+            return m_File.is_open();
+        }
+
+        for (l_s = 0; l_s < m_vNewStrings.size(); l_s++)
+        {
+            _PutVarint(l_vDictionary, m_vNewStrings[l_s].size());
+            l_vDictionary.insert(l_vDictionary.end(),
+                                 m_vNewStrings[l_s].begin(),
+                                 m_vNewStrings[l_s].end());
+        }
+
+        _Put(l_aucHeader, s_uiBlockMagic, 4);
+        _Put(l_aucHeader + 4, m_sBlockRecords, 4);
+        _Put(l_aucHeader + 8, m_llFirstTimestamp, 8);
+        _Put(l_aucHeader + 16, m_llLastTimestamp, 8);
+        _Put(l_aucHeader + 24, m_vNewStrings.size(), 4);
+        _Put(l_aucHeader + 28, l_vDictionary.size(), 4);
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            _Put(l_aucHeader + 32 + 4 * l_iCol, m_avColumns[l_iCol].size(), 4);
+        }
+
+        _Put(l_aucIndex, m_llOffset, 8);
+        _Put(l_aucIndex + 8, m_llFirstTimestamp, 8);
+        _Put(l_aucIndex + 16, m_llLastTimestamp, 8);
+        _Put(l_aucIndex + 24, m_llNumRecords - m_sBlockRecords, 8);
+        m_vIndex.insert(m_vIndex.end(),
+                        l_aucIndex,
+                        l_aucIndex + METADATA_LOG_INDEX_SIZE);
+
+        l_bOk = _Write(l_aucHeader, s_sBlockHeaderSize) &&
+                _Write(l_vDictionary.empty() ? NULL : &l_vDictionary[0],
+                       l_vDictionary.size()) &&
+                _Write(s_aucPadding,
+                       _Align(l_vDictionary.size()) - l_vDictionary.size());
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            l_bOk = l_bOk &&
+                    _Write(&m_avColumns[l_iCol][0],
+                           m_avColumns[l_iCol].size()) &&
+                    _Write(s_aucPadding,
+                           _Align(m_avColumns[l_iCol].size()) -
+                           m_avColumns[l_iCol].size());
+
+            m_avColumns[l_iCol].clear();
+        }
+
+        m_vNewStrings.clear();
+        m_sBlockRecords = 0;
+        m_File.flush();
+
+        return l_bOk && m_File.good();
+    }
+
+    /**
+     * @brief Close writes the block in progress and the time stamp index,
+     * and closes the log.
+     *
+     * @return false if the log can not be written.
+     */
+    bool Close()
+    {
+        uint8_t     l_aucTrailer[METADATA_LOG_TRAILER_SIZE];
+        bool        l_bOk;
+
+        if (!m_File.is_open())
+        {
+            return false;
+        }
+
+        l_bOk = Flush();
+
+        _Put(l_aucTrailer, m_llOffset, 8);
+        _Put(l_aucTrailer + 8, m_vIndex.size() / METADATA_LOG_INDEX_SIZE, 8);
+        memcpy(l_aucTrailer + 16, _Magic(true), 8);
+
+        l_bOk = l_bOk &&
+                _Write(m_vIndex.empty() ? NULL : &m_vIndex[0],
+                       m_vIndex.size()) &&
+                _Write(l_aucTrailer, METADATA_LOG_TRAILER_SIZE);
+
+        m_File.close();
+        _Reset();
+
+        return l_bOk;
+    }
+
+    /**
+     * @brief GetNumRecords returns the number of records of the log,
+     * including the ones it held when opened to append.
+     */
+    inline long long GetNumRecords() const
+    {
+        return m_llNumRecords;
+    }
+
+protected:
+
+    /**
+     * @brief _HasData returns true if a file exists and is not empty.
+     */
+    static bool _HasData(const std::string& p_sFileName)
+    {
+        std::ifstream   l_File;
+
+        l_File.open(p_sFileName.c_str(),
+                    std::ios::in | std::ios::binary | std::ios::ate);
+
+        return l_File.is_open() && l_File.tellg() > 0;
+    }
+
+    /**
+     * @brief _Truncate sets the size of a file, cutting it or extending it
+     * with zeros.
+     */
+    static bool _Truncate(const std::string&    p_sFileName,
+                          const long long       p_llSize)
+    {
+#ifdef WIN32
+        HANDLE          l_hFile;
+        LARGE_INTEGER   l_Size;
+        bool            l_bOk;
+
+        l_hFile = CreateFileA(p_sFileName.c_str(), GENERIC_WRITE,
+                              FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+
+        if (l_hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        l_Size.QuadPart = p_llSize;
+        l_bOk = (SetFilePointerEx(l_hFile, l_Size, NULL, FILE_BEGIN) &&
+                 SetEndOfFile(l_hFile));
+
+        CloseHandle(l_hFile);
+
+        return l_bOk;
+#else
+        return truncate(p_sFileName.c_str(),
+                        static_cast<off_t>(p_llSize)) == 0;
+#endif
+    }
+
+    /**
+     * @brief _Reopen loads the index and the dictionary of an existing log,
+     * cuts what follows its last complete block and opens it to append.
+     *
+     * @return false if the file is not a log or can not be written.
+     */
+    bool _Reopen(const std::string& p_sFileName)
+    {
+        MetadataLogReader                   l_Reader;
+        const MetadataLogReader::Block*     l_pBlock;
+        uint8_t                             l_aucIndex[METADATA_LOG_INDEX_SIZE];
+        size_t                              l_s;
+
+        if (!l_Reader.Open(p_sFileName))
+        {
+            return false;
+        }
+
+        m_llOffset = METADATA_LOG_HEADER_SIZE;
+        m_llNumRecords = static_cast<long long>(l_Reader.GetNumRecords());
+
+        for (l_s = 0; l_s < l_Reader.GetBlocks().size(); l_s++)
+        {
+            l_pBlock = &l_Reader.GetBlocks()[l_s];
+
+            _Put(l_aucIndex, l_pBlock->m_sOffset, 8);
+            _Put(l_aucIndex + 8, l_pBlock->m_llFirstTimestamp, 8);
+            _Put(l_aucIndex + 16, l_pBlock->m_llLastTimestamp, 8);
+            _Put(l_aucIndex + 24, l_pBlock->m_sFirstRecord, 8);
+            m_vIndex.insert(m_vIndex.end(),
+                            l_aucIndex,
+                            l_aucIndex + METADATA_LOG_INDEX_SIZE);
+
+            /* The padding of the last column may be missing. */
+            m_llOffset = static_cast<long long>(_Align(l_pBlock->m_sEnd));
+        }
+
+        for (l_s = 0; l_s < l_Reader.GetDictionary().size(); l_s++)
+        {
+            m_mapDictionary.insert(
+                std::make_pair(l_Reader.GetDictionary()[l_s],
+                               static_cast<uint32_t>(l_s)));
+        }
+
+        /* The mapping is released before the file is cut. */
+        l_Reader.Close();
+
+        if (_Truncate(p_sFileName, m_llOffset))
+        {
+            m_File.open(p_sFileName.c_str(),
+                        std::ios::out | std::ios::binary | std::ios::app);
+        }
+
+        if (!m_File.is_open())
+        {
+            _Reset();
+
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief _Reset forgets the state of the log.
+     */
+    void _Reset()
+    {
+        int     l_iCol;
+
+        for (l_iCol = 0; l_iCol < METADATA_LOG_NUM_COLUMNS; l_iCol++)
+        {
+            m_avColumns[l_iCol].clear();
+        }
+
+        m_vIndex.clear();
+        m_mapDictionary.clear();
+        m_vNewStrings.clear();
+        m_llOffset = 0;
+        m_llNumRecords = 0;
+        m_sBlockRecords = 0;
+    }
+
+    /**
+     * @brief _Intern returns the index of a string in the dictionary, and
+     * adds it if it is new.
+     */
+    uint64_t _Intern(const std::string& p_rsString)
+    {
+        std::map<std::string, uint32_t>::iterator   l_it;
+        uint32_t                                    l_uiIndex;
+
+        l_it = m_mapDictionary.find(p_rsString);
+
+        if (l_it == m_mapDictionary.end())
+        {
+            l_uiIndex = static_cast<uint32_t>(m_mapDictionary.size());
+            l_it = m_mapDictionary.insert(
+                std::make_pair(p_rsString, l_uiIndex)).first;
+
+            m_vNewStrings.push_back(p_rsString);
+        }
+
+        return l_it->second;
+    }
+
+    /**
+     * @brief _Write writes bytes at the end of the log.
+     */
+    bool _Write(const void* p_pData, const size_t p_sSize)
+    {
+        if (p_sSize > 0)
+        {
+            m_File.write(static_cast<const char*>(p_pData),
+                         static_cast<std::streamsize>(p_sSize));
+            m_llOffset += p_sSize;
+        }
+
+        return m_File.good();
+    }
+
+protected:
+
+    std::ofstream   m_File; /**< Log file. */
+
+    Column  m_avColumns[METADATA_LOG_NUM_COLUMNS]; /**< Columns of the block
+                                                    * in progress. */
+
+    long long   m_allPrevious[METADATA_LOG_NUM_COLUMNS]; /**< Last value
+                                                          * of each delta. */
+
+    std::map<std::string, uint32_t> m_mapDictionary; /**< Index of each
+                                                      * string written. */
+
+    std::vector<std::string>    m_vNewStrings; /**< Strings added by the
+                                                * block in progress. */
+
+    std::vector<uint8_t>    m_vIndex; /**< Index entries of the blocks. */
+
+    long long   m_llOffset; /**< Size of the file (bytes). */
+
+    long long   m_llNumRecords; /**< Number of records of the log. */
+
+    long long   m_llFirstTimestamp; /**< First time stamp of the block. */
+
+    long long   m_llLastTimestamp; /**< Last time stamp of the block. */
+
+    size_t      m_sBlockRecords; /**< Number of records of the block. */
+
+}; // end class MetadataLogWriter.
+
+} // end namespace fby.
+
+#endif // METADATA_LOG_H
@@ -115,7 +115,8 @@ union ValueUint64
 #  define SHARED_PTR        std::tr1::shared_ptr
 #  define GET_PTR(s)        s.get()
 #  define RELEASE_PTR(s)    s.reset();
-#  define DYNAMIC_PTR_CAST  std::dynamic_pointer_cast
+#  define DYNAMIC_PTR_CAST  std::tr1::dynamic_pointer_cast
+#  define STATIC_PTR_CAST   std::tr1::static_pointer_cast
 #endif // SHARED_PTR
 
 #ifndef DEF_PTR
@@ -75,6 +75,22 @@ public:
      */
     virtual void BuildModulesMenu();
 
+    /**
+     * @brief CollectStats appends the execution statistics of all the modules
+     * managed by this AppBase to the input list (see Module::GetStats()).
+     *
+     * @param[in,out]   p_rlStats   List of statistics.
+     */
+    void CollectStats(ModuleStatsList& p_rlStats) const
+    {
+        ModuleList::const_iterator  l_it;
+
+        FORALL(m_lModules, l_it)
+        {
+            (*l_it)->CollectStats(p_rlStats);
+        }
+    }
+
     /**
      * @brief Configures the modules managed by this AppBase. This is a pure
      * virtual function that needs to be implemented in subclasses in order to
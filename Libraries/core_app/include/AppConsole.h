@@ -0,0 +1,912 @@
+#ifndef APPCONSOLE_H
+#define APPCONSOLE_H
+
+/** @file AppConsole.h
+ *
+ * @brief Contains the runtime to load, link and run a pipeline of Modules
+ * without a graphical user interface.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <ModuleManager.h>
+#include <ModuleReplicas.h>
+#include <ModuleSchedule.h>
+#include <PipelineGraph.h>
+
+/** Default time to drain and stop a module being reloaded (ms). */
+#define APP_CONSOLE_RELOAD_WAIT_MS  1000
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class AppConsole
+ *
+ * @brief Headless counterpart of AppBase: instantiates the Modules through the
+ * ModuleManager in MODULE_MODE_CONSOLE, links them as described by a
+ * configuration file and runs them. It does not create any QWidget, so it can
+ * be used from a QCoreApplication.
+ *
+ * The pipeline is described in the group "Pipeline" of an *.ini file (see
+ * PipelineGraph). The graph is validated before any Module is instantiated:
+ * unknown modules, invalid or doubly linked ports and cycles are rejected.
+ *
+ * Threads < 0 runs each Module in its own thread, otherwise the Modules share
+ * a ModuleExecutor with the given number of threads (0: number of cores) and
+ * are linked with g_LinkModulesDirect(). A link with Coalesce=true keeps at
+ * most one pending execution of its destination (see
+ * g_LinkModulesCoalesced()). A node with Replicas > 1 is instantiated as a
+ * ModuleReplicas of its type. The Priority, Deadline and Shed keys of a node
+ * only take effect on the shared executor. With Scheduled=true the Modules
+ * that have an input link run in the topological order of the graph, one
+ * pass per notification of the sources (see ModuleSchedule), instead of
+ * being scheduled by each notification.
+ *
+ * The Modules compiled into the application (see ModuleRegistry) are
+ * instantiated directly; the modules path is only searched for the others.
+ * A Module loaded from a shared library can be replaced while the pipeline
+ * runs, after its library has been rebuilt (see ReloadModule()).
+ *
+ * The input ports referred by the links are added to the destination Modules
+ * if they do not exist yet. The Modules are started from the last of the
+ * topological order, so that every consumer is running before its producers,
+ * and stopped from the first. The same QSettings are then propagated to each
+ * Module (see Module::LoadConfig()).
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class AppConsole
+{
+public:
+
+    /** @brief Default constructor. */
+    AppConsole()
+        : m_iNumThreads(-1),
+          m_bStarted(false),
+          m_pFramePool(new FramePool())
+    {
+        /* Empty. */
+    }
+
+    /** @brief Destructor: stops and closes all the managed modules. */
+    virtual ~AppConsole()
+    {
+        Close();
+    }
+
+    /**
+     * @brief AddModule adds a module to the pipeline. The module must have
+     * been already initialized.
+     *
+     * @param[in]   p_rsName            Unique name of the module in the
+     *                                  pipeline.
+     * @param[in]   p_pModule           Module to be added.
+     * @param[in]   p_iLoopTime_ms      Period of the main timer of the module
+     *                                  (0: no timer).
+     * @param[in]   p_bTrigger          If true the module is triggered once
+     *                                  when the pipeline is started.
+     *
+     * @return RET_ERROR if the name is already used or the module is null.
+     */
+    RetFlag AddModule(const QString&    p_rsName,
+                      ModulePtr         p_pModule,
+                      const int         p_iLoopTime_ms = 0,
+                      const bool        p_bTrigger = false)
+    {
+        Entry   l_Entry;
+
+        if (!p_pModule || m_mapNameIndex.contains(p_rsName))
+        {
+            return RET_ERROR;
+        }
+
+        l_Entry.m_sName = p_rsName;
+        l_Entry.m_pModule = p_pModule;
+        l_Entry.m_iLoopTime_ms = p_iLoopTime_ms;
+        l_Entry.m_bTrigger = p_bTrigger;
+
+        /* Loading order, until a graph gives the topological one. */
+        m_vOrder.push_back(static_cast<int>(m_vModules.size()));
+
+        m_mapNameIndex.insert(p_rsName, static_cast<int>(m_vModules.size()));
+        m_vModules.push_back(l_Entry);
+
+        p_pModule->SetWorkDir(m_WorkDir.absolutePath().toStdString());
+        p_pModule->SetFramePool(m_pFramePool);
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief Close stops and closes all the managed modules and releases them.
+     */
+    void Close()
+    {
+        size_t  l_s;
+
+        Stop();
+
+        if (m_pSchedule)
+        {
+            m_pSchedule->Close();
+
+            RELEASE_PTR(m_pSchedule)
+        }
+
+        for (l_s = 0; l_s < m_vModules.size(); l_s++)
+        {
+            m_vModules[l_s].m_pModule->SetExecutor(ModuleExecutorPtr());
+            m_vModules[l_s].m_pModule->Close();
+        }
+
+        m_vModules.clear();
+        m_vOrder.clear();
+        m_mapNameIndex.clear();
+        m_Graph.Clear();
+        m_pFramePool->Trim();
+
+        RELEASE_PTR(m_pExecutor)
+    }
+
+    /**
+     * @brief CollectStats appends the execution statistics of all the managed
+     * modules to the input list (see Module::GetStats()).
+     *
+     * @param[in,out]   p_rlStats   List of statistics.
+     */
+    void CollectStats(ModuleStatsList& p_rlStats) const
+    {
+        size_t  l_s;
+
+        for (l_s = 0; l_s < m_vModules.size(); l_s++)
+        {
+            m_vModules[l_s].m_pModule->CollectStats(p_rlStats);
+        }
+    }
+
+    /**
+     * @return the description of the loaded pipeline.
+     */
+    inline const PipelineGraph& GetGraph() const
+    {
+        return m_Graph;
+    }
+
+    /**
+     * @return the module with the input name, or a null pointer if the
+     * pipeline does not contain it.
+     */
+    ModulePtr GetModule(const QString& p_rsName) const
+    {
+        QMap<QString, int>::const_iterator  l_it;
+
+        l_it = m_mapNameIndex.constFind(p_rsName);
+
+        if (l_it == m_mapNameIndex.constEnd())
+        {
+            return ModulePtr();
+        }
+
+        return m_vModules[l_it.value()].m_pModule;
+    }
+
+    /** @return the number of modules of the pipeline. */
+    inline int GetNumModules() const
+    {
+        return static_cast<int>(m_vModules.size());
+    }
+
+    /** @return true if the pipeline is running. */
+    inline bool IsStarted() const
+    {
+        return m_bStarted;
+    }
+
+    /**
+     * @brief Link links an output port of a module of the pipeline to an input
+     * port of another one, adding the input port if needed.
+     *
+     * @param[in]   p_rsFrom        Name of the source module.
+     * @param[in]   p_iOutPort      Output port of the source module.
+     * @param[in]   p_rsTo          Name of the destination module.
+     * @param[in]   p_iInPort       Input port of the destination module.
+     * @param[in]   p_bCoalesce     If true, the notifications of the link are
+     *                              coalesced (see g_LinkModulesCoalesced()).
+     *
+     * @return RET_ERROR if a module or a port is not valid.
+     */
+    RetFlag Link(const QString& p_rsFrom,
+                 const int      p_iOutPort,
+                 const QString& p_rsTo,
+                 const int      p_iInPort,
+                 const bool     p_bCoalesce = false)
+    {
+        ModulePtr   l_pFrom;
+        ModulePtr   l_pTo;
+
+        l_pFrom = GetModule(p_rsFrom);
+        l_pTo = GetModule(p_rsTo);
+
+        if (!l_pFrom || !l_pTo || p_iInPort < 0)
+        {
+            return RET_ERROR;
+        }
+
+        while (l_pTo->GetNumPortIn() <= p_iInPort)
+        {
+            if (l_pTo->AddInput(1) != RET_SUCCESS)
+            {
+                return RET_ERROR;
+            }
+        }
+
+        if (m_pSchedule && m_pSchedule->FindStage(l_pTo) >= 0)
+        {
+            return m_pSchedule->Link(l_pFrom, p_iOutPort, l_pTo, p_iInPort);
+        }
+
+        if (p_bCoalesce)
+        {
+            return g_LinkModulesCoalesced(l_pFrom,
+                                          p_iOutPort,
+                                          l_pTo,
+                                          p_iInPort);
+        }
+
+        if (m_iNumThreads >= 0)
+        {
+            return g_LinkModulesDirect(l_pFrom, p_iOutPort, l_pTo, p_iInPort);
+        }
+
+        return g_LinkModulesChecked(l_pFrom, p_iOutPort, l_pTo, p_iInPort);
+    }
+
+    /**
+     * @brief LoadPipeline loads the modules of the pipeline described by the
+     * input settings (see the class description), initializes and links them
+     * and propagates the settings to each module.
+     *
+     * @param[in]   p_rSettings     Settings describing the pipeline.
+     *
+     * @return RET_ERROR if the graph is not valid, a module cannot be
+     * instantiated or a link is not valid. In this case the pipeline is left
+     * empty.
+     */
+    RetFlag LoadPipeline(QSettings& p_rSettings)
+    {
+        std::vector<ModulePtr>  l_vModules;
+        QStringList             l_lTypes;
+        QString                 l_sError;
+        ModulePtr               l_pModule;
+        size_t                  l_s;
+
+        Close();
+
+        if (m_Graph.LoadConfig(p_rSettings) != RET_SUCCESS)
+        {
+            qWarning() << "AppConsole: invalid pipeline settings";
+
+            m_Graph.Clear();
+
+            return RET_ERROR;
+        }
+
+        const std::vector<PipelineNode>&    l_rvNodes = m_Graph.GetNodes();
+        const std::vector<PipelineLink>&    l_rvLinks = m_Graph.GetLinks();
+
+        /* Loads the libraries of the Modules that are not compiled into the
+         * application, so that Validate() can check the types. */
+        for (l_s = 0; l_s < l_rvNodes.size(); l_s++)
+        {
+            if (!ModuleRegistry::FindAllocator(l_rvNodes[l_s].m_sType))
+            {
+                l_lTypes << l_rvNodes[l_s].m_sType;
+            }
+        }
+
+        if (!l_lTypes.isEmpty())
+        {
+            ModuleManager::FindModules(
+                        QDir(m_Graph.GetModulesPath()).absolutePath(),
+                        l_lTypes,
+                        MODULE_MODE_CONSOLE);
+        }
+
+        if (m_Graph.Validate(l_sError,
+                             ModuleManager::AvailableModules() +
+                                ModuleRegistry::GetModuleNames()) !=
+                RET_SUCCESS)
+        {
+            qWarning() << "AppConsole: invalid pipeline:" << l_sError;
+
+            m_Graph.Clear();
+
+            return RET_ERROR;
+        }
+
+        m_iNumThreads = m_Graph.GetNumThreads();
+
+        if (!m_Graph.GetWorkDir().isEmpty())
+        {
+            m_WorkDir.setPath(m_Graph.GetWorkDir());
+        }
+
+        /* The passes of the schedule need an executor even when the modules
+         * run in their own threads. */
+        if (m_iNumThreads >= 0 || m_Graph.IsScheduled())
+        {
+            m_pExecutor.reset(new ModuleExecutor(std::max(m_iNumThreads, 0)));
+        }
+
+        for (l_s = 0; l_s < l_rvNodes.size(); l_s++)
+        {
+            /* The allocator of a Module runs Init() and InitOptions(), and
+             * returns NULL if Init() fails. */
+            if (l_rvNodes[l_s].m_iReplicas > 1)
+            {
+                l_pModule.reset(new ModuleReplicas(
+                                    MODULE_MODE_CONSOLE,
+                                    l_rvNodes[l_s].m_sType,
+                                    l_rvNodes[l_s].m_iReplicas));
+
+                /* A ModuleReplicas creates its replicas here. */
+                if (l_pModule->Init(MODULE_MODE_CONSOLE) == RET_SUCCESS)
+                {
+                    l_pModule->InitOptions();
+                }
+                else
+                {
+                    RELEASE_PTR(l_pModule);
+                }
+            }
+            else
+            {
+                l_pModule = ModuleManager::Create(l_rvNodes[l_s].m_sType,
+                                                  MODULE_MODE_CONSOLE);
+            }
+
+            if (!l_pModule)
+            {
+                qWarning() << "AppConsole: cannot instantiate"
+                           << l_rvNodes[l_s].m_sType;
+
+                Close();
+
+                return RET_ERROR;
+            }
+
+            l_pModule->SetName(l_rvNodes[l_s].m_sName.toStdString());
+            l_pModule->SetPriority(l_rvNodes[l_s].m_Priority);
+            l_pModule->SetDeadline(l_rvNodes[l_s].m_iDeadline_ms,
+                                   l_rvNodes[l_s].m_Shed);
+
+            AddModule(l_rvNodes[l_s].m_sName,
+                      l_pModule,
+                      l_rvNodes[l_s].m_iLoopTime_ms,
+                      l_rvNodes[l_s].m_bTrigger);
+
+            l_vModules.push_back(l_pModule);
+        }
+
+        if (m_Graph.CheckPorts(l_vModules, l_sError) != RET_SUCCESS)
+        {
+            qWarning() << "AppConsole: invalid pipeline:" << l_sError;
+
+            Close();
+
+            return RET_ERROR;
+        }
+
+        m_vOrder = m_Graph.GetSchedule();
+
+        if (m_Graph.IsScheduled())
+        {
+            _InitSchedule();
+        }
+
+        for (l_s = 0; l_s < l_rvLinks.size(); l_s++)
+        {
+            if (Link(l_rvLinks[l_s].m_sFrom,
+                     l_rvLinks[l_s].m_iOutPort,
+                     l_rvLinks[l_s].m_sTo,
+                     l_rvLinks[l_s].m_iInPort,
+                     l_rvLinks[l_s].m_bCoalesce) != RET_SUCCESS)
+            {
+                qWarning() << "AppConsole: invalid link"
+                           << l_rvLinks[l_s].m_sFrom << "->"
+                           << l_rvLinks[l_s].m_sTo;
+
+                Close();
+
+                return RET_ERROR;
+            }
+        }
+
+        for (l_s = 0; l_s < m_vModules.size(); l_s++)
+        {
+            m_vModules[l_s].m_pModule->LoadConfig(p_rSettings);
+        }
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief LoadPipeline loads the pipeline described by an *.ini file.
+     *
+     * @param[in]   p_rsFilename    Name of the *.ini file.
+     *
+     * @return RET_ERROR if the file does not exist or the pipeline is not
+     * valid.
+     */
+    RetFlag LoadPipeline(const QString& p_rsFilename)
+    {
+        if (!QFile::exists(p_rsFilename))
+        {
+            qWarning() << "AppConsole: cannot find" << p_rsFilename;
+
+            return RET_ERROR;
+        }
+
+        QSettings   l_Settings(p_rsFilename, QSettings::IniFormat);
+
+        return LoadPipeline(l_Settings);
+    }
+
+    /**
+     * @brief ReloadModule replaces a module of the pipeline with a new
+     * instance allocated by a fresh copy of its shared library (see
+     * ModuleManager::Reload()), without stopping the other modules. The
+     * producers of the module are unlinked and the Data it has already
+     * received are processed. The new instance takes over the options and the
+     * configuration of the old one (see Module::SaveConfig()), its input
+     * ports, links, priority and deadline, and is started if the pipeline is
+     * running. The old instance is then closed.
+     *
+     * @note The Data notified to the module while it is being replaced are
+     * not delivered, and its state other than the configuration (e.g. its
+     * caches) is not taken over. A node with Replicas > 1 cannot be reloaded.
+     *
+     * @param[in]   p_rsName        Name of the module in the pipeline.
+     * @param[in]   p_rsFileName    Shared library of the new instance. If
+     *                              empty, the library of the type of the
+     *                              module in the modules path is used.
+     * @param[in]   p_iWait_ms      Maximum time to drain and to stop the old
+     *                              instance.
+     *
+     * @return RET_ERROR if the module is not a node of the pipeline, the new
+     * instance cannot be created (the old one is then left running) or a link
+     * cannot be made again.
+     */
+    RetFlag ReloadModule(const QString& p_rsName,
+                         const QString& p_rsFileName = QString(),
+                         const int      p_iWait_ms = APP_CONSOLE_RELOAD_WAIT_MS)
+    {
+        const std::vector<PipelineLink>&    l_rvLinks = m_Graph.GetLinks();
+        Options::const_iterator             l_it;
+        Options                             l_Options;
+        ModulePtr                           l_pOld;
+        ModulePtr                           l_pNew;
+        QString                             l_sFileName;
+        RetFlag                             l_Result;
+        Entry*                              l_pEntry;
+        int                                 l_iNode;
+        size_t                              l_s;
+        bool                                l_bStage;
+        bool                                l_bDrained;
+
+        l_iNode = m_Graph.FindNode(p_rsName);
+
+        if (l_iNode < 0 || !m_mapNameIndex.contains(p_rsName) ||
+            m_Graph.GetNodes()[l_iNode].m_iReplicas > 1)
+        {
+            qWarning() << "AppConsole: cannot reload" << p_rsName;
+
+            return RET_ERROR;
+        }
+
+        const PipelineNode&     l_rNode = m_Graph.GetNodes()[l_iNode];
+
+        l_sFileName = p_rsFileName;
+
+        if (l_sFileName.isEmpty())
+        {
+            l_sFileName = ModuleManifest::FindLibrary(
+                        QDir(m_Graph.GetModulesPath()).absolutePath(),
+                        l_rNode.m_sType);
+        }
+
+        /* Instantiated first, so that a failure leaves the pipeline as it
+         * is. */
+        l_pNew = ModuleManager::Reload(l_rNode.m_sType,
+                                       l_sFileName,
+                                       MODULE_MODE_CONSOLE);
+
+        if (!l_pNew)
+        {
+            qWarning() << "AppConsole: cannot instantiate" << l_rNode.m_sType;
+
+            return RET_ERROR;
+        }
+
+        l_pNew->SetName(p_rsName.toStdString());
+        l_pNew->SetPriority(l_rNode.m_Priority);
+        l_pNew->SetDeadline(l_rNode.m_iDeadline_ms, l_rNode.m_Shed);
+        l_pNew->SetWorkDir(m_WorkDir.absolutePath().toStdString());
+        l_pNew->SetFramePool(m_pFramePool);
+
+        l_pEntry = &m_vModules[m_mapNameIndex.value(p_rsName)];
+        l_pOld = l_pEntry->m_pModule;
+        l_bStage = (m_pSchedule && m_pSchedule->FindStage(l_pOld) >= 0);
+
+        /* Detach the producers, then drain the Data in flight. */
+        for (l_s = 0; l_s < l_rvLinks.size(); l_s++)
+        {
+            if (l_rvLinks[l_s].m_sTo == p_rsName)
+            {
+                _Unlink(l_rvLinks[l_s]);
+            }
+        }
+
+        l_bDrained = (l_bStage ?
+                          m_pSchedule->WaitIdle(p_iWait_ms) :
+                          l_pOld->WaitIdle(p_iWait_ms));
+
+        if (!l_bDrained)
+        {
+            qWarning() << "AppConsole: the Data in flight to" << p_rsName
+                       << "have not been drained";
+        }
+
+        if (m_bStarted)
+        {
+            l_pOld->CloseInputQueues();
+            l_pOld->Stop(p_iWait_ms);
+        }
+
+        l_pOld->SetExecutor(ModuleExecutorPtr());
+
+        /* Take over the state of the old instance. */
+        l_pOld->GetOptions(l_Options);
+
+        for (l_it = l_Options.constBegin();
+             l_it != l_Options.constEnd();
+             l_it++)
+        {
+            l_pNew->SetOption(l_it.key(), l_it.value());
+        }
+
+        _CopyConfig(l_pOld, l_pNew);
+
+        l_pEntry->m_pModule = l_pNew;
+
+        if (l_bStage)
+        {
+            m_pSchedule->ReplaceStage(l_pOld, l_pNew);
+        }
+
+        l_Result = RET_SUCCESS;
+
+        for (l_s = 0; l_s < l_rvLinks.size(); l_s++)
+        {
+            if ((l_rvLinks[l_s].m_sTo == p_rsName ||
+                 l_rvLinks[l_s].m_sFrom == p_rsName) &&
+                Link(l_rvLinks[l_s].m_sFrom,
+                     l_rvLinks[l_s].m_iOutPort,
+                     l_rvLinks[l_s].m_sTo,
+                     l_rvLinks[l_s].m_iInPort,
+                     l_rvLinks[l_s].m_bCoalesce) != RET_SUCCESS)
+            {
+                qWarning() << "AppConsole: invalid link"
+                           << l_rvLinks[l_s].m_sFrom << "->"
+                           << l_rvLinks[l_s].m_sTo;
+
+                l_Result = RET_ERROR;
+            }
+        }
+
+        if (m_bStarted)
+        {
+            if (_StartModule(*l_pEntry, l_bStage) != RET_SUCCESS)
+            {
+                l_Result = RET_ERROR;
+            }
+
+            if (l_pEntry->m_bTrigger)
+            {
+                l_pNew->Trigger();
+            }
+        }
+
+        l_pOld->Close();
+
+        return l_Result;
+    }
+
+    /**
+     * @brief SaveConfig saves the description of the pipeline, then
+     * propagates the input settings to each module to save its specific
+     * configuration data.
+     */
+    void SaveConfig(QSettings& p_rSettings)
+    {
+        size_t  l_s;
+
+        m_Graph.SaveConfig(p_rSettings);
+
+        for (l_s = 0; l_s < m_vModules.size(); l_s++)
+        {
+            m_vModules[l_s].m_pModule->SaveConfig(p_rSettings);
+        }
+    }
+
+    /**
+     * @brief Start starts all the managed modules, from the last of the
+     * topological order, then triggers the ones configured to be triggered on
+     * start. The stages of the schedule are started without an executor or a
+     * thread of their own.
+     *
+     * @return RET_ERROR if a module cannot be started. In this case the
+     * modules already started are stopped and the pipeline is not started.
+     */
+    RetFlag Start()
+    {
+        RetFlag     l_Result;
+        Entry*      l_pEntry;
+        size_t      l_s;
+        bool        l_bStage;
+
+        if (m_bStarted)
+        {
+            return RET_SUCCESS;
+        }
+
+        l_Result = RET_SUCCESS;
+
+        for (l_s = m_vOrder.size(); l_s > 0; l_s--)
+        {
+            l_pEntry = &m_vModules[m_vOrder[l_s - 1]];
+            l_bStage = (m_pSchedule &&
+                        m_pSchedule->FindStage(l_pEntry->m_pModule) >= 0);
+
+            if (_StartModule(*l_pEntry, l_bStage) != RET_SUCCESS)
+            {
+                l_Result = RET_ERROR;
+                break;
+            }
+        }
+
+        /* Stops the modules already started, sources first, so that the
+         * pipeline is either running or stopped. */
+        if (l_Result != RET_SUCCESS)
+        {
+            for (; l_s <= m_vOrder.size(); l_s++)
+            {
+                m_vModules[m_vOrder[l_s - 1]].m_pModule->CloseInputQueues();
+                m_vModules[m_vOrder[l_s - 1]].m_pModule->Stop();
+            }
+
+            return l_Result;
+        }
+
+        m_bStarted = true;
+
+        for (l_s = 0; l_s < m_vOrder.size(); l_s++)
+        {
+            l_pEntry = &m_vModules[m_vOrder[l_s]];
+
+            if (l_pEntry->m_bTrigger)
+            {
+                l_pEntry->m_pModule->Trigger();
+            }
+        }
+
+        return l_Result;
+    }
+
+    /**
+     * @brief Stop stops all the managed modules, in topological order. The
+     * input queues of each module are closed first (see
+     * Module::CloseInputQueues()), so that its producers are not left
+     * blocked on them.
+     *
+     * @param[in]   p_iWait_ms  Maximum time to wait for each module to stop.
+     */
+    void Stop(int p_iWait_ms = MODULE_STOP_NO_WAIT)
+    {
+        size_t  l_s;
+
+        if (!m_bStarted)
+        {
+            return;
+        }
+
+        for (l_s = 0; l_s < m_vOrder.size(); l_s++)
+        {
+            m_vModules[m_vOrder[l_s]].m_pModule->CloseInputQueues();
+            m_vModules[m_vOrder[l_s]].m_pModule->Stop(p_iWait_ms);
+        }
+
+        m_bStarted = false;
+    }
+
+protected:
+
+    /** Module of the pipeline with its run parameters. */
+    struct Entry
+    {
+        QString     m_sName;
+
+        ModulePtr   m_pModule;
+
+        int         m_iLoopTime_ms;
+
+        bool        m_bTrigger;
+    };
+
+protected:
+
+    /**
+     * @brief _CopyConfig copies the configuration of a module to another one
+     * through a temporary *.ini file (see Module::SaveConfig()).
+     */
+    static void _CopyConfig(ModulePtr p_pFrom, ModulePtr p_pTo)
+    {
+        QString     l_sFileName;
+
+        l_sFileName = QDir(QDir::tempPath()).absoluteFilePath(
+                    QString("reload_%1_%2.ini")
+                        .arg(QCoreApplication::applicationPid())
+                        .arg(QDateTime::currentMSecsSinceEpoch()));
+
+        {
+            QSettings   l_Settings(l_sFileName, QSettings::IniFormat);
+
+            p_pFrom->SaveConfig(l_Settings);
+            l_Settings.sync();
+
+            p_pTo->LoadConfig(l_Settings);
+        }
+
+        QFile::remove(l_sFileName);
+    }
+
+    /**
+     * @brief _InitSchedule adds the modules that have an input link to a new
+     * schedule, in topological order.
+     */
+    void _InitSchedule()
+    {
+        const std::vector<PipelineLink>&    l_rvLinks = m_Graph.GetLinks();
+        QSet<QString>                       l_setLinked;
+        size_t                              l_s;
+
+        for (l_s = 0; l_s < l_rvLinks.size(); l_s++)
+        {
+            l_setLinked.insert(l_rvLinks[l_s].m_sTo);
+        }
+
+        m_pSchedule.reset(new ModuleSchedule);
+        m_pSchedule->SetExecutor(m_pExecutor);
+
+        for (l_s = 0; l_s < m_vOrder.size(); l_s++)
+        {
+            const Entry&    l_rEntry = m_vModules[m_vOrder[l_s]];
+
+            if (!l_setLinked.contains(l_rEntry.m_sName))
+            {
+                continue;
+            }
+
+            if (l_rEntry.m_iLoopTime_ms > 0 || l_rEntry.m_bTrigger)
+            {
+                qWarning() << "AppConsole: the loop time and the trigger of"
+                           << l_rEntry.m_sName << "are ignored";
+            }
+
+            m_pSchedule->AddStage(l_rEntry.m_pModule);
+        }
+    }
+
+    /**
+     * @brief _StartModule starts a module on the shared executor or in its own
+     * thread. A stage of the schedule is started without an executor or a
+     * thread of its own.
+     */
+    RetFlag _StartModule(Entry& p_rEntry, const bool p_bStage)
+    {
+        RetFlag     l_Result;
+
+        l_Result = RET_SUCCESS;
+
+        p_rEntry.m_pModule->OpenInputQueues();
+
+        if (p_bStage)
+        {
+            /* Executed by the passes of the schedule only. */
+        }
+        else if (m_pExecutor && m_iNumThreads >= 0)
+        {
+            p_rEntry.m_pModule->SetExecutor(m_pExecutor);
+        }
+        else if (p_rEntry.m_pModule->InitThread() != RET_SUCCESS)
+        {
+            l_Result = RET_ERROR;
+        }
+
+        if (p_rEntry.m_pModule->Start(
+                p_bStage ? 0 : p_rEntry.m_iLoopTime_ms) != RET_SUCCESS)
+        {
+            l_Result = RET_ERROR;
+        }
+
+        /* Applies the priority to the thread of the module, now running. */
+        p_rEntry.m_pModule->SetPriority(p_rEntry.m_pModule->GetPriority());
+
+        return l_Result;
+    }
+
+    /**
+     * @brief _Unlink stops the notifications of a link of the pipeline.
+     */
+    void _Unlink(const PipelineLink& p_rLink)
+    {
+        ModulePtr   l_pFrom;
+        ModulePtr   l_pTo;
+
+        l_pFrom = GetModule(p_rLink.m_sFrom);
+        l_pTo = GetModule(p_rLink.m_sTo);
+
+        if (!l_pFrom || !l_pTo)
+        {
+            return;
+        }
+
+        if (m_pSchedule && m_pSchedule->FindStage(l_pTo) >= 0)
+        {
+            m_pSchedule->Unlink(l_pFrom, p_rLink.m_iOutPort, l_pTo);
+        }
+        else
+        {
+            g_UnlinkModules(l_pFrom,
+                            p_rLink.m_iOutPort,
+                            l_pTo,
+                            p_rLink.m_iInPort);
+        }
+    }
+
+protected:
+
+    std::vector<Entry>  m_vModules; /**< Modules, in loading order. */
+
+    std::vector<int>    m_vOrder; /**< Indices in m_vModules, in topological
+                                   * order. */
+
+    PipelineGraph   m_Graph; /**< Description of the loaded pipeline. */
+
+    ModuleSchedulePtr   m_pSchedule; /**< Static schedule (Scheduled=true). */
+
+    QMap<QString, int>  m_mapNameIndex; /**< Map name-index in m_vModules. */
+
+    ModuleExecutorPtr   m_pExecutor; /**< Shared executor (Threads >= 0 or
+                                      * Scheduled=true). */
+
+    QDir    m_WorkDir; /**< Working directory of the modules. */
+
+    int     m_iNumThreads; /**< Number of executor threads, < 0 to run each
+                            * module in its own thread. */
+
+    bool    m_bStarted; /**< True between Start() and Stop(). */
+
+    FramePoolPtr    m_pFramePool; /**< Frame pool shared by all the modules of
+                                   * the pipeline. */
+
+}; // end class AppConsole.
+
+} // end namespace fby.
+
+#endif // APPCONSOLE_H
@@ -22,27 +22,14 @@
     };\
     DEF_PTR(DataName##_List)
 
+/* Defines a Data that publishes immutable snapshots of a DataType value (see
+ * fby::DataSnapshot). MemberName is unused: the value is no longer a member,
+ * and Get() returns a SHARED_PTR<const DataType> instead of a reference, so
+ * the callers that modified the value in place must call Set(). The argument
+ * is left only so that the existing invocations still expand. */
 #define DATA_WRAPPER(DataType, ClassName, MemberName) \
-    class ClassName : public fby::Data\
+    class ClassName : public fby::Data, public fby::DataSnapshot< DataType >\
     {\
-    public:\
-        inline DataType& Get()\
-        {\
-            LOCK_READ(&m_Mutex, l_Lock);\
-            return MemberName;\
-        }\
-        inline const DataType& Get() const\
-        {\
-            LOCK_READ(&m_Mutex, l_Lock);\
-            return MemberName;\
-        }\
-        inline void Set(const DataType& p_Value)\
-        {\
-            LOCK_WRITE(&m_Mutex, l_Lock);\
-            MemberName = p_Value;\
-        }\
-    protected:\
-        DataType    MemberName;\
     };\
     DEF_PTR(ClassName)
 
@@ -63,6 +50,60 @@ typedef std::list<DataPtr>      DataList;
 typedef QVariant                            DataProperty;
 typedef std::map<std::string, DataProperty> DataProperties;
 
+/******************************************************************************/
+/**
+ * @class DataPropertyKey
+ *
+ * @brief Key of a Data property. The name is stored once at construction, so
+ * that the lookups of a property do not allocate a new string. Keys used on
+ * every frame should be built once, e.g. as static objects:
+ *
+ * @code
+ * static const DataPropertyKey   s_KeyLatitude("Latitude");
+ *
+ * l_pData->AddProperty(s_KeyLatitude, l_dLatitude_deg);
+ * @endcode
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class DataPropertyKey
+{
+public:
+
+    explicit DataPropertyKey(const char* p_pcName)
+        : m_sName(p_pcName)
+    {
+        /* Empty. */
+    }
+
+    explicit DataPropertyKey(const std::string& p_rsName)
+        : m_sName(p_rsName)
+    {
+        /* Empty. */
+    }
+
+    explicit DataPropertyKey(const QString& p_rsName)
+        : m_sName(p_rsName.toStdString())
+    {
+        /* Empty. */
+    }
+
+    /** @return the name of this key. */
+    inline const std::string& GetName() const
+    {
+        return m_sName;
+    }
+
+protected:
+
+    std::string m_sName; /**< Name of the key. */
+
+}; // end class DataPropertyKey.
+
 /******************************************************************************/
 /* Data. */
 /**
@@ -96,6 +137,33 @@ public:
     virtual void AddProperty(const std::string&     p_rsKey,
                              const DataProperty&    p_rValue);
 
+    /**
+     * @brief AddProperty adds a new property to this Data, or sets its value
+     * if it already exists. This overload does not allocate if the property
+     * exists.
+     *
+     * @param[in]   p_rKey      Key of the property.
+     * @param[in]   p_rValue    Value of the property.
+     */
+    inline void AddProperty(const DataPropertyKey&  p_rKey,
+                            const DataProperty&     p_rValue)
+    {
+        DataProperties::iterator    l_it;
+
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        l_it = m_mapProperties.find(p_rKey.GetName());
+
+        if (l_it != m_mapProperties.end())
+        {
+            MAP_VALUE(l_it) = p_rValue;
+        }
+        else
+        {
+            m_mapProperties.insert(std::make_pair(p_rKey.GetName(), p_rValue));
+        }
+    }
+
     /**
      * @brief CopyProperties clears the current properties of this Data and
      * copies the input ones.
@@ -104,6 +172,37 @@ public:
      */
     virtual void CopyProperties(const DataProperties& p_rProperties);
 
+    /**
+     * @brief CopyProperties clears the current properties of this Data and
+     * copies the ones of the input Data, without building the intermediate
+     * copy of GetProperties().
+     *
+     * @param[in]   p_rOther    Input Data.
+     */
+    inline void CopyProperties(const Data& p_rOther)
+    {
+        if (&p_rOther == this)
+        {
+            return;
+        }
+
+        /* Locks the two Data in a fixed order. */
+        if (&p_rOther < this)
+        {
+            LOCK_READ(&p_rOther.m_Mutex, l_LockOther);
+            LOCK_WRITE(&m_Mutex, l_Lock);
+
+            m_mapProperties = p_rOther.m_mapProperties;
+        }
+        else
+        {
+            LOCK_WRITE(&m_Mutex, l_Lock);
+            LOCK_READ(&p_rOther.m_Mutex, l_LockOther);
+
+            m_mapProperties = p_rOther.m_mapProperties;
+        }
+    }
+
     /**
      * @brief GetId is a shorcut to get this Data's main id.
      *
@@ -126,8 +225,21 @@ public:
      */
     QMenu* GetMenu();
 
+    /**
+     * @return the number of properties of this Data.
+     */
+    inline int GetNumProperties() const
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        return static_cast<int>(m_mapProperties.size());
+    }
+
     /**
      * @return a copy of the properties of this Data.
+     *
+     * @note Use VisitProperties() to read all the properties without copying
+     * them.
      */
     virtual DataProperties GetProperties() const;
 
@@ -142,6 +254,48 @@ public:
      */
     virtual DataProperty GetProperty(const std::string& p_rsKey) const;
 
+    /**
+     * @brief GetProperty gets the property associated to the specified key, or
+     * an invalid value if the key does not exist.
+     */
+    inline DataProperty GetProperty(const DataPropertyKey& p_rKey) const
+    {
+        DataProperty    l_Value;
+
+        GetProperty(p_rKey, l_Value);
+
+        return l_Value;
+    }
+
+    /**
+     * @brief GetProperty copies the value of the property associated to the
+     * specified key, if it exists.
+     *
+     * @param[in]   p_rKey      Key of the property.
+     * @param[out]  p_rValue    Value of the property. Unchanged if the property
+     *                          does not exist.
+     *
+     * @return true if the property exists.
+     */
+    inline bool GetProperty(const DataPropertyKey&  p_rKey,
+                            DataProperty&           p_rValue) const
+    {
+        DataProperties::const_iterator  l_it;
+
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        l_it = m_mapProperties.find(p_rKey.GetName());
+
+        if (l_it == m_mapProperties.end())
+        {
+            return false;
+        }
+
+        p_rValue = MAP_VALUE(l_it);
+
+        return true;
+    }
+
     /**
      * @brief HasProperty checks if this Data has the specified property.
      *
@@ -152,6 +306,17 @@ public:
      */
     virtual bool HasProperty(const std::string& p_rsKey) const;
 
+    /**
+     * @brief HasProperty checks if this Data has the specified property.
+     */
+    inline bool HasProperty(const DataPropertyKey& p_rKey) const
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        return (m_mapProperties.find(p_rKey.GetName()) !=
+                m_mapProperties.end());
+    }
+
     /**
      * @brief InitMenu initializes the menu of this Data. The default
      * implementation allocates a new QMenu object.
@@ -169,6 +334,17 @@ public:
      */
     virtual void RemoveProperty(const std::string& p_rsKey);
 
+    /**
+     * @brief RemoveProperty removes the property associated to the specified
+     * key.
+     */
+    inline void RemoveProperty(const DataPropertyKey& p_rKey)
+    {
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        m_mapProperties.erase(p_rKey.GetName());
+    }
+
     /**
      * @brief SetId is a shortcut to set this Data's main id.
      *
@@ -186,6 +362,48 @@ public:
     virtual void SetProperty(const std::string  p_rsKey,
                              DataProperty       p_rValue);
 
+    /**
+     * @brief SetProperty sets the value of the specified property, if it
+     * exists. If the property does not exist, then this function does nothing.
+     */
+    inline void SetProperty(const DataPropertyKey&  p_rKey,
+                            const DataProperty&     p_rValue)
+    {
+        DataProperties::iterator    l_it;
+
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        l_it = m_mapProperties.find(p_rKey.GetName());
+
+        if (l_it != m_mapProperties.end())
+        {
+            MAP_VALUE(l_it) = p_rValue;
+        }
+    }
+
+    /**
+     * @brief VisitProperties calls the input visitor for each property of this
+     * Data, under the read lock of m_Mutex, as:
+     *
+     *     p_rVisitor(const std::string&, const DataProperty&);
+     *
+     * The visitor must not access the properties of this Data.
+     *
+     * @param[in,out]   p_rVisitor  Visitor.
+     */
+    template <typename Visitor>
+    void VisitProperties(Visitor& p_rVisitor) const
+    {
+        DataProperties::const_iterator  l_it;
+
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        FORALL(m_mapProperties, l_it)
+        {
+            p_rVisitor(MAP_KEY(l_it), MAP_VALUE(l_it));
+        }
+    }
+
 public:
 
     mutable QReadWriteLock  m_Mutex;
@@ -203,6 +421,127 @@ protected:
 
 }; // end class Data.
 
+/******************************************************************************/
+/**
+ * @class DataSnapshot
+ *
+ * @brief Holds a value of type T as a sequence of immutable snapshots, in the
+ * style of read-copy-update. Get() returns the current snapshot: the reader
+ * keeps it alive, and reads it without any lock, for as long as it holds the
+ * pointer. A writer builds the next value aside (see Clone()) and publishes it
+ * with Publish(), which only swaps the current pointer; the previous snapshot
+ * is released by its last reader.
+ *
+ * The internal mutex only protects the copy of the current pointer, so that
+ * readers never wait for a copy of the value. Concurrent writers that update
+ * the current value (Clone() then Publish()) must serialize on Data::m_Mutex,
+ * otherwise the last published value wins.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+template <typename T>
+class DataSnapshot
+{
+public:
+
+    typedef SHARED_PTR<const T> SnapshotPtr;
+
+    DataSnapshot()
+        : m_pSnapshot(new T)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @return a mutable copy of the current snapshot, to be modified and then
+     * published with Publish().
+     */
+    inline SHARED_PTR<T> Clone() const
+    {
+        SnapshotPtr     l_pSnapshot;
+
+        l_pSnapshot = Get();
+
+        return SHARED_PTR<T>(new T(*l_pSnapshot));
+    }
+
+    /**
+     * @return the current snapshot. It is never null and never modified.
+     */
+    inline SnapshotPtr Get() const
+    {
+        QMutexLocker    l_Lock(&m_MutexSnapshot);
+
+        return m_pSnapshot;
+    }
+
+    /**
+     * @brief Publish makes the input value the current snapshot. The caller
+     * must not modify the value afterwards.
+     *
+     * @param[in]   p_pValue    Next value. A null pointer publishes a default
+     *                          constructed value.
+     */
+    inline void Publish(SHARED_PTR<T> p_pValue)
+    {
+        SnapshotPtr     l_pNext;
+
+        if (!p_pValue)
+        {
+            p_pValue.reset(new T);
+        }
+
+        l_pNext = p_pValue;
+
+        {
+            QMutexLocker    l_Lock(&m_MutexSnapshot);
+
+            m_pSnapshot.swap(l_pNext);
+        }
+
+        /* The previous snapshot is released here, outside the lock, if this
+         * was its last reference. */
+    }
+
+    /**
+     * @brief PublishSwap publishes the content of the input value without
+     * copying it: the value is swapped into the next snapshot and the input
+     * is left default constructed.
+     *
+     * @param[in,out]   p_rValue    Next value.
+     */
+    inline void PublishSwap(T& p_rValue)
+    {
+        SHARED_PTR<T>   l_pNext(new T);
+
+        std::swap(*l_pNext, p_rValue);
+
+        Publish(l_pNext);
+    }
+
+    /**
+     * @brief Set publishes a copy of the input value. The copy is made before
+     * taking any lock.
+     *
+     * @param[in]   p_rValue    Next value.
+     */
+    inline void Set(const T& p_rValue)
+    {
+        Publish(SHARED_PTR<T>(new T(p_rValue)));
+    }
+
+protected:
+
+    mutable QMutex  m_MutexSnapshot; /**< Protects m_pSnapshot. */
+
+    SnapshotPtr     m_pSnapshot; /**< Current snapshot. */
+
+}; // end class DataSnapshot.
+
 } // end namespace fby.
 
 DATA_WRAPPER(std::string, DataFile, m_sFile);
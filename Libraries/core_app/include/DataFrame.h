@@ -2,9 +2,134 @@
 #define DATAFRAME_H
 
 #include <Data.h>
+#include <FramePool.h>
 
 namespace fby
 {
+/******************************************************************************/
+/**
+ * @class FrameBufferHandle
+ *
+ * @brief Reference to a FrameBuffer with an explicit ownership flag. The flag
+ * is set only by the holder of a buffer that nobody else references (e.g. a
+ * buffer just taken from a FramePool), and it is cleared for good as soon as
+ * the buffer is shared: copying a handle clears the flag of both the copy and
+ * the source. A handle therefore never writes into a buffer that may be read
+ * by someone else, without relying on the reference count of the buffer.
+ *
+ * The flag is atomic, since the copies of a handle clear the flag of their
+ * source while other readers may be copying it too.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class FrameBufferHandle
+{
+public:
+
+    FrameBufferHandle()
+        : m_iWritable(0)
+    {
+        /* Empty. */
+    }
+
+    FrameBufferHandle(const FrameBufferHandle& p_rOther)
+        : m_pBuffer(p_rOther.m_pBuffer),
+          m_iWritable(0)
+    {
+        p_rOther.m_iWritable.storeRelease(0);
+    }
+
+    FrameBufferHandle& operator = (const FrameBufferHandle& p_rOther)
+    {
+        if (this != &p_rOther)
+        {
+            m_pBuffer = p_rOther.m_pBuffer;
+            m_iWritable.storeRelease(0);
+            p_rOther.m_iWritable.storeRelease(0);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @return the referenced buffer, or a null pointer.
+     */
+    inline const FrameBufferPtr& Get() const
+    {
+        return m_pBuffer;
+    }
+
+    /**
+     * @return true if the referenced buffer may be written in place.
+     */
+    inline bool IsWritable() const
+    {
+        return (m_iWritable.loadAcquire() != 0);
+    }
+
+    /**
+     * @brief Reset references a new buffer.
+     *
+     * @param[in]   p_pBuffer       Buffer.
+     * @param[in]   p_bWritable     True if the caller does not keep any
+     *                              other reference to the buffer.
+     */
+    inline void Reset(FrameBufferPtr    p_pBuffer = FrameBufferPtr(),
+                      const bool        p_bWritable = false)
+    {
+        m_pBuffer = p_pBuffer;
+        m_iWritable.storeRelease((p_bWritable && m_pBuffer) ? 1 : 0);
+    }
+
+    /**
+     * @brief Share clears the ownership flag and returns the buffer, to be
+     * referenced by someone else.
+     */
+    inline FrameBufferPtr Share() const
+    {
+        m_iWritable.storeRelease(0);
+
+        return m_pBuffer;
+    }
+
+protected:
+
+    FrameBufferPtr  m_pBuffer; /**< Referenced buffer. */
+
+    mutable QAtomicInt  m_iWritable; /**< Non-zero if nobody else references
+                                      * m_pBuffer. */
+
+}; // end class FrameBufferHandle.
+
+/******************************************************************************/
+/**
+ * @class DataFrameBuffer
+ *
+ * @brief Shared pixel buffer of a DataFrame. It is attached to its DataFrame
+ * (see g_Attach()) by the inline zero-copy methods, since the layout of the
+ * DataFrame and Frame classes exported by the core libraries must not change.
+ *
+ * @note This class is an implementation detail of DataFrame: m_Buffer is
+ * protected by the mutex of the DataFrame.
+ */
+class DataFrameBuffer : public QObject
+{
+public:
+
+    explicit DataFrameBuffer(QObject* /* p_pOwner */)
+    {
+        /* Empty. */
+    }
+
+    FrameBufferHandle   m_Buffer; /**< Shared pixel buffer. */
+
+}; // end class DataFrameBuffer.
+
+/******************************************************************************/
 /**
  * @class DataFrame
  *
@@ -12,6 +137,16 @@ namespace fby
  * different modules in an application. This class holds a Frame object that
  * contains the necessary data.
  *
+ * The pixel data are held either by the m_vBuffer of the Frame, which is
+ * filled by the copying SetFrame() overloads, or by a shared FrameBuffer (see
+ * AllocFrame(), AdoptFrame(), ShareFrame() and WrapFrame()), so that
+ * consumers can keep a reference to them (see GetBuffer()) without copying.
+ * The shared buffer is used only while m_vBuffer is empty and the Frame has a
+ * size: Clear() and SetFrame() are compiled into the core_app library and
+ * only manage the Frame, so the buffer they leave behind is released by the
+ * next call of any of the inline methods below. GetData() returns the pixels
+ * wherever they are held.
+ *
  * @callgraph
  * @callergraph
  * @author Andrea Bracci
@@ -26,11 +161,160 @@ public:
 
     DataFrame();
 
+    /**
+     * @brief AdoptFrame moves the content of the input vector into a new
+     * pixel buffer without copying it.
+     *
+     * @note On return the input vector is empty.
+     *
+     * @param[in,out]   p_rvBuffer      Input buffer that contains the pixel
+     *                                  data.
+     * @param[in]       p_iWidth        Frame width.
+     * @param[in]       p_iHeight       Frame height.
+     * @param[in]       p_iLineWidth    Frame line width.
+     */
+    inline void AdoptFrame(std::vector<uchar>&  p_rvBuffer,
+                           const int            p_iWidth,
+                           const int            p_iHeight,
+                           const int            p_iLineWidth)
+    {
+        _SetBuffer(FrameBufferPtr(new FrameBuffer(p_rvBuffer)),
+                   true,
+                   p_iWidth,
+                   p_iHeight,
+                   p_iLineWidth);
+    }
+
+    /**
+     * @brief AllocFrame sets the pixel buffer of this DataFrame with a buffer
+     * taken from the input FramePool. The buffer goes back to the pool when
+     * the last reference to it is released.
+     *
+     * @param[in]   p_rPool             Pool of the pipeline.
+     * @param[in]   p_iWidth            Frame width (pixels).
+     * @param[in]   p_iHeight           Frame height (pixels).
+     * @param[in]   p_iBytesPerPixel    Number of bytes per pixel.
+     *
+     * @return the writable pointer to the pixel data. The line width of the
+     * frame is padded (see FramePool::GetPaddedLineWidth()).
+     */
+    inline uchar* AllocFrame(FramePool&     p_rPool,
+                             const int      p_iWidth,
+                             const int      p_iHeight,
+                             const int      p_iBytesPerPixel)
+    {
+        int     l_iLineWidth;
+
+        l_iLineWidth = FramePool::GetPaddedLineWidth(p_iWidth,
+                                                     p_iBytesPerPixel);
+
+        return _SetBuffer(p_rPool.Acquire(static_cast<size_t>(l_iLineWidth) *
+                                          p_iHeight),
+                          true,
+                          p_iWidth,
+                          p_iHeight,
+                          l_iLineWidth);
+    }
+
     /**
      * @brief Clear clears the content of the buffer.
      */
     void Clear();
 
+    /**
+     * @brief CopyFrame copies the Frame of the input DataFrame into this one.
+     * A shared pixel buffer is shared, not copied.
+     *
+     * @param[in]   p_rOther    DataFrame to be copied.
+     */
+    inline void CopyFrame(const DataFrame& p_rOther)
+    {
+        Frame               l_Frame;
+        FrameBufferPtr      l_pBuffer;
+        DataFrameBuffer*    l_pAttached;
+
+        if (this == &p_rOther)
+        {
+            return;
+        }
+
+        {
+            LOCK_READ(&p_rOther.m_Mutex, l_Lock);
+
+            l_Frame = p_rOther.m_Frame;
+            l_pBuffer = p_rOther._GetBuffer();
+        }
+
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        m_Frame = l_Frame;
+
+        l_pAttached = (l_pBuffer ? _Attached() :
+                                   g_FindAttached<DataFrameBuffer>(this));
+
+        if (l_pAttached)
+        {
+            l_pAttached->m_Buffer.Reset(l_pBuffer);
+        }
+    }
+
+    /**
+     * @return the shared pixel buffer of this DataFrame, or a null pointer if
+     * the pixels are held by the Frame. Holding the returned pointer keeps
+     * the pixel data alive even if this DataFrame is later updated by its
+     * producer, and the buffer is no longer written in place by this
+     * DataFrame.
+     */
+    inline FrameBufferPtr GetBuffer() const
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        return _GetBuffer();
+    }
+
+    /**
+     * @return the size of the pixel data (bytes).
+     */
+    inline size_t GetBufferSize() const
+    {
+        DataFrameBuffer*    l_pBuffer;
+
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        l_pBuffer = _FindBuffer();
+
+        if (l_pBuffer)
+        {
+            return l_pBuffer->m_Buffer.Get()->GetSize();
+        }
+
+        return m_Frame.m_vBuffer.size();
+    }
+
+    /**
+     * @return a const pointer to the pixel data, or NULL if this DataFrame is
+     * empty.
+     *
+     * @warning The pointer is valid until the DataFrame is updated: the
+     * consumers that keep the pixels must hold GetBuffer().
+     */
+    inline const uchar* GetData() const
+    {
+        DataFrameBuffer*    l_pBuffer;
+
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        l_pBuffer = _FindBuffer();
+
+        if (l_pBuffer)
+        {
+            return static_cast<const FrameBuffer*>(
+                        GET_PTR(l_pBuffer->m_Buffer.Get()))->GetData();
+        }
+
+        return (m_Frame.m_vBuffer.empty() ? NULL : &m_Frame.m_vBuffer[0]);
+    }
+
     /**
      * @return a reference to the Frame object.
      */
@@ -55,6 +339,40 @@ public:
         return m_Frame.m_Metadata;
     }
 
+    /**
+     * @brief GetMutableData returns a writable pointer to the pixel data. A
+     * shared buffer that this DataFrame does not own (see FrameBufferHandle)
+     * is copied first, so that the other holders are not affected.
+     *
+     * @return a pointer to the pixel data, or NULL if this DataFrame is empty.
+     */
+    inline uchar* GetMutableData()
+    {
+        DataFrameBuffer*    l_pBuffer;
+        const FrameBuffer*  l_pShared;
+
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        l_pBuffer = _FindBuffer();
+
+        if (!l_pBuffer)
+        {
+            return (m_Frame.m_vBuffer.empty() ? NULL : &m_Frame.m_vBuffer[0]);
+        }
+
+        if (!l_pBuffer->m_Buffer.IsWritable())
+        {
+            l_pShared = GET_PTR(l_pBuffer->m_Buffer.Get());
+
+            l_pBuffer->m_Buffer.Reset(FrameBufferPtr(new FrameBuffer(
+                                                         l_pShared->GetData(),
+                                                         l_pShared->GetSize())),
+                                      true);
+        }
+
+        return l_pBuffer->m_Buffer.Get()->GetData();
+    }
+
     /**
      * @brief SetFrame copies the input buffer to the member buffer along with
      * the frame size info.
@@ -85,7 +403,6 @@ public:
                   const int     p_iHeight,
                   const int     p_iLineWidth);
 
-
     /**
      * @brief SetMetadata sets the metadata of this DataFrame.
      *
@@ -93,6 +410,139 @@ public:
      */
     void SetMetadata(const Metadata& p_rMetadata);
 
+    /**
+     * @brief ShareFrame shares the input pixel buffer along with the frame
+     * size info. No pixel data is copied, and the buffer is never written in
+     * place by this DataFrame.
+     *
+     * @param[in]   p_pBuffer       Input buffer that contains the pixel data.
+     * @param[in]   p_iWidth        Frame width.
+     * @param[in]   p_iHeight       Frame height.
+     * @param[in]   p_iLineWidth    Frame line width.
+     */
+    inline void ShareFrame(FrameBufferPtr   p_pBuffer,
+                           const int        p_iWidth,
+                           const int        p_iHeight,
+                           const int        p_iLineWidth)
+    {
+        _SetBuffer(p_pBuffer, false, p_iWidth, p_iHeight, p_iLineWidth);
+    }
+
+    /**
+     * @brief WrapFrame wraps an external pixel storage without copying it.
+     *
+     * @param[in]   p_pucBuffer     External storage that contains the pixel
+     *                              data. It must hold at least
+     *                              p_iHeight * p_iLineWidth bytes.
+     * @param[in]   p_iWidth        Frame width.
+     * @param[in]   p_iHeight       Frame height.
+     * @param[in]   p_iLineWidth    Frame line width.
+     * @param[in]   p_pReleaser     Object to be notified when the storage is
+     *                              no longer referenced. If null, the caller
+     *                              must guarantee that the storage outlives
+     *                              this DataFrame and all its copies.
+     */
+    inline void WrapFrame(uchar*                    p_pucBuffer,
+                          const int                 p_iWidth,
+                          const int                 p_iHeight,
+                          const int                 p_iLineWidth,
+                          FrameBufferReleaserPtr    p_pReleaser =
+                                                    FrameBufferReleaserPtr())
+    {
+        ShareFrame(FrameBufferPtr(new FrameBuffer(
+                                      p_pucBuffer,
+                                      static_cast<size_t>(p_iHeight) *
+                                      static_cast<size_t>(p_iLineWidth),
+                                      p_pReleaser)),
+                   p_iWidth,
+                   p_iHeight,
+                   p_iLineWidth);
+    }
+
+protected:
+
+    /**
+     * @return the attached pixel buffer, created if needed.
+     */
+    inline DataFrameBuffer* _Attached()
+    {
+        return g_Attach<DataFrameBuffer>(this);
+    }
+
+    /**
+     * @return the attached pixel buffer if it holds the pixels of the Frame,
+     * or NULL. A buffer left behind by Clear() or SetFrame() is released.
+     *
+     * @warning m_Mutex must be locked by the caller.
+     */
+    inline DataFrameBuffer* _FindBuffer() const
+    {
+        DataFrameBuffer*    l_pBuffer;
+
+        l_pBuffer = g_FindAttached<DataFrameBuffer>(this);
+
+        if (!l_pBuffer)
+        {
+            return NULL;
+        }
+
+        if (!m_Frame.m_vBuffer.empty() || m_Frame.m_iHeight <= 0)
+        {
+            /* Several readers may get here under the read lock. */
+            LOCK_WRITE(g_GetAttachedLock(), l_Lock);
+
+            l_pBuffer->m_Buffer.Reset();
+
+            return NULL;
+        }
+
+        return (l_pBuffer->m_Buffer.Get() ? l_pBuffer : NULL);
+    }
+
+    /**
+     * @return the shared pixel buffer, or a null pointer.
+     *
+     * @warning m_Mutex must be locked by the caller.
+     */
+    inline FrameBufferPtr _GetBuffer() const
+    {
+        DataFrameBuffer*    l_pBuffer;
+
+        l_pBuffer = _FindBuffer();
+
+        return (l_pBuffer ? l_pBuffer->m_Buffer.Share() : FrameBufferPtr());
+    }
+
+    /**
+     * @brief _SetBuffer sets the shared pixel buffer and releases the pixels
+     * held by the Frame.
+     *
+     * @return the writable pointer to the pixel data, or NULL if the buffer
+     * is not writable.
+     */
+    inline uchar* _SetBuffer(FrameBufferPtr     p_pBuffer,
+                             const bool         p_bWritable,
+                             const int          p_iWidth,
+                             const int          p_iHeight,
+                             const int          p_iLineWidth)
+    {
+        DataFrameBuffer*    l_pBuffer;
+
+        l_pBuffer = _Attached();
+
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        std::vector<uchar>().swap(m_Frame.m_vBuffer);
+
+        l_pBuffer->m_Buffer.Reset(p_pBuffer, p_bWritable);
+
+        m_Frame.m_iWidth = p_iWidth;
+        m_Frame.m_iHeight = p_iHeight;
+        m_Frame.m_iLineWidth = p_iLineWidth;
+
+        return ((p_bWritable && p_pBuffer) ? p_pBuffer->GetData() : NULL);
+    }
+
 protected:
 
     Frame   m_Frame;
@@ -101,6 +551,62 @@ protected:
 
 DEF_PTR(DataFrame);
 
+/** @brief Global function that returns a copy of a Data that can be kept while
+ * its producer reuses the original object: the Frame of a DataFrame is copied,
+ * sharing its pixel buffer (see DataFrame::CopyFrame()), and any other Data is
+ * returned as it is.
+ *
+ * @param[in]   p_pData     Data to be copied.
+ *
+ * @return the copy of the Data.
+ */
+inline DataPtr g_SnapshotData(const DataPtr& p_pData)
+{
+    DataFramePtr    l_pFrame;
+    DataFramePtr    l_pResult;
+
+    l_pFrame = DYNAMIC_PTR_CAST<DataFrame>(p_pData);
+
+    if (!l_pFrame)
+    {
+        return p_pData;
+    }
+
+    l_pResult.reset(new DataFrame);
+    l_pResult->CopyProperties(*l_pFrame);
+    l_pResult->CopyFrame(*l_pFrame);
+
+    return l_pResult;
+}
+
+/** @brief Global function that reads the timestamp of a DataFrame, from its
+ * Metadata.
+ *
+ * @param[in]   p_pData         Input Data.
+ * @param[out]  p_rllTimestamp  Timestamp (UTC us). Unchanged if the Data is
+ *                              not a DataFrame.
+ *
+ * @return false if the Data is not a DataFrame.
+ */
+inline bool g_GetDataTimestamp(const DataPtr&  p_pData,
+                               long long&      p_rllTimestamp)
+{
+    DataFramePtr    l_pFrame;
+
+    l_pFrame = DYNAMIC_PTR_CAST<DataFrame>(p_pData);
+
+    if (!l_pFrame)
+    {
+        return false;
+    }
+
+    LOCK_READ(&l_pFrame->m_Mutex, l_Lock);
+
+    p_rllTimestamp = l_pFrame->GetMetadata().m_llTimestamp;
+
+    return true;
+}
+
 } // end namespace fby.
 
 DATA_WRAPPER(std::list<fby::Frame>, DataFrameList, m_lFrames);
@@ -0,0 +1,413 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+/**
+ * @file FramePool.h
+ *
+ * @brief Contains the FramePool class, which recycles the pixel buffers of the
+ * Frame objects exchanged along a pipeline.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <core_app_pch.h>
+
+/** Alignment (bytes) of the buffers and of the line width of the frames
+ * allocated by a FramePool. */
+#define FRAME_POOL_ALIGNMENT        64
+
+/** Default maximum number of free buffers of each size kept by a
+ * FramePool. */
+#define FRAME_POOL_DEFAULT_MAX_FREE 16
+
+/** Default maximum number of bytes held by the free buffers of a FramePool,
+ * over all the buffer sizes (256 MB). */
+#define FRAME_POOL_DEFAULT_MAX_FREE_BYTES   (Q_INT64_C(256) << 20)
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @struct FramePoolStats
+ *
+ * @brief Counters of a FramePool.
+ */
+struct FramePoolStats
+{
+    FramePoolStats()
+        : m_llHits(0),
+          m_llMisses(0),
+          m_iInUse(0),
+          m_iHighWater(0),
+          m_iFree(0),
+          m_llFreeBytes(0),
+          m_llAllocatedBytes(0)
+    {
+        /* Empty. */
+    }
+
+    qint64  m_llHits; /**< Number of requests served with a recycled buffer. */
+
+    qint64  m_llMisses; /**< Number of requests that required an allocation. */
+
+    int     m_iInUse; /**< Number of buffers currently referenced. */
+
+    int     m_iHighWater; /**< Maximum value reached by m_iInUse. */
+
+    int     m_iFree; /**< Number of buffers waiting to be recycled. */
+
+    qint64  m_llFreeBytes; /**< Bytes held by the buffers waiting to be
+                            * recycled. */
+
+    qint64  m_llAllocatedBytes; /**< Bytes currently allocated by the pool,
+                                 * both in use and free. */
+
+}; // end struct FramePoolStats.
+
+/******************************************************************************/
+/**
+ * @class FramePoolStorage
+ *
+ * @brief Shared state of a FramePool. It is referenced by the FramePool and by
+ * every FrameBuffer it has handed out, so that a buffer released after the
+ * destruction of its FramePool is still freed correctly.
+ *
+ * @note This class is an implementation detail of FramePool.
+ */
+class FramePoolStorage : public FrameBufferReleaser
+{
+public:
+
+    FramePoolStorage(const int      p_iMaxFree,
+                     const qint64   p_llMaxFreeBytes)
+        : m_iMaxFree(p_iMaxFree),
+          m_llMaxFreeBytes(p_llMaxFreeBytes),
+          m_bClosed(false)
+    {
+        /* Empty. */
+    }
+
+    virtual ~FramePoolStorage()
+    {
+        _FreeAll();
+    }
+
+    /**
+     * @brief Acquire returns a buffer of the specified size, recycling a free
+     * one if available.
+     *
+     * @param[in]   p_sSize     Size of the buffer (bytes).
+     *
+     * @return the pointer to the aligned storage.
+     */
+    uint8_t* Acquire(const size_t p_sSize)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+        uint8_t*        l_pucResult;
+
+        std::map<size_t, std::vector<uint8_t*> >::iterator  l_it;
+
+        l_pucResult = NULL;
+
+        l_it = m_mapFree.find(p_sSize);
+
+        if (l_it != m_mapFree.end() && !MAP_VALUE(l_it).empty())
+        {
+            l_pucResult = MAP_VALUE(l_it).back();
+            MAP_VALUE(l_it).pop_back();
+
+            m_Stats.m_iFree--;
+            m_Stats.m_llFreeBytes -= p_sSize;
+            m_Stats.m_llHits++;
+        }
+        else
+        {
+            l_pucResult = _AlignedAlloc(p_sSize);
+
+            m_Stats.m_llAllocatedBytes += p_sSize;
+            m_Stats.m_llMisses++;
+        }
+
+        m_Stats.m_iInUse++;
+        m_Stats.m_iHighWater = std::max(m_Stats.m_iHighWater,
+                                        m_Stats.m_iInUse);
+
+        return l_pucResult;
+    }
+
+    /**
+     * @brief Close frees the free buffers and makes the buffers still in use
+     * be freed, instead of recycled, when they are released.
+     */
+    void Close()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_bClosed = true;
+
+        _FreeAll();
+    }
+
+    /**
+     * @brief Trim frees all the buffers waiting to be recycled.
+     */
+    void Trim()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        _FreeAll();
+    }
+
+    /**
+     * @return a copy of the current counters.
+     */
+    FramePoolStats GetStats() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return m_Stats;
+    }
+
+    /**
+     * @brief Release recycles a buffer that is no longer referenced.
+     */
+    virtual void Release(uint8_t*       p_pucData,
+                         const size_t   p_sSize)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        std::vector<uint8_t*>&  l_rvFree = m_mapFree[p_sSize];
+
+        m_Stats.m_iInUse--;
+
+        if (!m_bClosed &&
+            l_rvFree.size() < static_cast<size_t>(m_iMaxFree) &&
+            m_Stats.m_llFreeBytes + static_cast<qint64>(p_sSize) <=
+            m_llMaxFreeBytes)
+        {
+            l_rvFree.push_back(p_pucData);
+
+            m_Stats.m_iFree++;
+            m_Stats.m_llFreeBytes += p_sSize;
+        }
+        else
+        {
+            _AlignedFree(p_pucData);
+
+            m_Stats.m_llAllocatedBytes -= p_sSize;
+        }
+    }
+
+protected:
+
+    /**
+     * @brief _AlignedAlloc allocates FRAME_POOL_ALIGNMENT-aligned storage.
+     * The pointer returned by malloc is stored right before the aligned
+     * address.
+     */
+    static uint8_t* _AlignedAlloc(const size_t p_sSize)
+    {
+        uint8_t*    l_pucRaw;
+        uintptr_t   l_uiAligned;
+
+        l_pucRaw = static_cast<uint8_t*>(
+                    malloc(p_sSize + FRAME_POOL_ALIGNMENT + sizeof(void*)));
+
+        if (!l_pucRaw)
+        {
+            throw std::bad_alloc();
+        }
+
+        l_uiAligned = reinterpret_cast<uintptr_t>(l_pucRaw + sizeof(void*));
+        l_uiAligned = (l_uiAligned + FRAME_POOL_ALIGNMENT - 1) &
+                      ~static_cast<uintptr_t>(FRAME_POOL_ALIGNMENT - 1);
+
+        reinterpret_cast<void**>(l_uiAligned)[-1] = l_pucRaw;
+
+        return reinterpret_cast<uint8_t*>(l_uiAligned);
+    }
+
+    /**
+     * @brief _AlignedFree frees a storage allocated by _AlignedAlloc.
+     */
+    static void _AlignedFree(uint8_t* p_pucData)
+    {
+        if (p_pucData)
+        {
+            free(reinterpret_cast<void**>(p_pucData)[-1]);
+        }
+    }
+
+    /**
+     * @brief _FreeAll frees the buffers waiting to be recycled.
+     *
+     * @warning m_Mutex must be locked by the caller, or the object must be
+     * being destroyed.
+     */
+    void _FreeAll()
+    {
+        std::map<size_t, std::vector<uint8_t*> >::iterator  l_it;
+        size_t                                              l_s;
+
+        FORALL(m_mapFree, l_it)
+        {
+            for (l_s = 0; l_s < MAP_VALUE(l_it).size(); l_s++)
+            {
+                _AlignedFree(MAP_VALUE(l_it)[l_s]);
+
+                m_Stats.m_llAllocatedBytes -= MAP_KEY(l_it);
+            }
+        }
+
+        m_mapFree.clear();
+        m_Stats.m_iFree = 0;
+        m_Stats.m_llFreeBytes = 0;
+    }
+
+protected:
+
+    mutable QMutex  m_Mutex;
+
+    std::map<size_t, std::vector<uint8_t*> >    m_mapFree; /**< Free buffers,
+                                                            * grouped by size. */
+
+    FramePoolStats  m_Stats; /**< Counters. */
+
+    const int   m_iMaxFree; /**< Maximum number of free buffers of each
+                             * size. */
+
+    const qint64    m_llMaxFreeBytes; /**< Maximum number of bytes held by
+                                       * the free buffers. */
+
+    bool    m_bClosed; /**< True after the FramePool has been destroyed. */
+
+}; // end class FramePoolStorage.
+
+DEF_PTR(FramePoolStorage);
+
+/******************************************************************************/
+/**
+ * @class FramePool
+ *
+ * @brief The FramePool class hands out pixel buffers for the DataFrame
+ * objects of a pipeline (see DataFrame::AllocFrame()) and recycles them. A
+ * buffer returns to the pool automatically when the last DataFrame (or
+ * FrameBufferPtr) that references it is released, so that a steady video
+ * stream does not allocate any memory once the pool is warm.
+ *
+ * The buffers are FRAME_POOL_ALIGNMENT-aligned and the line width of the
+ * frames is padded to a multiple of FRAME_POOL_ALIGNMENT, so that each row
+ * can be processed with aligned SIMD loads.
+ *
+ * The memory held by the free buffers is bounded both per buffer size (the
+ * number of free buffers of each size) and in total (the number of bytes of
+ * all the free buffers): a buffer released beyond either limit is freed. A
+ * pipeline shares one FramePool among its Modules (see
+ * Module::GetFramePool()), so that these limits apply to the whole pipeline
+ * rather than to each Module.
+ *
+ * @note The recycled buffers are not cleared.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class FramePool
+{
+public:
+
+    /**
+     * @brief Builds an empty FramePool.
+     *
+     * @param[in]   p_iMaxFree          Maximum number of free buffers of
+     *                                  each size kept for recycling.
+     * @param[in]   p_llMaxFreeBytes    Maximum number of bytes held by all
+     *                                  the free buffers. The buffers
+     *                                  released beyond either limit are
+     *                                  freed.
+     */
+    FramePool(const int     p_iMaxFree = FRAME_POOL_DEFAULT_MAX_FREE,
+              const qint64  p_llMaxFreeBytes =
+                            FRAME_POOL_DEFAULT_MAX_FREE_BYTES)
+        : m_pStorage(new FramePoolStorage(p_iMaxFree, p_llMaxFreeBytes))
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Destructor: frees the free buffers. The buffers still in use are
+     * freed when they are released.
+     */
+    ~FramePool()
+    {
+        m_pStorage->Close();
+    }
+
+    /**
+     * @brief Acquire returns a buffer of the specified size.
+     *
+     * @param[in]   p_sSize     Size of the buffer (bytes).
+     *
+     * @return the new buffer.
+     */
+    FrameBufferPtr Acquire(const size_t p_sSize)
+    {
+        return FrameBufferPtr(new FrameBuffer(m_pStorage->Acquire(p_sSize),
+                                              p_sSize,
+                                              m_pStorage));
+    }
+
+    /**
+     * @return a copy of the counters of this FramePool.
+     */
+    FramePoolStats GetStats() const
+    {
+        return m_pStorage->GetStats();
+    }
+
+    /**
+     * @brief Trim frees all the buffers waiting to be recycled, e.g. after a
+     * change of the frame size of the stream.
+     */
+    void Trim()
+    {
+        m_pStorage->Trim();
+    }
+
+    /**
+     * @return the line width (bytes) of a row of p_iWidth pixels, padded to a
+     * multiple of FRAME_POOL_ALIGNMENT.
+     */
+    static int GetPaddedLineWidth(const int p_iWidth,
+                                  const int p_iBytesPerPixel)
+    {
+        size_t  l_sLineWidth;
+
+        l_sLineWidth = static_cast<size_t>(p_iWidth) * p_iBytesPerPixel;
+
+        return static_cast<int>(((l_sLineWidth + FRAME_POOL_ALIGNMENT - 1) /
+                                 FRAME_POOL_ALIGNMENT) *
+                                FRAME_POOL_ALIGNMENT);
+    }
+
+private:
+
+    /* Non-copyable: FramePool objects are shared through FramePoolPtr. */
+    FramePool(const FramePool&);
+    FramePool& operator = (const FramePool&);
+
+protected:
+
+    FramePoolStoragePtr     m_pStorage; /**< Shared state. */
+
+}; // end class FramePool.
+
+DEF_PTR(FramePool);
+
+} // end namespace fby.
+
+#endif // FRAMEPOOL_H
@@ -11,23 +11,24 @@
  * @date 2015
  */
 
+#include <FramePool.h>
+#include <ModuleExecutor.h>
 #include <ModulePort.h>
+#include <ModuleProfiler.h>
+
+#ifndef WIN32
+#include <signal.h>
+#endif
 
 /******************************************************************************/
 /* Macros. */
 
-#define INIT_MAIN_TIMER_CONNECTION \
-connect(&m_timerMain,\
-    SIGNAL(timeout()),\
-    this,\
-    SLOT(slot_TimerTimeout()),\
-    Qt::QueuedConnection)
+/* The main timer and sig_Trigger reach the Module through _TimerTimeout()
+ * and _Triggered(), which run the thread function on the executor of the
+ * Module, if any (see Module::SetExecutor()). */
+#define INIT_MAIN_TIMER_CONNECTION  _ConnectMainTimer()
 
-#define INIT_TRIGGER_CONNECTION \
-connect(this,\
-        SIGNAL(sig_Trigger(int)),\
-        SLOT(slot_Triggered(int)),\
-        Qt::QueuedConnection);
+#define INIT_TRIGGER_CONNECTION     _ConnectTrigger();
 
 #define MODULE_ALLOC_FUN_DEC(name, exp) \
     extern "C"\
@@ -37,19 +38,29 @@ connect(this,\
 
 #define MODULE_ALLOC_FUN_STRING(name)  (QString("New") + #name)
 
+/* The Modules compiled into the application register their allocator (see
+ * ModuleRegistry). */
+#ifdef MODULE_LIBRARY_STATIC
+#define MODULE_STATIC_REGISTER(name)    MODULE_REGISTER(name)
+#else
+#define MODULE_STATIC_REGISTER(name)
+#endif
+
+/* The allocator initializes the new Module: it returns NULL if the license
+ * check or Init() fails. The initialized Module gets its execution state (see
+ * Module::InitExecution()). */
 #define MODULE_ALLOC_FUN_IMPL(name) \
 fby::Module* New##name(fby::ModuleExecMode p_Mode) \
 { \
    fby::Module*     l_pResult = new name(p_Mode); \
    if (l_pResult) \
    {\
-      if (l_pResult->CheckLicense() == true) \
+      if (l_pResult->CheckLicense() == true && \
+          (p_Mode == fby::MODULE_MODE_CHECK || \
+           l_pResult->Init(p_Mode) == fby::RET_SUCCESS)) \
       { \
-         if (p_Mode != fby::MODULE_MODE_CHECK) \
-         {\
-            l_pResult->Init(p_Mode);\
-         }\
          l_pResult->InitOptions();\
+         l_pResult->InitExecution();\
       } \
       else \
       { \
@@ -58,14 +69,23 @@ fby::Module* New##name(fby::ModuleExecMode p_Mode) \
        } \
    }\
    return l_pResult; \
-}
+} \
+MODULE_STATIC_REGISTER(name)
+
+/* Locks m_Mutex like LOCK_READ/LOCK_WRITE, recording the contended waits in
+ * the statistics of the Module (see Module::GetStats()). */
+#define LOCK_MODULE_READ(name) \
+    fby::ModuleProfiledLocker name(&m_Mutex, &_State()->m_Profiler, false)
+
+#define LOCK_MODULE_WRITE(name) \
+    fby::ModuleProfiledLocker name(&m_Mutex, &_State()->m_Profiler, true)
 
 #define INPUT_DATA(res, id) \
    {\
-      LOCK_READ(&m_Mutex, l_LockInputData);\
-      if (id >= 0 && id < m_lPortIn.size())\
+      fby::ModulePort* l_pPortInputData = _PortIn(id);\
+      if (l_pPortInputData)\
       {\
-         res = LIST_AT(m_lPortIn, id)->GetData();\
+         res = l_pPortInputData->GetData();\
       }\
       else\
       {\
@@ -73,24 +93,47 @@ fby::Module* New##name(fby::ModuleExecMode p_Mode) \
       }\
    }
 
+/* Gets the next Data received by an input port: to be used in place of
+ * INPUT_DATA with the queued ports (see ModulePort::EnableQueue()). Evaluates
+ * to true if a Data has been received, so that the queue can be drained with:
+ *
+ *     while (DEQUEUE_INPUT_DATA(l_pData, p_iPortId)) { ... }
+ */
+#define DEQUEUE_INPUT_DATA(res, id)     _DequeueInput(id, res)
+
 #define MODULE_STOP_NO_WAIT         -1
+
+/** Type of the events that post an execution of a Module to its thread (see
+ * Module::_Post()). They are only sent to the ModuleState objects. */
+#define MODULE_POST_EVENT_TYPE \
+    static_cast<QEvent::Type>(QEvent::User + 1)
+
+/** Maximum decimation of a Module that sheds load (see
+ * MODULE_DEADLINE_DECIMATE). */
+#define MODULE_DEADLINE_MAX_DECIMATION  8
+
 #define NOTIFY_OUTPUT(id) \
     {\
-        if (id < m_lPortOut.size()) \
+        fby::ModulePort* l_pPortNotifyOutput = _PortOut(id);\
+        if (l_pPortNotifyOutput) \
         {\
-            LIST_AT(m_lPortOut, id)->NotifyOut();\
+            l_pPortNotifyOutput->Notify();\
         }\
     }
-FIXME // ADD A LOCKING MECHANISM IN NOTIFY_OUTPUT(id)
-
-#define TIMER_EVENT_PORT_ID         -1
-#define TRIGGERED_EVENT_PORT_ID     -2
 
 namespace fby
 {
 /* Forward declarations. */
 class CORE_APP_EXPORT Module;
 DEF_PTR(Module);
+class ModuleState;
+class ModuleStrand;
+class ModuleInputListener;
+DEF_PTR(ModuleInputListener);
+class ModuleSchedule;
+class ModuleAsync;
+class CORE_APP_EXPORT SharedLib;
+DEF_PTR(SharedLib);
 typedef std::list<ModulePtr>    ModuleList;
 typedef QUuid                   ModuleId;
 
@@ -133,6 +176,23 @@ enum ModuleFlag
 
 }; // end enum ModuleFlag.
 
+/******************************************************************************/
+/**
+ * @enum ModuleDeadlinePolicy
+ *
+ * @brief Enumerates the behaviors of a Module whose executions would miss
+ * their deadline (see Module::SetDeadline()).
+ */
+enum ModuleDeadlinePolicy
+{
+    MODULE_DEADLINE_REPORT = 0, /**< Run anyway, only count the misses. */
+    MODULE_DEADLINE_SKIP,       /**< Skip the executions that would miss. */
+    MODULE_DEADLINE_DECIMATE    /**< Run one execution out of N, with N
+                                 * doubled on each miss and decreased on
+                                 * each execution in time. */
+
+}; // end enum ModuleDeadlinePolicy.
+
 /******************************************************************************/
 /**
  * @class SharedLib
@@ -154,13 +214,547 @@ public:
     SharedLib(const QString& p_rstrFilename);
     virtual ~SharedLib();
 
+    /**
+     * @brief LoadCopy loads a private copy of a shared library, made in the
+     * temporary folder. The dynamic loader returns the library already loaded
+     * when the same file is loaded again, so a library rebuilt in place can
+     * only be loaded next to the running one through a copy (see
+     * ModuleManager::Reload()).
+     *
+     * The copy is deleted when the returned object is destroyed, after the
+     * library has been unloaded. The copies left by the processes that did
+     * not exit cleanly are deleted by the next LoadCopy() of the same
+     * library (see RemoveStaleCopies()).
+     *
+     * @param[in]   p_rstrFilename  Shared library to be copied.
+     *
+     * @return the loaded copy, or a null object if it cannot be loaded.
+     */
+    static SharedLibPtr LoadCopy(const QString& p_rstrFilename);
+
+    /**
+     * @brief RemoveStaleCopies deletes the copies of a shared library made by
+     * LoadCopy() in the processes that are no longer running. The copies of
+     * the running processes, this one included, are left alone: on Unix they
+     * may have been loaded but not yet unlinked by LoadCopy().
+     *
+     * @param[in]   p_rstrFilename  Shared library.
+     */
+    static void RemoveStaleCopies(const QString& p_rstrFilename);
+
+protected:
+
+    /**
+     * @return true if the process with the input id is running, or if it
+     * cannot be told (e.g. a process of another user on Windows).
+     */
+    static bool _IsProcessRunning(const qint64 p_llPid);
+
 public:
 
     QLibrary    m_SharedLibrary;
 
 }; // end class SharedLib.
 
-DEF_PTR(SharedLib);
+/******************************************************************************/
+/**
+ * @struct SharedLibCopyDeleter
+ *
+ * @brief Deleter of the SharedLib objects returned by SharedLib::LoadCopy():
+ * deletes the object, which unloads the library, then the copied file.
+ */
+struct SharedLibCopyDeleter
+{
+    SharedLibCopyDeleter(const QString& p_rsFileName)
+        : m_sFileName(p_rsFileName)
+    {
+        /* Empty. */
+    }
+
+    void operator()(SharedLib* p_pSharedLib) const
+    {
+        delete p_pSharedLib;
+
+        QFile::remove(m_sFileName);
+    }
+
+    QString m_sFileName; /**< Copy of the shared library. */
+};
+
+/******************************************************************************/
+inline SharedLibPtr SharedLib::LoadCopy(const QString& p_rstrFilename)
+{
+    QFileInfo       l_Info(p_rstrFilename);
+    QString         l_sCopy;
+    SharedLibPtr    l_pSharedLib;
+    int             l_i;
+
+    RemoveStaleCopies(p_rstrFilename);
+
+    for (l_i = 0; l_sCopy.isEmpty() || QFile::exists(l_sCopy); l_i++)
+    {
+        l_sCopy = QDir(QDir::tempPath()).absoluteFilePath(
+                    QString("%1_%2_%3_%4.%5")
+                        .arg(l_Info.completeBaseName())
+                        .arg(QCoreApplication::applicationPid())
+                        .arg(QDateTime::currentMSecsSinceEpoch())
+                        .arg(l_i)
+                        .arg(l_Info.suffix()));
+    }
+
+    if (!QFile::copy(l_Info.absoluteFilePath(), l_sCopy))
+    {
+        qWarning() << "SharedLib: cannot copy" << p_rstrFilename;
+
+        return SharedLibPtr();
+    }
+
+    l_pSharedLib.reset(new SharedLib(l_sCopy), SharedLibCopyDeleter(l_sCopy));
+
+    if (!l_pSharedLib->m_SharedLibrary.load())
+    {
+        qWarning() << "SharedLib: cannot load" << p_rstrFilename
+                   << l_pSharedLib->m_SharedLibrary.errorString();
+
+        l_pSharedLib.reset();
+    }
+
+    /* A loaded library stays mapped on Unix and the file can go now; on
+     * Windows the file is locked and is deleted by SharedLibCopyDeleter. */
+    QFile::remove(l_sCopy);
+
+    return l_pSharedLib;
+}
+
+/******************************************************************************/
+inline void SharedLib::RemoveStaleCopies(const QString& p_rstrFilename)
+{
+    QFileInfo       l_Info(p_rstrFilename);
+    QDir            l_Dir(QDir::tempPath());
+    QStringList     l_lCopies;
+    qint64          l_llPid;
+    bool            l_bPid;
+    int             l_i;
+
+    /* Copies are named <name>_<pid>_<time>_<index>.<suffix>. */
+    l_lCopies = l_Dir.entryList(
+                QStringList() << QString("%1_*_*_*.%2")
+                                    .arg(l_Info.completeBaseName())
+                                    .arg(l_Info.suffix()),
+                QDir::Files);
+
+    for (l_i = 0; l_i < l_lCopies.size(); l_i++)
+    {
+        l_llPid = l_lCopies[l_i].section("_", -3, -3).toLongLong(&l_bPid);
+
+        if (l_bPid && !_IsProcessRunning(l_llPid))
+        {
+            QFile::remove(l_Dir.absoluteFilePath(l_lCopies[l_i]));
+        }
+    }
+}
+
+/******************************************************************************/
+inline bool SharedLib::_IsProcessRunning(const qint64 p_llPid)
+{
+    if (p_llPid == QCoreApplication::applicationPid())
+    {
+        return true;
+    }
+
+#ifdef WIN32
+    HANDLE  l_hProcess;
+    DWORD   l_dwExitCode;
+    bool    l_bRunning;
+
+    l_hProcess = OpenProcess(PROCESS_QUERY_INFORMATION,
+                             FALSE,
+                             static_cast<DWORD>(p_llPid));
+
+    if (!l_hProcess)
+    {
+        return (GetLastError() == ERROR_ACCESS_DENIED);
+    }
+
+    l_bRunning = (!GetExitCodeProcess(l_hProcess, &l_dwExitCode) ||
+                  l_dwExitCode == STILL_ACTIVE);
+
+    CloseHandle(l_hProcess);
+
+    return l_bRunning;
+#else
+    /* EPERM: the process exists but belongs to another user. */
+    return (kill(static_cast<pid_t>(p_llPid), 0) == 0 || errno != ESRCH);
+#endif
+}
+
+/******************************************************************************/
+/**
+ * @class ModuleCloser
+ *
+ * @brief Holds an object that calls back a Module (e.g. a strand or a port
+ * listener) and closes it on destruction, so that the object does not call
+ * the Module after the Module has been destroyed.
+ */
+template <typename T>
+class ModuleCloser
+{
+public:
+
+    ModuleCloser()
+    {
+        /* Empty. */
+    }
+
+    ~ModuleCloser()
+    {
+        Reset();
+    }
+
+    /**
+     * @return the held object.
+     */
+    inline SHARED_PTR<T> Get() const
+    {
+        return m_pObject;
+    }
+
+    /**
+     * @brief Exchange holds the input object and returns the previous one
+     * without closing it.
+     */
+    SHARED_PTR<T> Exchange(SHARED_PTR<T> p_pObject)
+    {
+        SHARED_PTR<T>   l_pResult;
+
+        l_pResult = m_pObject;
+        m_pObject = p_pObject;
+
+        return l_pResult;
+    }
+
+    /**
+     * @brief Reset closes the held object and holds the input one.
+     */
+    void Reset(SHARED_PTR<T> p_pObject = SHARED_PTR<T>())
+    {
+        if (m_pObject)
+        {
+            m_pObject->Close();
+        }
+
+        m_pObject = p_pObject;
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleCloser(const ModuleCloser&);
+    ModuleCloser& operator = (const ModuleCloser&);
+
+protected:
+
+    SHARED_PTR<T>   m_pObject; /**< Held object. */
+
+}; // end class ModuleCloser.
+
+/******************************************************************************/
+/**
+ * @class ModuleDeadline
+ *
+ * @brief Scheduling parameters of a Module (priority, deadline and shedding
+ * policy) and the decimation state of its executions. The parameters can be
+ * set from any thread; Admit() and Complete() are only called by the
+ * executions of the Module, which never overlap.
+ */
+class ModuleDeadline
+{
+public:
+
+    ModuleDeadline()
+        : m_iPriority(MODULE_PRIORITY_NORMAL),
+          m_iDeadline_ms(0),
+          m_iPolicy(MODULE_DEADLINE_REPORT),
+          m_iDecimation(1),
+          m_iCount(0)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Admit decides whether an execution runs or is shed.
+     *
+     * @param[in]   p_llWait_ns     Time the execution has waited.
+     * @param[in]   p_rProfiler     Statistics of the Module, for the expected
+     *                              duration of the execution.
+     *
+     * @return false if the execution must be shed.
+     */
+    bool Admit(const qint64 p_llWait_ns, const ModuleProfiler& p_rProfiler)
+    {
+        qint64  l_llDeadline_ns;
+
+        l_llDeadline_ns = static_cast<qint64>(m_iDeadline_ms.load()) * 1000000;
+
+        switch (m_iPolicy.load())
+        {
+        case MODULE_DEADLINE_SKIP:
+
+            return (l_llDeadline_ns <= 0 ||
+                    p_llWait_ns + p_rProfiler.GetMeanLatency_ns() <=
+                        l_llDeadline_ns);
+
+        case MODULE_DEADLINE_DECIMATE:
+
+            if (++m_iCount < m_iDecimation)
+            {
+                return false;
+            }
+
+            m_iCount = 0;
+
+            return true;
+
+        default:
+
+            return true;
+        }
+    }
+
+    /**
+     * @brief Complete records the end of an execution and adapts the
+     * decimation.
+     *
+     * @param[in]   p_llElapsed_ns  Wait plus duration of the execution.
+     *
+     * @return true if the execution has missed its deadline.
+     */
+    bool Complete(const qint64 p_llElapsed_ns)
+    {
+        qint64  l_llDeadline_ns;
+        bool    l_bMissed;
+
+        l_llDeadline_ns = static_cast<qint64>(m_iDeadline_ms.load()) * 1000000;
+        l_bMissed = (l_llDeadline_ns > 0 && p_llElapsed_ns > l_llDeadline_ns);
+
+        if (m_iPolicy.load() != MODULE_DEADLINE_DECIMATE)
+        {
+            m_iDecimation = 1;
+        }
+        else if (l_bMissed)
+        {
+            m_iDecimation = std::min(2 * m_iDecimation,
+                                     MODULE_DEADLINE_MAX_DECIMATION);
+        }
+        else if (m_iDecimation > 1)
+        {
+            m_iDecimation--;
+        }
+
+        return l_bMissed;
+    }
+
+    /** @return true if a deadline is set. */
+    inline bool IsEnabled() const
+    {
+        return (m_iDeadline_ms.load() > 0);
+    }
+
+    QAtomicInt  m_iPriority; /**< Priority (see ModulePriority). */
+
+    QAtomicInt  m_iDeadline_ms; /**< Deadline of an execution, from the
+                                 * notification of its input port (0: no
+                                 * deadline). */
+
+    QAtomicInt  m_iPolicy; /**< Shedding policy (see ModuleDeadlinePolicy). */
+
+protected:
+
+    int     m_iDecimation; /**< Current decimation (1: none). */
+
+    int     m_iCount; /**< Counter of the decimated executions. */
+
+}; // end class ModuleDeadline.
+
+/******************************************************************************/
+/**
+ * @class ModuleStatsSource
+ *
+ * @brief Interface of the Modules that manage other Modules (e.g.
+ * ModuleReplicas): Module::CollectStats() appends the statistics of the
+ * managed Modules after those of the container.
+ */
+class ModuleStatsSource
+{
+public:
+
+    virtual ~ModuleStatsSource()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief CollectManagedStats appends the execution statistics of the
+     * managed Modules to the input list (see Module::CollectStats()).
+     *
+     * @param[in,out]   p_rlStats   List of statistics.
+     */
+    virtual void CollectManagedStats(ModuleStatsList& p_rlStats) const = 0;
+
+}; // end class ModuleStatsSource.
+
+/******************************************************************************/
+/**
+ * @class ModulePostEvent
+ *
+ * @brief Event that requests an execution of a Module in its thread (see
+ * Module::_Post()).
+ */
+class ModulePostEvent : public QEvent
+{
+public:
+
+    ModulePostEvent(const int p_iPortId)
+        : QEvent(MODULE_POST_EVENT_TYPE),
+          m_iPortId(p_iPortId)
+    {
+        /* Empty. */
+    }
+
+    int     m_iPortId; /**< Id of the triggered port. */
+
+}; // end class ModulePostEvent.
+
+/******************************************************************************/
+/**
+ * @class ModuleState
+ *
+ * @brief Execution state of a Module: statistics, executor, deadline, frame
+ * pool and port tables. The state is attached to its Module (see g_Attach())
+ * rather than held by it, so that the layout of the Module class exported by
+ * the core_app library does not change. It lives in the thread of its Module
+ * and receives the executions posted to that thread (see Module::_Post()).
+ *
+ * The state is destroyed by ~QObject(), after the destructors of the Module
+ * classes: the Modules run by an executor or linked directly close it first
+ * (see Module::_CloseExecution()).
+ */
+class ModuleState : public QObject
+{
+public:
+
+    ModuleState(Module* p_pModule)
+        : m_pModule(p_pModule)
+    {
+        /* Empty. */
+    }
+
+    virtual ~ModuleState();
+
+    virtual bool event(QEvent* p_pEvent);
+
+    /**
+     * @brief Post requests an execution of the thread function of the Module:
+     * posts it to the executor, if any, or queues it to the thread of the
+     * Module as a ModulePostEvent. No lock of the Module is taken, so that a
+     * producer notifying the Module never waits for its thread function.
+     *
+     * @param[in]   p_iPortId   Id of the triggered port.
+     */
+    void Post(const int p_iPortId)
+    {
+        ModuleExecutorPtr       l_pExecutor;
+        ModuleExecutorStrandPtr l_pStrand;
+
+        {
+            LOCK_READ(&m_MutexExecution, l_Lock);
+
+            l_pExecutor = m_pExecutor;
+            l_pStrand = m_Strand.Get();
+        }
+
+        if (l_pExecutor)
+        {
+            l_pExecutor->Post(l_pStrand, p_iPortId);
+        }
+        else
+        {
+            QCoreApplication::postEvent(this, new ModulePostEvent(p_iPortId));
+        }
+    }
+
+    /**
+     * @return the port of a locked port list with the specified id, or NULL.
+     * The table that indexes the list by id is built by the first call.
+     */
+    inline ModulePort* PortAt(const ModulePortList&    p_rlPorts,
+                              ModulePortVector&        p_rvTable,
+                              QAtomicInt&              p_riIndexed,
+                              const int                p_iPortId)
+    {
+        if (!p_riIndexed.loadAcquire())
+        {
+            QMutexLocker    l_Lock(&m_MutexPortTables);
+
+            if (!p_riIndexed.load())
+            {
+                p_rvTable.assign(p_rlPorts.begin(), p_rlPorts.end());
+
+                p_riIndexed.storeRelease(1);
+            }
+        }
+
+        if (p_iPortId >= 0 &&
+            p_iPortId < static_cast<int>(p_rvTable.size()))
+        {
+            return GET_PTR(p_rvTable[p_iPortId]);
+        }
+
+        return NULL;
+    }
+
+    Module*     m_pModule; /**< Owner Module. */
+
+    ModuleProfiler  m_Profiler; /**< Execution statistics. */
+
+    ModuleExecutorPtr   m_pExecutor; /**< Executor that runs the Module. */
+
+    ModuleDeadline  m_Deadline; /**< Priority and deadline of the executions. */
+
+    FramePoolPtr    m_pFramePool; /**< Pool of the frames emitted by the
+                                   * Module. */
+
+    QMutex  m_MutexFramePool; /**< Protects m_pFramePool. */
+
+    ModulePortVector    m_vPortIn; /**< Table of the input ports, indexed by
+                                    * port id (see Module::_PortIn()). */
+
+    ModulePortVector    m_vPortOut; /**< Table of the output ports, indexed
+                                     * by port id (see Module::_PortOut()). */
+
+    QAtomicInt  m_iPortInIndexed; /**< Non-zero once m_vPortIn has been
+                                   * built. */
+
+    QAtomicInt  m_iPortOutIndexed; /**< Non-zero once m_vPortOut has been
+                                    * built. */
+
+    QMutex  m_MutexPortTables; /**< Serializes the build of the port tables. */
+
+    mutable QReadWriteLock  m_MutexExecution; /**< Protects m_pExecutor,
+                                               * m_Strand and m_PortListener.
+                                               */
+
+    /* The objects that call back the Module are declared last, so that they
+     * are closed before the rest of the state is destroyed. */
+
+    ModuleCloser<ModuleExecutorStrand>  m_Strand; /**< Serializes the
+                                                   * executions of the Module
+                                                   * on m_pExecutor. */
+
+    ModuleCloser<ModuleInputListener>   m_PortListener; /**< Port listener of
+                                                         * the Module. */
+
+}; // end class ModuleState.
 
 /******************************************************************************/
 
@@ -182,6 +776,11 @@ class CORE_APP_EXPORT Module : public QObject
 {
     Q_OBJECT
 
+    friend class ModuleState;
+    friend class ModuleStrand;
+    friend class ModuleSchedule;
+    friend class ModuleAsync;
+
     GET_SET_OPTIONS;
 
     /**
@@ -274,25 +873,95 @@ public:
     virtual RetFlag AddOutput(QList<DataPtr>&   p_rlData);
 
     /**
-     * @brief Changes the loop time of the main timer. If this Module is
-     * running, the main-timer-id will be changed without stopping the loop.
-     * Otherwise nothing is done.
-     *
-     * @param[in]   p_iPeriod_ms    New loop time (ms).
-     */
-    virtual void ChangeLoopTime(const int p_iPeriod_ms);
-
-    /**
-     * @brief Checks the licensing of this module. Subclasses must implement
-     * their own licensing management.
+     * @brief AddTypedInput adds an input port that accepts only Data of class
+     * T and binds it to the input handle. The type of the linked output port
+     * is checked once by g_LinkModulesChecked(), then the Data are read
+     * through the handle without any cast.
      *
-     * @note The default implementation returns true.
+     * @param[out]  p_rInput    Handle of the new input port.
      *
-     * @return True if this module is licensed, or false otherwise.
+     * @return RET_SUCCESS if the new input port has been successfully added.
      */
-    virtual bool CheckLicense();
+    template <typename T>
+    RetFlag AddTypedInput(ModuleInput<T>& p_rInput)
+    {
+        ModulePortPtr   l_pPort;
 
-    /**
+        if (AddInput(1) != RET_SUCCESS)
+        {
+            return RET_ERROR;
+        }
+
+        l_pPort = GetPortIn(GetNumPortIn() - 1);
+
+        if (!l_pPort)
+        {
+            return RET_ERROR;
+        }
+
+        l_pPort->SetDataType(ModulePortTypePtr(new ModulePortTypeOf<T>));
+
+        _ConnectInputPort(GET_PTR(l_pPort));
+
+        p_rInput.m_pPort = l_pPort;
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief AddTypedOutput adds an output port associated to a Data of class
+     * T and binds it to the output handle.
+     *
+     * @param[out]  p_rOutput   Handle of the new output port.
+     * @param[in]   p_pData     Data associated to the new output port.
+     *
+     * @return RET_SUCCESS if the new output port has been successfully added.
+     */
+    template <typename T>
+    RetFlag AddTypedOutput(ModuleOutput<T>& p_rOutput, SHARED_PTR<T> p_pData)
+    {
+        ModulePortPtr   l_pPort;
+
+        if (!p_pData || AddOutput(DataPtr(p_pData)) != RET_SUCCESS)
+        {
+            return RET_ERROR;
+        }
+
+        l_pPort = GetPortOut(GetNumPortOut() - 1);
+
+        if (!l_pPort)
+        {
+            return RET_ERROR;
+        }
+
+        l_pPort->SetDataType(ModulePortTypePtr(new ModulePortTypeOf<T>));
+
+        p_rOutput.m_pPort = l_pPort;
+        p_rOutput.m_pData = p_pData;
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief Changes the loop time of the main timer. If this Module is
+     * running, the main-timer-id will be changed without stopping the loop.
+     * Otherwise nothing is done.
+     *
+     * @param[in]   p_iPeriod_ms    New loop time (ms).
+     */
+    virtual void ChangeLoopTime(const int p_iPeriod_ms);
+
+    /**
+     * @brief Checks the licensing of this module. Subclasses must implement
+     * their own licensing management.
+     *
+     * @note The default implementation returns true.
+     *
+     * @return True if this module is licensed, or false otherwise.
+     */
+    virtual bool CheckLicense();
+
+    /**
      * @brief Close performs a clean closure of this Module.
      *
      * @note The default implementation calls the Stop() method.
@@ -302,6 +971,68 @@ public:
      */
     virtual bool Close();
 
+    /**
+     * @brief CloseInputQueues closes the queues of the input ports of this
+     * Module (see ModulePort::CloseQueue()): the producers blocked on a full
+     * queue are woken and their blocking pushes discard the Data until
+     * OpenInputQueues() is called. To be called when this Module is stopped,
+     * so that it does not stall its producers.
+     */
+    void CloseInputQueues()
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+        ModulePortList::const_iterator  l_it;
+
+        FORALL(m_lPortIn, l_it)
+        {
+            (*l_it)->CloseQueue();
+        }
+    }
+
+    /**
+     * @brief CollectStats appends the execution statistics of this Module to
+     * the input list, followed by those of the Modules it manages if it is a
+     * ModuleStatsSource.
+     *
+     * @note Not virtual, so that the virtual table of the Module class, which
+     * is built into the core_app library, does not change.
+     *
+     * @param[in,out]   p_rlStats   List of statistics.
+     */
+    void CollectStats(ModuleStatsList& p_rlStats) const
+    {
+        const ModuleStatsSource*    l_pSource;
+
+        p_rlStats.push_back(ModuleStats());
+
+        GetStats(p_rlStats.back());
+
+        l_pSource = dynamic_cast<const ModuleStatsSource*>(this);
+
+        if (l_pSource)
+        {
+            l_pSource->CollectManagedStats(p_rlStats);
+        }
+    }
+
+    /**
+     * @return the deadline of the executions of this Module (ms), or 0 if it
+     * has no deadline.
+     */
+    inline int GetDeadline() const
+    {
+        return _State()->m_Deadline.m_iDeadline_ms.load();
+    }
+
+    /**
+     * @return the behavior of this Module when its deadline would be missed.
+     */
+    inline ModuleDeadlinePolicy GetDeadlinePolicy() const
+    {
+        return static_cast<ModuleDeadlinePolicy>(
+                    _State()->m_Deadline.m_iPolicy.load());
+    }
+
     /**
      * @return the current loop time in milliseconds. If this moduel is not
      * running, then returns a negative value.
@@ -324,12 +1055,42 @@ public:
      */
     virtual std::string GetName() const;
 
+    /**
+     * @return the executor that runs this Module, or a null object if this
+     * Module runs in its own thread.
+     */
+    inline ModuleExecutorPtr GetExecutor() const
+    {
+        ModuleState*    l_pState = _State();
+        LOCK_READ(&l_pState->m_MutexExecution, l_Lock);
+
+        return l_pState->m_pExecutor;
+    }
+
+    /**
+     * @return the FramePool of the pipeline this Module belongs to (see
+     * SetFramePool()). A Module that has not been given one gets a private
+     * pool on the first call.
+     */
+    inline FramePoolPtr GetFramePool()
+    {
+        ModuleState*    l_pState = _State();
+        QMutexLocker    l_Lock(&l_pState->m_MutexFramePool);
+
+        if (!l_pState->m_pFramePool)
+        {
+            l_pState->m_pFramePool.reset(new FramePool());
+        }
+
+        return l_pState->m_pFramePool;
+    }
+
     /**
      * @return the number of output ports.
      */
     inline int GetNumPortIn() const
     {
-        return m_lPortIn.size();
+        return static_cast<int>(m_lPortIn.size());
     }
 
     /**
@@ -337,9 +1098,20 @@ public:
      */
     inline int GetNumPortOut() const
     {
-        return m_lPortOut.size();
+        return static_cast<int>(m_lPortOut.size());
     }
 
+    /**
+     * @brief GetPortListener returns the listener that schedules an execution
+     * of this Module when an output port it is registered to notifies its Data
+     * (see g_LinkModulesDirect()). The execution is posted to the executor of
+     * this Module, or queued to the thread of this Module if it has no
+     * executor.
+     *
+     * @return the port listener of this Module.
+     */
+    ModulePortListenerPtr GetPortListener();
+
     /**
      * @param[in]  p_iPortId   Id of the requested input port.
      *
@@ -354,6 +1126,32 @@ public:
      */
     virtual ModulePortPtr GetPortOut(const int p_iPortId);
 
+    /**
+     * @return the priority of the executions of this Module.
+     */
+    inline ModulePriority GetPriority() const
+    {
+        return static_cast<ModulePriority>(
+                    _State()->m_Deadline.m_iPriority.load());
+    }
+
+    /**
+     * @brief GetStats returns the execution statistics of this Module: calls
+     * per trigger source, latency percentiles of the thread function, waits on
+     * m_Mutex and dropped notifications. Only the locks taken with
+     * LOCK_MODULE_READ and LOCK_MODULE_WRITE are measured.
+     *
+     * @param[out]  p_rStats    Statistics of this Module.
+     */
+    void GetStats(ModuleStats& p_rStats) const
+    {
+        p_rStats = ModuleStats();
+        p_rStats.m_sName = GetName();
+        p_rStats.m_Id = GetId();
+
+        _State()->m_Profiler.GetStats(p_rStats);
+    }
+
     /**
      * @return The status bar of this Module.
      */
@@ -411,6 +1209,20 @@ public:
      */
     virtual void InitOptions();
 
+    /**
+     * @brief InitExecution attaches the execution state of this Module (see
+     * ModuleState) and routes the signals of its input ports through
+     * _InputPortTriggered(), so that they reach the executor of this Module,
+     * if any. Called by MODULE_ALLOC_FUN_IMPL after Init(); the Modules built
+     * otherwise get it from SetExecutor() and from g_LinkModulesChecked().
+     */
+    void InitExecution()
+    {
+        _State();
+
+        _ConnectInputPorts();
+    }
+
     /**
      * @brief Initializes the threading data of this module.
      *
@@ -441,6 +1253,11 @@ public:
      * @note If more than one output port share the same DataPtr, all that ports
      * will be notified.
      *
+     * @note The ports are notified through ModulePort::NotifyOut(), which only
+     * emits the Qt signals: the queued and the direct links (see
+     * g_LinkModulesDirect()) are served by NOTIFY_OUTPUT() and
+     * ModuleOutput::Notify().
+     *
      * @param[in]   p_pData     Input data whose respective output ports has
      *                          to be notified.
      *
@@ -449,6 +1266,21 @@ public:
      */
     virtual bool NotifyOutput(DataPtr p_pData);
 
+    /**
+     * @brief OpenInputQueues re-enables the blocking pushes on the queues of
+     * the input ports of this Module after CloseInputQueues().
+     */
+    void OpenInputQueues()
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+        ModulePortList::const_iterator  l_it;
+
+        FORALL(m_lPortIn, l_it)
+        {
+            (*l_it)->OpenQueue();
+        }
+    }
+
     /**
      * @brief Pauses this module by skipping the execution of the thread
      * function. This behavior is obtained by setting the pause-flag.
@@ -464,6 +1296,127 @@ public:
      */
     virtual void SetContinueThread(const bool p_bContinueThread);
 
+    /**
+     * @brief ResetStats clears the execution statistics of this Module.
+     */
+    void ResetStats()
+    {
+        _State()->m_Profiler.Reset();
+    }
+
+    /**
+     * @brief SetDeadline sets the deadline of the executions triggered by the
+     * input ports: the time from the notification of the port to the end of
+     * the thread function. The executions that end late are counted in
+     * ModuleStats::m_llDeadlineMisses; the policy decides how this Module
+     * sheds load when its deadline would be missed.
+     *
+     * @note The wait before an execution is only measured when this Module
+     * is run by an executor, and MODULE_DEADLINE_SKIP only predicts the
+     * duration of an execution when the profiler is enabled.
+     *
+     * @param[in]   p_iDeadline_ms  Deadline (ms), or 0 to remove it.
+     * @param[in]   p_Policy        Behavior when the deadline would be missed.
+     */
+    void SetDeadline(const int              p_iDeadline_ms,
+                     ModuleDeadlinePolicy   p_Policy = MODULE_DEADLINE_REPORT)
+    {
+        ModuleState*    l_pState = _State();
+
+        l_pState->m_Deadline.m_iPolicy.store(p_Policy);
+        l_pState->m_Deadline.m_iDeadline_ms.store(std::max(p_iDeadline_ms, 0));
+    }
+
+    /**
+     * @brief SetExecutor makes the executions of the thread function of this
+     * Module run as tasks on the input executor, instead of in the thread of
+     * this Module. Two executions of the same Module never overlap. The
+     * executions requested before this call and still pending are discarded;
+     * the running one, if any, is waited for.
+     *
+     * @note A Module run by an executor does not need InitThread(). The main
+     * timer and the signals still reach this Module in the thread it lives in,
+     * which only forwards the execution to the executor.
+     *
+     * @warning Call SetExecutor(ModuleExecutorPtr()) before destroying a
+     * Module run by an executor, or call _CloseExecution() in the destructor
+     * of the Module class.
+     *
+     * @param[in]   p_pExecutor     Executor, or a null object to restore the
+     *                              execution in the thread of this Module.
+     */
+    void SetExecutor(ModuleExecutorPtr p_pExecutor);
+
+    /**
+     * @brief SetFramePool sets the FramePool the frames emitted by this
+     * Module are taken from, usually the one shared by all the Modules of a
+     * pipeline (see AppConsole), so that the limits on the free buffers of
+     * the pool apply to the whole pipeline rather than to each Module.
+     *
+     * @param[in]   p_pPool     Frame pool, or a null object to let this
+     *                          Module create its own.
+     */
+    inline void SetFramePool(FramePoolPtr p_pPool)
+    {
+        ModuleState*    l_pState = _State();
+        QMutexLocker    l_Lock(&l_pState->m_MutexFramePool);
+
+        l_pState->m_pFramePool = p_pPool;
+    }
+
+    /**
+     * @brief SetPriority sets the priority of the executions of this Module.
+     * On an executor the ready executions of higher priority run first (see
+     * ModuleExecutor). In the thread of this Module the priority is mapped to
+     * the priority of the thread (QThread::setPriority()), if it is running:
+     * call it again after InitThread() and Start().
+     */
+    void SetPriority(ModulePriority p_Priority)
+    {
+        ModuleExecutorStrandPtr     l_pStrand;
+        ModuleState*                l_pState;
+        QThread*                    l_pThread;
+
+        l_pState = _State();
+        l_pState->m_Deadline.m_iPriority.store(p_Priority);
+
+        {
+            LOCK_READ(&l_pState->m_MutexExecution, l_Lock);
+
+            l_pStrand = l_pState->m_Strand.Get();
+        }
+
+        if (l_pStrand)
+        {
+            l_pStrand->SetPriority(p_Priority);
+
+            return;
+        }
+
+        /* The main thread of the application is never changed. */
+        l_pThread = thread();
+
+        if (l_pThread && l_pThread->isRunning() &&
+            (!QCoreApplication::instance() ||
+             l_pThread != QCoreApplication::instance()->thread()))
+        {
+            switch (p_Priority)
+            {
+            case MODULE_PRIORITY_LOW:
+                l_pThread->setPriority(QThread::LowPriority);
+                break;
+
+            case MODULE_PRIORITY_HIGH:
+                l_pThread->setPriority(QThread::HighPriority);
+                break;
+
+            default:
+                l_pThread->setPriority(QThread::NormalPriority);
+                break;
+            }
+        }
+    }
+
     /**
      * @brief SetId sets the ID of this Module. The ID of a Module should be
      * unique in the application.
@@ -490,6 +1443,17 @@ public:
      */
     virtual RetFlag SetParentModule(ModulePtr p_pParent);
 
+    /**
+     * @brief SetProfilingEnabled enables or disables the timing of the
+     * executions of this Module. Enabled by default.
+     *
+     * @param[in]   p_bEnabled  Input flag.
+     */
+    void SetProfilingEnabled(const bool p_bEnabled)
+    {
+        _State()->m_Profiler.SetEnabled(p_bEnabled);
+    }
+
     /**
      * @brief SetSharedLib sets the SharedLib object linked to this Module.
      *
@@ -537,20 +1501,375 @@ public:
      */
     virtual void Trigger(int p_iPortId = TRIGGERED_EVENT_PORT_ID);
 
+    /**
+     * @brief WaitIdle waits until the input queues of this Module are empty
+     * and no execution is pending or running on its executor, e.g. to drain
+     * the Data in flight once its producers have been unlinked.
+     *
+     * @param[in]   p_iWait_ms  Maximum wait (ms). If negative waits forever.
+     *
+     * @return true if this Module is idle.
+     */
+    bool WaitIdle(const int p_iWait_ms = -1);
+
 protected:
 
+    /**
+     * @brief _ClearPendingInputs forgets the pending executions of the
+     * coalesced input ports, e.g. after they have been discarded.
+     */
+    void _ClearPendingInputs();
+
+    /**
+     * @brief _CloseExecution stops the executions of this Module: closes its
+     * input queues and its port listener, detaches it from its executor,
+     * waiting for the running execution, and discards the executions posted
+     * to its thread. The execution state outlives the destructors of the
+     * Module classes (see ModuleState): the Module classes that may be run by
+     * an executor or linked through g_LinkModulesDirect() call it first thing
+     * in their destructor.
+     */
+    void _CloseExecution();
+
+    /**
+     * @brief _ConnectInputPort routes the sig_In() signal of an input port
+     * through _InputPortTriggered() instead of slot_InputPortTriggered().
+     *
+     * @param[in]   p_pPort     Input port of this Module.
+     */
+    void _ConnectInputPort(ModulePort* p_pPort)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        disconnect(p_pPort,
+                   SIGNAL(sig_In(int)),
+                   this,
+                   SLOT(slot_InputPortTriggered(int)));
+
+        connect(p_pPort,
+                &ModulePort::sig_In,
+                this,
+                &Module::_InputPortTriggered,
+                QT_UNIQUE_AUTO_CONNECTION);
+#else
+        Q_UNUSED(p_pPort);
+#endif
+    }
+
+    /**
+     * @brief _ConnectInputPorts routes the signals of all the input ports
+     * (see _ConnectInputPort()).
+     */
+    void _ConnectInputPorts()
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+        ModulePortList::const_iterator  l_it;
+
+        FORALL(m_lPortIn, l_it)
+        {
+            _ConnectInputPort(GET_PTR((*l_it)));
+        }
+    }
+
+    /**
+     * @brief _ConnectMainTimer connects the main timer to _TimerTimeout() (see
+     * INIT_MAIN_TIMER_CONNECTION).
+     */
+    void _ConnectMainTimer()
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        connect(&m_timerMain,
+                &QTimer::timeout,
+                this,
+                &Module::_TimerTimeout,
+                Qt::QueuedConnection);
+#else
+        connect(&m_timerMain,
+                SIGNAL(timeout()),
+                this,
+                SLOT(slot_TimerTimeout()),
+                Qt::QueuedConnection);
+#endif
+    }
+
+    /**
+     * @brief _ConnectTrigger connects sig_Trigger() to _Triggered() (see
+     * INIT_TRIGGER_CONNECTION).
+     */
+    void _ConnectTrigger()
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        connect(this,
+                &Module::sig_Trigger,
+                this,
+                &Module::_Triggered,
+                Qt::QueuedConnection);
+#else
+        connect(this,
+                SIGNAL(sig_Trigger(int)),
+                SLOT(slot_Triggered(int)),
+                Qt::QueuedConnection);
+#endif
+    }
+
     /**
      * @return true if the thread of this Module has to be continued.
      */
     bool    _ContinueThread() const;
 
     /**
-     * @brief _LockInputPort locks the number of input ports.
+     * @brief _DequeueInput gets the next Data received by an input port. See
+     * ModulePort::PopData().
+     *
+     * @param[in]   p_iPortId   Id of the input port.
+     * @param[out]  p_rpData    Received Data, or a null object.
+     *
+     * @return true if a Data has been received.
+     */
+    inline bool _DequeueInput(const int p_iPortId, DataPtr& p_rpData)
+    {
+        ModulePort*     l_pPort;
+
+        l_pPort = _PortIn(p_iPortId);
+
+        if (l_pPort)
+        {
+            return l_pPort->PopData(p_rpData);
+        }
+
+        RELEASE_PTR(p_rpData);
+
+        return false;
+    }
+
+    /**
+     * @brief _Dispatch requests an execution of the thread function: posts it
+     * to the executor of this Module, if any, or runs it in the calling thread.
+     *
+     * @param[in]   p_iPortId   Id of the triggered port.
+     */
+    void _Dispatch(const int p_iPortId);
+
+    /**
+     * @brief _Execute runs the thread function, unless this Module is paused
+     * or closed or the execution is shed to meet the deadline, records its
+     * duration and emits sig_ThreadFunctionFinished.
+     *
+     * @param[in]   p_iPortId   Id of the triggered port.
+     * @param[in]   p_llWait_ns Time the execution has waited since the
+     *                          notification of the port, if known.
+     */
+    inline void _Execute(const int p_iPortId, const qint64 p_llWait_ns = 0)
+    {
+        QElapsedTimer   l_Timer;
+        ModuleState*    l_pState;
+        ModulePort*     l_pPort;
+        qint64          l_llLatency_ns;
+        bool            l_bDeadline;
+
+        l_pState = _State();
+
+        /* Let the coalesced port schedule a new execution from now on. */
+        if (p_iPortId >= 0)
+        {
+            l_pPort = _PortIn(p_iPortId);
+
+            if (l_pPort)
+            {
+                l_pPort->ClearPending();
+            }
+        }
+
+        if (m_bPause || m_bIsClosed)
+        {
+            l_pState->m_Profiler.RecordSkipped();
+
+            return;
+        }
+
+        l_bDeadline = (p_iPortId >= 0 && l_pState->m_Deadline.IsEnabled());
+
+        if (l_bDeadline &&
+            !l_pState->m_Deadline.Admit(p_llWait_ns, l_pState->m_Profiler))
+        {
+            l_pState->m_Profiler.RecordShed();
+
+            return;
+        }
+
+        if (l_pState->m_Profiler.IsEnabled() || l_bDeadline)
+        {
+            l_Timer.start();
+
+            _ThreadFunction(p_iPortId);
+
+            l_llLatency_ns = l_Timer.nsecsElapsed();
+
+            if (l_pState->m_Profiler.IsEnabled())
+            {
+                l_pState->m_Profiler.RecordCall(p_iPortId, l_llLatency_ns);
+            }
+
+            if (l_bDeadline &&
+                l_pState->m_Deadline.Complete(p_llWait_ns + l_llLatency_ns))
+            {
+                l_pState->m_Profiler.RecordDeadlineMiss();
+            }
+        }
+        else
+        {
+            _ThreadFunction(p_iPortId);
+        }
+
+        emit sig_ThreadFunctionFinished();
+    }
+
+    /**
+     * @return the execution state of this Module (see ModuleState), attached
+     * by the first call.
+     */
+    inline ModuleState* _State() const
+    {
+        return g_Attach<ModuleState>(const_cast<Module*>(this));
+    }
+
+    /**
+     * @return the execution state of this Module, or NULL if it has not been
+     * attached yet.
+     */
+    inline ModuleState* _FindState() const
+    {
+        return g_FindAttached<ModuleState>(this);
+    }
+
+    /**
+     * @brief _InputPortTriggered runs the thread function for a notified input
+     * port, on the executor of this Module if any (see _Dispatch()). It
+     * receives the sig_In() signals in place of slot_InputPortTriggered() (see
+     * InitExecution()).
+     *
+     * @param[in]   p_iPortId   Id of the input port that was triggered.
+     */
+    void _InputPortTriggered(int p_iPortId)
+    {
+        _Dispatch(p_iPortId);
+    }
+
+    /**
+     * @brief _IsInputQueued checks if an input port is linked through a queue
+     * (see g_LinkModulesQueued()). A port that is not queued always returns
+     * its current Data, so that a loop on DEQUEUE_INPUT_DATA must read it once
+     * per execution:
+     *
+     *     while (DEQUEUE_INPUT_DATA(l_pData, p_iPortId))
+     *     {
+     *         ...
+     *         if (!_IsInputQueued(p_iPortId)) break;
+     *     }
+     *
+     * @param[in]   p_iPortId   Id of the input port.
+     */
+    inline bool _IsInputQueued(const int p_iPortId)
+    {
+        ModulePort*     l_pPort;
+
+        l_pPort = _PortIn(p_iPortId);
+
+        return (l_pPort && l_pPort->GetQueue());
+    }
+
+    /**
+     * @brief _PortIn returns the input port with the specified id. Once the
+     * number of input ports has been locked (see _LockInputPortNum()) the port
+     * is read from a table indexed by id, without locking m_Mutex.
+     *
+     * @param[in]   p_iPortId   Id of the input port.
+     *
+     * @return the input port, or NULL if the id is not valid.
+     */
+    inline ModulePort* _PortIn(const int p_iPortId) const
+    {
+        ModuleState*    l_pState;
+
+        if (m_bLockInputPortNum)
+        {
+            l_pState = _State();
+
+            return l_pState->PortAt(m_lPortIn,
+                                    l_pState->m_vPortIn,
+                                    l_pState->m_iPortInIndexed,
+                                    p_iPortId);
+        }
+
+        LOCK_MODULE_READ(l_Lock);
+
+        return _PortAt(m_lPortIn, p_iPortId);
+    }
+
+    /**
+     * @brief _PortOut returns the output port with the specified id. Once the
+     * number of output ports has been locked (see _LockOutputPortNum()) the
+     * port is read from a table indexed by id, without locking m_Mutex.
+     *
+     * @param[in]   p_iPortId   Id of the output port.
+     *
+     * @return the output port, or NULL if the id is not valid.
+     */
+    inline ModulePort* _PortOut(const int p_iPortId) const
+    {
+        ModuleState*    l_pState;
+
+        if (m_bLockOutputPortNum)
+        {
+            l_pState = _State();
+
+            return l_pState->PortAt(m_lPortOut,
+                                    l_pState->m_vPortOut,
+                                    l_pState->m_iPortOutIndexed,
+                                    p_iPortId);
+        }
+
+        LOCK_MODULE_READ(l_Lock);
+
+        return _PortAt(m_lPortOut, p_iPortId);
+    }
+
+    /**
+     * @return the port of a port list with the specified id, or NULL.
+     */
+    static inline ModulePort* _PortAt(const ModulePortList& p_rlPorts,
+                                      const int             p_iPortId)
+    {
+        if (p_iPortId >= 0 &&
+            p_iPortId < static_cast<int>(p_rlPorts.size()))
+        {
+            return GET_PTR(LIST_AT(p_rlPorts, p_iPortId));
+        }
+
+        return NULL;
+    }
+
+    /**
+     * @brief _Post requests an asynchronous execution of the thread function:
+     * posts it to the executor of this Module, if any, or queues it to the
+     * thread of this Module as a ModulePostEvent.
+     *
+     * @param[in]   p_iPortId   Id of the triggered port.
+     */
+    void _Post(const int p_iPortId);
+
+    /**
+     * @brief _LockInputPort locks the number of input ports. From then on the
+     * input port table is read without locking.
+     *
+     * @warning To be called before this Module is started.
      */
     void    _LockInputPortNum();
 
     /**
-     * @brief _LockOutputPort locks the number of output ports.
+     * @brief _LockOutputPort locks the number of output ports. From then on
+     * the output port table is read without locking.
+     *
+     * @warning To be called before this Module is started.
      */
     void    _LockOutputPortNum();
 
@@ -570,6 +1889,26 @@ protected:
      */
     virtual RetFlag _ThreadFunction(const int p_iPortId) = 0;
 
+    /**
+     * @brief _TimerTimeout runs the thread function for the main timer (see
+     * INIT_MAIN_TIMER_CONNECTION).
+     */
+    void _TimerTimeout()
+    {
+        _Dispatch(TIMER_EVENT_PORT_ID);
+    }
+
+    /**
+     * @brief _Triggered runs the thread function for sig_Trigger() (see
+     * INIT_TRIGGER_CONNECTION).
+     *
+     * @param[in]   p_iPortId   Input port id.
+     */
+    void _Triggered(int p_iPortId)
+    {
+        _Dispatch(p_iPortId);
+    }
+
 signals:
 
     /**
@@ -704,6 +2043,323 @@ protected:
 
 }; // end class Module.
 
+/******************************************************************************/
+/**
+ * @class ModuleStrand
+ *
+ * @brief Strand that runs the thread function of a Module on a
+ * ModuleExecutor.
+ */
+class ModuleStrand : public ModuleExecutorStrand
+{
+public:
+
+    ModuleStrand(Module* p_pModule)
+        : m_pModule(p_pModule)
+    {
+        /* Empty. */
+    }
+
+protected:
+
+    virtual void _Execute(const int p_iPortId)
+    {
+        m_pModule->_Execute(p_iPortId, _GetWait_ns());
+    }
+
+protected:
+
+    Module*     m_pModule; /**< Executed Module. */
+
+}; // end class ModuleStrand.
+
+/******************************************************************************/
+/**
+ * @class ModuleInputListener
+ *
+ * @brief Port listener that posts an execution of a Module for each
+ * notification of the output ports it is registered to, unless the notified
+ * input port is coalesced and already has a pending execution.
+ */
+class ModuleInputListener : public ModulePortListener,
+                            public ModulePortQueueObserver
+{
+public:
+
+    ModuleInputListener(ModuleState* p_pState)
+        : m_pState(p_pState),
+          m_bClosed(false)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Close detaches this listener from its Module. Waits for the
+     * notifications in progress.
+     */
+    void Close()
+    {
+        LOCK_WRITE(&m_Mutex, l_Lock);
+
+        m_bClosed = true;
+    }
+
+    virtual void DataDropped(const int p_iNumDropped)
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        if (!m_bClosed)
+        {
+            m_pState->m_Profiler.RecordDropped(p_iNumDropped);
+        }
+    }
+
+    /**
+     * @brief PortNotified posts an execution of the Module. The input port is
+     * the one registered at link time (see g_LinkModulesDirect()): no lock of
+     * the Module is taken.
+     */
+    virtual void PortNotified(const int p_iPortId, ModulePort* p_pPort)
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        if (!m_bClosed)
+        {
+            if (p_pPort && !p_pPort->MarkPending())
+            {
+                m_pState->m_Profiler.RecordCoalesced();
+
+                return;
+            }
+
+            m_pState->Post(p_iPortId);
+        }
+    }
+
+protected:
+
+    ModuleState*    m_pState; /**< State of the notified Module. */
+
+    QReadWriteLock  m_Mutex; /**< Protects m_bClosed. */
+
+    bool    m_bClosed; /**< True if the Module must not be notified. */
+
+}; // end class ModuleInputListener.
+
+/******************************************************************************/
+inline ModuleState::~ModuleState()
+{
+    /* The listener posts the executions run by the strand. */
+    m_PortListener.Reset();
+    m_Strand.Reset();
+}
+
+/******************************************************************************/
+inline bool ModuleState::event(QEvent* p_pEvent)
+{
+    if (p_pEvent->type() == MODULE_POST_EVENT_TYPE)
+    {
+        m_pModule->_Dispatch(
+                    static_cast<ModulePostEvent*>(p_pEvent)->m_iPortId);
+
+        return true;
+    }
+
+    return QObject::event(p_pEvent);
+}
+
+/******************************************************************************/
+inline ModulePortListenerPtr Module::GetPortListener()
+{
+    ModuleState*    l_pState = _State();
+    LOCK_WRITE(&l_pState->m_MutexExecution, l_Lock);
+
+    if (!l_pState->m_PortListener.Get())
+    {
+        l_pState->m_PortListener.Reset(ModuleInputListenerPtr(
+                                           new ModuleInputListener(l_pState)));
+    }
+
+    return l_pState->m_PortListener.Get();
+}
+
+/******************************************************************************/
+inline void Module::SetExecutor(ModuleExecutorPtr p_pExecutor)
+{
+    ModuleExecutorStrandPtr     l_pNewStrand;
+    ModuleExecutorStrandPtr     l_pOldStrand;
+    ModuleState*                l_pState;
+
+    l_pState = _State();
+
+    if (p_pExecutor)
+    {
+        l_pNewStrand.reset(new ModuleStrand(this));
+        l_pNewStrand->SetPriority(GetPriority());
+    }
+
+    {
+        LOCK_WRITE(&l_pState->m_MutexExecution, l_Lock);
+
+        l_pState->m_pExecutor = p_pExecutor;
+
+        l_pOldStrand = l_pState->m_Strand.Exchange(l_pNewStrand);
+    }
+
+    /* The running execution may post to the strands: wait for it without
+     * holding the lock. */
+    if (l_pOldStrand)
+    {
+        l_pOldStrand->Close();
+    }
+
+    /* The pending executions have been discarded: the coalesced ports must
+     * schedule the next one. */
+    _ClearPendingInputs();
+
+    /* The Qt-linked input ports must reach the executor too. */
+    _ConnectInputPorts();
+}
+
+/******************************************************************************/
+inline void Module::_ClearPendingInputs()
+{
+    LOCK_READ(&m_Mutex, l_Lock);
+    ModulePortList::const_iterator  l_it;
+
+    FORALL(m_lPortIn, l_it)
+    {
+        (*l_it)->ClearPending();
+    }
+}
+
+/******************************************************************************/
+inline void Module::_CloseExecution()
+{
+    ModuleExecutorStrandPtr l_pStrand;
+    ModuleInputListenerPtr  l_pListener;
+    ModuleState*            l_pState;
+
+    l_pState = _FindState();
+
+    if (!l_pState)
+    {
+        return;
+    }
+
+    CloseInputQueues();
+
+    {
+        LOCK_WRITE(&l_pState->m_MutexExecution, l_Lock);
+
+        RELEASE_PTR(l_pState->m_pExecutor)
+
+        l_pStrand = l_pState->m_Strand.Exchange(ModuleExecutorStrandPtr());
+        l_pListener = l_pState->m_PortListener.Exchange(
+                          ModuleInputListenerPtr());
+    }
+
+    /* The running execution may post to the strands: wait for it without
+     * holding the lock. */
+    if (l_pListener)
+    {
+        l_pListener->Close();
+    }
+
+    if (l_pStrand)
+    {
+        l_pStrand->Close();
+    }
+
+    QCoreApplication::removePostedEvents(l_pState, MODULE_POST_EVENT_TYPE);
+}
+
+/******************************************************************************/
+inline void Module::_Dispatch(const int p_iPortId)
+{
+    ModuleExecutorPtr       l_pExecutor;
+    ModuleExecutorStrandPtr l_pStrand;
+    ModuleState*            l_pState;
+
+    l_pState = _State();
+
+    {
+        LOCK_READ(&l_pState->m_MutexExecution, l_Lock);
+
+        l_pExecutor = l_pState->m_pExecutor;
+        l_pStrand = l_pState->m_Strand.Get();
+    }
+
+    if (l_pExecutor)
+    {
+        l_pExecutor->Post(l_pStrand, p_iPortId);
+    }
+    else
+    {
+        _Execute(p_iPortId);
+    }
+}
+
+/******************************************************************************/
+inline void Module::_Post(const int p_iPortId)
+{
+    _State()->Post(p_iPortId);
+}
+
+/******************************************************************************/
+inline bool Module::WaitIdle(const int p_iWait_ms)
+{
+    ModuleExecutorStrandPtr l_pStrand;
+    ModulePortQueuePtr      l_pQueue;
+    QElapsedTimer           l_Timer;
+    ModuleState*            l_pState;
+    bool                    l_bQueued;
+
+    ModulePortList::const_iterator  l_it;
+
+    l_pState = _State();
+
+    l_Timer.start();
+
+    for (;;)
+    {
+        l_bQueued = false;
+
+        {
+            LOCK_READ(&m_Mutex, l_Lock);
+
+            for (l_it = m_lPortIn.begin();
+                 l_it != m_lPortIn.end() && !l_bQueued;
+                 l_it++)
+            {
+                l_pQueue = (*l_it)->GetQueue();
+                l_bQueued = (l_pQueue && l_pQueue->GetSize() > 0);
+            }
+
+        }
+
+        {
+            LOCK_READ(&l_pState->m_MutexExecution, l_Lock);
+
+            l_pStrand = l_pState->m_Strand.Get();
+        }
+
+        if (!l_bQueued &&
+            (!l_pStrand || (l_pStrand->GetNumPending() == 0 &&
+                            l_pStrand->WaitIdle(0))))
+        {
+            return true;
+        }
+
+        if (p_iWait_ms >= 0 && l_Timer.elapsed() >= p_iWait_ms)
+        {
+            return false;
+        }
+
+        QThread::msleep(1);
+    }
+}
+
 /** @typedef Generic module allocator function, for the use with modules defined
  * inside a shared library (*.dll, *.so). */
 typedef Module* (*ModuleAllocatorFun)(ModuleExecMode);
@@ -711,6 +2367,9 @@ typedef Module* (*ModuleAllocatorFun)(ModuleExecMode);
 /** @brief Global function that links an output port of the first module with an
  * input port of the second module.
  *
+ * @note The type of the ports is not checked: use g_LinkModulesChecked() to
+ * link typed ports.
+ *
  * @param[in]   p_pModule   First module.
  * @param[in]   p_iOutPort1 Id of the output port of the first module.
  * @param[in]   p_pModule   Second module.
@@ -724,6 +2383,230 @@ RetFlag g_LinkModules(ModulePtr     p_pModule1,
                       ModulePtr     p_pModule2,
                       const int     p_iInPort2);
 
+/** @brief Global function that links an output port of the first module with an
+ * input port of the second module. If the input port is typed (see
+ * Module::AddTypedInput()), the type of the output port must match its type
+ * (see ModulePort::CheckLink()).
+ *
+ * @param[in]   p_pModule   First module.
+ * @param[in]   p_iOutPort1 Id of the output port of the first module.
+ * @param[in]   p_pModule   Second module.
+ * @param[in]   p_iInPort2  Id of the input port of the second module.
+ *
+ * @retval  RET_SUCCESS     if the two modules have been successfully linked.
+ * @retval  RET_ERROR       if a port is not valid or the types of the two
+ *                          ports do not match.
+ */
+inline
+RetFlag g_LinkModulesChecked(ModulePtr  p_pModule1,
+                             const int  p_iOutPort1,
+                             ModulePtr  p_pModule2,
+                             const int  p_iInPort2)
+{
+    ModulePortPtr   l_pPortIn;
+
+    if (!p_pModule1 || !p_pModule2)
+    {
+        return RET_ERROR;
+    }
+
+    l_pPortIn = p_pModule2->GetPortIn(p_iInPort2);
+
+    if (l_pPortIn &&
+        l_pPortIn->CheckLink(p_pModule1->GetPortOut(p_iOutPort1)) !=
+            RET_SUCCESS)
+    {
+        return RET_ERROR;
+    }
+
+    /* The Modules built without MODULE_ALLOC_FUN_IMPL. */
+    p_pModule2->InitExecution();
+
+    return g_LinkModules(p_pModule1, p_iOutPort1, p_pModule2, p_iInPort2);
+}
+
+/** @brief Global function that links an output port of the first module with an
+ * input port of the second module through a bounded queue. The second module
+ * gets the queued Data with DEQUEUE_INPUT_DATA.
+ *
+ * @param[in]   p_pModule1  First module.
+ * @param[in]   p_iOutPort1 Id of the output port of the first module.
+ * @param[in]   p_pModule2  Second module.
+ * @param[in]   p_iInPort2  Id of the input port of the second module.
+ * @param[in]   p_iCapacity Capacity of the queue.
+ * @param[in]   p_Policy    Behavior when the queue is full.
+ *
+ * @retval  RET_SUCCESS     if the two modules have been successfully linked.
+ */
+inline
+RetFlag g_LinkModulesQueued(ModulePtr                       p_pModule1,
+                            const int                       p_iOutPort1,
+                            ModulePtr                       p_pModule2,
+                            const int                       p_iInPort2,
+                            const int                       p_iCapacity,
+                            ModulePortQueue::OverflowPolicy p_Policy =
+                                ModulePortQueue::OVERFLOW_DROP_OLDEST)
+{
+    ModulePortPtr   l_pPortIn;
+    RetFlag         l_Result;
+
+    l_Result = g_LinkModulesChecked(p_pModule1,
+                                    p_iOutPort1,
+                                    p_pModule2,
+                                    p_iInPort2);
+
+    if (l_Result == RET_SUCCESS)
+    {
+        l_pPortIn = p_pModule2->GetPortIn(p_iInPort2);
+
+        if (!l_pPortIn)
+        {
+            l_Result = RET_ERROR;
+        }
+        else if (l_pPortIn->EnableQueue(p_iCapacity, p_Policy) == RET_SUCCESS)
+        {
+            /* The consumer records the Data discarded by its queue. */
+            l_pPortIn->GetQueue()->SetObserver(
+                        DYNAMIC_PTR_CAST<ModulePortQueueObserver>(
+                            p_pModule2->GetPortListener()));
+        }
+        else
+        {
+            l_Result = RET_ERROR;
+        }
+    }
+
+    return l_Result;
+}
+
+/** @brief Global function that links an output port of the first module with an
+ * input port of the second module through the direct notification path: the
+ * output port calls the port listener of the second module, which posts the
+ * execution to the executor of the second module (see Module::SetExecutor()),
+ * instead of going through the Qt signals of the two ports. The sig_Out()
+ * signal of the output port is still emitted for the GUI observers.
+ *
+ * @param[in]   p_pModule1  First module.
+ * @param[in]   p_iOutPort1 Id of the output port of the first module.
+ * @param[in]   p_pModule2  Second module.
+ * @param[in]   p_iInPort2  Id of the input port of the second module.
+ *
+ * @retval  RET_SUCCESS     if the two modules have been successfully linked.
+ */
+inline
+RetFlag g_LinkModulesDirect(ModulePtr   p_pModule1,
+                            const int   p_iOutPort1,
+                            ModulePtr   p_pModule2,
+                            const int   p_iInPort2)
+{
+    ModulePortPtr   l_pPortOut;
+    ModulePortPtr   l_pPortIn;
+    RetFlag         l_Result;
+
+    l_Result = g_LinkModulesChecked(p_pModule1,
+                                    p_iOutPort1,
+                                    p_pModule2,
+                                    p_iInPort2);
+
+    if (l_Result == RET_SUCCESS)
+    {
+        l_pPortOut = p_pModule1->GetPortOut(p_iOutPort1);
+        l_pPortIn = p_pModule2->GetPortIn(p_iInPort2);
+
+        if (l_pPortOut && l_pPortIn)
+        {
+            QObject::disconnect(GET_PTR(l_pPortOut),
+                                SIGNAL(sig_Out()),
+                                GET_PTR(l_pPortIn),
+                                SLOT(slot_In()));
+
+            l_pPortOut->AddListener(p_pModule2->GetPortListener(),
+                                    p_iInPort2,
+                                    GET_PTR(l_pPortIn));
+        }
+        else
+        {
+            l_Result = RET_ERROR;
+        }
+    }
+
+    return l_Result;
+}
+
+/** @brief Global function that links an output port of the first module with an
+ * input port of the second module through the direct notification path (see
+ * g_LinkModulesDirect()), coalescing the notifications: at most one execution
+ * of the second module is pending for the input port, and the notifications
+ * received meanwhile are only counted (see ModulePort::SetCoalesced()). The
+ * latency stays bounded when the second module is slower than the first one.
+ *
+ * @param[in]   p_pModule1  First module.
+ * @param[in]   p_iOutPort1 Id of the output port of the first module.
+ * @param[in]   p_pModule2  Second module.
+ * @param[in]   p_iInPort2  Id of the input port of the second module.
+ *
+ * @retval  RET_SUCCESS     if the two modules have been successfully linked.
+ */
+inline
+RetFlag g_LinkModulesCoalesced(ModulePtr    p_pModule1,
+                               const int    p_iOutPort1,
+                               ModulePtr    p_pModule2,
+                               const int    p_iInPort2)
+{
+    RetFlag     l_Result;
+
+    l_Result = g_LinkModulesDirect(p_pModule1,
+                                   p_iOutPort1,
+                                   p_pModule2,
+                                   p_iInPort2);
+
+    if (l_Result == RET_SUCCESS)
+    {
+        p_pModule2->GetPortIn(p_iInPort2)->SetCoalesced(true);
+    }
+
+    return l_Result;
+}
+
+/** @brief Global function that stops the notifications of an output port of
+ * the first module to an input port of the second module, linked by any of
+ * the functions above. The Data already received by the second module are not
+ * discarded. The direct notifications (see g_LinkModulesDirect()) of the
+ * output port are stopped for all the input ports of the second module.
+ *
+ * @param[in]   p_pModule1  First module.
+ * @param[in]   p_iOutPort1 Id of the output port of the first module.
+ * @param[in]   p_pModule2  Second module.
+ * @param[in]   p_iInPort2  Id of the input port of the second module.
+ */
+inline
+void g_UnlinkModules(ModulePtr  p_pModule1,
+                     const int  p_iOutPort1,
+                     ModulePtr  p_pModule2,
+                     const int  p_iInPort2)
+{
+    ModulePortPtr   l_pPortOut;
+    ModulePortPtr   l_pPortIn;
+
+    if (!p_pModule1 || !p_pModule2)
+    {
+        return;
+    }
+
+    l_pPortOut = p_pModule1->GetPortOut(p_iOutPort1);
+    l_pPortIn = p_pModule2->GetPortIn(p_iInPort2);
+
+    if (l_pPortOut && l_pPortIn)
+    {
+        QObject::disconnect(GET_PTR(l_pPortOut),
+                            SIGNAL(sig_Out()),
+                            GET_PTR(l_pPortIn),
+                            SLOT(slot_In()));
+
+        l_pPortOut->RemoveListener(p_pModule2->GetPortListener());
+    }
+}
+
 } // end namespace fby.
 
 #endif // MODULE_H
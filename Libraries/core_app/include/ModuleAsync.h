@@ -0,0 +1,455 @@
+#ifndef MODULE_ASYNC_H
+#define MODULE_ASYNC_H
+
+/** @file ModuleAsync.h
+ *
+ * @brief Defines the ModuleAsyncJob and ModuleAsync classes, which run the
+ * blocking work of a Module (e.g. loading a file or a model) outside of the
+ * executions of its thread function.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Module.h>
+
+#include <algorithm>
+#include <climits>
+#include <deque>
+
+/** Number of threads of the executor of a ModuleAsync that is not given one
+ * (see ModuleAsync::SetExecutor()). */
+#define MODULE_ASYNC_DEFAULT_THREADS    4
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class ModuleAsyncJob
+ *
+ * @brief Blocking work started by a Module through ModuleAsync. Subclasses
+ * implement _Run() and keep its inputs and results as data members: the job
+ * runs on another thread and must not access the Module or its Data.
+ *
+ * A job can also be used as a future: IsDone() and Wait() tell when _Run()
+ * has returned, after which its results can be read from any thread.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleAsyncJob
+{
+    friend class ModuleAsync;
+
+public:
+
+    ModuleAsyncJob()
+        : m_bDone(false),
+          m_bCancelled(false)
+    {
+        /* Empty. */
+    }
+
+    virtual ~ModuleAsyncJob()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Cancel requests the cancellation of this job: a job not started
+     * yet does not run, while a running job can poll IsCancelled().
+     */
+    void Cancel()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_bCancelled = true;
+    }
+
+    /** @return true if the job has been cancelled. */
+    bool IsCancelled() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return m_bCancelled;
+    }
+
+    /** @return true if the job has run (or has been skipped). */
+    bool IsDone() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return m_bDone;
+    }
+
+    /**
+     * @brief Wait waits until the job is done.
+     *
+     * @param[in]   p_iWait_ms  Maximum wait (ms). If negative, waits forever.
+     *
+     * @return true if the job is done.
+     */
+    bool Wait(const int p_iWait_ms = -1)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        if (!m_bDone)
+        {
+            m_condDone.wait(&m_Mutex,
+                            p_iWait_ms < 0 ?
+                                ULONG_MAX :
+                                static_cast<unsigned long>(p_iWait_ms));
+        }
+
+        return m_bDone;
+    }
+
+protected:
+
+    /**
+     * @brief _Run performs the blocking work. Called on a thread of the
+     * executor of the jobs, without any lock of the Module.
+     */
+    virtual void _Run() = 0;
+
+    /**
+     * @brief _Finish marks the job as done and wakes the waiting threads.
+     */
+    void _Finish()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_bDone = true;
+
+        m_condDone.wakeAll();
+    }
+
+protected:
+
+    mutable QMutex  m_Mutex; /**< Protects the state of this job. */
+
+    QWaitCondition  m_condDone; /**< Signalled when the job is done. */
+
+    bool    m_bDone; /**< True if _Run() has returned. */
+
+    bool    m_bCancelled; /**< True if the job has been cancelled. */
+
+}; // end class ModuleAsyncJob.
+
+DEF_PTR(ModuleAsyncJob);
+
+/******************************************************************************/
+/**
+ * @class ModuleAsync
+ *
+ * @brief Runs the asynchronous jobs of a Module and resumes the Module when
+ * they are done. A Module holds a ModuleAsync as a data member and, instead
+ * of blocking its thread function on a slow operation, starts a job and
+ * returns, releasing its locks and its thread (or its slot on the executor).
+ * When the job is done the thread function is called with port id
+ * ASYNC_EVENT_PORT_ID, and takes the results with TakeCompleted():
+ *
+ * @code
+ * case TRIGGERED_EVENT_PORT_ID:
+ *     if (!m_pLoad)
+ *     {
+ *         m_pLoad.reset(new LoadJob(l_sFileName));
+ *         m_Async.Start(m_pLoad);
+ *     }
+ *     break;
+ *
+ * case ASYNC_EVENT_PORT_ID:
+ *     while (m_Async.TakeCompleted(l_pJob))
+ *     {
+ *         // Publish the results of l_pJob, under the usual locks.
+ *     }
+ *     break;
+ * @endcode
+ *
+ * The jobs run in parallel on the executor given to the constructor or to
+ * SetExecutor(), e.g. a pool shared by the Modules of an application, which
+ * must not be the executor of the pipeline, so that a slow disk does not stall
+ * it. Without one, the first job creates an executor owned by this object,
+ * with MODULE_ASYNC_DEFAULT_THREADS threads. The jobs complete in any order.
+ *
+ * @note The executor is never a static object of this header: each shared
+ * library would get its own, destroyed when the library is unloaded.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleAsync
+{
+public:
+
+    /**
+     * @param[in]   p_pModule   Module resumed by the completed jobs.
+     * @param[in]   p_pExecutor Executor of the jobs, or a null object (see
+     *                          SetExecutor()).
+     */
+    ModuleAsync(Module*             p_pModule,
+                ModuleExecutorPtr   p_pExecutor = ModuleExecutorPtr())
+        : m_pCore(new Core(p_pModule)),
+          m_pExecutor(p_pExecutor)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Closes this object. If the executor of the jobs is owned by this
+     * object, waits for the running jobs, which have been cancelled.
+     */
+    ~ModuleAsync()
+    {
+        Close();
+
+        RELEASE_PTR(m_pExecutor)
+    }
+
+    /**
+     * @brief Close cancels the pending jobs and discards the completed ones.
+     * The Module is no longer resumed after this call returns. The running
+     * jobs are not waited for.
+     *
+     * @warning Must not be called while holding the mutex of the Module.
+     */
+    void Close()
+    {
+        QMutexLocker    l_Lock(&m_pCore->m_Mutex);
+        size_t          l_s;
+
+        m_pCore->m_bClosed = true;
+
+        for (l_s = 0; l_s < m_pCore->m_vRunning.size(); l_s++)
+        {
+            m_pCore->m_vRunning[l_s]->Cancel();
+        }
+
+        m_pCore->m_dqCompleted.clear();
+    }
+
+    /**
+     * @return the number of jobs started and not yet taken.
+     */
+    int GetNumPending() const
+    {
+        QMutexLocker    l_Lock(&m_pCore->m_Mutex);
+
+        return static_cast<int>(m_pCore->m_vRunning.size() +
+                                m_pCore->m_dqCompleted.size());
+    }
+
+    /**
+     * @brief SetExecutor sets the executor of the next jobs, e.g. a pool shared
+     * by the Modules of the application or a dedicated pool for a slow device.
+     * A null executor makes the next job create an executor owned by this
+     * object.
+     */
+    void SetExecutor(ModuleExecutorPtr p_pExecutor)
+    {
+        QMutexLocker    l_Lock(&m_pCore->m_Mutex);
+
+        m_pExecutor = p_pExecutor;
+    }
+
+    /**
+     * @brief Start starts a job.
+     *
+     * @return false if the job is null or this object is closed.
+     */
+    bool Start(ModuleAsyncJobPtr p_pJob)
+    {
+        ModuleExecutorPtr   l_pExecutor;
+
+        if (!p_pJob)
+        {
+            return false;
+        }
+
+        {
+            QMutexLocker    l_Lock(&m_pCore->m_Mutex);
+
+            if (m_pCore->m_bClosed)
+            {
+                return false;
+            }
+
+            m_pCore->m_vRunning.push_back(p_pJob);
+
+            if (!m_pExecutor)
+            {
+                m_pExecutor.reset(
+                            new ModuleExecutor(MODULE_ASYNC_DEFAULT_THREADS));
+            }
+
+            l_pExecutor = m_pExecutor;
+        }
+
+        l_pExecutor->Post(ModuleExecutorStrandPtr(
+                              new JobStrand(m_pCore, p_pJob)),
+                          0);
+
+        return true;
+    }
+
+    /**
+     * @brief TakeCompleted takes the oldest completed job. To be called by
+     * the thread function on ASYNC_EVENT_PORT_ID, until it returns false.
+     *
+     * @return false if no job is completed.
+     */
+    bool TakeCompleted(ModuleAsyncJobPtr& p_rpJob)
+    {
+        QMutexLocker    l_Lock(&m_pCore->m_Mutex);
+
+        if (m_pCore->m_dqCompleted.empty())
+        {
+            return false;
+        }
+
+        p_rpJob = m_pCore->m_dqCompleted.front();
+        m_pCore->m_dqCompleted.pop_front();
+
+        return true;
+    }
+
+protected:
+
+    /**
+     * @struct Core
+     *
+     * @brief State shared with the running jobs, which may outlive this
+     * object.
+     */
+    struct Core
+    {
+        Core(Module* p_pModule)
+            : m_pModule(p_pModule),
+              m_bClosed(false)
+        {
+            /* Empty. */
+        }
+
+        QMutex  m_Mutex; /**< Protects the data of this struct. */
+
+        Module* m_pModule; /**< Module resumed by the completed jobs. */
+
+        std::vector<ModuleAsyncJobPtr>  m_vRunning; /**< Started jobs. */
+
+        std::deque<ModuleAsyncJobPtr>   m_dqCompleted; /**< Completed jobs,
+                                                        * oldest first. */
+
+        bool    m_bClosed; /**< True if the Module must not be resumed. */
+    };
+
+    DEF_PTR(Core);
+
+    /**
+     * @class JobStrand
+     *
+     * @brief Strand that runs a single job.
+     */
+    class JobStrand : public ModuleExecutorStrand
+    {
+    public:
+
+        JobStrand(CorePtr p_pCore, ModuleAsyncJobPtr p_pJob)
+            : m_pCore(p_pCore),
+              m_pJob(p_pJob)
+        {
+            /* Empty. */
+        }
+
+    protected:
+
+        /**
+         * @brief _Abandon completes the job as cancelled when its executor
+         * is destroyed before running it.
+         */
+        virtual void _Abandon(const int p_iItem)
+        {
+            Q_UNUSED(p_iItem);
+
+            m_pJob->Cancel();
+            m_pJob->_Finish();
+
+            ModuleAsync::_Complete(m_pCore, m_pJob);
+        }
+
+        virtual void _Execute(const int p_iItem)
+        {
+            Q_UNUSED(p_iItem);
+
+            if (!m_pJob->IsCancelled())
+            {
+                m_pJob->_Run();
+            }
+
+            m_pJob->_Finish();
+
+            ModuleAsync::_Complete(m_pCore, m_pJob);
+        }
+
+    protected:
+
+        CorePtr     m_pCore; /**< State of the owner. */
+
+        ModuleAsyncJobPtr   m_pJob; /**< Job. */
+
+    }; // end class JobStrand.
+
+protected:
+
+    /**
+     * @brief _Complete moves a job to the completed ones and resumes the
+     * Module, unless the owner has been closed.
+     */
+    static void _Complete(CorePtr p_pCore, ModuleAsyncJobPtr p_pJob)
+    {
+        QMutexLocker    l_Lock(&p_pCore->m_Mutex);
+
+        p_pCore->m_vRunning.erase(std::remove(p_pCore->m_vRunning.begin(),
+                                              p_pCore->m_vRunning.end(),
+                                              p_pJob),
+                                  p_pCore->m_vRunning.end());
+
+        if (p_pCore->m_bClosed)
+        {
+            return;
+        }
+
+        p_pCore->m_dqCompleted.push_back(p_pJob);
+
+        /* Holding m_Mutex: Close() cannot return before the Module has been
+         * resumed. */
+        p_pCore->m_pModule->_Post(ASYNC_EVENT_PORT_ID);
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleAsync(const ModuleAsync&);
+    ModuleAsync& operator = (const ModuleAsync&);
+
+protected:
+
+    CorePtr     m_pCore; /**< State shared with the running jobs. */
+
+    ModuleExecutorPtr   m_pExecutor; /**< Executor of the jobs. It is not
+                                      * part of m_pCore, so that a job never
+                                      * releases the last reference to the
+                                      * executor running it. Protected by
+                                      * m_pCore->m_Mutex. */
+
+}; // end class ModuleAsync.
+
+} // end namespace fby.
+
+#endif // MODULE_ASYNC_H
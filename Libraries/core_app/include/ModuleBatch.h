@@ -0,0 +1,338 @@
+#ifndef MODULE_BATCH_H
+#define MODULE_BATCH_H
+
+/** @file ModuleBatch.h
+ *
+ * @brief Defines the ModuleBatch class, a Module that receives the Data of
+ * its input ports in batches.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <DataFrame.h>
+#include <Module.h>
+
+/** Default maximum number of Data of a batch. */
+#define MODULE_BATCH_DEFAULT_MAX_SIZE   8
+
+/** Default maximum time the first Data of a batch waits for the others (ms). */
+#define MODULE_BATCH_DEFAULT_MAX_WAIT_MS    10
+
+namespace fby
+{
+/** Batch of Data received by an input port, oldest first. */
+typedef std::vector<DataPtr>    DataBatch;
+
+/******************************************************************************/
+/**
+ * @class ModuleBatch
+ *
+ * @ingroup Modules
+ *
+ * @brief Base class for the Modules that process many Data at once (e.g. a
+ * classifier or an encoder) and whose per-execution overhead (locking,
+ * dispatch, cache warm-up) should be paid once per batch instead of once per
+ * Data. Subclasses implement _ProcessBatch() instead of _ThreadFunction().
+ *
+ * The Data received by each input port are collected until the batch holds
+ * the maximum number of Data, or until its first Data has waited the maximum
+ * time: the batch is then delivered in a single call. A batch size of 1
+ * restores the delivery of one Data per call.
+ *
+ * The input ports should be linked with g_LinkModulesQueued(), so that every
+ * notification is kept; a port that is not queued contributes its current
+ * Data once per execution. When this Module is started without a loop time,
+ * the main timer is still used to deliver the batches that stop growing, and
+ * its events are not forwarded to _ProcessEvent().
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleBatch : public Module
+{
+public:
+
+    ModuleBatch(ModuleExecMode p_Mode)
+        : Module(p_Mode),
+          m_iMaxSize(MODULE_BATCH_DEFAULT_MAX_SIZE),
+          m_iMaxWait_ms(MODULE_BATCH_DEFAULT_MAX_WAIT_MS),
+          m_iActiveMaxSize(MODULE_BATCH_DEFAULT_MAX_SIZE),
+          m_iActiveMaxWait_ms(MODULE_BATCH_DEFAULT_MAX_WAIT_MS),
+          m_bForwardTimer(true),
+          m_llBatches(0),
+          m_llBatchedData(0)
+    {
+        m_Clock.start();
+    }
+
+    virtual ~ModuleBatch()
+    {
+        _CloseExecution();
+    }
+
+    /**
+     * @return the mean number of Data per delivered batch.
+     */
+    inline double GetMeanBatchSize() const
+    {
+        LOCK_MODULE_READ(l_Lock);
+
+        return (m_llBatches > 0 ?
+                    static_cast<double>(m_llBatchedData) / m_llBatches : 0.0);
+    }
+
+    /**
+     * @return the number of delivered batches.
+     */
+    inline qint64 GetNumBatches() const
+    {
+        LOCK_MODULE_READ(l_Lock);
+
+        return m_llBatches;
+    }
+
+    /**
+     * @brief SetBatch sets the maximum size and the maximum wait of the
+     * batches. Takes effect from the next execution; the timer of a Module
+     * started without a loop time is updated by the next Start().
+     *
+     * @param[in]   p_iMaxSize      Maximum number of Data of a batch.
+     * @param[in]   p_iMaxWait_ms   Maximum wait of the first Data of a batch.
+     *                              If zero, a batch is delivered on every
+     *                              execution with the Data received so far.
+     */
+    void SetBatch(const int p_iMaxSize, const int p_iMaxWait_ms)
+    {
+        LOCK_MODULE_WRITE(l_Lock);
+
+        m_iMaxSize = std::max(p_iMaxSize, 1);
+        m_iMaxWait_ms = std::max(p_iMaxWait_ms, 0);
+    }
+
+    RetFlag Start(int p_iPeriod_ms = 0)
+    {
+        int     l_iMaxWait_ms;
+
+        {
+            LOCK_MODULE_READ(l_Lock);
+
+            l_iMaxWait_ms = m_iMaxWait_ms;
+        }
+
+        m_bForwardTimer = (p_iPeriod_ms > 0);
+
+        /* Without a loop time, check the pending batches twice per wait. */
+        if (!m_bForwardTimer && l_iMaxWait_ms > 0)
+        {
+            p_iPeriod_ms = std::max(l_iMaxWait_ms / 2, 1);
+        }
+
+        return Module::Start(p_iPeriod_ms);
+    }
+
+protected:
+
+    /**
+     * @struct Pending
+     *
+     * @brief Batch being collected by an input port.
+     */
+    struct Pending
+    {
+        Pending()
+            : m_llFirst_ms(0)
+        {
+            /* Empty. */
+        }
+
+        DataBatch   m_vData; /**< Collected Data. */
+
+        qint64      m_llFirst_ms; /**< Arrival of the first Data (m_Clock). */
+    };
+
+protected:
+
+    /**
+     * @brief _ProcessBatch processes a batch of Data received by an input
+     * port. To be implemented by the subclasses.
+     *
+     * @param[in]   p_iPortId   Id of the input port.
+     * @param[in]   p_rvBatch   Received Data, oldest first (at least one).
+     *
+     * @return The execution flag.
+     */
+    virtual RetFlag _ProcessBatch(const int         p_iPortId,
+                                  const DataBatch&  p_rvBatch) = 0;
+
+    /**
+     * @brief _ProcessEvent handles the executions that are not due to an
+     * input port (TIMER_EVENT_PORT_ID, TRIGGERED_EVENT_PORT_ID). The default
+     * implementation is empty.
+     */
+    virtual RetFlag _ProcessEvent(const int p_iPortId)
+    {
+        Q_UNUSED(p_iPortId);
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief _Snapshot returns the Data to be kept in a batch for a received
+     * Data: the producer reuses its output Data, so the batch must not hold
+     * it. The default implementation copies the Frame of a DataFrame, sharing
+     * its pixel buffer (see g_SnapshotData()), and keeps any other Data as it
+     * is.
+     */
+    virtual DataPtr _Snapshot(const int p_iPortId, const DataPtr& p_pData)
+    {
+        Q_UNUSED(p_iPortId);
+
+        return g_SnapshotData(p_pData);
+    }
+
+    RetFlag _ThreadFunction(const int p_iPortId)
+    {
+        RetFlag     l_Result;
+        qint64      l_llNow_ms;
+        size_t      l_s;
+
+        {
+            LOCK_MODULE_READ(l_Lock);
+
+            m_iActiveMaxSize = m_iMaxSize;
+            m_iActiveMaxWait_ms = m_iMaxWait_ms;
+        }
+
+        if (static_cast<int>(m_vPending.size()) != GetNumPortIn())
+        {
+            m_vPending.resize(GetNumPortIn());
+        }
+
+        l_Result = RET_SUCCESS;
+
+        if (p_iPortId >= 0 && p_iPortId < static_cast<int>(m_vPending.size()))
+        {
+            l_Result = _Collect(p_iPortId);
+        }
+
+        /* Deliver the batches whose wait has expired. */
+        l_llNow_ms = m_Clock.elapsed();
+
+        for (l_s = 0; l_s < m_vPending.size(); l_s++)
+        {
+            if (!m_vPending[l_s].m_vData.empty() &&
+                l_llNow_ms - m_vPending[l_s].m_llFirst_ms >=
+                    m_iActiveMaxWait_ms)
+            {
+                _Deliver(static_cast<int>(l_s));
+            }
+        }
+
+        if (p_iPortId < 0 &&
+            (p_iPortId != TIMER_EVENT_PORT_ID || m_bForwardTimer))
+        {
+            l_Result = _ProcessEvent(p_iPortId);
+        }
+
+        return l_Result;
+    }
+
+protected:
+
+    /**
+     * @brief _Collect appends the Data received by an input port to its
+     * pending batch, delivering the batches that reach the maximum size.
+     */
+    RetFlag _Collect(const int p_iPortId)
+    {
+        Pending&    l_rPending = m_vPending[p_iPortId];
+        RetFlag     l_Result;
+        DataPtr     l_pData;
+        bool        l_bQueued;
+
+        l_Result = RET_SUCCESS;
+        l_bQueued = _IsInputQueued(p_iPortId);
+
+        while (DEQUEUE_INPUT_DATA(l_pData, p_iPortId))
+        {
+            if (l_rPending.m_vData.empty())
+            {
+                l_rPending.m_llFirst_ms = m_Clock.elapsed();
+            }
+
+            l_rPending.m_vData.push_back(_Snapshot(p_iPortId, l_pData));
+
+            if (static_cast<int>(l_rPending.m_vData.size()) >= m_iActiveMaxSize)
+            {
+                l_Result = _Deliver(p_iPortId);
+            }
+
+            if (!l_bQueued)
+            {
+                break;
+            }
+        }
+
+        return l_Result;
+    }
+
+    /**
+     * @brief _Deliver calls _ProcessBatch() with the pending batch of an input
+     * port and empties it.
+     */
+    RetFlag _Deliver(const int p_iPortId)
+    {
+        Pending&    l_rPending = m_vPending[p_iPortId];
+        RetFlag     l_Result;
+
+        l_Result = _ProcessBatch(p_iPortId, l_rPending.m_vData);
+
+        {
+            LOCK_MODULE_WRITE(l_Lock);
+
+            m_llBatches++;
+            m_llBatchedData += static_cast<qint64>(l_rPending.m_vData.size());
+        }
+
+        /* clear() keeps the capacity: the next batch does not allocate. */
+        l_rPending.m_vData.clear();
+
+        return l_Result;
+    }
+
+protected:
+
+    int     m_iMaxSize; /**< Maximum number of Data of a batch. */
+
+    int     m_iMaxWait_ms; /**< Maximum wait of the first Data of a batch. */
+
+    int     m_iActiveMaxSize; /**< m_iMaxSize of the current execution. */
+
+    int     m_iActiveMaxWait_ms; /**< m_iMaxWait_ms of the current
+                                  * execution. */
+
+    bool    m_bForwardTimer; /**< False if the main timer only checks the
+                              * pending batches. */
+
+    std::vector<Pending>    m_vPending; /**< Pending batches, per input
+                                         * port. Only accessed by
+                                         * _ThreadFunction(). */
+
+    QElapsedTimer   m_Clock; /**< Clock of the arrival times. */
+
+    qint64  m_llBatches; /**< Number of delivered batches. */
+
+    qint64  m_llBatchedData; /**< Number of delivered Data. */
+
+}; // end class ModuleBatch.
+
+DEF_PTR(ModuleBatch);
+
+} // end namespace fby.
+
+#endif // MODULE_BATCH_H
@@ -0,0 +1,744 @@
+#ifndef MODULE_EXECUTOR_H
+#define MODULE_EXECUTOR_H
+
+/** @file ModuleExecutor.h
+ *
+ * @brief Defines the ModuleExecutor class, a fixed pool of worker threads that
+ * runs the executions of the Modules as tasks, and the ModuleExecutorStrand
+ * class that serializes the executions of a single Module.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <core_app_pch.h>
+
+#include <deque>
+
+/** Maximum number of items executed by a strand before it yields its worker
+ * to the other strands. */
+#define MODULE_EXECUTOR_STRAND_BATCH    16
+
+/** Every MODULE_EXECUTOR_AGING_PERIOD strands taken, a worker looks for a
+ * strand starting from the lowest priority (see ModuleExecutor). */
+#define MODULE_EXECUTOR_AGING_PERIOD    8
+
+/** Number of priority levels of the strands (see ModulePriority). */
+#define MODULE_PRIORITY_NUM     3
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @enum ModulePriority
+ *
+ * @brief Enumerates the priorities of the strands of a ModuleExecutor: a
+ * ready strand always runs before the ready strands of lower priority.
+ */
+enum ModulePriority
+{
+    MODULE_PRIORITY_LOW = 0,    /**< Background work (e.g. recording). */
+    MODULE_PRIORITY_NORMAL,     /**< Default priority. */
+    MODULE_PRIORITY_HIGH        /**< Latency-bound work (e.g. display). */
+
+}; // end enum ModulePriority.
+
+/******************************************************************************/
+/* Forward declarations. */
+class ModuleExecutor;
+DEF_PTR(ModuleExecutor);
+
+class ModuleExecutorStrand;
+DEF_PTR(ModuleExecutorStrand);
+
+/******************************************************************************/
+/**
+ * @class ModuleExecutorStrand
+ *
+ * @brief Sequence of items (port ids) to be executed one at a time on a
+ * ModuleExecutor. Items posted to the same strand never run concurrently,
+ * while different strands run in parallel on the workers of the executor.
+ * Subclasses implement _Execute() to process a single item; the time the item
+ * has waited since it was posted is available through _GetWait_ns().
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleExecutorStrand
+{
+    friend class ModuleExecutor;
+
+public:
+
+    ModuleExecutorStrand()
+        : m_iPriority(MODULE_PRIORITY_NORMAL),
+          m_llWait_ns(0),
+          m_bScheduled(false),
+          m_bRunning(false),
+          m_bClosed(false),
+          m_pRunningThread(NULL)
+    {
+        m_Clock.start();
+    }
+
+    virtual ~ModuleExecutorStrand()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Close discards the pending items and waits until the running
+     * item, if any, has finished. After this call no item is executed.
+     *
+     * @note If called from the item being executed, this function does not
+     * wait.
+     */
+    void Close()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_bClosed = true;
+        m_dqPending.clear();
+
+        while (m_bRunning && m_pRunningThread != QThread::currentThread())
+        {
+            m_condIdle.wait(&m_Mutex);
+        }
+    }
+
+    /**
+     * @return the number of items waiting to be executed.
+     */
+    int GetNumPending() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return static_cast<int>(m_dqPending.size());
+    }
+
+    /**
+     * @return the priority of this strand.
+     */
+    inline ModulePriority GetPriority() const
+    {
+        return static_cast<ModulePriority>(m_iPriority.load());
+    }
+
+    /**
+     * @brief SetPriority sets the priority of this strand. Takes effect from
+     * the next time the strand gets ready.
+     */
+    inline void SetPriority(ModulePriority p_Priority)
+    {
+        m_iPriority.store(std::max(0, std::min(static_cast<int>(p_Priority),
+                                               MODULE_PRIORITY_NUM - 1)));
+    }
+
+    /**
+     * @brief WaitIdle waits until this strand has no pending or running item.
+     *
+     * @param[in]   p_iWait_ms  Maximum wait (ms). If negative waits forever.
+     *
+     * @return true if the strand is idle.
+     */
+    bool WaitIdle(const int p_iWait_ms = -1)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+        QElapsedTimer   l_Timer;
+
+        l_Timer.start();
+
+        while (m_bScheduled && m_pRunningThread != QThread::currentThread())
+        {
+            if (p_iWait_ms < 0)
+            {
+                m_condIdle.wait(&m_Mutex);
+            }
+            else
+            {
+                if (l_Timer.elapsed() >= p_iWait_ms)
+                {
+                    return false;
+                }
+
+                m_condIdle.wait(&m_Mutex,
+                                static_cast<unsigned long>(
+                                    p_iWait_ms - l_Timer.elapsed()));
+            }
+        }
+
+        return !m_bScheduled;
+    }
+
+protected:
+
+    /**
+     * @brief _Abandon is called for each pending item that will never be
+     * executed because the executor has been destroyed (see _Discard()). The
+     * default implementation does nothing.
+     *
+     * @param[in]   p_iItem     Abandoned item.
+     */
+    virtual void _Abandon(const int p_iItem)
+    {
+        Q_UNUSED(p_iItem);
+    }
+
+    /**
+     * @brief _Discard removes the pending items of a strand that will no
+     * longer be run by its executor and makes the strand idle, so that
+     * WaitIdle() returns. _Abandon() is called for each removed item.
+     */
+    void _Discard()
+    {
+        std::deque<Pending> l_dqPending;
+        size_t              l_s;
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            l_dqPending.swap(m_dqPending);
+
+            m_bScheduled = false;
+
+            m_condIdle.wakeAll();
+        }
+
+        for (l_s = 0; l_s < l_dqPending.size(); l_s++)
+        {
+            _Abandon(l_dqPending[l_s].m_iItem);
+        }
+    }
+
+    /**
+     * @brief _Execute processes a single item.
+     *
+     * @param[in]   p_iItem     Item to be processed (e.g. a port id).
+     */
+    virtual void _Execute(const int p_iItem) = 0;
+
+    /**
+     * @return the time the item being executed has waited since it was
+     * posted. Only valid within _Execute().
+     */
+    inline qint64 _GetWait_ns() const
+    {
+        return m_llWait_ns;
+    }
+
+    /**
+     * @brief _Post appends an item.
+     *
+     * @return true if the strand was idle and must be scheduled on a worker.
+     */
+    bool _Post(const int p_iItem)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        if (m_bClosed)
+        {
+            return false;
+        }
+
+        m_dqPending.push_back(Pending(p_iItem, m_Clock.nsecsElapsed()));
+
+        if (m_bScheduled)
+        {
+            return false;
+        }
+
+        m_bScheduled = true;
+
+        return true;
+    }
+
+    /**
+     * @brief _RunBatch executes up to MODULE_EXECUTOR_STRAND_BATCH items.
+     *
+     * @return true if items are still pending and the strand must be
+     * scheduled again.
+     */
+    bool _RunBatch()
+    {
+        Pending l_aItems[MODULE_EXECUTOR_STRAND_BATCH];
+        int     l_iNumItems;
+        int     l_i;
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            for (l_iNumItems = 0;
+                 l_iNumItems < MODULE_EXECUTOR_STRAND_BATCH &&
+                 !m_dqPending.empty();
+                 l_iNumItems++)
+            {
+                l_aItems[l_iNumItems] = m_dqPending.front();
+                m_dqPending.pop_front();
+            }
+
+            m_bRunning = true;
+            m_pRunningThread = QThread::currentThread();
+        }
+
+        for (l_i = 0; l_i < l_iNumItems; l_i++)
+        {
+            m_llWait_ns = m_Clock.nsecsElapsed() - l_aItems[l_i].m_llPosted_ns;
+
+            _Execute(l_aItems[l_i].m_iItem);
+        }
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            m_bRunning = false;
+            m_pRunningThread = NULL;
+
+            if (!m_dqPending.empty() && !m_bClosed)
+            {
+                return true;
+            }
+
+            m_bScheduled = false;
+
+            m_condIdle.wakeAll();
+        }
+
+        return false;
+    }
+
+protected:
+
+    /**
+     * @struct Pending
+     *
+     * @brief Item waiting to be executed.
+     */
+    struct Pending
+    {
+        Pending(const int p_iItem = 0, const qint64 p_llPosted_ns = 0)
+            : m_iItem(p_iItem),
+              m_llPosted_ns(p_llPosted_ns)
+        {
+            /* Empty. */
+        }
+
+        int     m_iItem; /**< Item. */
+
+        qint64  m_llPosted_ns; /**< Post time (m_Clock). */
+    };
+
+protected:
+
+    mutable QMutex  m_Mutex; /**< Protects the data of this strand. */
+
+    std::deque<Pending> m_dqPending; /**< Items waiting to be executed. */
+
+    QElapsedTimer   m_Clock; /**< Clock of the post times. */
+
+    QAtomicInt  m_iPriority; /**< Priority (see ModulePriority). */
+
+    qint64  m_llWait_ns; /**< Wait of the item being executed. */
+
+    bool    m_bScheduled; /**< True if the strand is queued on a worker or
+                           * running. */
+
+    bool    m_bRunning; /**< True if an item is being executed. */
+
+    bool    m_bClosed; /**< True if no more items must be executed. */
+
+    QThread*    m_pRunningThread; /**< Worker executing the strand. */
+
+    QWaitCondition  m_condIdle; /**< Signaled when the strand gets idle. */
+
+}; // end class ModuleExecutorStrand.
+
+/******************************************************************************/
+/**
+ * @class ModuleExecutor
+ *
+ * @brief Fixed pool of worker threads that executes ModuleExecutorStrand
+ * objects. Each worker owns a deque of ready strands per priority: a worker
+ * takes the most recently readied strand of its own deque and, when its deque
+ * is empty, steals the oldest strand of another worker. A strand readied from
+ * a worker is pushed to the deque of that worker, so that a consumer tends to
+ * run on the core that has just produced its input. A strand that still has
+ * pending items after its batch goes to the other end of the deque of its
+ * worker, behind the ready strands, so that a busy strand does not starve
+ * them.
+ *
+ * An idle worker sleeps until a strand is readied: m_iNumReady counts the
+ * ready strands, so that a worker never sleeps while one is waiting.
+ *
+ * A worker looks for a strand of lower priority only when no strand of higher
+ * priority is ready, either in its deque or in the deques of the other
+ * workers, except once every MODULE_EXECUTOR_AGING_PERIOD strands taken, when
+ * it looks starting from the lowest priority. A ready strand of low priority
+ * therefore gets at least that share of a worker under a sustained load of
+ * higher priority, instead of starving.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleExecutor
+{
+public:
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param[in]   p_iNumThreads   Number of workers. If not positive, the
+     *                              number of cores is used.
+     */
+    ModuleExecutor(const int p_iNumThreads = 0)
+        : m_iNextWorker(0),
+          m_iNumReady(0),
+          m_iNumSleeping(0),
+          m_iStop(0)
+    {
+        int     l_iNumThreads;
+        int     l_i;
+
+        l_iNumThreads = p_iNumThreads;
+
+        if (l_iNumThreads <= 0)
+        {
+            l_iNumThreads = std::max(1, QThread::idealThreadCount());
+        }
+
+        for (l_i = 0; l_i < l_iNumThreads; l_i++)
+        {
+            m_vWorkers.push_back(new Worker(this, l_i));
+        }
+
+        for (l_i = 0; l_i < l_iNumThreads; l_i++)
+        {
+            m_vWorkers[l_i]->start();
+        }
+    }
+
+    /**
+     * @brief Destructor: stops the workers. The strands still queued are not
+     * executed: their pending items are discarded (see
+     * ModuleExecutorStrand::_Discard()), so that the threads waiting for them
+     * are released.
+     */
+    ~ModuleExecutor()
+    {
+        size_t  l_s;
+        int     l_iPriority;
+
+        {
+            QMutexLocker    l_Lock(&m_MutexSleep);
+
+            m_iStop.storeRelease(1);
+
+            m_condWork.wakeAll();
+        }
+
+        for (l_s = 0; l_s < m_vWorkers.size(); l_s++)
+        {
+            m_vWorkers[l_s]->wait();
+        }
+
+        for (l_s = 0; l_s < m_vWorkers.size(); l_s++)
+        {
+            for (l_iPriority = 0;
+                 l_iPriority < MODULE_PRIORITY_NUM;
+                 l_iPriority++)
+            {
+                std::deque<ModuleExecutorStrandPtr>&    l_rdqReady =
+                        m_vWorkers[l_s]->m_adqReady[l_iPriority];
+
+                while (!l_rdqReady.empty())
+                {
+                    l_rdqReady.front()->_Discard();
+                    l_rdqReady.pop_front();
+                }
+            }
+
+            delete m_vWorkers[l_s];
+        }
+    }
+
+    /**
+     * @return the number of worker threads.
+     */
+    inline int GetNumThreads() const
+    {
+        return static_cast<int>(m_vWorkers.size());
+    }
+
+    /**
+     * @brief Post appends an item to a strand and schedules the strand if it
+     * was idle.
+     *
+     * @param[in]   p_pStrand   Strand.
+     * @param[in]   p_iItem     Item to be executed.
+     */
+    void Post(ModuleExecutorStrandPtr   p_pStrand,
+              const int                 p_iItem)
+    {
+        if (p_pStrand && p_pStrand->_Post(p_iItem))
+        {
+            _Schedule(p_pStrand);
+        }
+    }
+
+protected:
+
+    /**
+     * @class Worker
+     *
+     * @brief Worker thread of a ModuleExecutor.
+     */
+    class Worker : public QThread
+    {
+    public:
+
+        Worker(ModuleExecutor* p_pExecutor, const int p_iIndex)
+            : m_uiNumTaken(0),
+              m_pExecutor(p_pExecutor),
+              m_iIndex(p_iIndex)
+        {
+            /* Empty. */
+        }
+
+        mutable QMutex  m_Mutex; /**< Protects m_adqReady. */
+
+        std::deque<ModuleExecutorStrandPtr>  m_adqReady[MODULE_PRIORITY_NUM];
+                                    /**< Ready strands, per priority. */
+
+        unsigned int    m_uiNumTaken; /**< Number of calls to _Take(). Only
+                                       * accessed by this worker. */
+
+    protected:
+
+        virtual void run()
+        {
+            ModuleExecutorStrandPtr     l_pStrand;
+
+            while (m_pExecutor->_Take(m_iIndex, l_pStrand))
+            {
+                if (l_pStrand->_RunBatch())
+                {
+                    m_pExecutor->_Schedule(l_pStrand, true);
+                }
+
+                RELEASE_PTR(l_pStrand);
+            }
+        }
+
+    protected:
+
+        ModuleExecutor*     m_pExecutor;
+
+        const int   m_iIndex;
+
+    }; // end class Worker.
+
+    friend class Worker;
+
+protected:
+
+    /**
+     * @return the index of the worker running in the current thread, or -1.
+     */
+    int _CurrentWorker() const
+    {
+        QThread*    l_pThread;
+        size_t      l_s;
+
+        l_pThread = QThread::currentThread();
+
+        for (l_s = 0; l_s < m_vWorkers.size(); l_s++)
+        {
+            if (m_vWorkers[l_s] == l_pThread)
+            {
+                return static_cast<int>(l_s);
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * @brief _Schedule pushes a ready strand to a worker deque and wakes a
+     * sleeping worker.
+     *
+     * @param[in]   p_pStrand   Strand.
+     * @param[in]   p_bRequeue  True if the strand has just run a batch on the
+     *                          current worker: it is pushed to the end its
+     *                          worker takes last and the thieves take first.
+     */
+    void _Schedule(ModuleExecutorStrandPtr  p_pStrand,
+                   const bool               p_bRequeue = false)
+    {
+        int     l_iWorker;
+        int     l_iPriority;
+
+        l_iWorker = _CurrentWorker();
+
+        if (l_iWorker < 0)
+        {
+            l_iWorker = static_cast<unsigned int>(
+                            m_iNextWorker.fetchAndAddRelaxed(1)) %
+                        m_vWorkers.size();
+        }
+
+        l_iPriority = static_cast<int>(p_pStrand->GetPriority());
+
+        {
+            QMutexLocker    l_Lock(&m_vWorkers[l_iWorker]->m_Mutex);
+            std::deque<ModuleExecutorStrandPtr>&    l_rdqReady =
+                    m_vWorkers[l_iWorker]->m_adqReady[l_iPriority];
+
+            if (p_bRequeue)
+            {
+                l_rdqReady.push_front(p_pStrand);
+            }
+            else
+            {
+                l_rdqReady.push_back(p_pStrand);
+            }
+        }
+
+        /* Full barriers: either a worker going to sleep sees the ready
+         * strand, or this thread sees the worker sleeping and wakes it under
+         * m_MutexSleep (see _Take()). */
+        m_iNumReady.fetchAndAddOrdered(1);
+
+        if (m_iNumSleeping.fetchAndAddOrdered(0) > 0)
+        {
+            QMutexLocker    l_Lock(&m_MutexSleep);
+
+            m_condWork.wakeOne();
+        }
+    }
+
+    /**
+     * @brief _Take gets the next strand for a worker, starting from the
+     * highest priority (from the lowest one once every
+     * MODULE_EXECUTOR_AGING_PERIOD calls): the newest one of its own deque or
+     * the oldest one stolen from another worker. Sleeps while no strand is
+     * ready.
+     *
+     * @return false if the executor is stopping.
+     */
+    bool _Take(const int                    p_iWorker,
+               ModuleExecutorStrandPtr&     p_rpStrand)
+    {
+        size_t  l_sNumWorkers;
+        size_t  l_s;
+        Worker* l_pVictim;
+        bool    l_bAging;
+        int     l_iLevel;
+        int     l_iPriority;
+
+        l_sNumWorkers = m_vWorkers.size();
+        l_bAging = (m_vWorkers[p_iWorker]->m_uiNumTaken++ %
+                        MODULE_EXECUTOR_AGING_PERIOD ==
+                    MODULE_EXECUTOR_AGING_PERIOD - 1);
+
+        for (;;)
+        {
+            if (m_iStop.loadAcquire())
+            {
+                return false;
+            }
+
+            for (l_iLevel = 0; l_iLevel < MODULE_PRIORITY_NUM; l_iLevel++)
+            {
+                l_iPriority = (l_bAging ?
+                                   l_iLevel :
+                                   MODULE_PRIORITY_NUM - 1 - l_iLevel);
+
+                {
+                    QMutexLocker    l_Lock(&m_vWorkers[p_iWorker]->m_Mutex);
+                    std::deque<ModuleExecutorStrandPtr>&    l_rdqOwn =
+                            m_vWorkers[p_iWorker]->m_adqReady[l_iPriority];
+
+                    if (!l_rdqOwn.empty())
+                    {
+                        p_rpStrand = l_rdqOwn.back();
+                        l_rdqOwn.pop_back();
+
+                        m_iNumReady.fetchAndAddOrdered(-1);
+
+                        return true;
+                    }
+                }
+
+                for (l_s = 1; l_s < l_sNumWorkers; l_s++)
+                {
+                    l_pVictim = m_vWorkers[(p_iWorker + l_s) % l_sNumWorkers];
+
+                    QMutexLocker    l_Lock(&l_pVictim->m_Mutex);
+                    std::deque<ModuleExecutorStrandPtr>&    l_rdqVictim =
+                            l_pVictim->m_adqReady[l_iPriority];
+
+                    if (!l_rdqVictim.empty())
+                    {
+                        p_rpStrand = l_rdqVictim.front();
+                        l_rdqVictim.pop_front();
+
+                        m_iNumReady.fetchAndAddOrdered(-1);
+
+                        return true;
+                    }
+                }
+            }
+
+            {
+                QMutexLocker    l_Lock(&m_MutexSleep);
+
+                m_iNumSleeping.fetchAndAddOrdered(1);
+
+                /* A strand readied after this check sees m_iNumSleeping
+                 * and wakes this worker under m_MutexSleep. */
+                while (m_iNumReady.fetchAndAddOrdered(0) <= 0 &&
+                       !m_iStop.load())
+                {
+                    m_condWork.wait(&m_MutexSleep);
+                }
+
+                m_iNumSleeping.fetchAndAddOrdered(-1);
+            }
+        }
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleExecutor(const ModuleExecutor&);
+    ModuleExecutor& operator = (const ModuleExecutor&);
+
+protected:
+
+    std::vector<Worker*>    m_vWorkers; /**< Worker threads. */
+
+    QAtomicInt  m_iNextWorker; /**< Round-robin index for the strands readied
+                                * from outside the workers. */
+
+    QAtomicInt  m_iNumReady; /**< Number of strands in the deques of the
+                              * workers. */
+
+    QAtomicInt  m_iNumSleeping; /**< Number of sleeping workers. */
+
+    QMutex  m_MutexSleep; /**< Protects the sleep of the workers. */
+
+    QWaitCondition  m_condWork; /**< Wakes the sleeping workers. */
+
+    QAtomicInt  m_iStop; /**< Non-zero when the workers must exit. */
+
+}; // end class ModuleExecutor.
+
+} // end namespace fby.
+
+#endif // MODULE_EXECUTOR_H
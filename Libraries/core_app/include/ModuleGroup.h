@@ -45,6 +45,31 @@ public:
      */
     virtual void AddModule(ModulePtr p_pModule);
 
+    /**
+     * @brief CollectStats appends the execution statistics of this ModuleGroup
+     * and of all the managed modules to the input list.
+     *
+     * @note ModuleGroup is built into the core_app library and cannot become a
+     * ModuleStatsSource without changing its layout: the managed modules are
+     * collected only when the group is reached through its own type, while
+     * Module::CollectStats() reports the group alone.
+     *
+     * @param[in,out]   p_rlStats   List of statistics.
+     */
+    void CollectStats(ModuleStatsList& p_rlStats) const
+    {
+        ModuleList::const_iterator  l_it;
+
+        Module::CollectStats(p_rlStats);
+
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        FORALL(m_lModules, l_it)
+        {
+            (*l_it)->CollectStats(p_rlStats);
+        }
+    }
+
     /**
      * @brief ContainsModule checks if this ModuleGroup manages a specified
      * Module.
@@ -0,0 +1,819 @@
+#ifndef MODULE_JOIN_H
+#define MODULE_JOIN_H
+
+/** @file ModuleJoin.h
+ *
+ * @brief Defines the ModuleJoin class, a Module that synchronizes the Data
+ * received on its input ports by timestamp.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <DataFrame.h>
+#include <Module.h>
+
+#include <cmath>
+#include <deque>
+
+/** Default tolerance of the nearest and interpolate policies (us). */
+#define MODULE_JOIN_DEFAULT_TOLERANCE_US    20000
+
+/** Default maximum time a reference Data waits for its matches (ms). */
+#define MODULE_JOIN_DEFAULT_MAX_WAIT_MS     200
+
+/** Default maximum number of Data buffered per input port. */
+#define MODULE_JOIN_DEFAULT_MAX_QUEUE       64
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class DataJoin
+ *
+ * @brief Tuple of Data with the same timestamp, one per input port of the
+ * ModuleJoin that produced it. A DataJoin is never modified after it has been
+ * notified: the ModuleJoin publishes a new object for each tuple, so that the
+ * output can also feed queued links.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class DataJoin : public Data
+{
+public:
+
+    DataJoin()
+        : m_llTimestamp(0)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @return the Data received on the specified input port, or a null object
+     * if the id is not valid.
+     */
+    inline DataPtr GetData(const int p_iPortId) const
+    {
+        if (p_iPortId < 0 || p_iPortId >= GetNumData())
+        {
+            return DataPtr();
+        }
+
+        return m_vData[p_iPortId];
+    }
+
+    /** @return the number of Data of the tuple. */
+    inline int GetNumData() const
+    {
+        return static_cast<int>(m_vData.size());
+    }
+
+    /** @return the timestamp of the tuple (UTC us). */
+    inline long long GetTimestamp() const
+    {
+        return m_llTimestamp;
+    }
+
+public:
+
+    long long   m_llTimestamp; /**< Timestamp of the reference Data. */
+
+    std::vector<DataPtr>    m_vData; /**< Data, indexed by input port. */
+
+}; // end class DataJoin.
+
+DEF_PTR(DataJoin);
+
+/******************************************************************************/
+/**
+ * @class ModuleJoin
+ *
+ * @ingroup Modules
+ *
+ * @brief Buffers the Data received on each input port and emits a DataJoin
+ * on its output port for each Data of the reference port (port 0) that can be
+ * matched with a Data of every other port:
+ *
+ * - JOIN_EXACT: same timestamp;
+ * - JOIN_NEAREST: nearest timestamp, within the tolerance;
+ * - JOIN_INTERPOLATE: value interpolated between the Data that bracket the
+ *   reference timestamp, each within the tolerance (see _Interpolate()).
+ *
+ * The timestamps are read by _GetTimestamp() (by default the Metadata of a
+ * DataFrame). Each port must receive increasing timestamps. The buffered
+ * DataFrames are shallow copies that share the pixel buffer of the received
+ * ones, so that the producers can reuse their output Data.
+ *
+ * Memory and latency are bounded: each port buffers at most a given number of
+ * Data (the oldest are dropped) and a reference Data waits at most a given
+ * time for its matches. When the wait expires the nearest and interpolate
+ * policies fall back to the nearest Data within the tolerance, otherwise the
+ * reference Data is discarded as unmatched. The wait is checked on every
+ * received Data and on every execution of the main timer, so the module
+ * should be started with a loop time when an input can stall.
+ *
+ * Link the inputs with g_LinkModulesQueued() so that no Data is lost when the
+ * producers run faster than this module.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleJoin : public Module
+{
+public:
+
+    /**
+     * @enum JoinPolicy
+     *
+     * @brief Enumerates the ways the Data of a port are matched to the
+     * reference timestamp.
+     */
+    enum JoinPolicy
+    {
+        JOIN_EXACT = 0, /**< Same timestamp. */
+        JOIN_NEAREST, /**< Nearest timestamp within the tolerance. */
+        JOIN_INTERPOLATE /**< Interpolation within the tolerance. */
+
+    }; // end enum JoinPolicy.
+
+public:
+
+    /**
+     * @brief Builds a join of the specified number of inputs.
+     *
+     * @param[in]   p_Mode          Execution mode.
+     * @param[in]   p_iNumInputs    Number of input ports (at least 2). Port 0
+     *                              is the reference.
+     * @param[in]   p_Policy        Matching policy.
+     */
+    ModuleJoin(ModuleExecMode   p_Mode,
+               const int        p_iNumInputs = 2,
+               JoinPolicy       p_Policy = JOIN_NEAREST)
+        : Module(p_Mode),
+          m_vQueues(std::max(p_iNumInputs, 2)),
+          m_llEmitted(0),
+          m_llUnmatched(0),
+          m_llDropped(0)
+    {
+        m_Config.m_Policy = p_Policy;
+
+        m_Clock.start();
+    }
+
+    virtual ~ModuleJoin()
+    {
+        _CloseExecution();
+    }
+
+    /** @return the number of emitted tuples. */
+    inline qint64 GetNumEmitted() const
+    {
+        LOCK_MODULE_READ(l_Lock);
+
+        return m_llEmitted;
+    }
+
+    /** @return the number of reference Data discarded as unmatched. */
+    inline qint64 GetNumUnmatched() const
+    {
+        LOCK_MODULE_READ(l_Lock);
+
+        return m_llUnmatched;
+    }
+
+    /** @return the number of Data dropped because a buffer was full, or
+     * because they had no timestamp. */
+    inline qint64 GetNumDropped() const
+    {
+        LOCK_MODULE_READ(l_Lock);
+
+        return m_llDropped;
+    }
+
+    RetFlag Init(ModuleExecMode p_Mode)
+    {
+        RetFlag     l_Result;
+
+        l_Result = Module::Init(p_Mode);
+
+        if (l_Result != RET_SUCCESS)
+        {
+            return l_Result;
+        }
+
+        AddInput(static_cast<int>(m_vQueues.size()));
+        AddOutput(DataPtr(new DataJoin));
+
+        _LockInputPortNum();
+        _LockOutputPortNum();
+
+        return l_Result;
+    }
+
+    /**
+     * @brief SetMaxQueue sets the maximum number of Data buffered per port.
+     */
+    void SetMaxQueue(const int p_iMaxQueue)
+    {
+        LOCK_MODULE_WRITE(l_Lock);
+
+        m_Config.m_iMaxQueue = std::max(p_iMaxQueue, 1);
+    }
+
+    /**
+     * @brief SetMaxWait sets the maximum time a reference Data waits for its
+     * matches.
+     */
+    void SetMaxWait(const int p_iMaxWait_ms)
+    {
+        LOCK_MODULE_WRITE(l_Lock);
+
+        m_Config.m_iMaxWait_ms = std::max(p_iMaxWait_ms, 0);
+    }
+
+    /**
+     * @brief SetPolicy sets the matching policy.
+     */
+    void SetPolicy(JoinPolicy p_Policy)
+    {
+        LOCK_MODULE_WRITE(l_Lock);
+
+        m_Config.m_Policy = p_Policy;
+    }
+
+    /**
+     * @brief SetTolerance sets the maximum distance between the reference
+     * timestamp and a matched one (nearest and interpolate policies).
+     */
+    void SetTolerance(const long long p_llTolerance_us)
+    {
+        LOCK_MODULE_WRITE(l_Lock);
+
+        m_Config.m_llTolerance_us = std::max(p_llTolerance_us, 0LL);
+    }
+
+protected:
+
+    /**
+     * @enum MatchResult
+     *
+     * @brief Result of the match of a port to a reference timestamp.
+     */
+    enum MatchResult
+    {
+        MATCH_OK = 0, /**< The port has a match. */
+        MATCH_WAIT, /**< A match may still arrive. */
+        MATCH_MISS /**< The port cannot match the timestamp. */
+
+    }; // end enum MatchResult.
+
+    /**
+     * @struct Item
+     *
+     * @brief Data buffered by an input port.
+     */
+    struct Item
+    {
+        long long   m_llTimestamp; /**< Timestamp of the Data (us). */
+
+        qint64      m_llArrival_ms; /**< Arrival time (m_Clock). */
+
+        DataPtr     m_pData; /**< Buffered Data. */
+    };
+
+    typedef std::deque<Item>    ItemQueue;
+
+    /**
+     * @struct JoinConfig
+     *
+     * @brief Parameters of the join.
+     */
+    struct JoinConfig
+    {
+        JoinConfig()
+            : m_Policy(JOIN_NEAREST),
+              m_llTolerance_us(MODULE_JOIN_DEFAULT_TOLERANCE_US),
+              m_iMaxWait_ms(MODULE_JOIN_DEFAULT_MAX_WAIT_MS),
+              m_iMaxQueue(MODULE_JOIN_DEFAULT_MAX_QUEUE)
+        {
+            /* Empty. */
+        }
+
+        JoinPolicy  m_Policy; /**< Matching policy. */
+
+        long long   m_llTolerance_us; /**< Maximum distance of a match. */
+
+        int     m_iMaxWait_ms; /**< Maximum wait of a reference Data. */
+
+        int     m_iMaxQueue; /**< Maximum number of Data per port. */
+    };
+
+protected:
+
+    /**
+     * @brief _GetTimestamp reads the timestamp of a received Data. The default
+     * implementation supports DataFrame and DataJoin.
+     *
+     * @param[in]   p_iPortId       Input port of the Data.
+     * @param[in]   p_pData         Received Data.
+     * @param[out]  p_rllTimestamp  Timestamp (UTC us).
+     *
+     * @return false if the Data has no timestamp: the Data is dropped.
+     */
+    virtual bool _GetTimestamp(const int        p_iPortId,
+                               const DataPtr&   p_pData,
+                               long long&       p_rllTimestamp)
+    {
+        DataJoinPtr     l_pJoin;
+
+        Q_UNUSED(p_iPortId);
+
+        if (g_GetDataTimestamp(p_pData, p_rllTimestamp))
+        {
+            return true;
+        }
+
+        l_pJoin = DYNAMIC_PTR_CAST<DataJoin>(p_pData);
+
+        if (l_pJoin)
+        {
+            p_rllTimestamp = l_pJoin->GetTimestamp();
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief _Interpolate builds the Data of a port at the reference timestamp
+     * from the two buffered Data that bracket it. The default implementation
+     * supports DataFrame: it returns a copy of the nearest frame, whose
+     * Metadata are linearly interpolated (angles on the shortest arc).
+     *
+     * @param[in]   p_iPortId       Input port.
+     * @param[in]   p_rBefore       Data before the reference timestamp.
+     * @param[in]   p_rAfter        Data after the reference timestamp.
+     * @param[in]   p_llTimestamp   Reference timestamp.
+     *
+     * @return the interpolated Data, or a null object if the Data cannot be
+     * interpolated (the reference Data is discarded as unmatched).
+     */
+    virtual DataPtr _Interpolate(const int          p_iPortId,
+                                 const Item&        p_rBefore,
+                                 const Item&        p_rAfter,
+                                 const long long    p_llTimestamp)
+    {
+        DataFramePtr    l_pBefore;
+        DataFramePtr    l_pAfter;
+        DataFramePtr    l_pResult;
+        Metadata        l_Metadata;
+        double          l_dAlpha;
+
+        Q_UNUSED(p_iPortId);
+
+        l_pBefore = DYNAMIC_PTR_CAST<DataFrame>(p_rBefore.m_pData);
+        l_pAfter = DYNAMIC_PTR_CAST<DataFrame>(p_rAfter.m_pData);
+
+        if (!l_pBefore || !l_pAfter)
+        {
+            return DataPtr();
+        }
+
+        l_dAlpha = (p_rAfter.m_llTimestamp > p_rBefore.m_llTimestamp) ?
+                        static_cast<double>(p_llTimestamp -
+                                            p_rBefore.m_llTimestamp) /
+                        (p_rAfter.m_llTimestamp - p_rBefore.m_llTimestamp) :
+                        0.0;
+
+        /* The buffered frames are private copies: no lock is needed. */
+        l_pResult.reset(new DataFrame);
+        l_pResult->CopyFrame(*(l_dAlpha < 0.5 ? l_pBefore : l_pAfter));
+        l_pResult->CopyProperties(*(l_dAlpha < 0.5 ? l_pBefore : l_pAfter));
+
+        _InterpolateMetadata(l_pBefore->GetMetadata(),
+                             l_pAfter->GetMetadata(),
+                             l_dAlpha,
+                             l_pResult->GetFrame().m_Metadata);
+
+        l_pResult->GetFrame().m_Metadata.m_llTimestamp = p_llTimestamp;
+
+        return l_pResult;
+    }
+
+    /**
+     * @brief _Snapshot returns the Data to be buffered for a received Data.
+     * The default implementation is g_SnapshotData().
+     */
+    virtual DataPtr _Snapshot(const int p_iPortId, const DataPtr& p_pData)
+    {
+        Q_UNUSED(p_iPortId);
+
+        return g_SnapshotData(p_pData);
+    }
+
+    RetFlag _ThreadFunction(const int p_iPortId)
+    {
+        DataPtr     l_pData;
+        Item        l_Item;
+
+        {
+            LOCK_MODULE_READ(l_Lock);
+
+            m_ActiveConfig = m_Config;
+        }
+
+        if (p_iPortId >= 0 && p_iPortId < static_cast<int>(m_vQueues.size()))
+        {
+            while (DEQUEUE_INPUT_DATA(l_pData, p_iPortId))
+            {
+                if (!_GetTimestamp(p_iPortId, l_pData, l_Item.m_llTimestamp))
+                {
+                    _AddDropped(1);
+                    continue;
+                }
+
+                l_Item.m_llArrival_ms = m_Clock.elapsed();
+                l_Item.m_pData = _Snapshot(p_iPortId, l_pData);
+
+                _Push(p_iPortId, l_Item);
+
+                if (!_IsInputQueued(p_iPortId))
+                {
+                    break;
+                }
+            }
+        }
+
+        _Process();
+
+        return RET_SUCCESS;
+    }
+
+protected:
+
+    /** @brief _AddDropped updates the number of dropped Data. */
+    inline void _AddDropped(const qint64 p_llNum)
+    {
+        LOCK_MODULE_WRITE(l_Lock);
+
+        m_llDropped += p_llNum;
+    }
+
+    /** @brief _Emit publishes a new DataJoin with the input tuple. */
+    void _Emit(const long long              p_llTimestamp,
+               const std::vector<DataPtr>&  p_rvTuple)
+    {
+        DataJoinPtr     l_pJoin;
+        ModulePort*     l_pPort;
+
+        l_pJoin.reset(new DataJoin);
+        l_pJoin->m_llTimestamp = p_llTimestamp;
+        l_pJoin->m_vData = p_rvTuple;
+
+        {
+            LOCK_MODULE_WRITE(l_Lock);
+
+            m_llEmitted++;
+        }
+
+        l_pPort = _PortOut(0);
+
+        if (l_pPort)
+        {
+            l_pPort->SetData(l_pJoin);
+            l_pPort->Notify();
+        }
+    }
+
+    /**
+     * @brief _InterpolateMetadata linearly interpolates the numeric fields of
+     * two Metadata. The angles, longitudes included, are interpolated on the
+     * shortest arc, so that a track crossing the antimeridian does not sweep
+     * the whole globe; the other fields are taken from the nearest Metadata.
+     */
+    static void _InterpolateMetadata(const Metadata&    p_rBefore,
+                                     const Metadata&    p_rAfter,
+                                     const double       p_dAlpha,
+                                     Metadata&          p_rResult)
+    {
+        p_rResult = (p_dAlpha < 0.5 ? p_rBefore : p_rAfter);
+
+#define MODULE_JOIN_LERP(field) \
+        p_rResult.field = p_rBefore.field + \
+                          (p_rAfter.field - p_rBefore.field) * p_dAlpha
+
+#define MODULE_JOIN_LERP_DEG(field) \
+        p_rResult.field = _LerpAngle_deg(p_rBefore.field, \
+                                         p_rAfter.field, \
+                                         p_dAlpha)
+
+        MODULE_JOIN_LERP_DEG(m_fPlatformHeading_deg);
+        MODULE_JOIN_LERP_DEG(m_fPlatformPitch_deg);
+        MODULE_JOIN_LERP_DEG(m_fPlatformRoll_deg);
+        MODULE_JOIN_LERP(m_fPlatformTrueAirSpeed_m_s);
+        MODULE_JOIN_LERP(m_dSensorLat_deg);
+        MODULE_JOIN_LERP_DEG(m_dSensorLon_deg);
+        MODULE_JOIN_LERP(m_dSensorAlt_m);
+        MODULE_JOIN_LERP(m_fSensorHFOV_deg);
+        MODULE_JOIN_LERP(m_fSensorVFOV_deg);
+        MODULE_JOIN_LERP_DEG(m_fSensorAzimuth_deg);
+        MODULE_JOIN_LERP_DEG(m_fSensorElevation_deg);
+        MODULE_JOIN_LERP_DEG(m_fSensorRoll_deg);
+        MODULE_JOIN_LERP(m_fSlantRange_m);
+        MODULE_JOIN_LERP(m_fTargetWidth_m);
+        MODULE_JOIN_LERP(m_dFrameCenterLat_deg);
+        MODULE_JOIN_LERP_DEG(m_dFrameCenterLon_deg);
+        MODULE_JOIN_LERP(m_dFrameCenterAlt_m);
+        MODULE_JOIN_LERP_DEG(m_fWindDirection_deg);
+        MODULE_JOIN_LERP(m_fWindSpeed_m_s);
+
+#undef MODULE_JOIN_LERP
+#undef MODULE_JOIN_LERP_DEG
+    }
+
+    /** @return the interpolation of two angles on the shortest arc (deg). */
+    static inline double _LerpAngle_deg(const double p_dBefore_deg,
+                                        const double p_dAfter_deg,
+                                        const double p_dAlpha)
+    {
+        double  l_dDelta_deg;
+        double  l_dResult_deg;
+
+        l_dDelta_deg = fmod(p_dAfter_deg - p_dBefore_deg, 360.0);
+
+        if (l_dDelta_deg > 180.0)
+        {
+            l_dDelta_deg -= 360.0;
+        }
+        else if (l_dDelta_deg < -180.0)
+        {
+            l_dDelta_deg += 360.0;
+        }
+
+        l_dResult_deg = p_dBefore_deg + l_dDelta_deg * p_dAlpha;
+
+        /* Keep the range of the inputs: [0, 360) or [-180, 180). */
+        if (p_dBefore_deg >= 0.0 && p_dAfter_deg >= 0.0)
+        {
+            l_dResult_deg = fmod(l_dResult_deg + 360.0, 360.0);
+        }
+        else if (l_dResult_deg >= 180.0)
+        {
+            l_dResult_deg -= 360.0;
+        }
+        else if (l_dResult_deg < -180.0)
+        {
+            l_dResult_deg += 360.0;
+        }
+
+        return l_dResult_deg;
+    }
+
+    /**
+     * @brief _Match matches the buffered Data of a port to a reference
+     * timestamp.
+     *
+     * @param[in]   p_iPortId       Input port.
+     * @param[in]   p_llTimestamp   Reference timestamp.
+     * @param[in]   p_bExpired      True if the reference Data cannot wait any
+     *                              longer.
+     * @param[out]  p_rpData        Matched Data.
+     */
+    MatchResult _Match(const int        p_iPortId,
+                       const long long  p_llTimestamp,
+                       const bool       p_bExpired,
+                       DataPtr&         p_rpData)
+    {
+        const ItemQueue&    l_rQueue = m_vQueues[p_iPortId];
+        const Item*         l_pBefore;
+        const Item*         l_pAfter;
+        const Item*         l_pNearest;
+        const long long     l_llTolerance_us = m_ActiveConfig.m_llTolerance_us;
+        size_t              l_s;
+
+        for (l_s = 0;
+             l_s < l_rQueue.size() &&
+             l_rQueue[l_s].m_llTimestamp < p_llTimestamp;
+             l_s++)
+        {
+            /* Empty. */
+        }
+
+        l_pBefore = (l_s > 0 ? &l_rQueue[l_s - 1] : NULL);
+        l_pAfter = (l_s < l_rQueue.size() ? &l_rQueue[l_s] : NULL);
+
+        if (l_pAfter && l_pAfter->m_llTimestamp == p_llTimestamp)
+        {
+            p_rpData = l_pAfter->m_pData;
+
+            return MATCH_OK;
+        }
+
+        if (m_ActiveConfig.m_Policy == JOIN_EXACT)
+        {
+            return ((l_pAfter || p_bExpired) ? MATCH_MISS : MATCH_WAIT);
+        }
+
+        l_pNearest = NULL;
+
+        if (l_pBefore &&
+            p_llTimestamp - l_pBefore->m_llTimestamp <= l_llTolerance_us)
+        {
+            l_pNearest = l_pBefore;
+        }
+
+        if (l_pAfter &&
+            l_pAfter->m_llTimestamp - p_llTimestamp <= l_llTolerance_us &&
+            (!l_pNearest ||
+             l_pAfter->m_llTimestamp - p_llTimestamp <
+                p_llTimestamp - l_pNearest->m_llTimestamp))
+        {
+            l_pNearest = l_pAfter;
+        }
+
+        if (m_ActiveConfig.m_Policy == JOIN_INTERPOLATE && l_pAfter)
+        {
+            if (!l_pBefore ||
+                p_llTimestamp - l_pBefore->m_llTimestamp > l_llTolerance_us ||
+                l_pAfter->m_llTimestamp - p_llTimestamp > l_llTolerance_us)
+            {
+                return MATCH_MISS;
+            }
+
+            p_rpData = _Interpolate(p_iPortId,
+                                    *l_pBefore,
+                                    *l_pAfter,
+                                    p_llTimestamp);
+
+            return (p_rpData ? MATCH_OK : MATCH_MISS);
+        }
+
+        /* Nearest policy, or interpolate policy without a Data after the
+         * reference: a nearer Data may still arrive, unless the wait is over
+         * or a Data after the reference has already been received. */
+        if (!l_pAfter && !p_bExpired)
+        {
+            return MATCH_WAIT;
+        }
+
+        if (!l_pNearest)
+        {
+            return MATCH_MISS;
+        }
+
+        p_rpData = l_pNearest->m_pData;
+
+        return MATCH_OK;
+    }
+
+    /**
+     * @brief _Process emits the tuples of the buffered reference Data that can
+     * be matched and discards the ones that cannot, then prunes the buffers.
+     */
+    void _Process()
+    {
+        std::vector<DataPtr>    l_vTuple;
+        MatchResult             l_Result;
+        qint64                  l_llNow_ms;
+        long long               l_llTimestamp;
+        bool                    l_bExpired;
+        size_t                  l_sPort;
+
+        l_llNow_ms = m_Clock.elapsed();
+        l_vTuple.resize(m_vQueues.size());
+
+        while (!m_vQueues[0].empty())
+        {
+            l_llTimestamp = m_vQueues[0].front().m_llTimestamp;
+            l_bExpired = (l_llNow_ms - m_vQueues[0].front().m_llArrival_ms >=
+                          m_ActiveConfig.m_iMaxWait_ms);
+
+            l_vTuple[0] = m_vQueues[0].front().m_pData;
+            l_Result = MATCH_OK;
+
+            for (l_sPort = 1;
+                 l_sPort < m_vQueues.size() && l_Result == MATCH_OK;
+                 l_sPort++)
+            {
+                l_Result = _Match(static_cast<int>(l_sPort),
+                                  l_llTimestamp,
+                                  l_bExpired,
+                                  l_vTuple[l_sPort]);
+            }
+
+            if (l_Result == MATCH_WAIT)
+            {
+                break;
+            }
+
+            m_vQueues[0].pop_front();
+
+            _Prune(l_llTimestamp);
+
+            if (l_Result == MATCH_OK)
+            {
+                _Emit(l_llTimestamp, l_vTuple);
+            }
+            else
+            {
+                LOCK_MODULE_WRITE(l_Lock);
+
+                m_llUnmatched++;
+            }
+        }
+
+        std::fill(l_vTuple.begin(), l_vTuple.end(), DataPtr());
+    }
+
+    /**
+     * @brief _Prune removes the Data of the secondary ports that are too old
+     * to match a reference timestamp after the input one, keeping the last
+     * one for the interpolation.
+     */
+    void _Prune(const long long p_llTimestamp)
+    {
+        long long   l_llOldest;
+        size_t      l_sPort;
+
+        l_llOldest = p_llTimestamp -
+                     (m_ActiveConfig.m_Policy == JOIN_EXACT ?
+                          0 : m_ActiveConfig.m_llTolerance_us);
+
+        for (l_sPort = 1; l_sPort < m_vQueues.size(); l_sPort++)
+        {
+            while (m_vQueues[l_sPort].size() >= 2 &&
+                   m_vQueues[l_sPort][1].m_llTimestamp <= l_llOldest)
+            {
+                m_vQueues[l_sPort].pop_front();
+            }
+        }
+    }
+
+    /**
+     * @brief _Push buffers a received Data, dropping the oldest buffered one
+     * if the buffer is full, or the received one if its timestamp is older
+     * than the last buffered one.
+     */
+    void _Push(const int p_iPortId, const Item& p_rItem)
+    {
+        ItemQueue&  l_rQueue = m_vQueues[p_iPortId];
+        qint64      l_llDropped;
+
+        l_llDropped = 0;
+
+        if (!l_rQueue.empty() &&
+            p_rItem.m_llTimestamp <= l_rQueue.back().m_llTimestamp)
+        {
+            _AddDropped(1);
+
+            return;
+        }
+
+        l_rQueue.push_back(p_rItem);
+
+        while (static_cast<int>(l_rQueue.size()) > m_ActiveConfig.m_iMaxQueue)
+        {
+            l_rQueue.pop_front();
+            l_llDropped++;
+        }
+
+        if (l_llDropped > 0)
+        {
+            _AddDropped(l_llDropped);
+        }
+    }
+
+protected:
+
+    JoinConfig  m_Config; /**< Parameters, set by the setters. */
+
+    JoinConfig  m_ActiveConfig; /**< Copy of the parameters used by the
+                                 * current execution of _ThreadFunction(). */
+
+    std::vector<ItemQueue>  m_vQueues; /**< Buffered Data, per input port.
+                                        * Only accessed by _ThreadFunction(). */
+
+    QElapsedTimer   m_Clock; /**< Clock of the arrival times. */
+
+    qint64  m_llEmitted; /**< Number of emitted tuples. */
+
+    qint64  m_llUnmatched; /**< Number of unmatched reference Data. */
+
+    qint64  m_llDropped; /**< Number of dropped Data. */
+
+}; // end class ModuleJoin.
+
+DEF_PTR(ModuleJoin);
+
+} // end namespace fby.
+
+#endif // MODULE_JOIN_H
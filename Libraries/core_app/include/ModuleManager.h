@@ -12,6 +12,8 @@
  */
 
 #include <ModuleDescriptor.h>
+#include <ModuleManifest.h>
+#include <ModuleRegistry.h>
 
 namespace fby
 {
@@ -31,6 +33,39 @@ public:
      * @return a list with the names of the available modules. */
     static QStringList  AvailableModules();
 
+    /**
+     * @brief Returns a new instance of the specified module. A module
+     * compiled into the application (see ModuleRegistry) is instantiated
+     * directly. Otherwise, if the module is not available yet but is listed
+     * in the manifest (see FindModulesCached()), its shared library is loaded
+     * first.
+     *
+     * @param[in]   p_rsModuleName      Name of the module to be instantiated.
+     * @param[in]   p_Mode              Execution mode of the new Module.
+     *
+     * @return The newly instantiated module or a null pointer if something
+     * was wrong.
+     */
+    static ModulePtr    Create(const QString&   p_rsModuleName,
+                               ModuleExecMode   p_Mode);
+
+    /**
+     * @brief Returns a new instance of the specified module wrapper, looking
+     * for it in the ModuleRegistry before the shared libraries (see
+     * NewWrapper()).
+     *
+     * @param[in]   p_rsModuleName      Name of the module to be instantiated.
+     * @param[in]   p_rsPath            Path to be provided to the constructor
+     *                                  of the Module.
+     * @param[in]   p_Mode              Execution mode of the new Module.
+     *
+     * @return The newly instantiated module or a null pointer if something
+     * was wrong.
+     */
+    static ModulePtr    CreateWrapper(const QString&    p_rsModuleName,
+                                      const QString&    p_rsPath,
+                                      ModuleExecMode    p_Mode);
+
     /**
      * @brief Detects all the available modules in the specified path and
      * stores their configuration in the internal map.
@@ -54,6 +89,28 @@ public:
                                 const QStringList&  p_rlModuleNames,
                                 ModuleExecMode      p_Mode);
 
+    /**
+     * @brief Detects the available modules in the specified path through a
+     * manifest file (see ModuleManifest): only the shared libraries that are
+     * new or have changed since the manifest was saved are loaded, in
+     * parallel, and the other ones are loaded by Create() when needed. The
+     * manifest is saved if it has changed.
+     *
+     * @param[in]   p_rstrPath      Path to the folder where the Modules are
+     *                              sought.
+     * @param[in]   p_Mode          Execution mode to check the Modules
+     *                              validity.
+     * @param[in]   p_rsManifest    Manifest file. If empty, the file
+     *                              MODULE_MANIFEST_FILE_NAME of the folder is
+     *                              used.
+     *
+     * @return the names of the valid modules.
+     */
+    static QStringList  FindModulesCached(const QString&    p_rstrPath,
+                                          ModuleExecMode    p_Mode,
+                                          const QString&    p_rsManifest =
+                                                                QString());
+
     /**
      * @brief Returns a new instance of the specified module, if available.
      * Otherwise returns a null object.
@@ -83,6 +140,26 @@ public:
                                    const QString&   p_rsPath,
                                    ModuleExecMode   p_Mode);
 
+    /**
+     * @brief Returns a new instance of the specified module, allocated by a
+     * private copy of its shared library (see SharedLib::LoadCopy()), so that
+     * a library rebuilt while the application is running can be loaded next
+     * to the one of the running instances. The copy stays loaded as long as
+     * the new instance (see Module::SetSharedLib()).
+     *
+     * @param[in]   p_rsModuleName      Name of the module to be instantiated.
+     * @param[in]   p_rsFileName        Shared library of the module. If empty,
+     *                                  the library listed in the manifest is
+     *                                  used (see FindModulesCached()).
+     * @param[in]   p_Mode              Execution mode of the new Module.
+     *
+     * @return The newly instantiated module or a null pointer if something
+     * was wrong.
+     */
+    static ModulePtr    Reload(const QString&   p_rsModuleName,
+                               const QString&   p_rsFileName,
+                               ModuleExecMode   p_Mode);
+
 protected:
 
     static ModuleManagerPtr     m_pInstance; /**< Unique instance of the module
@@ -109,6 +186,131 @@ protected:
 
 }; // end class ModuleManager.
 
+/******************************************************************************/
+inline ModulePtr ModuleManager::Create(const QString&   p_rsModuleName,
+                                       ModuleExecMode   p_Mode)
+{
+    ModuleManifestEntry     l_Entry;
+    ModuleAllocatorFun      l_funAllocator;
+
+    l_funAllocator = ModuleRegistry::FindAllocator(p_rsModuleName);
+
+    if (l_funAllocator)
+    {
+        return ModulePtr(l_funAllocator(p_Mode));
+    }
+
+    if (!AvailableModules().contains(p_rsModuleName) &&
+        ModuleManifest::GetInstance().Find(p_rsModuleName, l_Entry))
+    {
+        FindModules(QFileInfo(l_Entry.m_sFileName).absolutePath(),
+                    QStringList() << p_rsModuleName,
+                    l_Entry.m_Mode);
+    }
+
+    return New(p_rsModuleName, p_Mode);
+}
+
+/******************************************************************************/
+inline ModulePtr ModuleManager::CreateWrapper(const QString&    p_rsModuleName,
+                                              const QString&    p_rsPath,
+                                              ModuleExecMode    p_Mode)
+{
+    ModuleWrapperAllocatorFun   l_funAllocator;
+
+    l_funAllocator = ModuleRegistry::FindWrapperAllocator(p_rsModuleName);
+
+    if (l_funAllocator)
+    {
+        return ModulePtr(l_funAllocator(p_rsPath.toStdString(), p_Mode));
+    }
+
+    return NewWrapper(p_rsModuleName, p_rsPath, p_Mode);
+}
+
+/******************************************************************************/
+inline ModulePtr ModuleManager::Reload(const QString&   p_rsModuleName,
+                                       const QString&   p_rsFileName,
+                                       ModuleExecMode   p_Mode)
+{
+    ModuleManifestEntry     l_Entry;
+    ModuleAllocatorFun      l_funAllocator;
+    SharedLibPtr            l_pSharedLib;
+    ModulePtr               l_pModule;
+    QString                 l_sFileName;
+
+    l_sFileName = p_rsFileName;
+
+    if (l_sFileName.isEmpty() &&
+        ModuleManifest::GetInstance().Find(p_rsModuleName, l_Entry))
+    {
+        l_sFileName = l_Entry.m_sFileName;
+    }
+
+    if (l_sFileName.isEmpty())
+    {
+        qWarning() << "ModuleManager: no shared library for" << p_rsModuleName;
+
+        return ModulePtr();
+    }
+
+    l_pSharedLib = SharedLib::LoadCopy(l_sFileName);
+
+    if (!l_pSharedLib)
+    {
+        return ModulePtr();
+    }
+
+    l_funAllocator = reinterpret_cast<ModuleAllocatorFun>(
+                l_pSharedLib->m_SharedLibrary.resolve(
+                    (QString("New") + p_rsModuleName).toStdString().c_str()));
+
+    if (!l_funAllocator)
+    {
+        qWarning() << "ModuleManager:" << l_sFileName
+                   << "does not define" << p_rsModuleName;
+
+        return ModulePtr();
+    }
+
+    l_pModule.reset(l_funAllocator(p_Mode));
+
+    if (l_pModule)
+    {
+        l_pModule->SetSharedLib(l_pSharedLib);
+    }
+
+    return l_pModule;
+}
+
+/******************************************************************************/
+inline QStringList ModuleManager::FindModulesCached(
+        const QString&  p_rstrPath,
+        ModuleExecMode  p_Mode,
+        const QString&  p_rsManifest)
+{
+    ModuleManifest&     l_rManifest = ModuleManifest::GetInstance();
+    QString             l_sManifest;
+
+    l_sManifest = p_rsManifest;
+
+    if (l_sManifest.isEmpty())
+    {
+        l_sManifest = QDir(p_rstrPath).absoluteFilePath(
+                    MODULE_MANIFEST_FILE_NAME);
+    }
+
+    l_rManifest.Load(l_sManifest);
+    l_rManifest.Refresh(p_rstrPath, p_Mode);
+
+    if (l_rManifest.IsModified())
+    {
+        l_rManifest.Save(l_sManifest);
+    }
+
+    return l_rManifest.GetModuleNames();
+}
+
 } // end namespace fby.
 
 #endif // MODULE_MANAGER_H
@@ -0,0 +1,621 @@
+#ifndef MODULE_MANIFEST_H
+#define MODULE_MANIFEST_H
+
+/** @file ModuleManifest.h
+ *
+ * @brief Defines the ModuleManifest class, a persistent cache of the Modules
+ * found in the shared libraries of a folder.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Module.h>
+#include <SettingsDefs.h>
+
+#include <map>
+
+/** Version of the manifest file format. A manifest of another version is
+ * ignored. */
+#define MODULE_MANIFEST_VERSION     1
+
+/** Suffix of the names of the shared libraries built in debug (see the
+ * TARGET of FlysightConfig.pri). */
+#define MODULE_DEBUG_SUFFIX         QString("d")
+
+/** True if the application is built in debug: only the shared libraries of
+ * the same configuration are loaded. */
+#ifdef QT_DEBUG
+#define MODULE_DEBUG_BUILD          true
+#else
+#define MODULE_DEBUG_BUILD          false
+#endif
+
+/** Default name of the manifest file, in the folder of the Modules. The debug
+ * and release applications keep separate manifests. */
+#define MODULE_MANIFEST_FILE_NAME   (MODULE_DEBUG_BUILD ? \
+                                        QString("modulesd.manifest") : \
+                                        QString("modules.manifest"))
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @struct ModuleManifestEntry
+ *
+ * @brief Shared library of a Module, as recorded by a ModuleManifest.
+ */
+struct ModuleManifestEntry
+{
+    ModuleManifestEntry()
+        : m_llModified_ms(0),
+          m_llSize(0),
+          m_Mode(MODULE_MODE_INVALID),
+          m_bValid(false)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @return true if the entry still describes the input file, as checked
+     * in the input mode.
+     */
+    bool IsCurrent(const QFileInfo& p_rInfo, ModuleExecMode p_Mode) const
+    {
+        return (m_Mode == p_Mode &&
+                m_llSize == p_rInfo.size() &&
+                m_llModified_ms ==
+                    p_rInfo.lastModified().toMSecsSinceEpoch());
+    }
+
+    QString m_sFileName; /**< Absolute path of the shared library. */
+
+    qint64  m_llModified_ms; /**< Modification time of the library. */
+
+    qint64  m_llSize; /**< Size of the library (bytes). */
+
+    QString m_sModuleName; /**< Name of the Module (see
+                            * MODULE_ALLOC_FUN_DEC). */
+
+    ModuleExecMode  m_Mode; /**< Mode of the validity check. */
+
+    bool    m_bValid; /**< True if the Module has been instantiated in
+                       * m_Mode. */
+};
+
+/******************************************************************************/
+/**
+ * @class ModuleManifest
+ *
+ * @brief Persistent record of the Modules of a folder, keyed by the path,
+ * the modification time and the size of their shared libraries.
+ *
+ * ModuleManager::FindModules() loads every library of the folder and
+ * instantiates its Module to discover it. Refresh() only does so for the
+ * libraries that are new or have changed since the manifest was saved, in
+ * parallel, and the others are not loaded at all: ModuleManager::Create()
+ * loads the library of a Module the first time it is instantiated.
+ *
+ * Only the libraries of the configuration of the application are considered:
+ * in debug the ones whose name ends with MODULE_DEBUG_SUFFIX, which is not
+ * part of the name of the Module; in release all the others (see
+ * _FindLibraries()).
+ *
+ * @note The libraries checked by Refresh() are loaded in parallel and left
+ * loaded, so that their later instantiation does not load them again. Their
+ * Modules are instantiated one at a time in the thread that calls Refresh(),
+ * since a QObject belongs to the thread that creates it.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleManifest
+{
+public:
+
+    ModuleManifest()
+        : m_bModified(false)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief Find looks for a valid Module.
+     *
+     * @param[in]   p_rsModuleName  Name of the Module.
+     * @param[out]  p_rEntry        Library of the Module.
+     *
+     * @return true if the Module has been found.
+     */
+    bool Find(const QString&        p_rsModuleName,
+              ModuleManifestEntry&  p_rEntry) const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+        std::map<QString, ModuleManifestEntry>::const_iterator  l_it;
+
+        for (l_it = m_mapEntries.begin(); l_it != m_mapEntries.end(); l_it++)
+        {
+            if (l_it->second.m_bValid &&
+                l_it->second.m_sModuleName == p_rsModuleName)
+            {
+                p_rEntry = l_it->second;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @return the shared library of a Module in a folder, or an empty string.
+     */
+    static QString FindLibrary(const QString&   p_rsPath,
+                               const QString&   p_rsModuleName)
+    {
+        QStringList     l_lFiles;
+        int             l_i;
+
+        l_lFiles = _FindLibraries(p_rsPath);
+
+        for (l_i = 0; l_i < l_lFiles.size(); l_i++)
+        {
+            if (GetModuleName(QFileInfo(l_lFiles[l_i])) == p_rsModuleName)
+            {
+                return l_lFiles[l_i];
+            }
+        }
+
+        return QString();
+    }
+
+    /**
+     * @return the manifest shared by the application (see
+     * ModuleManager::FindModulesCached()).
+     */
+    static ModuleManifest& GetInstance()
+    {
+        static ModuleManifest   s_Manifest;
+
+        return s_Manifest;
+    }
+
+    /**
+     * @return the name of the Module of a shared library: its base name,
+     * without the "lib" prefix of the Unix libraries and, in debug, without
+     * MODULE_DEBUG_SUFFIX (e.g. modSimpled.dll contains modSimple).
+     */
+    static QString GetModuleName(const QFileInfo& p_rInfo)
+    {
+        QString     l_sName;
+
+        l_sName = p_rInfo.completeBaseName();
+
+        if (p_rInfo.suffix() != "dll" && l_sName.startsWith("lib"))
+        {
+            l_sName = l_sName.mid(3);
+        }
+
+        if (MODULE_DEBUG_BUILD && l_sName.endsWith(MODULE_DEBUG_SUFFIX))
+        {
+            l_sName.chop(MODULE_DEBUG_SUFFIX.size());
+        }
+
+        return l_sName;
+    }
+
+    /**
+     * @return the names of the valid Modules.
+     */
+    QStringList GetModuleNames() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+        QStringList     l_lNames;
+        std::map<QString, ModuleManifestEntry>::const_iterator  l_it;
+
+        for (l_it = m_mapEntries.begin(); l_it != m_mapEntries.end(); l_it++)
+        {
+            if (l_it->second.m_bValid)
+            {
+                l_lNames << l_it->second.m_sModuleName;
+            }
+        }
+
+        return l_lNames;
+    }
+
+    /**
+     * @return true if the entries have changed since the last Load() or
+     * Save().
+     */
+    bool IsModified() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return m_bModified;
+    }
+
+    /**
+     * @brief Load replaces the entries with the ones saved in a manifest
+     * file. A missing file or a file of another version leaves no entry.
+     *
+     * @retval  RET_SUCCESS     if the manifest has been loaded.
+     * @retval  RET_ERROR       otherwise.
+     */
+    RetFlag Load(const QString& p_rsFileName)
+    {
+        QSettings           l_Settings(p_rsFileName, QSettings::IniFormat);
+        ModuleManifestEntry l_Entry;
+        RetFlag             l_Result;
+        int                 l_iSize;
+        int                 l_i;
+
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_mapEntries.clear();
+        m_bModified = false;
+
+        l_Settings.beginGroup(SETTING_GROUP_MANIFEST);
+
+        l_Result = RET_ERROR;
+
+        if (l_Settings.value(SETTING_KEY_VERSION, 0).toInt() ==
+            MODULE_MANIFEST_VERSION)
+        {
+            l_iSize = l_Settings.beginReadArray(SETTING_GROUP_LIBRARIES);
+
+            for (l_i = 0; l_i < l_iSize; l_i++)
+            {
+                l_Settings.setArrayIndex(l_i);
+
+                l_Entry.m_sFileName =
+                        l_Settings.value(SETTING_KEY_FILE).toString();
+                l_Entry.m_llModified_ms =
+                        l_Settings.value(SETTING_KEY_MODIFIED).toLongLong();
+                l_Entry.m_llSize =
+                        l_Settings.value(SETTING_KEY_SIZE).toLongLong();
+                l_Entry.m_sModuleName =
+                        l_Settings.value(SETTING_KEY_MODULE).toString();
+                l_Entry.m_Mode = static_cast<ModuleExecMode>(
+                            l_Settings.value(SETTING_KEY_MODE,
+                                             MODULE_MODE_INVALID).toInt());
+                l_Entry.m_bValid =
+                        l_Settings.value(SETTING_KEY_VALID, false).toBool();
+
+                m_mapEntries[l_Entry.m_sFileName] = l_Entry;
+            }
+
+            l_Settings.endArray();
+
+            l_Result = RET_SUCCESS;
+        }
+
+        l_Settings.endGroup();
+
+        return l_Result;
+    }
+
+    /**
+     * @brief Refresh updates the entries with the shared libraries of a
+     * folder: the new and changed libraries are checked in parallel, the
+     * entries of the removed ones are dropped.
+     *
+     * @param[in]   p_rsPath        Folder of the Modules.
+     * @param[in]   p_Mode          Execution mode of the validity check.
+     * @param[in]   p_iNumThreads   Maximum number of parallel checks. If not
+     *                              positive, the number of cores is used.
+     *
+     * @return the number of checked libraries.
+     */
+    int Refresh(const QString&  p_rsPath,
+                ModuleExecMode  p_Mode,
+                const int       p_iNumThreads = 0)
+    {
+        std::map<QString, ModuleManifestEntry>              l_mapEntries;
+        std::map<QString, ModuleManifestEntry>::iterator    l_it;
+        std::vector<CheckStrandPtr>     l_vChecks;
+        ModuleExecutorPtr               l_pExecutor;
+        ModuleManifestEntry             l_Entry;
+        QStringList                     l_lFiles;
+        int                             l_iNumThreads;
+        int                             l_i;
+        size_t                          l_s;
+
+        l_lFiles = _FindLibraries(p_rsPath);
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            for (l_i = 0; l_i < l_lFiles.size(); l_i++)
+            {
+                QFileInfo   l_Info(l_lFiles[l_i]);
+
+                l_it = m_mapEntries.find(l_Info.absoluteFilePath());
+
+                if (l_it != m_mapEntries.end() &&
+                    l_it->second.IsCurrent(l_Info, p_Mode))
+                {
+                    l_mapEntries.insert(*l_it);
+                    continue;
+                }
+
+                l_Entry = ModuleManifestEntry();
+                l_Entry.m_sFileName = l_Info.absoluteFilePath();
+                l_Entry.m_llModified_ms =
+                        l_Info.lastModified().toMSecsSinceEpoch();
+                l_Entry.m_llSize = l_Info.size();
+                l_Entry.m_sModuleName = GetModuleName(l_Info);
+                l_Entry.m_Mode = p_Mode;
+
+                l_vChecks.push_back(CheckStrandPtr(new CheckStrand(l_Entry)));
+            }
+        }
+
+        if (!l_vChecks.empty())
+        {
+            l_iNumThreads = p_iNumThreads;
+
+            if (l_iNumThreads <= 0)
+            {
+                l_iNumThreads = std::max(1, QThread::idealThreadCount());
+            }
+
+            l_pExecutor.reset(new ModuleExecutor(
+                                  std::min(l_iNumThreads,
+                                           static_cast<int>(
+                                               l_vChecks.size()))));
+
+            for (l_s = 0; l_s < l_vChecks.size(); l_s++)
+            {
+                l_pExecutor->Post(l_vChecks[l_s], 0);
+            }
+
+            /* The libraries are loaded by the executor, the Modules are
+             * instantiated here. */
+            for (l_s = 0; l_s < l_vChecks.size(); l_s++)
+            {
+                l_vChecks[l_s]->WaitIdle();
+
+                l_Entry = l_vChecks[l_s]->m_Entry;
+                l_Entry.m_bValid = _Check(l_Entry,
+                                          l_vChecks[l_s]->m_funAllocator);
+
+                l_mapEntries[l_Entry.m_sFileName] = l_Entry;
+            }
+        }
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            if (!l_vChecks.empty() ||
+                l_mapEntries.size() != m_mapEntries.size())
+            {
+                m_bModified = true;
+            }
+
+            m_mapEntries.swap(l_mapEntries);
+        }
+
+        return static_cast<int>(l_vChecks.size());
+    }
+
+    /**
+     * @brief Save writes the entries to a manifest file.
+     *
+     * @retval  RET_SUCCESS     if the manifest has been written.
+     * @retval  RET_ERROR       otherwise.
+     */
+    RetFlag Save(const QString& p_rsFileName)
+    {
+        QSettings       l_Settings(p_rsFileName, QSettings::IniFormat);
+        int             l_i;
+        std::map<QString, ModuleManifestEntry>::const_iterator  l_it;
+
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        l_Settings.clear();
+
+        l_Settings.beginGroup(SETTING_GROUP_MANIFEST);
+
+        l_Settings.setValue(SETTING_KEY_VERSION, MODULE_MANIFEST_VERSION);
+
+        l_Settings.beginWriteArray(SETTING_GROUP_LIBRARIES,
+                                   static_cast<int>(m_mapEntries.size()));
+
+        for (l_it = m_mapEntries.begin(), l_i = 0;
+             l_it != m_mapEntries.end();
+             l_it++, l_i++)
+        {
+            l_Settings.setArrayIndex(l_i);
+
+            l_Settings.setValue(SETTING_KEY_FILE, l_it->second.m_sFileName);
+            l_Settings.setValue(SETTING_KEY_MODIFIED,
+                                l_it->second.m_llModified_ms);
+            l_Settings.setValue(SETTING_KEY_SIZE, l_it->second.m_llSize);
+            l_Settings.setValue(SETTING_KEY_MODULE,
+                                l_it->second.m_sModuleName);
+            l_Settings.setValue(SETTING_KEY_MODE,
+                                static_cast<int>(l_it->second.m_Mode));
+            l_Settings.setValue(SETTING_KEY_VALID, l_it->second.m_bValid);
+        }
+
+        l_Settings.endArray();
+
+        l_Settings.endGroup();
+
+        l_Settings.sync();
+
+        if (l_Settings.status() != QSettings::NoError)
+        {
+            qWarning() << "ModuleManifest: cannot write" << p_rsFileName;
+
+            return RET_ERROR;
+        }
+
+        m_bModified = false;
+
+        return RET_SUCCESS;
+    }
+
+protected:
+
+    /**
+     * @class CheckStrand
+     *
+     * @brief Strand that loads the library of an entry and resolves the
+     * allocator of its Module.
+     */
+    class CheckStrand : public ModuleExecutorStrand
+    {
+    public:
+
+        CheckStrand(const ModuleManifestEntry& p_rEntry)
+            : m_Entry(p_rEntry),
+              m_funAllocator(NULL)
+        {
+            /* Empty. */
+        }
+
+        ModuleManifestEntry m_Entry; /**< Checked entry. */
+
+        ModuleAllocatorFun  m_funAllocator; /**< Allocator of the Module, or
+                                             * NULL. Only valid after
+                                             * WaitIdle(). */
+
+    protected:
+
+        virtual void _Execute(const int p_iItem)
+        {
+            Q_UNUSED(p_iItem);
+
+            m_funAllocator = ModuleManifest::_Resolve(m_Entry);
+        }
+
+    }; // end class CheckStrand.
+
+    DEF_PTR(CheckStrand);
+
+protected:
+
+    /**
+     * @brief _Check instantiates the Module of an entry in the mode of the
+     * entry. Must be called in the thread the Module may live in.
+     *
+     * @param[in]   p_rEntry        Checked entry.
+     * @param[in]   p_funAllocator  Allocator of the Module (see _Resolve()).
+     *
+     * @return true if the Module has been instantiated.
+     */
+    static bool _Check(const ModuleManifestEntry&   p_rEntry,
+                       ModuleAllocatorFun           p_funAllocator)
+    {
+        ModulePtr   l_pModule;
+
+        if (p_funAllocator)
+        {
+            l_pModule.reset(p_funAllocator(p_rEntry.m_Mode));
+        }
+
+        return static_cast<bool>(l_pModule);
+    }
+
+    /**
+     * @return the absolute paths of the shared libraries of a folder that
+     * belong to the configuration of the application. In debug these are the
+     * libraries whose name ends with MODULE_DEBUG_SUFFIX; in release, all the
+     * others except a library "<name>d" when "<name>" is also present, which
+     * is its debug build.
+     */
+    static QStringList _FindLibraries(const QString& p_rsPath)
+    {
+        QDir            l_Dir(p_rsPath);
+        QStringList     l_lFiles;
+        QStringList     l_lResult;
+        QSet<QString>   l_setNames;
+        QString         l_sName;
+        int             l_i;
+
+        l_lFiles = l_Dir.entryList(_LibraryFilters(), QDir::Files);
+
+        for (l_i = 0; l_i < l_lFiles.size(); l_i++)
+        {
+            l_setNames.insert(QFileInfo(l_lFiles[l_i]).completeBaseName());
+        }
+
+        for (l_i = 0; l_i < l_lFiles.size(); l_i++)
+        {
+            l_sName = QFileInfo(l_lFiles[l_i]).completeBaseName();
+
+            if (MODULE_DEBUG_BUILD ?
+                    !l_sName.endsWith(MODULE_DEBUG_SUFFIX) :
+                    (l_sName.endsWith(MODULE_DEBUG_SUFFIX) &&
+                     l_setNames.contains(l_sName.left(
+                         l_sName.size() - MODULE_DEBUG_SUFFIX.size()))))
+            {
+                continue;
+            }
+
+            l_lResult << l_Dir.absoluteFilePath(l_lFiles[l_i]);
+        }
+
+        return l_lResult;
+    }
+
+    /**
+     * @return the name filters of the shared libraries.
+     */
+    static QStringList _LibraryFilters()
+    {
+        return QStringList() << "*.dll" << "*.so" << "*.dylib";
+    }
+
+    /**
+     * @brief _Resolve loads the library of an entry and resolves the
+     * allocator of its Module. Can be called from any thread.
+     *
+     * @return the allocator, or NULL.
+     */
+    static ModuleAllocatorFun _Resolve(const ModuleManifestEntry& p_rEntry)
+    {
+        QLibrary    l_Library(p_rEntry.m_sFileName);
+
+        if (!l_Library.load())
+        {
+            qWarning() << "ModuleManifest: cannot load" << p_rEntry.m_sFileName
+                       << l_Library.errorString();
+
+            return NULL;
+        }
+
+        /* MODULE_ALLOC_FUN_STRING() stringizes its argument: build the
+         * name of the allocator from the value. */
+        return reinterpret_cast<ModuleAllocatorFun>(
+                    l_Library.resolve(
+                        (QString("New") + p_rEntry.m_sModuleName)
+                            .toStdString().c_str()));
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleManifest(const ModuleManifest&);
+    ModuleManifest& operator = (const ModuleManifest&);
+
+protected:
+
+    mutable QMutex  m_Mutex; /**< Protects the data of this manifest. */
+
+    std::map<QString, ModuleManifestEntry>  m_mapEntries; /**< Entries, by
+                                                           * library path. */
+
+    bool    m_bModified; /**< True if the entries have not been saved. */
+
+}; // end class ModuleManifest.
+
+} // end namespace fby.
+
+#endif // MODULE_MANIFEST_H
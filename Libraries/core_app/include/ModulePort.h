@@ -10,7 +10,18 @@
  * @date 2015
  */
 
-#include <Data.h>
+#include <DataFrame.h>
+#include <ModulePortQueue.h>
+
+/** Port id passed to the thread function of a Module by its main timer. */
+#define TIMER_EVENT_PORT_ID         -1
+
+/** Port id passed to the thread function of a Module by Module::Trigger(). */
+#define TRIGGERED_EVENT_PORT_ID     -2
+
+/** Port id passed to the thread function of a Module when its asynchronous
+ * jobs are done (see ModuleAsync). */
+#define ASYNC_EVENT_PORT_ID         -3
 
 namespace fby
 {
@@ -20,6 +31,346 @@ class CORE_APP_EXPORT ModulePort;
 DEF_PTR(ModulePort);
 
 typedef std::list<ModulePortPtr>    ModulePortList;
+typedef std::vector<ModulePortPtr>  ModulePortVector;
+
+/******************************************************************************/
+/**
+ * @class ModulePortListener
+ *
+ * @brief Interface of the objects that are notified directly, without any Qt
+ * signal, when an output port notifies its Data (see ModulePort::AddListener()).
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModulePortListener
+{
+public:
+
+    virtual ~ModulePortListener()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief PortNotified is called in the thread of the notifying Module.
+     * Implementations must return quickly, e.g. by scheduling the execution of
+     * the consumer.
+     *
+     * @note No lock of the output port is held, and a listener removed from
+     * the port (see ModulePort::RemoveListener()) may still be called by the
+     * notifications already in progress.
+     *
+     * @param[in]   p_iPortId   Id of the input port registered with the
+     *                          listener.
+     * @param[in]   p_pPort     Input port registered with the listener, or
+     *                          NULL if none was given (see
+     *                          ModulePort::AddListener()).
+     */
+    virtual void PortNotified(const int p_iPortId, ModulePort* p_pPort) = 0;
+
+}; // end class ModulePortListener.
+
+DEF_PTR(ModulePortListener);
+
+/******************************************************************************/
+/**
+ * @class ModulePortType
+ *
+ * @brief Describes the type of the Data accepted or produced by a typed port
+ * (see Module::AddTypedInput() and Module::AddTypedOutput()). The type of two
+ * linked ports is checked once, by g_LinkModulesChecked(), so that the
+ * consumer can then access the Data without any cast.
+ *
+ * Two types are compared without any instance of the Data: the described
+ * class is thrown as a null pointer by one type and caught by the other (see
+ * Accepts(const ModulePortType&)), so that the C++ exception handling tells
+ * whether a class derives from the other. This only happens at link time.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModulePortType
+{
+public:
+
+    virtual ~ModulePortType()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @return true if the input Data is an instance of the described type.
+     */
+    virtual bool Accepts(const Data* p_pData) const = 0;
+
+    /**
+     * @return true if the class described by the input type is the described
+     * class or derives from it.
+     */
+    virtual bool Accepts(const ModulePortType& p_rType) const = 0;
+
+    /**
+     * @return the class name of the described type.
+     */
+    virtual const char* GetName() const = 0;
+
+    /**
+     * @brief Throw throws a null pointer to the described class (see
+     * Accepts(const ModulePortType&)).
+     */
+    virtual void Throw() const = 0;
+
+}; // end class ModulePortType.
+
+DEF_PTR(ModulePortType);
+
+/******************************************************************************/
+/**
+ * @class ModulePortTypeOf
+ *
+ * @brief ModulePortType of the Data class T.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+template <typename T>
+class ModulePortTypeOf : public ModulePortType
+{
+public:
+
+    bool Accepts(const Data* p_pData) const
+    {
+        return dynamic_cast<const T*>(p_pData) != NULL;
+    }
+
+    bool Accepts(const ModulePortType& p_rType) const
+    {
+        try
+        {
+            p_rType.Throw();
+        }
+        catch (const T*)
+        {
+            return true;
+        }
+        catch (...)
+        {
+            /* Unrelated class. */
+        }
+
+        return false;
+    }
+
+    const char* GetName() const
+    {
+        return T::staticMetaObject.className();
+    }
+
+    void Throw() const
+    {
+        throw static_cast<const T*>(NULL);
+    }
+
+}; // end class ModulePortTypeOf.
+
+/******************************************************************************/
+/**
+ * @class ModulePortLinks
+ *
+ * @brief Queued and direct links of a ModulePort, with the type of its Data
+ * and the state of its coalesced notifications. It is attached to its port
+ * (see g_Attach()) by the inline methods of ModulePort, since the layout of
+ * the ModulePort class exported by the core_app library must not change.
+ *
+ * The queues and the listeners served by an output port are held by an
+ * immutable Targets object, which is replaced whenever a link is added or
+ * removed: ModulePort::Notify() takes the current one under m_Mutex and then
+ * serves it without any lock, so that a producer blocked on a full queue or
+ * a slow listener never holds the links of the port.
+ *
+ * @note This class is an implementation detail of ModulePort.
+ */
+class ModulePortLinks : public QObject
+{
+public:
+
+    /**
+     * @struct Listener
+     *
+     * @brief Listener registered to an output port.
+     */
+    struct Listener
+    {
+        Listener(ModulePortListenerPtr  p_pListener,
+                 const int              p_iPortId,
+                 ModulePort*            p_pPort)
+            : m_pListener(p_pListener),
+              m_iPortId(p_iPortId),
+              m_pPort(p_pPort)
+        {
+            /* Empty. */
+        }
+
+        ModulePortListenerPtr   m_pListener; /**< Listener. */
+
+        int     m_iPortId; /**< Id passed to the listener. */
+
+        ModulePort*     m_pPort; /**< Port passed to the listener. */
+    };
+
+    /**
+     * @struct Targets
+     *
+     * @brief Queues and listeners served by an output port.
+     */
+    struct Targets
+    {
+        std::vector<ModulePortQueuePtr> m_vQueues; /**< Queues of the linked
+                                                    * input ports. */
+
+        std::vector<Listener>   m_vListeners; /**< Listeners called by
+                                               * ModulePort::Notify(). */
+    };
+
+    typedef SHARED_PTR<const Targets>   TargetsPtr;
+
+public:
+
+    explicit ModulePortLinks(QObject* /* p_pOwner */)
+        : m_pTargets(new Targets()),
+          m_pCheckedPort(NULL),
+          m_iCoalesce(0),
+          m_iPending(0),
+          m_llCoalesced(0)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief AddListener adds a listener to the targets.
+     */
+    void AddListener(ModulePortListenerPtr  p_pListener,
+                     const int              p_iPortId,
+                     ModulePort*            p_pPort)
+    {
+        LOCK_WRITE(&m_Mutex, l_Lock);
+        SHARED_PTR<Targets>     l_pTargets(new Targets(*m_pTargets));
+
+        l_pTargets->m_vListeners.push_back(Listener(p_pListener,
+                                                    p_iPortId,
+                                                    p_pPort));
+
+        m_pTargets = l_pTargets;
+    }
+
+    /**
+     * @brief AddQueue adds a queue to the targets, unless already there.
+     */
+    void AddQueue(ModulePortQueuePtr p_pQueue)
+    {
+        LOCK_WRITE(&m_Mutex, l_Lock);
+        SHARED_PTR<Targets>     l_pTargets;
+
+        if (std::find(m_pTargets->m_vQueues.begin(),
+                      m_pTargets->m_vQueues.end(),
+                      p_pQueue) == m_pTargets->m_vQueues.end())
+        {
+            l_pTargets.reset(new Targets(*m_pTargets));
+            l_pTargets->m_vQueues.push_back(p_pQueue);
+
+            m_pTargets = l_pTargets;
+        }
+    }
+
+    /**
+     * @return the current targets.
+     */
+    inline TargetsPtr GetTargets() const
+    {
+        LOCK_READ(&m_Mutex, l_Lock);
+
+        return m_pTargets;
+    }
+
+    /**
+     * @brief RemoveListener removes all the entries of a listener from the
+     * targets.
+     */
+    void RemoveListener(ModulePortListenerPtr p_pListener)
+    {
+        LOCK_WRITE(&m_Mutex, l_Lock);
+        SHARED_PTR<Targets>     l_pTargets(new Targets(*m_pTargets));
+        size_t                  l_s;
+
+        for (l_s = l_pTargets->m_vListeners.size(); l_s > 0; l_s--)
+        {
+            if (l_pTargets->m_vListeners[l_s - 1].m_pListener == p_pListener)
+            {
+                l_pTargets->m_vListeners.erase(
+                            l_pTargets->m_vListeners.begin() + (l_s - 1));
+            }
+        }
+
+        m_pTargets = l_pTargets;
+    }
+
+    /**
+     * @brief RemoveQueue removes a queue from the targets.
+     */
+    void RemoveQueue(ModulePortQueuePtr p_pQueue)
+    {
+        LOCK_WRITE(&m_Mutex, l_Lock);
+        SHARED_PTR<Targets>     l_pTargets(new Targets(*m_pTargets));
+
+        l_pTargets->m_vQueues.erase(std::remove(l_pTargets->m_vQueues.begin(),
+                                                l_pTargets->m_vQueues.end(),
+                                                p_pQueue),
+                                    l_pTargets->m_vQueues.end());
+
+        m_pTargets = l_pTargets;
+    }
+
+    TargetsPtr  m_pTargets; /**< Effective only for output ports: queues and
+                             * listeners served by ModulePort::Notify(). */
+
+    ModulePortQueuePtr  m_pQueue; /**< Effective only for input ports: queue
+                                   * of the link, or a null object if the link
+                                   * is not queued. */
+
+    ModulePortTypePtr   m_pDataType; /**< Type of the Data of the port, or a
+                                      * null object if the port is not typed.
+                                      */
+
+    const ModulePort*   m_pCheckedPort; /**< Effective only for input ports:
+                                         * typed output port accepted by
+                                         * ModulePort::CheckLink(), or NULL.
+                                         */
+
+    mutable QReadWriteLock  m_Mutex; /**< Protects m_pTargets, m_pQueue,
+                                      * m_pDataType and m_pCheckedPort. */
+
+    QAtomicInt  m_iCoalesce; /**< Effective only for input ports: non-zero if
+                              * the notifications are coalesced. */
+
+    QAtomicInt  m_iPending; /**< Effective only for input ports: non-zero if
+                             * an execution is pending (coalesced ports). */
+
+    long long   m_llCoalesced; /**< Effective only for input ports: number of
+                                * coalesced notifications. */
+
+    mutable QMutex  m_MutexCoalesced; /**< Protects m_llCoalesced. */
+
+}; // end class ModulePortLinks.
 
 /******************************************************************************/
 /**
@@ -28,6 +379,21 @@ typedef std::list<ModulePortPtr>    ModulePortList;
  * @brief Base class that represents a generic input or output port of a Module.
  * This class acts as an interface between different modules.
  *
+ * By default an input port reads the Data of the linked output port, so that a
+ * slow consumer only sees the latest Data. An input port may instead enable a
+ * bounded ModulePortQueue (see EnableQueue()): each notification of the linked
+ * output port then queues a snapshot of the current Data (see
+ * g_SnapshotData()), which the consumer removes with PopData().
+ *
+ * An output port notifies its consumers either through the Qt signals
+ * (sig_Out() -> slot_In() -> sig_In()), which cost an event-loop round trip
+ * per consumer, or through a list of ModulePortListener objects that are
+ * called directly by Notify() (see g_LinkModulesDirect()). The Qt signals
+ * are always emitted, so that GUI observers can still connect to them.
+ *
+ * The queues, the listeners, the type and the coalescing state of a port are
+ * held by its ModulePortLinks.
+ *
  * @callgraph
  * @callergraph
  * @author Andrea Bracci
@@ -64,11 +430,289 @@ public:
 
     virtual ~ModulePort();
 
+    /**
+     * @brief AddListener registers a listener to be called directly by each
+     * Notify() of this output port.
+     *
+     * @param[in]   p_pListener     Listener.
+     * @param[in]   p_iPortId       Id passed to the listener, usually the id
+     *                              of the linked input port.
+     * @param[in]   p_pPort         Port passed to the listener, usually the
+     *                              linked input port, so that the listener
+     *                              does not have to look it up in its Module.
+     *                              It must outlive the registration.
+     */
+    void AddListener(ModulePortListenerPtr  p_pListener,
+                     const int              p_iPortId,
+                     ModulePort*            p_pPort = NULL)
+    {
+        _Links()->AddListener(p_pListener, p_iPortId, p_pPort);
+    }
+
+    /**
+     * @brief CheckLink checks that the Data of an output port can be read by
+     * this input port. If this port is typed (see SetDataType()), the type
+     * declared by the output port (see Module::AddTypedOutput()) must be the
+     * same type or derive from it, so that the check does not depend on the
+     * Data the producer has published so far: the link is then marked as
+     * checked (see IsLinkChecked()). The current Data of an untyped output
+     * port must be an instance of the type, which does not hold for the Data
+     * published later, so the link is not marked.
+     *
+     * @param[in]   p_pPortOut      Output port to be linked to this port.
+     *
+     * @retval  RET_SUCCESS     if the two ports can be linked.
+     * @retval  RET_ERROR       if the type of the output port is different,
+     *                          or its Data is missing or of a different type.
+     */
+    RetFlag CheckLink(ModulePortPtr p_pPortOut) const
+    {
+        ModulePortTypePtr   l_pType;
+        ModulePortTypePtr   l_pTypeOut;
+        DataPtr             l_pData;
+        ModulePortLinks*    l_pLinks;
+
+        l_pType = GetDataType();
+
+        if (!l_pType)
+        {
+            return RET_SUCCESS;
+        }
+
+        if (!p_pPortOut)
+        {
+            return RET_ERROR;
+        }
+
+        l_pTypeOut = p_pPortOut->GetDataType();
+
+        if (l_pTypeOut)
+        {
+            if (!l_pType->Accepts(*l_pTypeOut))
+            {
+                qWarning() << "Invalid link from" << l_pTypeOut->GetName()
+                           << "to" << l_pType->GetName();
+
+                return RET_ERROR;
+            }
+
+            l_pLinks = const_cast<ModulePort*>(this)->_Links();
+
+            LOCK_WRITE(&l_pLinks->m_Mutex, l_Lock);
+
+            l_pLinks->m_pCheckedPort = GET_PTR(p_pPortOut);
+
+            return RET_SUCCESS;
+        }
+
+        l_pData = p_pPortOut->GetData();
+
+        if (!l_pType->Accepts(GET_PTR(l_pData)))
+        {
+            qWarning() << "Invalid link from"
+                       << (l_pData ? l_pData->metaObject()->className()
+                                   : "null")
+                       << "to"
+                       << l_pType->GetName();
+
+            return RET_ERROR;
+        }
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief ClearPending marks the execution scheduled for this input port
+     * as started (see MarkPending()). Called by the Module before running its
+     * thread function, so that a notification received during the execution
+     * schedules a new one.
+     */
+    inline void ClearPending()
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (l_pLinks)
+        {
+            l_pLinks->m_iPending.fetchAndStoreOrdered(0);
+        }
+    }
+
+    /**
+     * @brief CloseQueue wakes the producer blocked on the queue of this input
+     * port, if any, and makes its blocking pushes fail until OpenQueue() is
+     * called (see ModulePortQueue::Close()).
+     */
+    void CloseQueue()
+    {
+        ModulePortQueuePtr  l_pQueue;
+
+        l_pQueue = GetQueue();
+
+        if (l_pQueue)
+        {
+            l_pQueue->Close();
+        }
+    }
+
+    /**
+     * @brief DisableQueue removes the queue of this input port, if any. The
+     * queued Data are discarded.
+     */
+    void DisableQueue()
+    {
+        ModulePortLinks*    l_pLinks;
+        ModulePortQueuePtr  l_pQueue;
+
+        l_pLinks = _FindLinks();
+
+        if (!l_pLinks)
+        {
+            return;
+        }
+
+        {
+            LOCK_WRITE(&l_pLinks->m_Mutex, l_Lock);
+
+            l_pQueue = l_pLinks->m_pQueue;
+
+            RELEASE_PTR(l_pLinks->m_pQueue);
+        }
+
+        if (l_pQueue)
+        {
+            if (m_pLinkedPort)
+            {
+                m_pLinkedPort->_RemoveQueue(l_pQueue);
+            }
+
+            l_pQueue->Close();
+        }
+    }
+
+    /**
+     * @brief EnableQueue places a bounded queue on the link between this input
+     * port and its linked output port. From now on every notification of the
+     * output port queues its current Data.
+     *
+     * @warning This function must be called after the port has been linked
+     * (see g_LinkModulesQueued()).
+     *
+     * @param[in]   p_iCapacity     Capacity of the queue.
+     * @param[in]   p_Policy        Behavior when the queue is full.
+     *
+     * @retval  RET_SUCCESS     if the queue has been enabled.
+     * @retval  RET_ERROR       if this is not a linked input port.
+     */
+    RetFlag EnableQueue(const int                       p_iCapacity,
+                        ModulePortQueue::OverflowPolicy p_Policy =
+                                ModulePortQueue::OVERFLOW_DROP_OLDEST)
+    {
+        ModulePortLinks*    l_pLinks;
+        ModulePortQueuePtr  l_pQueue;
+
+        if (m_Type != PORT_INPUT || !m_pLinkedPort)
+        {
+            return RET_ERROR;
+        }
+
+        DisableQueue();
+
+        l_pLinks = _Links();
+        l_pQueue.reset(new ModulePortQueue(p_iCapacity, p_Policy));
+
+        {
+            LOCK_WRITE(&l_pLinks->m_Mutex, l_Lock);
+
+            l_pLinks->m_pQueue = l_pQueue;
+        }
+
+        m_pLinkedPort->_AddQueue(l_pQueue);
+
+        return RET_SUCCESS;
+    }
+
     /**
      * @return The data associated to this port.
      */
     virtual DataPtr GetData();
 
+    /**
+     * @return the type of the Data of this port, or a null object if the port
+     * is not typed.
+     */
+    inline ModulePortTypePtr GetDataType() const
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (!l_pLinks)
+        {
+            return ModulePortTypePtr();
+        }
+
+        LOCK_READ(&l_pLinks->m_Mutex, l_Lock);
+
+        return l_pLinks->m_pDataType;
+    }
+
+    /**
+     * @return the number of notifications of this input port that have been
+     * merged into an already pending execution.
+     */
+    inline long long GetNumCoalesced() const
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (!l_pLinks)
+        {
+            return 0;
+        }
+
+        QMutexLocker    l_Lock(&l_pLinks->m_MutexCoalesced);
+
+        return l_pLinks->m_llCoalesced;
+    }
+
+    /**
+     * @return the number of listeners of this output port.
+     */
+    inline int GetNumListeners() const
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        return (l_pLinks ?
+                    static_cast<int>(
+                        l_pLinks->GetTargets()->m_vListeners.size()) :
+                    0);
+    }
+
+    /**
+     * @return the queue of this input port, or a null object if the port is
+     * not queued.
+     */
+    inline ModulePortQueuePtr GetQueue() const
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (!l_pLinks)
+        {
+            return ModulePortQueuePtr();
+        }
+
+        LOCK_READ(&l_pLinks->m_Mutex, l_Lock);
+
+        return l_pLinks->m_pQueue;
+    }
+
     /**
      * @return The id number of this port.
      */
@@ -79,6 +723,41 @@ public:
      */
     virtual Type    GetType() const;
 
+    /**
+     * @return true if the notifications of this input port are coalesced (see
+     * SetCoalesced()).
+     */
+    inline bool IsCoalesced() const
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        return (l_pLinks && l_pLinks->m_iCoalesce.load() != 0);
+    }
+
+    /**
+     * @return true if this input port is linked to the output port accepted
+     * by the last call to CheckLink(), i.e. if its Data are known to be of the
+     * type of this port. A link made afterwards (e.g. by LinkToPort()) is not
+     * checked.
+     */
+    inline bool IsLinkChecked() const
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (!l_pLinks || !m_pLinkedPort)
+        {
+            return false;
+        }
+
+        LOCK_READ(&l_pLinks->m_Mutex, l_Lock);
+
+        return (l_pLinks->m_pCheckedPort == GET_PTR(m_pLinkedPort));
+    }
+
     /**
      * @brief Links this port to the specified port so that the two ports share
      * the same data.
@@ -91,6 +770,80 @@ public:
     virtual void    LinkToPort(ModulePortPtr    p_pPort,
                                bool             p_bOutToOut = false);
 
+    /**
+     * @brief MarkPending is called for each notification of this input port
+     * before an execution of its Module is scheduled.
+     *
+     * @return false if the port is coalesced and an execution is already
+     * pending: the notification is counted as coalesced and no execution must
+     * be scheduled. True otherwise.
+     */
+    inline bool MarkPending()
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (!l_pLinks || !l_pLinks->m_iCoalesce.load())
+        {
+            return true;
+        }
+
+        if (l_pLinks->m_iPending.testAndSetOrdered(0, 1))
+        {
+            return true;
+        }
+
+        {
+            QMutexLocker    l_Lock(&l_pLinks->m_MutexCoalesced);
+
+            l_pLinks->m_llCoalesced++;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Notify queues a snapshot of the data of this output port on the
+     * queued links (see g_SnapshotData()), since the producer reuses its Data
+     * for the next notification, calls the listeners, then notifies the
+     * linked input ports through NotifyOut(). No lock of this port is held
+     * while the Data are pushed and the listeners are called.
+     */
+    inline void     Notify()
+    {
+        ModulePortLinks::TargetsPtr l_pTargets;
+        ModulePortLinks*            l_pLinks;
+        DataPtr                     l_pSnapshot;
+        size_t                      l_s;
+
+        l_pLinks = _FindLinks();
+
+        if (l_pLinks)
+        {
+            l_pTargets = l_pLinks->GetTargets();
+
+            if (!l_pTargets->m_vQueues.empty())
+            {
+                l_pSnapshot = g_SnapshotData(m_pData);
+            }
+
+            for (l_s = 0; l_s < l_pTargets->m_vQueues.size(); l_s++)
+            {
+                l_pTargets->m_vQueues[l_s]->Push(l_pSnapshot);
+            }
+
+            for (l_s = 0; l_s < l_pTargets->m_vListeners.size(); l_s++)
+            {
+                l_pTargets->m_vListeners[l_s].m_pListener->PortNotified(
+                            l_pTargets->m_vListeners[l_s].m_iPortId,
+                            l_pTargets->m_vListeners[l_s].m_pPort);
+            }
+        }
+
+        NotifyOut();
+    }
+
     /**
      * @brief Notifies the id of the input port that received the signal from
      * an output port of another module.
@@ -100,15 +853,120 @@ public:
     /**
      * @brief Emits the sig_Out() signal to notify that the data are available
      * to this Port.
+     *
+     * @note The queued links and the listeners are served by Notify().
      */
     virtual void    NotifyOut();
 
+    /**
+     * @brief OpenQueue re-enables the blocking pushes on the queue of this
+     * input port after CloseQueue().
+     */
+    void OpenQueue()
+    {
+        ModulePortQueuePtr  l_pQueue;
+
+        l_pQueue = GetQueue();
+
+        if (l_pQueue)
+        {
+            l_pQueue->Open();
+        }
+    }
+
+    /**
+     * @brief PopData gets the next Data received by this input port.
+     *
+     * @param[out]  p_rpData    Received Data.
+     *
+     * @return for a queued port, true if a Data has been removed from the
+     * queue and false if the queue is empty. For a port that is not queued,
+     * p_rpData is set to the current Data (as with GetData()) and the function
+     * returns true if it is not null.
+     */
+    inline bool     PopData(DataPtr& p_rpData)
+    {
+        ModulePortQueuePtr  l_pQueue;
+
+        l_pQueue = GetQueue();
+
+        if (l_pQueue)
+        {
+            return l_pQueue->Pop(p_rpData);
+        }
+
+        p_rpData = GetData();
+
+        return static_cast<bool>(p_rpData);
+    }
+
+    /**
+     * @brief RemoveListener unregisters all the entries of a listener. A
+     * notification already in progress may still call the listener: the
+     * listeners that must not be called afterwards are closed by their owner
+     * (see ModuleInputListener::Close()).
+     *
+     * @param[in]   p_pListener     Listener to be removed.
+     */
+    void RemoveListener(ModulePortListenerPtr p_pListener)
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (l_pLinks)
+        {
+            l_pLinks->RemoveListener(p_pListener);
+        }
+    }
+
     /** @brief Sets the data associated to this port.
      *
      * @param[in]   p_pData     Data to be associated ot this Port.
      */
     virtual void    SetData(DataPtr p_pData);
 
+    /**
+     * @brief SetDataType sets the type of the Data of this port. An input port
+     * with a type can only be linked to output ports whose Data is an instance
+     * of the same type (see CheckLink()).
+     *
+     * @param[in]   p_pType     Type of the Data, or a null object to accept
+     *                          any Data.
+     */
+    inline void     SetDataType(ModulePortTypePtr p_pType)
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _Links();
+
+        LOCK_WRITE(&l_pLinks->m_Mutex, l_Lock);
+
+        l_pLinks->m_pDataType = p_pType;
+    }
+
+    /**
+     * @brief SetCoalesced enables or disables the coalescing of the
+     * notifications of this input port: while an execution triggered by this
+     * port is pending, further notifications do not schedule another one, so
+     * that a slow consumer does not accumulate executions. The consumer then
+     * reads only the latest Data (or drains the queue of the link).
+     *
+     * @note Only the notifications delivered through the port listener of the
+     * Module are coalesced (see g_LinkModulesCoalesced()).
+     *
+     * @param[in]   p_bCoalesced    Input flag.
+     */
+    inline void SetCoalesced(const bool p_bCoalesced)
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _Links();
+
+        l_pLinks->m_iCoalesce.fetchAndStoreOrdered(p_bCoalesced ? 1 : 0);
+        l_pLinks->m_iPending.fetchAndStoreOrdered(0);
+    }
+
 signals:
 
     /**
@@ -148,6 +1006,48 @@ protected slots:
      */
     virtual void slot_PropagateOut();
 
+protected:
+
+    /**
+     * @brief _AddQueue registers the queue of a linked input port to this
+     * output port.
+     */
+    void    _AddQueue(ModulePortQueuePtr p_pQueue)
+    {
+        _Links()->AddQueue(p_pQueue);
+    }
+
+    /**
+     * @return the links of this port, or NULL if none has been made yet.
+     */
+    inline ModulePortLinks* _FindLinks() const
+    {
+        return g_FindAttached<ModulePortLinks>(this);
+    }
+
+    /**
+     * @return the links of this port, created if needed.
+     */
+    inline ModulePortLinks* _Links()
+    {
+        return g_Attach<ModulePortLinks>(this);
+    }
+
+    /**
+     * @brief _RemoveQueue unregisters the queue of a linked input port.
+     */
+    void    _RemoveQueue(ModulePortQueuePtr p_pQueue)
+    {
+        ModulePortLinks*    l_pLinks;
+
+        l_pLinks = _FindLinks();
+
+        if (l_pLinks)
+        {
+            l_pLinks->RemoveQueue(p_pQueue);
+        }
+    }
+
 protected:
 
     int     m_iPortId; /**< Id number of this Port. */
@@ -161,6 +1061,175 @@ protected:
 
 }; // end class ModulePort.
 
+class CORE_APP_EXPORT Module;
+
+/******************************************************************************/
+/**
+ * @class ModuleInput
+ *
+ * @brief Typed handle of an input port that accepts Data of class T (see
+ * Module::AddTypedInput()). If the type of the linked output port has been
+ * checked by g_LinkModulesChecked() (see ModulePort::IsLinkChecked()), Get()
+ * and Pop() return the Data without any dynamic cast; otherwise the Data are
+ * cast dynamically, and a Data of another class is returned as a null object.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+template <typename T>
+class ModuleInput
+{
+public:
+
+    /**
+     * @return the Data of the linked output port, or a null object if the port
+     * is not linked.
+     */
+    inline SHARED_PTR<T> Get() const
+    {
+        DataPtr l_pData;
+
+        if (!m_pPort)
+        {
+            return SHARED_PTR<T>();
+        }
+
+        l_pData = m_pPort->GetData();
+
+        if (!m_pPort->IsLinkChecked())
+        {
+            return DYNAMIC_PTR_CAST<T>(l_pData);
+        }
+
+        Q_ASSERT(!l_pData || dynamic_cast<T*>(GET_PTR(l_pData)));
+
+        return STATIC_PTR_CAST<T>(l_pData);
+    }
+
+    /**
+     * @return the id of the port, or -1 if the handle is not bound to a port.
+     */
+    inline int GetId() const
+    {
+        return (m_pPort ? m_pPort->GetId() : -1);
+    }
+
+    /**
+     * @return the port of this handle.
+     */
+    inline ModulePortPtr GetPort() const
+    {
+        return m_pPort;
+    }
+
+    /**
+     * @brief Pop gets the next Data received by the port (see
+     * ModulePort::PopData()).
+     *
+     * @param[out]  p_rpData    Received Data.
+     *
+     * @return true if a Data has been received.
+     */
+    inline bool Pop(SHARED_PTR<T>& p_rpData)
+    {
+        DataPtr l_pData;
+
+        if (!m_pPort || !m_pPort->PopData(l_pData))
+        {
+            RELEASE_PTR(p_rpData)
+
+            return false;
+        }
+
+        if (m_pPort->IsLinkChecked())
+        {
+            Q_ASSERT(!l_pData || dynamic_cast<T*>(GET_PTR(l_pData)));
+
+            p_rpData = STATIC_PTR_CAST<T>(l_pData);
+        }
+        else
+        {
+            p_rpData = DYNAMIC_PTR_CAST<T>(l_pData);
+        }
+
+        return static_cast<bool>(p_rpData);
+    }
+
+protected:
+
+    friend class Module;
+
+    ModulePortPtr   m_pPort; /**< Input port. */
+
+}; // end class ModuleInput.
+
+/******************************************************************************/
+/**
+ * @class ModuleOutput
+ *
+ * @brief Typed handle of an output port that produces Data of class T (see
+ * Module::AddTypedOutput()).
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+template <typename T>
+class ModuleOutput
+{
+public:
+
+    /**
+     * @return the Data of the port.
+     */
+    inline SHARED_PTR<T> Get() const
+    {
+        return m_pData;
+    }
+
+    /**
+     * @return the id of the port, or -1 if the handle is not bound to a port.
+     */
+    inline int GetId() const
+    {
+        return (m_pPort ? m_pPort->GetId() : -1);
+    }
+
+    /**
+     * @return the port of this handle.
+     */
+    inline ModulePortPtr GetPort() const
+    {
+        return m_pPort;
+    }
+
+    /**
+     * @brief Notify notifies the Data of the port to the linked input ports
+     * (see ModulePort::Notify()).
+     */
+    inline void Notify()
+    {
+        if (m_pPort)
+        {
+            m_pPort->Notify();
+        }
+    }
+
+protected:
+
+    friend class Module;
+
+    ModulePortPtr   m_pPort; /**< Output port. */
+
+    SHARED_PTR<T>   m_pData; /**< Data of the port. */
+
+}; // end class ModuleOutput.
+
 } // end namespace fby.
 
 #endif // PORT_H
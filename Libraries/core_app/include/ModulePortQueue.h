@@ -0,0 +1,493 @@
+#ifndef MODULE_PORT_QUEUE_H
+#define MODULE_PORT_QUEUE_H
+
+/** @file ModulePortQueue.h
+ *
+ * @brief Defines the ModulePortQueue class, the bounded queue of Data that can
+ * be placed on a link between an output port and an input port.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Data.h>
+
+/** Size (bytes) of the padding that keeps the producer and the consumer
+ * counters of a ModulePortQueue on different cache lines. */
+#define MODULE_PORT_QUEUE_PADDING   64
+
+/** Maximum time (ms) a producer waits for a free cell of a full
+ * ModulePortQueue with the OVERFLOW_BLOCK policy, before discarding its Data.
+ */
+#define MODULE_PORT_QUEUE_BLOCK_TIMEOUT_MS  1000
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class ModulePortQueueObserver
+ *
+ * @brief Interface of the objects that are told about the Data discarded by a
+ * ModulePortQueue (see ModulePortQueue::SetObserver()).
+ */
+class ModulePortQueueObserver
+{
+public:
+
+    virtual ~ModulePortQueueObserver()
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief DataDropped is called in the thread of the producer that has
+     * found the queue full.
+     *
+     * @param[in]   p_iNumDropped   Number of Data discarded.
+     */
+    virtual void DataDropped(const int p_iNumDropped) = 0;
+
+}; // end class ModulePortQueueObserver.
+
+DEF_PTR(ModulePortQueueObserver);
+
+/******************************************************************************/
+/**
+ * @class ModulePortQueue
+ *
+ * @brief Bounded multi-producer/multi-consumer ring of DataPtr. The ring is
+ * lock-free: every cell carries a sequence number that tells producers and
+ * consumers whether the cell is free or holds a Data object. Locks are only
+ * taken by a producer that must wait for a free cell (OVERFLOW_BLOCK). The
+ * wait is bounded (see MODULE_PORT_QUEUE_BLOCK_TIMEOUT_MS) and ends when the
+ * queue is closed, so that a stopped consumer cannot stall its producer.
+ *
+ * @warning The queue stores the DataPtr, not a copy of the Data. An output
+ * port queues a snapshot of a DataFrame (see ModulePort::Notify()); a
+ * producer of any other Data that feeds a queued link must publish a new Data
+ * object for each notification, otherwise the queued elements alias the same
+ * object.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModulePortQueue
+{
+public:
+
+    /**
+     * @enum OverflowPolicy
+     *
+     * @brief Enumerates the behaviors of Push() when the queue is full.
+     */
+    enum OverflowPolicy
+    {
+        OVERFLOW_BLOCK = 0, /**< Waits until a consumer frees a cell, for
+                             * MODULE_PORT_QUEUE_BLOCK_TIMEOUT_MS at most. */
+        OVERFLOW_DROP_OLDEST, /**< Discards the oldest queued Data. */
+        OVERFLOW_DROP_NEWEST /**< Discards the Data being pushed. */
+
+    }; // end enum OverflowPolicy.
+
+public:
+
+    /**
+     * @brief Builds an empty queue.
+     *
+     * @param[in]   p_iCapacity     Minimum capacity of the queue. The actual
+     *                              capacity is rounded up to a power of two.
+     * @param[in]   p_Policy        Behavior when the queue is full.
+     */
+    ModulePortQueue(const int       p_iCapacity,
+                    OverflowPolicy  p_Policy = OVERFLOW_DROP_OLDEST)
+        : m_pCells(NULL),
+          m_iMask(0),
+          m_Policy(p_Policy),
+          m_iWaiting(0),
+          m_bClosed(false)
+    {
+        int     l_iCapacity;
+        int     l_i;
+
+        l_iCapacity = 2;
+
+        while (l_iCapacity < p_iCapacity)
+        {
+            l_iCapacity <<= 1;
+        }
+
+        m_pCells = new Cell[l_iCapacity];
+        m_iMask = l_iCapacity - 1;
+
+        for (l_i = 0; l_i < l_iCapacity; l_i++)
+        {
+            m_pCells[l_i].m_iSeq.store(l_i);
+        }
+    }
+
+    ~ModulePortQueue()
+    {
+        delete [] m_pCells;
+    }
+
+    /**
+     * @brief Close wakes the producers blocked in Push() and makes further
+     * blocking pushes fail. Called when the consumer stops (see
+     * Module::CloseInputQueues()).
+     */
+    void Close()
+    {
+        QMutexLocker    l_Lock(&m_MutexWait);
+
+        m_bClosed = true;
+
+        m_condNotFull.wakeAll();
+    }
+
+    /**
+     * @return the capacity of this queue.
+     */
+    inline int GetCapacity() const
+    {
+        return m_iMask + 1;
+    }
+
+    /**
+     * @return the number of Data discarded because of overflow.
+     */
+    inline int GetNumDropped() const
+    {
+        return m_iDropped.load();
+    }
+
+    /**
+     * @return the overflow policy of this queue.
+     */
+    inline OverflowPolicy GetOverflowPolicy() const
+    {
+        return m_Policy;
+    }
+
+    /**
+     * @return an estimate of the number of queued Data.
+     */
+    inline int GetSize() const
+    {
+        return static_cast<int>(static_cast<unsigned int>(
+                                    m_iEnqueuePos.load()) -
+                                static_cast<unsigned int>(
+                                    m_iDequeuePos.load()));
+    }
+
+    /**
+     * @brief Open re-enables the blocking pushes after a call to Close().
+     */
+    void Open()
+    {
+        QMutexLocker    l_Lock(&m_MutexWait);
+
+        m_bClosed = false;
+    }
+
+    /**
+     * @brief SetObserver sets the object told about the Data discarded
+     * because of overflow, e.g. the Module of the consumer, which records
+     * them in its statistics.
+     *
+     * @param[in]   p_pObserver     Observer, or a null object.
+     */
+    void SetObserver(ModulePortQueueObserverPtr p_pObserver)
+    {
+        QMutexLocker    l_Lock(&m_MutexWait);
+
+        m_pObserver = p_pObserver;
+    }
+
+    /**
+     * @brief Pop removes the oldest Data from the queue.
+     *
+     * @param[out]  p_rpData    Removed Data.
+     *
+     * @retval  true    if a Data has been removed.
+     * @retval  false   if the queue is empty.
+     */
+    bool Pop(DataPtr& p_rpData)
+    {
+        if (!_TryPop(p_rpData))
+        {
+            return false;
+        }
+
+        /* Full barrier: either the blocked producer sees the freed cell, or
+         * this consumer sees the producer waiting (see Push()). */
+        if (m_iWaiting.fetchAndAddOrdered(0) > 0)
+        {
+            QMutexLocker    l_Lock(&m_MutexWait);
+
+            m_condNotFull.wakeOne();
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Push appends a Data to the queue, applying the overflow policy if
+     * the queue is full.
+     *
+     * @param[in]   p_pData     Data to be queued.
+     *
+     * @retval  true    if the Data has been queued.
+     * @retval  false   if the Data has been discarded (OVERFLOW_DROP_NEWEST,
+     *                  or OVERFLOW_BLOCK on a closed queue or after waiting
+     *                  MODULE_PORT_QUEUE_BLOCK_TIMEOUT_MS).
+     */
+    bool Push(DataPtr p_pData)
+    {
+        QElapsedTimer   l_Timer;
+        DataPtr         l_pOldest;
+        qint64          l_llWait_ms;
+
+        while (!_TryPush(p_pData))
+        {
+            switch (m_Policy)
+            {
+            case OVERFLOW_DROP_NEWEST:
+                _Dropped();
+                return false;
+
+            case OVERFLOW_DROP_OLDEST:
+                if (_TryPop(l_pOldest))
+                {
+                    _Dropped();
+                }
+                break;
+
+            case OVERFLOW_BLOCK:
+            default:
+                {
+                    QMutexLocker    l_Lock(&m_MutexWait);
+
+                    if (!l_Timer.isValid())
+                    {
+                        l_Timer.start();
+                    }
+
+                    l_llWait_ms = MODULE_PORT_QUEUE_BLOCK_TIMEOUT_MS -
+                                  l_Timer.elapsed();
+
+                    if (m_bClosed || l_llWait_ms <= 0)
+                    {
+                        l_Lock.unlock();
+
+                        _Dropped();
+                        return false;
+                    }
+
+                    m_iWaiting.fetchAndAddOrdered(1);
+
+                    /* A Pop() that completes after this check sees
+                     * m_iWaiting and wakes this producer under m_MutexWait,
+                     * so the wake-up cannot be lost. */
+                    if (GetSize() >= GetCapacity())
+                    {
+                        m_condNotFull.wait(
+                                    &m_MutexWait,
+                                    static_cast<unsigned long>(l_llWait_ms));
+                    }
+
+                    m_iWaiting.fetchAndAddOrdered(-1);
+                }
+                break;
+            } // end switch.
+        }
+
+        return true;
+    }
+
+protected:
+
+    /**
+     * @brief _Dropped counts a Data discarded because of overflow and tells
+     * the observer, if any.
+     */
+    void _Dropped()
+    {
+        ModulePortQueueObserverPtr  l_pObserver;
+
+        m_iDropped.fetchAndAddRelaxed(1);
+
+        {
+            QMutexLocker    l_Lock(&m_MutexWait);
+
+            l_pObserver = m_pObserver;
+        }
+
+        if (l_pObserver)
+        {
+            l_pObserver->DataDropped(1);
+        }
+    }
+
+    /**
+     * @brief _TryPop removes the oldest Data without waking the producers.
+     */
+    bool _TryPop(DataPtr& p_rpData)
+    {
+        Cell*   l_pCell;
+        int     l_iPos;
+        int     l_iDiff;
+
+        l_iPos = m_iDequeuePos.load();
+
+        for (;;)
+        {
+            l_pCell = &m_pCells[l_iPos & m_iMask];
+
+            l_iDiff = _Diff(l_pCell->m_iSeq.loadAcquire(), _Next(l_iPos));
+
+            if (l_iDiff == 0)
+            {
+                if (m_iDequeuePos.testAndSetRelaxed(l_iPos, _Next(l_iPos)))
+                {
+                    break;
+                }
+
+                l_iPos = m_iDequeuePos.load();
+            }
+            else if (l_iDiff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                l_iPos = m_iDequeuePos.load();
+            }
+        }
+
+        p_rpData = l_pCell->m_pData;
+        RELEASE_PTR(l_pCell->m_pData);
+
+        l_pCell->m_iSeq.storeRelease(
+                    static_cast<int>(static_cast<unsigned int>(l_iPos) +
+                                     static_cast<unsigned int>(m_iMask) + 1u));
+
+        return true;
+    }
+
+    /**
+     * @brief _TryPush appends a Data if the queue is not full.
+     */
+    bool _TryPush(DataPtr& p_rpData)
+    {
+        Cell*   l_pCell;
+        int     l_iPos;
+        int     l_iDiff;
+
+        l_iPos = m_iEnqueuePos.load();
+
+        for (;;)
+        {
+            l_pCell = &m_pCells[l_iPos & m_iMask];
+
+            l_iDiff = _Diff(l_pCell->m_iSeq.loadAcquire(), l_iPos);
+
+            if (l_iDiff == 0)
+            {
+                if (m_iEnqueuePos.testAndSetRelaxed(l_iPos, _Next(l_iPos)))
+                {
+                    break;
+                }
+
+                l_iPos = m_iEnqueuePos.load();
+            }
+            else if (l_iDiff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                l_iPos = m_iEnqueuePos.load();
+            }
+        }
+
+        l_pCell->m_pData = p_rpData;
+        l_pCell->m_iSeq.storeRelease(_Next(l_iPos));
+
+        return true;
+    }
+
+    /** @return p_iA - p_iB, with wrap-around. */
+    static inline int _Diff(const int p_iA, const int p_iB)
+    {
+        return static_cast<int>(static_cast<unsigned int>(p_iA) -
+                                static_cast<unsigned int>(p_iB));
+    }
+
+    /** @return p_iPos + 1, with wrap-around. */
+    static inline int _Next(const int p_iPos)
+    {
+        return static_cast<int>(static_cast<unsigned int>(p_iPos) + 1u);
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModulePortQueue(const ModulePortQueue&);
+    ModulePortQueue& operator = (const ModulePortQueue&);
+
+protected:
+
+    /**
+     * @struct Cell
+     *
+     * @brief Element of the ring.
+     */
+    struct Cell
+    {
+        QAtomicInt  m_iSeq; /**< Sequence number of the cell. */
+
+        DataPtr     m_pData; /**< Queued Data. */
+    };
+
+    Cell*   m_pCells; /**< Ring of cells. */
+
+    int     m_iMask; /**< Capacity - 1. */
+
+    const OverflowPolicy    m_Policy; /**< Overflow policy. */
+
+    char    m_acPad0[MODULE_PORT_QUEUE_PADDING];
+
+    QAtomicInt  m_iEnqueuePos; /**< Producers position. */
+
+    char    m_acPad1[MODULE_PORT_QUEUE_PADDING];
+
+    QAtomicInt  m_iDequeuePos; /**< Consumers position. */
+
+    char    m_acPad2[MODULE_PORT_QUEUE_PADDING];
+
+    QAtomicInt  m_iDropped; /**< Number of discarded Data. */
+
+    QAtomicInt  m_iWaiting; /**< Number of producers waiting for a free
+                             * cell. */
+
+    QMutex  m_MutexWait; /**< Protects the wait of the blocked producers and
+                          * m_pObserver. */
+
+    ModulePortQueueObserverPtr  m_pObserver; /**< Told about the discarded
+                                              * Data. */
+
+    QWaitCondition  m_condNotFull; /**< Wakes the blocked producers. */
+
+    bool    m_bClosed; /**< True if the blocking pushes must fail. */
+
+}; // end class ModulePortQueue.
+
+DEF_PTR(ModulePortQueue);
+
+} // end namespace fby.
+
+#endif // MODULE_PORT_QUEUE_H
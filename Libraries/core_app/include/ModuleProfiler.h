@@ -0,0 +1,553 @@
+#ifndef MODULE_PROFILER_H
+#define MODULE_PROFILER_H
+
+/** @file ModuleProfiler.h
+ *
+ * @brief Defines the ModuleProfiler class, which records the execution
+ * statistics of a Module, and the ModuleStats snapshot of those statistics.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <ModulePort.h>
+
+/** Number of linear sub-buckets for each power of two of the latency
+ * histogram: the relative error of the percentiles is 1 / this value. */
+#define MODULE_PROFILER_SUB_BUCKETS     8
+
+/** Number of buckets of the latency histogram. */
+#define MODULE_PROFILER_NUM_BUCKETS     512
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @struct ModuleStats
+ *
+ * @brief Snapshot of the execution statistics of a Module. Times are in
+ * nanoseconds.
+ */
+struct ModuleStats
+{
+    ModuleStats()
+        : m_llCalls(0),
+          m_llTimerCalls(0),
+          m_llTriggerCalls(0),
+          m_llAsyncCalls(0),
+          m_llPortCalls(0),
+          m_llSkipped(0),
+          m_llDropped(0),
+          m_llCoalesced(0),
+          m_llDeadlineMisses(0),
+          m_llShed(0),
+          m_llLatencyMean_ns(0),
+          m_llLatencyP50_ns(0),
+          m_llLatencyP99_ns(0),
+          m_llLatencyMax_ns(0),
+          m_llBusy_ns(0),
+          m_llMutexWaits(0),
+          m_llMutexWait_ns(0),
+          m_llMutexWaitMax_ns(0),
+          m_iLastPortId(TRIGGERED_EVENT_PORT_ID)
+    {
+        /* Empty. */
+    }
+
+    std::string m_sName; /**< Name of the Module. */
+
+    QUuid   m_Id; /**< Id of the Module. */
+
+    qint64  m_llCalls; /**< Number of executions of the thread function. */
+
+    qint64  m_llTimerCalls; /**< Executions triggered by the main timer. */
+
+    qint64  m_llTriggerCalls; /**< Executions triggered by Trigger(). */
+
+    qint64  m_llAsyncCalls; /**< Executions triggered by the completion of an
+                             * asynchronous job (see ModuleAsync). */
+
+    qint64  m_llPortCalls; /**< Executions triggered by an input port. Other
+                            * negative port ids, e.g. used by a Module for
+                            * its own events, are only counted in
+                            * m_llCalls. */
+
+    std::vector<qint64>     m_vPortCalls; /**< Executions triggered by each
+                                           * input port, indexed by port id. */
+
+    qint64  m_llSkipped; /**< Executions skipped because the Module was paused
+                          * or closed. */
+
+    qint64  m_llDropped; /**< Data discarded by the full queue of an input
+                          * port (see g_LinkModulesQueued()). */
+
+    qint64  m_llCoalesced; /**< Notifications merged into a pending execution
+                            * (see ModulePort::SetCoalesced()). */
+
+    qint64  m_llDeadlineMisses; /**< Executions that ended after the deadline
+                                 * (see Module::SetDeadline()). */
+
+    qint64  m_llShed; /**< Executions skipped to meet the deadline. */
+
+    qint64  m_llLatencyMean_ns; /**< Mean duration of the thread function. */
+
+    qint64  m_llLatencyP50_ns; /**< Median duration of the thread function. */
+
+    qint64  m_llLatencyP99_ns; /**< 99th percentile of the duration. */
+
+    qint64  m_llLatencyMax_ns; /**< Maximum duration of the thread function. */
+
+    qint64  m_llBusy_ns; /**< Total time spent in the thread function. */
+
+    qint64  m_llMutexWaits; /**< Number of contended locks of m_Mutex taken
+                             * with LOCK_MODULE_READ or LOCK_MODULE_WRITE. The
+                             * plain LOCK_READ and LOCK_WRITE of m_Mutex, e.g.
+                             * those in Module.cpp, are not measured. */
+
+    qint64  m_llMutexWait_ns; /**< Total time spent waiting for m_Mutex. */
+
+    qint64  m_llMutexWaitMax_ns; /**< Longest wait for m_Mutex. */
+
+    int     m_iLastPortId; /**< Trigger source of the last execution: an input
+                            * port id, TIMER_EVENT_PORT_ID or
+                            * TRIGGERED_EVENT_PORT_ID. */
+
+}; // end struct ModuleStats.
+
+typedef std::list<ModuleStats>  ModuleStatsList;
+
+/******************************************************************************/
+/**
+ * @class ModuleProfiler
+ *
+ * @brief Records the executions of the thread function of a Module: number of
+ * calls per trigger source, a latency histogram with logarithmic buckets, the
+ * time spent waiting for the Module mutex, the dropped notifications and the
+ * missed deadlines.
+ *
+ * The histogram has MODULE_PROFILER_SUB_BUCKETS linear buckets for each power
+ * of two, so that the percentiles have a bounded relative error and recording
+ * a call costs a few integer operations. The counters are protected by a
+ * mutex that is practically never contended, since a Module does not run
+ * concurrently with itself.
+ *
+ * Only the locks of the Module mutex taken with LOCK_MODULE_READ or
+ * LOCK_MODULE_WRITE are measured (see ModuleProfiledLocker): the waits of the
+ * plain LOCK_READ and LOCK_WRITE are not recorded.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleProfiler
+{
+public:
+
+    ModuleProfiler()
+        : m_iEnabled(1)
+    {
+        Reset();
+    }
+
+    /**
+     * @return true if the executions are recorded.
+     */
+    inline bool IsEnabled() const
+    {
+        return (m_iEnabled.load() != 0);
+    }
+
+    /**
+     * @brief GetStats fills a snapshot of the recorded statistics. The name
+     * and the id are filled by the Module.
+     *
+     * @param[out]  p_rStats    Snapshot.
+     */
+    void GetStats(ModuleStats& p_rStats) const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        p_rStats.m_llCalls = m_llCalls;
+        p_rStats.m_llTimerCalls = m_llTimerCalls;
+        p_rStats.m_llTriggerCalls = m_llTriggerCalls;
+        p_rStats.m_llAsyncCalls = m_llAsyncCalls;
+        p_rStats.m_llPortCalls = m_llPortCalls;
+        p_rStats.m_vPortCalls = m_vPortCalls;
+        p_rStats.m_llSkipped = m_llSkipped;
+        p_rStats.m_llDropped = m_llDropped;
+        p_rStats.m_llCoalesced = m_llCoalesced;
+        p_rStats.m_llDeadlineMisses = m_llDeadlineMisses;
+        p_rStats.m_llShed = m_llShed;
+        p_rStats.m_llLatencyMean_ns = (m_llCalls > 0 ?
+                                       m_llBusy_ns / m_llCalls : 0);
+        p_rStats.m_llLatencyP50_ns = _Percentile(0.50);
+        p_rStats.m_llLatencyP99_ns = _Percentile(0.99);
+        p_rStats.m_llLatencyMax_ns = m_llLatencyMax_ns;
+        p_rStats.m_llBusy_ns = m_llBusy_ns;
+        p_rStats.m_llMutexWaits = m_llMutexWaits;
+        p_rStats.m_llMutexWait_ns = m_llMutexWait_ns;
+        p_rStats.m_llMutexWaitMax_ns = m_llMutexWaitMax_ns;
+        p_rStats.m_iLastPortId = m_iLastPortId;
+    }
+
+    /**
+     * @return the mean duration of the thread function, or 0 if it has not
+     * been called yet.
+     */
+    qint64 GetMeanLatency_ns() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return (m_llCalls > 0 ? m_llBusy_ns / m_llCalls : 0);
+    }
+
+    /**
+     * @brief RecordCall records an execution of the thread function.
+     *
+     * @param[in]   p_iPortId       Trigger source.
+     * @param[in]   p_llLatency_ns  Duration of the execution.
+     */
+    void RecordCall(const int       p_iPortId,
+                    const qint64    p_llLatency_ns)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llCalls++;
+        m_llBusy_ns += p_llLatency_ns;
+        m_llLatencyMax_ns = std::max(m_llLatencyMax_ns, p_llLatency_ns);
+        m_allHistogram[_Bucket(p_llLatency_ns)]++;
+        m_iLastPortId = p_iPortId;
+
+        switch (p_iPortId)
+        {
+        case TIMER_EVENT_PORT_ID:
+            m_llTimerCalls++;
+            break;
+
+        case TRIGGERED_EVENT_PORT_ID:
+            m_llTriggerCalls++;
+            break;
+
+        case ASYNC_EVENT_PORT_ID:
+            m_llAsyncCalls++;
+            break;
+
+        default:
+            if (p_iPortId >= 0)
+            {
+                if (p_iPortId >= static_cast<int>(m_vPortCalls.size()))
+                {
+                    m_vPortCalls.resize(p_iPortId + 1, 0);
+                }
+
+                m_llPortCalls++;
+                m_vPortCalls[p_iPortId]++;
+            }
+            break;
+        } // end switch.
+    }
+
+    /**
+     * @brief RecordCoalesced records a notification merged into the pending
+     * execution of a coalesced input port.
+     */
+    void RecordCoalesced()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llCoalesced++;
+    }
+
+    /**
+     * @brief RecordDeadlineMiss records an execution that ended after its
+     * deadline.
+     */
+    void RecordDeadlineMiss()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llDeadlineMisses++;
+    }
+
+    /**
+     * @brief RecordDropped records Data discarded by the full queue of an
+     * input port, without causing an execution.
+     */
+    void RecordDropped(const qint64 p_llNumDropped = 1)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llDropped += p_llNumDropped;
+    }
+
+    /**
+     * @brief RecordMutexWait records a contended lock of the Module mutex.
+     *
+     * @param[in]   p_llWait_ns     Time spent waiting for the lock.
+     */
+    void RecordMutexWait(const qint64 p_llWait_ns)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llMutexWaits++;
+        m_llMutexWait_ns += p_llWait_ns;
+        m_llMutexWaitMax_ns = std::max(m_llMutexWaitMax_ns, p_llWait_ns);
+    }
+
+    /**
+     * @brief RecordShed records an execution skipped to meet the deadline.
+     */
+    void RecordShed()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llShed++;
+    }
+
+    /**
+     * @brief RecordSkipped records an execution skipped because the Module
+     * was paused or closed.
+     */
+    void RecordSkipped()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llSkipped++;
+    }
+
+    /**
+     * @brief Reset clears the recorded statistics.
+     */
+    void Reset()
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_llCalls = 0;
+        m_llTimerCalls = 0;
+        m_llTriggerCalls = 0;
+        m_llAsyncCalls = 0;
+        m_llPortCalls = 0;
+        m_vPortCalls.clear();
+        m_llSkipped = 0;
+        m_llDropped = 0;
+        m_llCoalesced = 0;
+        m_llDeadlineMisses = 0;
+        m_llShed = 0;
+        m_llBusy_ns = 0;
+        m_llLatencyMax_ns = 0;
+        m_llMutexWaits = 0;
+        m_llMutexWait_ns = 0;
+        m_llMutexWaitMax_ns = 0;
+        m_iLastPortId = TRIGGERED_EVENT_PORT_ID;
+
+        std::fill(m_allHistogram,
+                  m_allHistogram + MODULE_PROFILER_NUM_BUCKETS,
+                  0);
+    }
+
+    /**
+     * @brief SetEnabled enables or disables the recording of the executions.
+     */
+    inline void SetEnabled(const bool p_bEnabled)
+    {
+        m_iEnabled.store(p_bEnabled ? 1 : 0);
+    }
+
+protected:
+
+    /**
+     * @return the histogram bucket of a duration.
+     */
+    static int _Bucket(const qint64 p_llValue_ns)
+    {
+        quint64     l_ullValue;
+        int         l_iExp;
+
+        if (p_llValue_ns < MODULE_PROFILER_SUB_BUCKETS)
+        {
+            return static_cast<int>(std::max(p_llValue_ns, qint64(0)));
+        }
+
+        l_ullValue = static_cast<quint64>(p_llValue_ns);
+        l_iExp = 0;
+
+        while ((l_ullValue >> l_iExp) >= 2 * MODULE_PROFILER_SUB_BUCKETS)
+        {
+            l_iExp++;
+        }
+
+        return std::min(MODULE_PROFILER_NUM_BUCKETS - 1,
+                        (l_iExp + 1) * MODULE_PROFILER_SUB_BUCKETS +
+                        static_cast<int>(l_ullValue >> l_iExp) -
+                        MODULE_PROFILER_SUB_BUCKETS);
+    }
+
+    /**
+     * @return the largest duration that falls in a histogram bucket.
+     */
+    static qint64 _BucketUpperBound(const int p_iBucket)
+    {
+        int     l_iExp;
+
+        if (p_iBucket < MODULE_PROFILER_SUB_BUCKETS)
+        {
+            return p_iBucket;
+        }
+
+        l_iExp = p_iBucket / MODULE_PROFILER_SUB_BUCKETS - 1;
+
+        return ((static_cast<qint64>(p_iBucket % MODULE_PROFILER_SUB_BUCKETS +
+                                     MODULE_PROFILER_SUB_BUCKETS + 1)
+                 << l_iExp) - 1);
+    }
+
+    /**
+     * @return the specified percentile of the durations, bounded by the
+     * maximum duration.
+     *
+     * @warning m_Mutex must be locked by the caller.
+     */
+    qint64 _Percentile(const double p_dFraction) const
+    {
+        qint64  l_llTarget;
+        qint64  l_llCount;
+        int     l_i;
+
+        if (m_llCalls == 0)
+        {
+            return 0;
+        }
+
+        l_llTarget = static_cast<qint64>(ceil(p_dFraction * m_llCalls));
+        l_llCount = 0;
+
+        for (l_i = 0; l_i < MODULE_PROFILER_NUM_BUCKETS; l_i++)
+        {
+            l_llCount += m_allHistogram[l_i];
+
+            if (l_llCount >= l_llTarget)
+            {
+                return std::min(_BucketUpperBound(l_i), m_llLatencyMax_ns);
+            }
+        }
+
+        return m_llLatencyMax_ns;
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleProfiler(const ModuleProfiler&);
+    ModuleProfiler& operator = (const ModuleProfiler&);
+
+protected:
+
+    mutable QMutex  m_Mutex; /**< Protects the counters. */
+
+    QAtomicInt  m_iEnabled; /**< Non-zero if the executions are recorded: read
+                             * without m_Mutex by the executions. */
+
+    qint64  m_llCalls;
+
+    qint64  m_llTimerCalls;
+
+    qint64  m_llTriggerCalls;
+
+    qint64  m_llAsyncCalls;
+
+    qint64  m_llPortCalls;
+
+    std::vector<qint64>     m_vPortCalls;
+
+    qint64  m_llSkipped;
+
+    qint64  m_llDropped;
+
+    qint64  m_llCoalesced;
+
+    qint64  m_llDeadlineMisses;
+
+    qint64  m_llShed;
+
+    qint64  m_llBusy_ns;
+
+    qint64  m_llLatencyMax_ns;
+
+    qint64  m_llMutexWaits;
+
+    qint64  m_llMutexWait_ns;
+
+    qint64  m_llMutexWaitMax_ns;
+
+    int     m_iLastPortId;
+
+    qint64  m_allHistogram[MODULE_PROFILER_NUM_BUCKETS]; /**< Latency
+                                                          * histogram. */
+
+}; // end class ModuleProfiler.
+
+/******************************************************************************/
+/**
+ * @class ModuleProfiledLocker
+ *
+ * @brief Locks a QReadWriteLock for the lifetime of this object, like
+ * QReadLocker and QWriteLocker, and records the time spent waiting for the
+ * lock when it is contended.
+ */
+class ModuleProfiledLocker
+{
+public:
+
+    ModuleProfiledLocker(QReadWriteLock*    p_pMutex,
+                         ModuleProfiler*    p_pProfiler,
+                         const bool         p_bWrite)
+        : m_pMutex(p_pMutex)
+    {
+        QElapsedTimer   l_Timer;
+
+        if (p_bWrite ? m_pMutex->tryLockForWrite() :
+                       m_pMutex->tryLockForRead())
+        {
+            return;
+        }
+
+        l_Timer.start();
+
+        if (p_bWrite)
+        {
+            m_pMutex->lockForWrite();
+        }
+        else
+        {
+            m_pMutex->lockForRead();
+        }
+
+        if (p_pProfiler->IsEnabled())
+        {
+            p_pProfiler->RecordMutexWait(l_Timer.nsecsElapsed());
+        }
+    }
+
+    ~ModuleProfiledLocker()
+    {
+        m_pMutex->unlock();
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleProfiledLocker(const ModuleProfiledLocker&);
+    ModuleProfiledLocker& operator = (const ModuleProfiledLocker&);
+
+protected:
+
+    QReadWriteLock*     m_pMutex; /**< Locked mutex. */
+
+}; // end class ModuleProfiledLocker.
+
+} // end namespace fby.
+
+#endif // MODULE_PROFILER_H
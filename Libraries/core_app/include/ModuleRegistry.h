@@ -0,0 +1,234 @@
+#ifndef MODULE_REGISTRY_H
+#define MODULE_REGISTRY_H
+
+/** @file ModuleRegistry.h
+ *
+ * @brief Defines the ModuleRegistry class, the registry of the Modules linked
+ * statically into the application.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <ModuleWrapper.h>
+
+#include <cstring>
+#include <vector>
+
+/******************************************************************************/
+/* Macros. */
+
+/** Registers the allocator of a Module at static initialization time. Used by
+ * MODULE_ALLOC_FUN_IMPL when MODULE_LIBRARY_STATIC is defined. */
+#define MODULE_REGISTER(name) \
+    static const bool s_bModuleRegistered##name = \
+        fby::ModuleRegistry::Register(#name, New##name);
+
+/** Registers the allocator of a ModuleWrapper at static initialization time.
+ * Used by MODULE_WRAPPER_ALLOC_FUN_IMPL when MODULE_LIBRARY_STATIC is
+ * defined. */
+#define MODULE_WRAPPER_REGISTER(name) \
+    static const bool s_bModuleWrapperRegistered##name = \
+        fby::ModuleRegistry::RegisterWrapper(#name, NewWrap##name);
+
+/** Registers a statically linked Module from the application. Since it
+ * references the allocator, it also keeps the linker from discarding the
+ * Module when its library is not linked as a whole archive. */
+#define MODULE_STATIC_IMPORT(name) \
+    extern "C" fby::Module* New##name(fby::ModuleExecMode); \
+    MODULE_REGISTER(name)
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class ModuleRegistry
+ *
+ * @brief Registry of the allocators of the Modules compiled into the
+ * application (qmake: MODULE_LIBRARY_STATIC=1). Each Module registers itself
+ * at static initialization time, through MODULE_ALLOC_FUN_IMPL, and
+ * ModuleManager::Create() looks for it here before loading any shared
+ * library, so that no folder is scanned and no symbol is resolved at start
+ * up.
+ *
+ * @note The linker only keeps the objects of a static library that are
+ * referenced: the libraries of the Modules must be linked as whole archives
+ * (e.g. -Wl,--whole-archive, /WHOLEARCHIVE), or the application must name
+ * them with MODULE_STATIC_IMPORT.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleRegistry
+{
+public:
+
+    /**
+     * @return the allocator of a registered Module, or NULL.
+     */
+    static ModuleAllocatorFun FindAllocator(const QString& p_rsModuleName)
+    {
+        QMutexLocker    l_Lock(&_Mutex());
+        const Entry*    l_pEntry;
+
+        l_pEntry = _Find(p_rsModuleName);
+
+        return (l_pEntry ? l_pEntry->m_funAllocator : NULL);
+    }
+
+    /**
+     * @return the allocator of a registered ModuleWrapper, or NULL.
+     */
+    static ModuleWrapperAllocatorFun FindWrapperAllocator(
+            const QString& p_rsModuleName)
+    {
+        QMutexLocker    l_Lock(&_Mutex());
+        const Entry*    l_pEntry;
+
+        l_pEntry = _Find(p_rsModuleName);
+
+        return (l_pEntry ? l_pEntry->m_funAllocatorWrap : NULL);
+    }
+
+    /**
+     * @return the names of the registered Modules.
+     */
+    static QStringList GetModuleNames()
+    {
+        QMutexLocker    l_Lock(&_Mutex());
+        QStringList     l_lNames;
+        size_t          l_s;
+
+        for (l_s = 0; l_s < _Entries().size(); l_s++)
+        {
+            l_lNames << QString(_Entries()[l_s].m_pszName);
+        }
+
+        return l_lNames;
+    }
+
+    /**
+     * @brief Register registers the allocator of a Module. A later
+     * registration of the same name replaces the allocator.
+     *
+     * @return true, so that it can initialize a static variable.
+     */
+    static bool Register(const char*        p_pszModuleName,
+                         ModuleAllocatorFun p_funAllocator)
+    {
+        QMutexLocker    l_Lock(&_Mutex());
+
+        _Get(p_pszModuleName).m_funAllocator = p_funAllocator;
+
+        return true;
+    }
+
+    /**
+     * @brief RegisterWrapper registers the allocator of a ModuleWrapper.
+     *
+     * @return true, so that it can initialize a static variable.
+     */
+    static bool RegisterWrapper(const char*                 p_pszModuleName,
+                                ModuleWrapperAllocatorFun   p_funAllocator)
+    {
+        QMutexLocker    l_Lock(&_Mutex());
+
+        _Get(p_pszModuleName).m_funAllocatorWrap = p_funAllocator;
+
+        return true;
+    }
+
+protected:
+
+    /**
+     * @struct Entry
+     *
+     * @brief Allocators of a registered Module.
+     */
+    struct Entry
+    {
+        const char*     m_pszName; /**< Name of the Module. */
+
+        ModuleAllocatorFun  m_funAllocator; /**< Module allocator. */
+
+        ModuleWrapperAllocatorFun   m_funAllocatorWrap; /**< ModuleWrapper
+                                                         * allocator. */
+    };
+
+protected:
+
+    /**
+     * @return the registered Modules. Built on first use, so that the
+     * registrations do not depend on the order of the static
+     * initializations.
+     */
+    static std::vector<Entry>& _Entries()
+    {
+        static std::vector<Entry>   s_vEntries;
+
+        return s_vEntries;
+    }
+
+    /**
+     * @return the entry of a Module, or NULL. _Mutex() must be locked.
+     */
+    static const Entry* _Find(const QString& p_rsModuleName)
+    {
+        size_t  l_s;
+
+        for (l_s = 0; l_s < _Entries().size(); l_s++)
+        {
+            if (p_rsModuleName == QString(_Entries()[l_s].m_pszName))
+            {
+                return &_Entries()[l_s];
+            }
+        }
+
+        return NULL;
+    }
+
+    /**
+     * @return the entry of a Module, added if missing. _Mutex() must be
+     * locked.
+     */
+    static Entry& _Get(const char* p_pszModuleName)
+    {
+        Entry   l_Entry;
+        size_t  l_s;
+
+        for (l_s = 0; l_s < _Entries().size(); l_s++)
+        {
+            if (strcmp(_Entries()[l_s].m_pszName, p_pszModuleName) == 0)
+            {
+                return _Entries()[l_s];
+            }
+        }
+
+        l_Entry.m_pszName = p_pszModuleName;
+        l_Entry.m_funAllocator = NULL;
+        l_Entry.m_funAllocatorWrap = NULL;
+
+        _Entries().push_back(l_Entry);
+
+        return _Entries().back();
+    }
+
+    /**
+     * @return the mutex that protects the entries.
+     */
+    static QMutex& _Mutex()
+    {
+        static QMutex   s_Mutex;
+
+        return s_Mutex;
+    }
+
+}; // end class ModuleRegistry.
+
+} // end namespace fby.
+
+#endif // MODULE_REGISTRY_H
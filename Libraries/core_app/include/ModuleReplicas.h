@@ -0,0 +1,966 @@
+#ifndef MODULE_REPLICAS_H
+#define MODULE_REPLICAS_H
+
+/** @file ModuleReplicas.h
+ *
+ * @brief Defines the ModuleReplicas class, which runs many instances of a
+ * stateless Module in parallel and restores the order of their outputs.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <DataFrame.h>
+#include <ModuleManager.h>
+
+/** Default maximum number of Data being processed by each replica. */
+#define MODULE_REPLICAS_DEFAULT_MAX_IN_FLIGHT   4
+
+/** Default maximum time a replica may take to process a Data (ms). */
+#define MODULE_REPLICAS_DEFAULT_MAX_WAIT_MS     1000
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class ModuleReplicas
+ *
+ * @ingroup Modules
+ *
+ * @brief Runs N replicas of a stateless Module, created through
+ * ModuleManager::Create(), so that a CPU-heavy stage (e.g.
+ * ortho-rectification or detection) is spread over many cores instead of
+ * being bound to the rate of a single one. The replicas must not share any
+ * state between two executions, since they run concurrently.
+ *
+ * This Module has the same ports as the replicated one. Each Data received by
+ * the input port 0 is a work item, dispatched to one replica, round-robin or
+ * to the replica with the fewest Data in flight, through a private queued
+ * link. The Data received by the other input ports are not work items: the
+ * last one of each port is held and fed, just before the next work item, to
+ * the replica that processes it, so that the inputs of a sample are never
+ * split across replicas. A replica should publish only when it runs on its
+ * port 0. The Data
+ * published by the replicas are then reordered by the timestamp of the
+ * dispatched Data (see _GetTimestamp()), the dispatch order breaking the
+ * ties, and published on the output ports of this Module: a result is
+ * published once every Data dispatched before it has been processed.
+ *
+ * A replica is expected to publish at most one Data on its output port 0 for
+ * each processed Data, with the timestamp of the processed one. The Data
+ * published on the other output ports are released together with the result
+ * of port 0 they precede. A Data that a replica does not answer is considered
+ * lost when the replica answers a later one, or after the maximum wait, so
+ * that it does not block the following ones. The wait is checked on every
+ * received Data and on every execution of the main timer: this Module should
+ * be started with a loop time when the replicas can drop their input. When
+ * every replica has the maximum number of Data in flight, the received Data
+ * are dropped.
+ *
+ * The replicas run on the executor of this Module (see Module::SetExecutor())
+ * or, without it, each one in its own thread. The configuration is propagated
+ * to all the replicas (see LoadConfig()).
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleReplicas : public Module,
+                       public ModuleStatsSource
+{
+public:
+
+    /**
+     * @enum DispatchPolicy
+     *
+     * @brief Enumerates the ways a received Data is assigned to a replica.
+     */
+    enum DispatchPolicy
+    {
+        DISPATCH_ROUND_ROBIN = 0, /**< Replicas in turn. */
+        DISPATCH_LEAST_LOADED /**< Replica with the fewest Data in flight. */
+
+    }; // end enum DispatchPolicy.
+
+public:
+
+    /**
+     * @brief Builds a new ModuleReplicas. The replicas are created by Init().
+     *
+     * @param[in]   p_Mode          Execution mode.
+     * @param[in]   p_rsType        Type of the replicated Module (see
+     *                              ModuleManager::Create()).
+     * @param[in]   p_iNumReplicas  Number of replicas. If not positive, the
+     *                              number of cores.
+     * @param[in]   p_Policy        Dispatch policy.
+     */
+    ModuleReplicas(ModuleExecMode   p_Mode,
+                   const QString&   p_rsType,
+                   const int        p_iNumReplicas = 0,
+                   DispatchPolicy   p_Policy = DISPATCH_ROUND_ROBIN)
+        : Module(p_Mode),
+          m_sType(p_rsType),
+          m_iNumReplicas(p_iNumReplicas > 0 ? p_iNumReplicas
+                                            : QThread::idealThreadCount()),
+          m_Policy(p_Policy),
+          m_iMaxInFlight(MODULE_REPLICAS_DEFAULT_MAX_IN_FLIGHT),
+          m_iMaxWait_ms(MODULE_REPLICAS_DEFAULT_MAX_WAIT_MS),
+          m_sNext(0),
+          m_llDispatched(0),
+          m_llDropped(0),
+          m_llLost(0)
+    {
+        m_iNumReplicas = std::max(m_iNumReplicas, 1);
+
+        m_Clock.start();
+    }
+
+    virtual ~ModuleReplicas()
+    {
+        _CloseExecution();
+
+        _CloseListeners();
+    }
+
+    virtual bool Close()
+    {
+        bool    l_bResult;
+        size_t  l_s;
+
+        l_bResult = Module::Close();
+
+        _CloseListeners();
+
+        for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+        {
+            m_vReplicas[l_s]->SetExecutor(ModuleExecutorPtr());
+
+            l_bResult = m_vReplicas[l_s]->Close() && l_bResult;
+        }
+
+        return l_bResult;
+    }
+
+    virtual void CollectManagedStats(ModuleStatsList& p_rlStats) const
+    {
+        size_t  l_s;
+
+        for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+        {
+            m_vReplicas[l_s]->CollectStats(p_rlStats);
+        }
+    }
+
+    /** @return the number of Data dispatched to the replicas. */
+    inline qint64 GetNumDispatched() const
+    {
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        return m_llDispatched;
+    }
+
+    /** @return the number of Data dropped since every replica was busy. */
+    inline qint64 GetNumDropped() const
+    {
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        return m_llDropped;
+    }
+
+    /** @return the number of Data not answered within the maximum wait. */
+    inline qint64 GetNumLost() const
+    {
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        return m_llLost;
+    }
+
+    /** @return the number of replicas. */
+    inline int GetNumReplicas() const
+    {
+        return m_iNumReplicas;
+    }
+
+    /**
+     * @return the replica with the input index, or a null object before
+     * Init().
+     */
+    inline ModulePtr GetReplica(const int p_iIndex) const
+    {
+        if (p_iIndex < 0 || p_iIndex >= static_cast<int>(m_vReplicas.size()))
+        {
+            return ModulePtr();
+        }
+
+        return m_vReplicas[p_iIndex];
+    }
+
+    /** @return the type of the replicated Module. */
+    inline const QString& GetType() const
+    {
+        return m_sType;
+    }
+
+    /**
+     * @brief Init creates and initializes the replicas, then adds to this
+     * Module the ports of the replicated one.
+     *
+     * @return RET_ERROR if a replica cannot be created or initialized.
+     */
+    virtual RetFlag Init(ModuleExecMode p_Mode)
+    {
+        ModulePtr       l_pReplica;
+        ModulePortPtr   l_pFeed;
+        ModulePortPtr   l_pPort;
+        RetFlag         l_Result;
+        int             l_iReplica;
+        int             l_iPort;
+
+        if (!m_vReplicas.empty())
+        {
+            return RET_SUCCESS;
+        }
+
+        l_Result = Module::Init(p_Mode);
+
+        for (l_iReplica = 0; l_iReplica < m_iNumReplicas; l_iReplica++)
+        {
+            l_pReplica = ModuleManager::Create(m_sType, p_Mode);
+
+            /* The allocator of the replica has already run its Init() and
+             * InitOptions(). */
+            if (!l_pReplica)
+            {
+                qWarning() << "ModuleReplicas: cannot instantiate" << m_sType;
+
+                m_vReplicas.clear();
+                m_vFeeds.clear();
+
+                return RET_ERROR;
+            }
+
+            l_pReplica->SetName(GetName());
+            l_pReplica->SetWorkDir(GetWorkDir());
+
+            m_vReplicas.push_back(l_pReplica);
+            m_vFeeds.push_back(std::vector<ModulePortPtr>());
+
+            if (l_pReplica->GetNumPortIn() < 1)
+            {
+                qWarning() << "ModuleReplicas:" << m_sType
+                           << "has no input port";
+
+                m_vReplicas.clear();
+                m_vFeeds.clear();
+
+                return RET_ERROR;
+            }
+
+            /* Private output ports that feed the inputs of the replica. */
+            for (l_iPort = 0; l_iPort < l_pReplica->GetNumPortIn(); l_iPort++)
+            {
+                l_pFeed.reset(new ModulePort(l_iPort,
+                                             ModulePort::PORT_OUTPUT));
+
+                l_pPort = l_pReplica->GetPortIn(l_iPort);
+
+                l_pPort->LinkToPort(l_pFeed);
+                l_pFeed->AddListener(l_pReplica->GetPortListener(),
+                                     l_iPort,
+                                     GET_PTR(l_pPort));
+
+                m_vFeeds.back().push_back(l_pFeed);
+            }
+        }
+
+        l_pReplica = m_vReplicas.front();
+
+        for (l_iPort = 0; l_iPort < l_pReplica->GetNumPortIn(); l_iPort++)
+        {
+            AddInput(1);
+
+            GetPortIn(l_iPort)->SetDataType(
+                        l_pReplica->GetPortIn(l_iPort)->GetDataType());
+        }
+
+        for (l_iPort = 0; l_iPort < l_pReplica->GetNumPortOut(); l_iPort++)
+        {
+            AddOutput(l_pReplica->GetPortOut(l_iPort)->GetData());
+
+            GetPortOut(l_iPort)->SetDataType(
+                        l_pReplica->GetPortOut(l_iPort)->GetDataType());
+        }
+
+        _LockInputPortNum();
+        _LockOutputPortNum();
+
+        m_vPending.assign(l_pReplica->GetNumPortIn(), DataPtr());
+
+        _InitListeners();
+
+        return l_Result;
+    }
+
+    /**
+     * @brief LoadConfig loads the configuration of this Module, then the same
+     * configuration into all the replicas.
+     */
+    virtual void LoadConfig(QSettings& p_rSettings)
+    {
+        size_t  l_s;
+
+        Module::LoadConfig(p_rSettings);
+
+        for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+        {
+            m_vReplicas[l_s]->LoadConfig(p_rSettings);
+        }
+    }
+
+    /**
+     * @brief SaveConfig saves the configuration of the first replica, which
+     * is shared by all of them.
+     */
+    virtual void SaveConfig(QSettings& p_rSettings)
+    {
+        if (!m_vReplicas.empty())
+        {
+            m_vReplicas.front()->SaveConfig(p_rSettings);
+        }
+    }
+
+    /**
+     * @brief SetMaxInFlight sets the maximum number of Data being processed
+     * by each replica. Takes effect from the next Start().
+     */
+    void SetMaxInFlight(const int p_iMaxInFlight)
+    {
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        m_iMaxInFlight = std::max(p_iMaxInFlight, 1);
+    }
+
+    /**
+     * @brief SetMaxWait sets the maximum time a replica may take to process a
+     * Data before it is considered lost.
+     */
+    void SetMaxWait(const int p_iMaxWait_ms)
+    {
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        m_iMaxWait_ms = std::max(p_iMaxWait_ms, 0);
+    }
+
+    virtual void SetName(const std::string& p_rsName)
+    {
+        size_t  l_s;
+
+        Module::SetName(p_rsName);
+
+        /* The replicas share the name, hence the configuration group. */
+        for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+        {
+            m_vReplicas[l_s]->SetName(p_rsName);
+        }
+    }
+
+    /** @brief SetPolicy sets the dispatch policy. */
+    void SetPolicy(DispatchPolicy p_Policy)
+    {
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        m_Policy = p_Policy;
+    }
+
+    virtual void SetWorkDir(const std::string& p_rsPath)
+    {
+        size_t  l_s;
+
+        Module::SetWorkDir(p_rsPath);
+
+        for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+        {
+            m_vReplicas[l_s]->SetWorkDir(p_rsPath);
+        }
+    }
+
+    /**
+     * @brief Start starts the replicas, on the executor of this Module or in
+     * their own threads, then this Module.
+     */
+    virtual RetFlag Start(int p_iPeriod_ms = 0)
+    {
+        ModuleExecutorPtr   l_pExecutor;
+        RetFlag             l_Result;
+        size_t              l_sReplica;
+        size_t              l_sPort;
+        int                 l_iMaxInFlight;
+
+        {
+            QMutexLocker    l_Lock(&m_MutexOrder);
+
+            l_iMaxInFlight = m_iMaxInFlight;
+        }
+
+        l_pExecutor = GetExecutor();
+        l_Result = RET_SUCCESS;
+
+        for (l_sReplica = 0; l_sReplica < m_vReplicas.size(); l_sReplica++)
+        {
+            ModulePtr   l_pReplica = m_vReplicas[l_sReplica];
+
+            /* The dispatch never exceeds the in-flight limit: the queues of
+             * the private links never overflow. */
+            for (l_sPort = 0;
+                 l_sPort < m_vFeeds[l_sReplica].size();
+                 l_sPort++)
+            {
+                l_pReplica->GetPortIn(static_cast<int>(l_sPort))->EnableQueue(
+                            l_iMaxInFlight);
+            }
+
+            /* The replicas run the work the deadline is about. */
+            l_pReplica->SetPriority(GetPriority());
+            l_pReplica->SetDeadline(GetDeadline(), GetDeadlinePolicy());
+            l_pReplica->SetFramePool(GetFramePool());
+
+            if (l_pExecutor)
+            {
+                l_pReplica->SetExecutor(l_pExecutor);
+            }
+            else if (l_pReplica->InitThread() != RET_SUCCESS)
+            {
+                l_Result = RET_ERROR;
+            }
+
+            if (l_pReplica->Start(0) != RET_SUCCESS)
+            {
+                l_Result = RET_ERROR;
+            }
+        }
+
+        if (Module::Start(p_iPeriod_ms) != RET_SUCCESS)
+        {
+            l_Result = RET_ERROR;
+        }
+
+        return l_Result;
+    }
+
+    /**
+     * @brief Stop stops this Module, then the replicas.
+     */
+    virtual bool Stop(int p_iWait_ms = MODULE_STOP_NO_WAIT)
+    {
+        bool    l_bResult;
+        size_t  l_s;
+
+        l_bResult = Module::Stop(p_iWait_ms);
+
+        for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+        {
+            l_bResult = m_vReplicas[l_s]->Stop(p_iWait_ms) && l_bResult;
+        }
+
+        return l_bResult;
+    }
+
+protected:
+
+    /**
+     * @struct Key
+     *
+     * @brief Position of a dispatched Data in the output order.
+     */
+    struct Key
+    {
+        Key()
+            : m_llTimestamp(0),
+              m_llSequence(0)
+        {
+            /* Empty. */
+        }
+
+        inline bool operator < (const Key& p_rOther) const
+        {
+            return (m_llTimestamp < p_rOther.m_llTimestamp ||
+                    (m_llTimestamp == p_rOther.m_llTimestamp &&
+                     m_llSequence < p_rOther.m_llSequence));
+        }
+
+        long long   m_llTimestamp; /**< Timestamp of the Data (UTC us). */
+
+        qint64      m_llSequence; /**< Dispatch order. */
+    };
+
+    /**
+     * @struct InFlight
+     *
+     * @brief Data dispatched to a replica and not answered yet.
+     */
+    struct InFlight
+    {
+        Key     m_Key; /**< Position in the output order. */
+
+        qint64  m_llDispatched_ms; /**< Dispatch time (m_Clock). */
+    };
+
+    /**
+     * @struct Result
+     *
+     * @brief Data published by a replica, waiting for its turn.
+     */
+    struct Result
+    {
+        int     m_iPortId; /**< Output port. */
+
+        DataPtr m_pData; /**< Published Data. */
+    };
+
+    /**
+     * @class OutputListener
+     *
+     * @brief Port listener that collects the Data published by a replica.
+     */
+    class OutputListener : public ModulePortListener
+    {
+    public:
+
+        OutputListener(ModuleReplicas* p_pOwner, const int p_iReplica)
+            : m_pOwner(p_pOwner),
+              m_iReplica(p_iReplica),
+              m_bClosed(false)
+        {
+            /* Empty. */
+        }
+
+        /**
+         * @brief Close detaches this listener from its owner. Waits for the
+         * notifications in progress.
+         */
+        void Close()
+        {
+            LOCK_WRITE(&m_Mutex, l_Lock);
+
+            m_bClosed = true;
+        }
+
+        virtual void PortNotified(const int p_iPortId, ModulePort* p_pPort)
+        {
+            LOCK_READ(&m_Mutex, l_Lock);
+
+            Q_UNUSED(p_pPort);
+
+            if (!m_bClosed)
+            {
+                m_pOwner->_Collect(m_iReplica, p_iPortId);
+            }
+        }
+
+    protected:
+
+        ModuleReplicas* m_pOwner; /**< Owner. */
+
+        const int   m_iReplica; /**< Index of the replica. */
+
+        QReadWriteLock  m_Mutex; /**< Protects m_bClosed. */
+
+        bool    m_bClosed; /**< True if the owner must not be notified. */
+
+    }; // end class OutputListener.
+
+    DEF_PTR(OutputListener);
+
+protected:
+
+    /**
+     * @brief _GetTimestamp reads the timestamp of a received or published
+     * Data. The default implementation supports DataFrame.
+     *
+     * @return false if the Data has no timestamp. A received Data is then
+     * ordered after the last dispatched one, and a published Data answers
+     * the oldest Data in flight of its replica.
+     */
+    virtual bool _GetTimestamp(const DataPtr& p_pData, long long& p_rllTimestamp)
+    {
+        return g_GetDataTimestamp(p_pData, p_rllTimestamp);
+    }
+
+    /**
+     * @brief _Snapshot returns the Data to be handed to a replica or buffered
+     * for a Data published by a replica: the producers reuse their output
+     * Data, and the replicas run in parallel. The default implementation is
+     * g_SnapshotData().
+     *
+     * @param[in]   p_iPortId   Input port of a Data handed to a replica, or
+     *                          output port of a Data published by a replica.
+     * @param[in]   p_pData     Data to be copied.
+     */
+    virtual DataPtr _Snapshot(const int p_iPortId, const DataPtr& p_pData)
+    {
+        Q_UNUSED(p_iPortId);
+
+        return g_SnapshotData(p_pData);
+    }
+
+    RetFlag _ThreadFunction(const int p_iPortId)
+    {
+        DataPtr     l_pData;
+
+        if (p_iPortId >= 0 && p_iPortId < GetNumPortIn())
+        {
+            while (DEQUEUE_INPUT_DATA(l_pData, p_iPortId))
+            {
+                _Dispatch(p_iPortId, l_pData);
+
+                if (!_IsInputQueued(p_iPortId))
+                {
+                    break;
+                }
+            }
+        }
+
+        {
+            QMutexLocker    l_Lock(&m_MutexOrder);
+
+            _Expire();
+            _Release();
+        }
+
+        return RET_SUCCESS;
+    }
+
+protected:
+
+    /**
+     * @brief _CloseListeners detaches the listeners from the output ports of
+     * the replicas.
+     */
+    void _CloseListeners()
+    {
+        size_t  l_sReplica;
+        int     l_iPort;
+
+        for (l_sReplica = 0; l_sReplica < m_vListeners.size(); l_sReplica++)
+        {
+            m_vListeners[l_sReplica]->Close();
+
+            for (l_iPort = 0;
+                 l_iPort < m_vReplicas[l_sReplica]->GetNumPortOut();
+                 l_iPort++)
+            {
+                m_vReplicas[l_sReplica]->GetPortOut(l_iPort)->RemoveListener(
+                            m_vListeners[l_sReplica]);
+            }
+        }
+
+        m_vListeners.clear();
+    }
+
+    /**
+     * @brief _Collect buffers a Data published by a replica and publishes the
+     * results whose turn has come. Called in the thread of the replica.
+     */
+    void _Collect(const int p_iReplica, const int p_iPortId)
+    {
+        std::deque<InFlight>&   l_rdqInFlight = m_vInFlight[p_iReplica];
+        Result                  l_Result;
+        Key                     l_Key;
+        long long               l_llTimestamp;
+        bool                    l_bTimestamp;
+
+        l_Result.m_iPortId = p_iPortId;
+        l_Result.m_pData = _Snapshot(
+                    p_iPortId,
+                    m_vReplicas[p_iReplica]->GetPortOut(p_iPortId)->GetData());
+
+        l_bTimestamp = _GetTimestamp(l_Result.m_pData, l_llTimestamp);
+
+        QMutexLocker    l_Lock(&m_MutexOrder);
+
+        /* The earlier Data of the replica have not been answered. */
+        while (l_bTimestamp &&
+               !l_rdqInFlight.empty() &&
+               l_rdqInFlight.front().m_Key.m_llTimestamp < l_llTimestamp)
+        {
+            l_rdqInFlight.pop_front();
+            m_llLost++;
+        }
+
+        if (!l_rdqInFlight.empty())
+        {
+            l_Key = l_rdqInFlight.front().m_Key;
+
+            if (p_iPortId == 0)
+            {
+                l_rdqInFlight.pop_front();
+            }
+        }
+        else
+        {
+            /* Not an answer (e.g. the Data had been considered lost): publish
+             * it after the last released one. */
+            l_Key = m_LastReleased;
+        }
+
+        m_mapResults[l_Key].push_back(l_Result);
+
+        _Release();
+    }
+
+    /**
+     * @brief _Dispatch assigns a Data received by the port 0 to a replica and
+     * feeds it, preceded by the Data held for the other ports. A Data received
+     * by another port is only held for the next work item.
+     */
+    void _Dispatch(const int p_iPortId, const DataPtr& p_pData)
+    {
+        std::vector<DataPtr>    l_vPending;
+        InFlight                l_InFlight;
+        long long               l_llTimestamp;
+        size_t                  l_sReplica;
+        size_t                  l_s;
+        bool                    l_bFound;
+
+        if (p_iPortId != 0)
+        {
+            DataPtr l_pSnapshot = _Snapshot(p_iPortId, p_pData);
+
+            QMutexLocker    l_Lock(&m_MutexOrder);
+
+            m_vPending[p_iPortId] = l_pSnapshot;
+
+            return;
+        }
+
+        {
+            QMutexLocker    l_Lock(&m_MutexOrder);
+
+            l_bFound = false;
+            l_sReplica = 0;
+
+            for (l_s = 0; l_s < m_vReplicas.size(); l_s++)
+            {
+                size_t  l_sCandidate = (m_sNext + l_s) % m_vReplicas.size();
+                int     l_iLoad = static_cast<int>(
+                            m_vInFlight[l_sCandidate].size());
+
+                if (l_iLoad >= m_iMaxInFlight)
+                {
+                    continue;
+                }
+
+                if (!l_bFound ||
+                    l_iLoad < static_cast<int>(
+                        m_vInFlight[l_sReplica].size()))
+                {
+                    l_sReplica = l_sCandidate;
+                    l_bFound = true;
+                }
+
+                if (m_Policy == DISPATCH_ROUND_ROBIN)
+                {
+                    break;
+                }
+            }
+
+            if (!l_bFound)
+            {
+                m_llDropped++;
+
+                return;
+            }
+
+            m_sNext = (l_sReplica + 1) % m_vReplicas.size();
+
+            /* A Data without a timestamp keeps its arrival order. */
+            if (!_GetTimestamp(p_pData, l_llTimestamp))
+            {
+                l_llTimestamp = m_LastDispatched.m_llTimestamp;
+            }
+
+            l_InFlight.m_Key.m_llTimestamp = l_llTimestamp;
+            l_InFlight.m_Key.m_llSequence = m_llDispatched++;
+            l_InFlight.m_llDispatched_ms = m_Clock.elapsed();
+
+            m_LastDispatched = l_InFlight.m_Key;
+
+            m_vInFlight[l_sReplica].push_back(l_InFlight);
+
+            l_vPending.swap(m_vPending);
+            m_vPending.assign(l_vPending.size(), DataPtr());
+        }
+
+        /* The Data of the other ports reach the replica before the work item
+         * (the notifications of a replica are served in order). */
+        for (l_s = 1; l_s < l_vPending.size(); l_s++)
+        {
+            if (l_vPending[l_s])
+            {
+                m_vFeeds[l_sReplica][l_s]->SetData(l_vPending[l_s]);
+                m_vFeeds[l_sReplica][l_s]->Notify();
+            }
+        }
+
+        m_vFeeds[l_sReplica][0]->SetData(_Snapshot(0, p_pData));
+        m_vFeeds[l_sReplica][0]->Notify();
+    }
+
+    /**
+     * @brief _Expire discards the Data in flight for longer than the maximum
+     * wait. Must be called with m_MutexOrder locked.
+     */
+    void _Expire()
+    {
+        qint64  l_llNow_ms;
+        size_t  l_s;
+
+        l_llNow_ms = m_Clock.elapsed();
+
+        for (l_s = 0; l_s < m_vInFlight.size(); l_s++)
+        {
+            while (!m_vInFlight[l_s].empty() &&
+                   l_llNow_ms - m_vInFlight[l_s].front().m_llDispatched_ms >
+                       m_iMaxWait_ms)
+            {
+                m_vInFlight[l_s].pop_front();
+                m_llLost++;
+            }
+        }
+    }
+
+    /**
+     * @brief _InitListeners registers a listener on each output port of the
+     * replicas.
+     */
+    void _InitListeners()
+    {
+        size_t  l_sReplica;
+        int     l_iPort;
+
+        m_vInFlight.assign(m_vReplicas.size(), std::deque<InFlight>());
+
+        for (l_sReplica = 0; l_sReplica < m_vReplicas.size(); l_sReplica++)
+        {
+            m_vListeners.push_back(OutputListenerPtr(
+                        new OutputListener(this,
+                                           static_cast<int>(l_sReplica))));
+
+            for (l_iPort = 0;
+                 l_iPort < m_vReplicas[l_sReplica]->GetNumPortOut();
+                 l_iPort++)
+            {
+                m_vReplicas[l_sReplica]->GetPortOut(l_iPort)->AddListener(
+                            m_vListeners.back(),
+                            l_iPort);
+            }
+        }
+    }
+
+    /**
+     * @brief _Release publishes, in order, the buffered results that precede
+     * every Data still in flight. Must be called with m_MutexOrder locked, so
+     * that the results are published by one thread at a time.
+     */
+    void _Release()
+    {
+        std::map<Key, std::vector<Result> >::iterator   l_it;
+        Key     l_First;
+        size_t  l_s;
+        bool    l_bInFlight;
+
+        l_bInFlight = false;
+
+        for (l_s = 0; l_s < m_vInFlight.size(); l_s++)
+        {
+            if (!m_vInFlight[l_s].empty() &&
+                (!l_bInFlight || m_vInFlight[l_s].front().m_Key < l_First))
+            {
+                l_First = m_vInFlight[l_s].front().m_Key;
+                l_bInFlight = true;
+            }
+        }
+
+        while (!m_mapResults.empty())
+        {
+            l_it = m_mapResults.begin();
+
+            if (l_bInFlight && !(l_it->first < l_First))
+            {
+                break;
+            }
+
+            for (l_s = 0; l_s < l_it->second.size(); l_s++)
+            {
+                _PortOut(l_it->second[l_s].m_iPortId)->SetData(
+                            l_it->second[l_s].m_pData);
+                _PortOut(l_it->second[l_s].m_iPortId)->Notify();
+            }
+
+            m_LastReleased = l_it->first;
+
+            m_mapResults.erase(l_it);
+        }
+    }
+
+protected:
+
+    QString     m_sType; /**< Type of the replicated Module. */
+
+    int     m_iNumReplicas; /**< Number of replicas. */
+
+    std::vector<ModulePtr>  m_vReplicas; /**< Replicas. */
+
+    std::vector<std::vector<ModulePortPtr> >    m_vFeeds; /**< Private output
+                                                           * ports that feed
+                                                           * each input port
+                                                           * of each replica. */
+
+    std::vector<OutputListenerPtr>  m_vListeners; /**< Listeners of the output
+                                                   * ports, per replica. */
+
+    mutable QMutex  m_MutexOrder; /**< Protects the dispatch and reorder
+                                   * state below. */
+
+    DispatchPolicy  m_Policy; /**< Dispatch policy. */
+
+    int     m_iMaxInFlight; /**< Maximum number of Data in flight per
+                             * replica. */
+
+    int     m_iMaxWait_ms; /**< Maximum processing time of a Data. */
+
+    size_t  m_sNext; /**< Next replica in turn. */
+
+    std::vector<std::deque<InFlight> >  m_vInFlight; /**< Data in flight, per
+                                                      * replica, in dispatch
+                                                      * order. */
+
+    std::map<Key, std::vector<Result> > m_mapResults; /**< Results waiting for
+                                                       * their turn. */
+
+    std::vector<DataPtr>    m_vPending; /**< Last Data received by each input
+                                         * port other than 0, held for the
+                                         * next work item. */
+
+    Key     m_LastDispatched; /**< Key of the last dispatched Data. */
+
+    Key     m_LastReleased; /**< Key of the last published result. */
+
+    QElapsedTimer   m_Clock; /**< Clock of the dispatch times. */
+
+    qint64  m_llDispatched; /**< Number of dispatched Data. */
+
+    qint64  m_llDropped; /**< Number of Data dropped (replicas busy). */
+
+    qint64  m_llLost; /**< Number of Data not answered in time. */
+
+}; // end class ModuleReplicas.
+
+DEF_PTR(ModuleReplicas);
+
+} // end namespace fby.
+
+#endif // MODULE_REPLICAS_H
@@ -0,0 +1,551 @@
+#ifndef MODULE_SCHEDULE_H
+#define MODULE_SCHEDULE_H
+
+/** @file ModuleSchedule.h
+ *
+ * @brief Defines the ModuleSchedule class, which runs a set of linked Modules
+ * in a static topological order.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Module.h>
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @class ModuleSchedule
+ *
+ * @brief Runs the Modules of a pipeline (the stages) in a static order,
+ * usually the topological order computed by PipelineGraph::Validate(),
+ * instead of letting each notification schedule its consumer.
+ *
+ * The links to the stages are made with Link(): a notification only marks the
+ * input port of the stage as pending and requests a pass. A pass runs on a
+ * strand of the executor and visits the stages in order, executing the thread
+ * function of each stage once per pending input port. Since the stages
+ * downstream of a stage come later in the order, the Data notified by a
+ * source flow through the whole pipeline in a single pass, always in the same
+ * order, and a notification received during a pass for a stage not yet
+ * visited does not request another pass.
+ *
+ * The stages must not have an executor, a loop time or a trigger of their
+ * own, so that their executions never overlap. The sources (the Modules that
+ * feed the stages) run as usual.
+ *
+ * Without an executor (see SetExecutor()) a pass runs in the thread of the
+ * notification that requests it, and that thread repeats the pass while
+ * other notifications request one; WaitIdle() then does not wait for it.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class ModuleSchedule
+{
+public:
+
+    ModuleSchedule()
+        : m_bPassPosted(false),
+          m_bInlinePass(false),
+          m_iCurrentStage(-1),
+          m_llPasses(0)
+    {
+        m_pStrand.reset(new PassStrand(this));
+    }
+
+    ~ModuleSchedule()
+    {
+        Close();
+    }
+
+    /**
+     * @brief AddStage appends a Module to the schedule. The stages are run in
+     * the order they are added.
+     *
+     * @return the index of the stage, or -1 if the Module is null.
+     */
+    int AddStage(ModulePtr p_pModule)
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+        Stage           l_Stage;
+
+        if (!p_pModule)
+        {
+            return -1;
+        }
+
+        l_Stage.m_pModule = p_pModule;
+        l_Stage.m_pListener.reset(new StageListener(
+                                      this,
+                                      static_cast<int>(m_vStages.size())));
+
+        m_vStages.push_back(l_Stage);
+
+        return static_cast<int>(m_vStages.size()) - 1;
+    }
+
+    /**
+     * @brief Close detaches the schedule from the linked output ports and
+     * discards the pending pass. Waits for the running pass.
+     */
+    void Close()
+    {
+        std::vector<StageListenerPtr>   l_vListeners;
+        ModuleExecutorStrandPtr         l_pStrand;
+        size_t                          l_s;
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            for (l_s = 0; l_s < m_vStages.size(); l_s++)
+            {
+                l_vListeners.push_back(m_vStages[l_s].m_pListener);
+            }
+
+            l_pStrand = m_pStrand;
+        }
+
+        /* A notification in progress locks m_Mutex: close the listeners
+         * without holding it. */
+        for (l_s = 0; l_s < l_vListeners.size(); l_s++)
+        {
+            l_vListeners[l_s]->Close();
+        }
+
+        l_pStrand->Close();
+    }
+
+    /**
+     * @return the index of the stage that runs the input Module, or -1.
+     */
+    int FindStage(ModulePtr p_pModule) const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+        size_t          l_s;
+
+        for (l_s = 0; l_s < m_vStages.size(); l_s++)
+        {
+            if (m_vStages[l_s].m_pModule == p_pModule)
+            {
+                return static_cast<int>(l_s);
+            }
+        }
+
+        return -1;
+    }
+
+    /** @return the number of passes run so far. */
+    inline qint64 GetNumPasses() const
+    {
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        return m_llPasses;
+    }
+
+    /**
+     * @brief Link links an output port of a Module to an input port of a
+     * stage of this schedule. The type of the ports is checked as by
+     * g_LinkModulesChecked().
+     *
+     * @retval  RET_SUCCESS     if the ports have been linked.
+     * @retval  RET_ERROR       if a port is not valid or the second Module is
+     *                          not a stage of this schedule.
+     */
+    RetFlag Link(ModulePtr  p_pModule1,
+                 const int  p_iOutPort1,
+                 ModulePtr  p_pModule2,
+                 const int  p_iInPort2)
+    {
+        ModulePortPtr           l_pPortOut;
+        ModulePortPtr           l_pPortIn;
+        ModulePortListenerPtr   l_pListener;
+        int                     l_iStage;
+
+        l_iStage = FindStage(p_pModule2);
+
+        if (l_iStage < 0 ||
+            g_LinkModulesChecked(p_pModule1,
+                                 p_iOutPort1,
+                                 p_pModule2,
+                                 p_iInPort2) != RET_SUCCESS)
+        {
+            return RET_ERROR;
+        }
+
+        l_pPortOut = p_pModule1->GetPortOut(p_iOutPort1);
+        l_pPortIn = p_pModule2->GetPortIn(p_iInPort2);
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            l_pListener = m_vStages[l_iStage].m_pListener;
+        }
+
+        QObject::disconnect(GET_PTR(l_pPortOut),
+                            SIGNAL(sig_Out()),
+                            GET_PTR(l_pPortIn),
+                            SLOT(slot_In()));
+
+        l_pPortOut->AddListener(l_pListener, p_iInPort2, GET_PTR(l_pPortIn));
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief ReplaceStage makes a stage run another Module, e.g. a reloaded
+     * instance of its Module (see AppConsole::ReloadModule()). The pending
+     * input ports of the stage are discarded. The links to the stage must be
+     * made again with Link().
+     *
+     * @return false if the first Module is not a stage of this schedule.
+     */
+    bool ReplaceStage(ModulePtr p_pOldModule, ModulePtr p_pNewModule)
+    {
+        int     l_iStage;
+
+        l_iStage = FindStage(p_pOldModule);
+
+        if (l_iStage < 0 || !p_pNewModule)
+        {
+            return false;
+        }
+
+        QMutexLocker    l_Lock(&m_Mutex);
+
+        m_vStages[l_iStage].m_pModule = p_pNewModule;
+        m_vStages[l_iStage].m_vPending.clear();
+
+        return true;
+    }
+
+    /**
+     * @brief SetExecutor sets the executor that runs the passes. The pending
+     * pass, if any, is discarded. A null executor runs the passes in the
+     * notifying threads (see the class description).
+     */
+    void SetExecutor(ModuleExecutorPtr p_pExecutor)
+    {
+        ModuleExecutorStrandPtr     l_pOldStrand;
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            m_pExecutor = p_pExecutor;
+
+            l_pOldStrand = m_pStrand;
+            m_pStrand.reset(new PassStrand(this));
+
+            m_bPassPosted = false;
+        }
+
+        l_pOldStrand->Close();
+    }
+
+    /**
+     * @brief Unlink removes the links made with Link() from an output port to
+     * a stage: the notifications of the port no longer reach the stage.
+     */
+    void Unlink(ModulePtr   p_pModule1,
+                const int   p_iOutPort1,
+                ModulePtr   p_pModule2)
+    {
+        ModulePortPtr           l_pPortOut;
+        ModulePortListenerPtr   l_pListener;
+        int                     l_iStage;
+
+        l_iStage = FindStage(p_pModule2);
+        l_pPortOut = p_pModule1->GetPortOut(p_iOutPort1);
+
+        if (l_iStage < 0 || !l_pPortOut)
+        {
+            return;
+        }
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            l_pListener = m_vStages[l_iStage].m_pListener;
+        }
+
+        l_pPortOut->RemoveListener(l_pListener);
+    }
+
+    /**
+     * @brief WaitIdle waits until no pass is pending or running.
+     *
+     * @param[in]   p_iWait_ms  Maximum wait (ms). If negative waits forever.
+     *
+     * @return true if the schedule is idle.
+     */
+    bool WaitIdle(const int p_iWait_ms = -1)
+    {
+        ModuleExecutorStrandPtr     l_pStrand;
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            l_pStrand = m_pStrand;
+        }
+
+        return l_pStrand->WaitIdle(p_iWait_ms);
+    }
+
+protected:
+
+    /**
+     * @class PassStrand
+     *
+     * @brief Strand that runs the passes of a ModuleSchedule.
+     */
+    class PassStrand : public ModuleExecutorStrand
+    {
+    public:
+
+        PassStrand(ModuleSchedule* p_pSchedule)
+            : m_pSchedule(p_pSchedule)
+        {
+            /* Empty. */
+        }
+
+    protected:
+
+        virtual void _Execute(const int p_iItem)
+        {
+            Q_UNUSED(p_iItem);
+
+            m_pSchedule->_RunPass();
+        }
+
+    protected:
+
+        ModuleSchedule*     m_pSchedule; /**< Owner. */
+
+    }; // end class PassStrand.
+
+    /**
+     * @class StageListener
+     *
+     * @brief Port listener that marks an input port of a stage as pending.
+     */
+    class StageListener : public ModulePortListener
+    {
+    public:
+
+        StageListener(ModuleSchedule* p_pSchedule, const int p_iStage)
+            : m_pSchedule(p_pSchedule),
+              m_iStage(p_iStage),
+              m_bClosed(false)
+        {
+            /* Empty. */
+        }
+
+        /**
+         * @brief Close detaches this listener from its schedule. Waits for
+         * the notifications in progress.
+         */
+        void Close()
+        {
+            LOCK_WRITE(&m_Mutex, l_Lock);
+
+            m_bClosed = true;
+        }
+
+        virtual void PortNotified(const int p_iPortId, ModulePort* p_pPort)
+        {
+            LOCK_READ(&m_Mutex, l_Lock);
+
+            Q_UNUSED(p_pPort);
+
+            if (!m_bClosed)
+            {
+                m_pSchedule->_Mark(m_iStage, p_iPortId);
+            }
+        }
+
+    protected:
+
+        ModuleSchedule*     m_pSchedule; /**< Owner. */
+
+        const int   m_iStage; /**< Index of the notified stage. */
+
+        QReadWriteLock  m_Mutex; /**< Protects m_bClosed. */
+
+        bool    m_bClosed; /**< True if the schedule must not be notified. */
+
+    }; // end class StageListener.
+
+    DEF_PTR(StageListener);
+
+    /**
+     * @struct Stage
+     *
+     * @brief Module run by the schedule.
+     */
+    struct Stage
+    {
+        ModulePtr   m_pModule; /**< Module. */
+
+        StageListenerPtr    m_pListener; /**< Listener of the linked ports. */
+
+        std::vector<int>    m_vPending; /**< Pending input ports. */
+    };
+
+protected:
+
+    /**
+     * @brief _Mark marks an input port of a stage as pending and posts a
+     * pass, unless one is already posted or the running pass has not visited
+     * the stage yet. Without an executor the pass is run by _RunInline().
+     */
+    void _Mark(const int p_iStage, const int p_iPortId)
+    {
+        ModuleExecutorPtr       l_pExecutor;
+        ModuleExecutorStrandPtr l_pStrand;
+
+        {
+            QMutexLocker        l_Lock(&m_Mutex);
+            std::vector<int>&   l_rvPending = m_vStages[p_iStage].m_vPending;
+
+            if (std::find(l_rvPending.begin(),
+                          l_rvPending.end(),
+                          p_iPortId) == l_rvPending.end())
+            {
+                l_rvPending.push_back(p_iPortId);
+            }
+
+            if (m_bPassPosted ||
+                (m_iCurrentStage >= 0 && p_iStage > m_iCurrentStage))
+            {
+                return;
+            }
+
+            m_bPassPosted = true;
+
+            l_pExecutor = m_pExecutor;
+            l_pStrand = m_pStrand;
+
+            /* The thread that runs the inline passes also runs this one. */
+            if (!l_pExecutor)
+            {
+                if (m_bInlinePass)
+                {
+                    return;
+                }
+
+                m_bInlinePass = true;
+            }
+        }
+
+        if (l_pExecutor)
+        {
+            l_pExecutor->Post(l_pStrand, 0);
+        }
+        else
+        {
+            _RunInline();
+        }
+    }
+
+    /**
+     * @brief _RunInline runs the passes in the calling thread until no pass is
+     * posted. Called by _Mark() when the schedule has no executor.
+     */
+    void _RunInline()
+    {
+        for (;;)
+        {
+            _RunPass();
+
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            if (!m_bPassPosted)
+            {
+                m_bInlinePass = false;
+
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief _RunPass visits the stages in order and executes each one once
+     * per pending input port.
+     */
+    void _RunPass()
+    {
+        std::vector<int>    l_vPorts;
+        ModulePtr           l_pModule;
+        size_t              l_sStage;
+        size_t              l_s;
+
+        {
+            QMutexLocker    l_Lock(&m_Mutex);
+
+            m_bPassPosted = false;
+            m_llPasses++;
+        }
+
+        for (l_sStage = 0; ; l_sStage++)
+        {
+            {
+                QMutexLocker    l_Lock(&m_Mutex);
+
+                if (l_sStage >= m_vStages.size())
+                {
+                    m_iCurrentStage = -1;
+                    break;
+                }
+
+                m_iCurrentStage = static_cast<int>(l_sStage);
+
+                l_pModule = m_vStages[l_sStage].m_pModule;
+                l_vPorts.swap(m_vStages[l_sStage].m_vPending);
+            }
+
+            for (l_s = 0; l_s < l_vPorts.size(); l_s++)
+            {
+                l_pModule->_Execute(l_vPorts[l_s]);
+            }
+
+            l_vPorts.clear();
+        }
+    }
+
+private:
+
+    /* Non-copyable. */
+    ModuleSchedule(const ModuleSchedule&);
+    ModuleSchedule& operator = (const ModuleSchedule&);
+
+protected:
+
+    mutable QMutex  m_Mutex; /**< Protects the data of this schedule. */
+
+    std::vector<Stage>  m_vStages; /**< Stages, in execution order. */
+
+    ModuleExecutorPtr   m_pExecutor; /**< Executor that runs the passes. */
+
+    ModuleExecutorStrandPtr m_pStrand; /**< Strand of the passes. */
+
+    bool    m_bPassPosted; /**< True if a pass is posted and not started. */
+
+    bool    m_bInlinePass; /**< True while a thread runs the passes inline
+                            * (no executor). */
+
+    int     m_iCurrentStage; /**< Stage visited by the running pass, or -1. */
+
+    qint64  m_llPasses; /**< Number of passes run. */
+
+}; // end class ModuleSchedule.
+
+DEF_PTR(ModuleSchedule);
+
+} // end namespace fby.
+
+#endif // MODULE_SCHEDULE_H
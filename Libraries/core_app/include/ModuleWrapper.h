@@ -14,6 +14,12 @@
 
 #define MODULE_WRAPPER_ALLOC_FUN_STRING(name)  (QString("NewWrap") + #name)
 
+#ifdef MODULE_LIBRARY_STATIC
+#define MODULE_WRAPPER_STATIC_REGISTER(name)    MODULE_WRAPPER_REGISTER(name)
+#else
+#define MODULE_WRAPPER_STATIC_REGISTER(name)
+#endif
+
 #define MODULE_WRAPPER_ALLOC_FUN_IMPL(name) \
 fby::Module* NewWrap##name(const std::string& p_rsPath, fby::ModuleExecMode p_Mode)\
 { \
@@ -27,6 +33,7 @@ fby::Module* NewWrap##name(const std::string& p_rsPath, fby::ModuleExecMode p_Mo
             l_pResult->Init(p_Mode);\
          }\
          l_pResult->InitOptions();\
+         l_pResult->InitExecution();\
       } \
       else \
       { \
@@ -35,7 +42,8 @@ fby::Module* NewWrap##name(const std::string& p_rsPath, fby::ModuleExecMode p_Mo
        } \
    }\
    return l_pResult; \
-}
+} \
+MODULE_WRAPPER_STATIC_REGISTER(name)
 
 namespace fby
 {
@@ -192,4 +200,8 @@ DEF_PTR(ModuleWrapper);
 
 } // end namespace fby.
 
+/* Declares the registration macros of the static Modules. Included last, since
+ * it needs the allocator types declared above. */
+#include <ModuleRegistry.h>
+
 #endif // MODULEDATAPROCESSING_H
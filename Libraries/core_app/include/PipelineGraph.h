@@ -0,0 +1,742 @@
+#ifndef PIPELINE_GRAPH_H
+#define PIPELINE_GRAPH_H
+
+/** @file PipelineGraph.h
+ *
+ * @brief Defines the PipelineGraph class, the declarative description of a
+ * pipeline of Modules: the Modules to be instantiated and the links between
+ * their ports.
+ *
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+
+#include <Module.h>
+#include <SettingsDefs.h>
+
+namespace fby
+{
+/******************************************************************************/
+/**
+ * @struct PipelineNode
+ *
+ * @brief Module of a PipelineGraph.
+ */
+struct PipelineNode
+{
+    PipelineNode()
+        : m_iLoopTime_ms(0),
+          m_iReplicas(1),
+          m_Priority(MODULE_PRIORITY_NORMAL),
+          m_iDeadline_ms(0),
+          m_Shed(MODULE_DEADLINE_REPORT),
+          m_bTrigger(false)
+    {
+        /* Empty. */
+    }
+
+    QString     m_sName; /**< Unique name of the Module in the pipeline. */
+
+    QString     m_sType; /**< Type of the Module (see ModuleManager::New()). */
+
+    int     m_iLoopTime_ms; /**< Period of the main timer (0: no timer). */
+
+    int     m_iReplicas; /**< Number of parallel replicas (see
+                          * ModuleReplicas), 1 for a single instance. */
+
+    ModulePriority  m_Priority; /**< Priority on the executor. */
+
+    int     m_iDeadline_ms; /**< Deadline of the executions (0: none). */
+
+    ModuleDeadlinePolicy    m_Shed; /**< Behavior when the deadline would be
+                                     * missed. */
+
+    bool    m_bTrigger; /**< True if the Module is triggered on start. */
+
+}; // end struct PipelineNode.
+
+/******************************************************************************/
+/**
+ * @struct PipelineLink
+ *
+ * @brief Link of a PipelineGraph, from an output port of a node to an input
+ * port of another one.
+ */
+struct PipelineLink
+{
+    PipelineLink()
+        : m_iOutPort(0),
+          m_iInPort(0),
+          m_bCoalesce(false)
+    {
+        /* Empty. */
+    }
+
+    QString     m_sFrom; /**< Name of the source node. */
+
+    int     m_iOutPort; /**< Output port of the source node. */
+
+    QString     m_sTo; /**< Name of the destination node. */
+
+    int     m_iInPort; /**< Input port of the destination node. */
+
+    bool    m_bCoalesce; /**< True if the notifications are coalesced (see
+                          * g_LinkModulesCoalesced()). */
+
+}; // end struct PipelineLink.
+
+/******************************************************************************/
+/**
+ * @class PipelineGraph
+ *
+ * @brief Declarative description of a pipeline, loaded from and saved to the
+ * group "Pipeline" of a QSettings object:
+ *
+ * @code
+ * [Pipeline]
+ * ModulesPath=../mod
+ * Threads=-1
+ * Scheduled=false
+ * Modules\size=3
+ * Modules\1\Name=source
+ * Modules\1\Type=modSimple
+ * Modules\1\LoopTime=40
+ * Modules\1\Trigger=false
+ * Modules\1\Priority=High
+ * Modules\2\Name=detector
+ * Modules\2\Type=modDetector
+ * Modules\2\Replicas=4
+ * Modules\2\Priority=Low
+ * Modules\2\Deadline=100
+ * Modules\2\Shed=Skip
+ * Modules\3\Name=sink
+ * Modules\3\Type=modSink
+ * Links\size=2
+ * Links\1\From=source:0
+ * Links\1\To=detector:0
+ * Links\1\Coalesce=false
+ * Links\2\From=detector:0
+ * Links\2\To=sink:0
+ * @endcode
+ *
+ * The endpoints of a link have the form "name:port"; the port defaults to 0.
+ * A node with Replicas > 1 runs that many instances of a stateless Module in
+ * parallel (see ModuleReplicas). Priority (Low, Normal, High), Deadline (ms)
+ * and Shed (Report, Skip, Decimate) set the scheduling of a node on the
+ * executor (see Module::SetPriority() and Module::SetDeadline()).
+ * Validate() checks the names and the ports and computes the topological
+ * order of the nodes (see GetSchedule()); a graph with a cycle is rejected.
+ *
+ * @callgraph
+ * @callergraph
+ * @author Andrea Bracci
+ * @version 1.0
+ * @date 2015
+ */
+class PipelineGraph
+{
+public:
+
+    PipelineGraph()
+        : m_sModulesPath("."),
+          m_iNumThreads(-1),
+          m_bScheduled(false)
+    {
+        /* Empty. */
+    }
+
+    /**
+     * @brief AddLink appends a link. The link is checked by Validate().
+     */
+    void AddLink(const PipelineLink& p_rLink)
+    {
+        m_vLinks.push_back(p_rLink);
+        m_vSchedule.clear();
+    }
+
+    /**
+     * @brief AddNode appends a node. The node is checked by Validate().
+     */
+    void AddNode(const PipelineNode& p_rNode)
+    {
+        m_vNodes.push_back(p_rNode);
+        m_vSchedule.clear();
+    }
+
+    /**
+     * @brief CheckPorts checks the links against the instantiated Modules:
+     * every output port must exist.
+     *
+     * @param[in]   p_rvModules     Modules, indexed as the nodes.
+     * @param[out]  p_rsError       Description of the first error.
+     *
+     * @return RET_ERROR if a link refers to an output port that does not
+     * exist.
+     */
+    RetFlag CheckPorts(const std::vector<ModulePtr>&    p_rvModules,
+                       QString&                         p_rsError) const
+    {
+        size_t  l_s;
+        int     l_iFrom;
+
+        for (l_s = 0; l_s < m_vLinks.size(); l_s++)
+        {
+            l_iFrom = FindNode(m_vLinks[l_s].m_sFrom);
+
+            if (l_iFrom < 0 ||
+                l_iFrom >= static_cast<int>(p_rvModules.size()) ||
+                !p_rvModules[l_iFrom] ||
+                m_vLinks[l_s].m_iOutPort >=
+                    p_rvModules[l_iFrom]->GetNumPortOut())
+            {
+                p_rsError = QString("invalid output port %1:%2")
+                                .arg(m_vLinks[l_s].m_sFrom)
+                                .arg(m_vLinks[l_s].m_iOutPort);
+
+                return RET_ERROR;
+            }
+        }
+
+        return RET_SUCCESS;
+    }
+
+    /**
+     * @brief Clear removes all the nodes and the links.
+     */
+    void Clear()
+    {
+        m_vNodes.clear();
+        m_vLinks.clear();
+        m_vSchedule.clear();
+    }
+
+    /**
+     * @return the index of the node with the input name, or -1.
+     */
+    int FindNode(const QString& p_rsName) const
+    {
+        size_t  l_s;
+
+        for (l_s = 0; l_s < m_vNodes.size(); l_s++)
+        {
+            if (m_vNodes[l_s].m_sName == p_rsName)
+            {
+                return static_cast<int>(l_s);
+            }
+        }
+
+        return -1;
+    }
+
+    /** @return the links. */
+    inline const std::vector<PipelineLink>& GetLinks() const
+    {
+        return m_vLinks;
+    }
+
+    /** @return the path of the Module libraries. */
+    inline const QString& GetModulesPath() const
+    {
+        return m_sModulesPath;
+    }
+
+    /** @return the nodes. */
+    inline const std::vector<PipelineNode>& GetNodes() const
+    {
+        return m_vNodes;
+    }
+
+    /** @return the number of executor threads, < 0 for a thread per Module. */
+    inline int GetNumThreads() const
+    {
+        return m_iNumThreads;
+    }
+
+    /**
+     * @return the indices of the nodes in topological order (every node comes
+     * after the nodes it is linked from), as computed by Validate(). Nodes
+     * that do not depend on each other keep their loading order.
+     */
+    inline const std::vector<int>& GetSchedule() const
+    {
+        return m_vSchedule;
+    }
+
+    /** @return the working directory of the Modules, or an empty string. */
+    inline const QString& GetWorkDir() const
+    {
+        return m_sWorkDir;
+    }
+
+    /**
+     * @return true if the linked Modules must run in the static order of
+     * GetSchedule() (see ModuleSchedule).
+     */
+    inline bool IsScheduled() const
+    {
+        return m_bScheduled;
+    }
+
+    /**
+     * @brief LoadConfig loads the graph from the group "Pipeline" of the
+     * input settings, replacing the current one.
+     *
+     * @return RET_ERROR if a link endpoint cannot be parsed. The graph must
+     * then be checked with Validate().
+     */
+    RetFlag LoadConfig(QSettings& p_rSettings)
+    {
+        PipelineNode    l_Node;
+        PipelineLink    l_Link;
+        RetFlag         l_Result;
+        int             l_iSize;
+        int             l_i;
+
+        Clear();
+
+        l_Result = RET_SUCCESS;
+
+        p_rSettings.beginGroup(SETTING_GROUP_PIPELINE);
+
+        m_sModulesPath = p_rSettings.value(SETTING_KEY_MODULES_PATH,
+                                           QString(".")).toString();
+        m_iNumThreads = p_rSettings.value(SETTING_KEY_THREADS, -1).toInt();
+        m_bScheduled = p_rSettings.value(SETTING_KEY_SCHEDULED,
+                                         false).toBool();
+        m_sWorkDir = p_rSettings.value(SETTING_KEY_WORK_DIR,
+                                       QString()).toString();
+
+        l_iSize = p_rSettings.beginReadArray(SETTING_GROUP_MODULES);
+
+        for (l_i = 0; l_i < l_iSize; l_i++)
+        {
+            p_rSettings.setArrayIndex(l_i);
+
+            l_Node.m_sType = p_rSettings.value(SETTING_KEY_TYPE).toString();
+            l_Node.m_sName = p_rSettings.value(SETTING_KEY_NAME,
+                                               l_Node.m_sType).toString();
+            l_Node.m_iLoopTime_ms = p_rSettings.value(SETTING_KEY_LOOP_TIME,
+                                                      0).toInt();
+            l_Node.m_bTrigger = p_rSettings.value(SETTING_KEY_TRIGGER,
+                                                  false).toBool();
+            l_Node.m_iReplicas = std::max(
+                        p_rSettings.value(SETTING_KEY_REPLICAS, 1).toInt(), 1);
+            l_Node.m_Priority = static_cast<ModulePriority>(
+                        _ParseName(p_rSettings.value(SETTING_KEY_PRIORITY)
+                                        .toString(),
+                                   _PriorityName,
+                                   MODULE_PRIORITY_NUM,
+                                   MODULE_PRIORITY_NORMAL));
+            l_Node.m_iDeadline_ms = std::max(
+                        p_rSettings.value(SETTING_KEY_DEADLINE, 0).toInt(), 0);
+            l_Node.m_Shed = static_cast<ModuleDeadlinePolicy>(
+                        _ParseName(p_rSettings.value(SETTING_KEY_SHED)
+                                        .toString(),
+                                   _ShedName,
+                                   MODULE_DEADLINE_DECIMATE + 1,
+                                   MODULE_DEADLINE_REPORT));
+
+            m_vNodes.push_back(l_Node);
+        }
+
+        p_rSettings.endArray();
+
+        l_iSize = p_rSettings.beginReadArray(SETTING_GROUP_LINKS);
+
+        for (l_i = 0; l_i < l_iSize; l_i++)
+        {
+            p_rSettings.setArrayIndex(l_i);
+
+            if (!_ParseEndpoint(p_rSettings.value(SETTING_KEY_FROM).toString(),
+                                l_Link.m_sFrom,
+                                l_Link.m_iOutPort) ||
+                !_ParseEndpoint(p_rSettings.value(SETTING_KEY_TO).toString(),
+                                l_Link.m_sTo,
+                                l_Link.m_iInPort))
+            {
+                qWarning() << "PipelineGraph: invalid link"
+                           << p_rSettings.value(SETTING_KEY_FROM).toString()
+                           << "->"
+                           << p_rSettings.value(SETTING_KEY_TO).toString();
+
+                l_Result = RET_ERROR;
+                continue;
+            }
+
+            l_Link.m_bCoalesce = p_rSettings.value(SETTING_KEY_COALESCE,
+                                                   false).toBool();
+
+            m_vLinks.push_back(l_Link);
+        }
+
+        p_rSettings.endArray();
+
+        p_rSettings.endGroup();
+
+        return l_Result;
+    }
+
+    /**
+     * @brief SaveConfig saves the graph to the group "Pipeline" of the input
+     * settings.
+     */
+    void SaveConfig(QSettings& p_rSettings) const
+    {
+        size_t  l_s;
+
+        p_rSettings.beginGroup(SETTING_GROUP_PIPELINE);
+
+        p_rSettings.setValue(SETTING_KEY_MODULES_PATH, m_sModulesPath);
+        p_rSettings.setValue(SETTING_KEY_THREADS, m_iNumThreads);
+        p_rSettings.setValue(SETTING_KEY_SCHEDULED, m_bScheduled);
+
+        if (!m_sWorkDir.isEmpty())
+        {
+            p_rSettings.setValue(SETTING_KEY_WORK_DIR, m_sWorkDir);
+        }
+
+        p_rSettings.beginWriteArray(SETTING_GROUP_MODULES,
+                                    static_cast<int>(m_vNodes.size()));
+
+        for (l_s = 0; l_s < m_vNodes.size(); l_s++)
+        {
+            p_rSettings.setArrayIndex(static_cast<int>(l_s));
+
+            p_rSettings.setValue(SETTING_KEY_NAME, m_vNodes[l_s].m_sName);
+            p_rSettings.setValue(SETTING_KEY_TYPE, m_vNodes[l_s].m_sType);
+            p_rSettings.setValue(SETTING_KEY_LOOP_TIME,
+                                 m_vNodes[l_s].m_iLoopTime_ms);
+            p_rSettings.setValue(SETTING_KEY_TRIGGER,
+                                 m_vNodes[l_s].m_bTrigger);
+
+            if (m_vNodes[l_s].m_iReplicas > 1)
+            {
+                p_rSettings.setValue(SETTING_KEY_REPLICAS,
+                                     m_vNodes[l_s].m_iReplicas);
+            }
+
+            p_rSettings.setValue(SETTING_KEY_PRIORITY,
+                                 QString(_PriorityName(
+                                             m_vNodes[l_s].m_Priority)));
+
+            if (m_vNodes[l_s].m_iDeadline_ms > 0)
+            {
+                p_rSettings.setValue(SETTING_KEY_DEADLINE,
+                                     m_vNodes[l_s].m_iDeadline_ms);
+                p_rSettings.setValue(SETTING_KEY_SHED,
+                                     QString(_ShedName(m_vNodes[l_s].m_Shed)));
+            }
+        }
+
+        p_rSettings.endArray();
+
+        p_rSettings.beginWriteArray(SETTING_GROUP_LINKS,
+                                    static_cast<int>(m_vLinks.size()));
+
+        for (l_s = 0; l_s < m_vLinks.size(); l_s++)
+        {
+            p_rSettings.setArrayIndex(static_cast<int>(l_s));
+
+            p_rSettings.setValue(SETTING_KEY_FROM,
+                                 QString("%1:%2")
+                                    .arg(m_vLinks[l_s].m_sFrom)
+                                    .arg(m_vLinks[l_s].m_iOutPort));
+            p_rSettings.setValue(SETTING_KEY_TO,
+                                 QString("%1:%2")
+                                    .arg(m_vLinks[l_s].m_sTo)
+                                    .arg(m_vLinks[l_s].m_iInPort));
+            p_rSettings.setValue(SETTING_KEY_COALESCE,
+                                 m_vLinks[l_s].m_bCoalesce);
+        }
+
+        p_rSettings.endArray();
+
+        p_rSettings.endGroup();
+    }
+
+    /** @brief SetModulesPath sets the path of the Module libraries. */
+    inline void SetModulesPath(const QString& p_rsPath)
+    {
+        m_sModulesPath = p_rsPath;
+    }
+
+    /** @brief SetNumThreads sets the number of executor threads. */
+    inline void SetNumThreads(const int p_iNumThreads)
+    {
+        m_iNumThreads = p_iNumThreads;
+    }
+
+    /** @brief SetScheduled enables the static schedule (see IsScheduled()). */
+    inline void SetScheduled(const bool p_bScheduled)
+    {
+        m_bScheduled = p_bScheduled;
+    }
+
+    /** @brief SetWorkDir sets the working directory of the Modules. */
+    inline void SetWorkDir(const QString& p_rsPath)
+    {
+        m_sWorkDir = p_rsPath;
+    }
+
+    /**
+     * @brief Validate checks the graph and computes its topological order:
+     * the node names must be unique and not empty, every node must have a
+     * type, every link must join two existing nodes with non-negative ports,
+     * an input port can be linked only once and the graph must be acyclic.
+     * If the list of the known types is not empty, the type of every node
+     * must be in it, so that an unknown Module is reported before any Module
+     * is instantiated.
+     *
+     * @param[out]  p_rsError   Description of the first error.
+     * @param[in]   p_rlTypes   Known Module types, or an empty list to accept
+     *                          any type.
+     *
+     * @return RET_ERROR if the graph is not valid.
+     */
+    RetFlag Validate(QString&           p_rsError,
+                     const QStringList& p_rlTypes = QStringList())
+    {
+        std::vector<std::vector<int> >  l_vvNext;
+        std::vector<int>                l_vInDegree;
+        std::vector<int>                l_vReady;
+        QSet<QString>                   l_setNames;
+        QSet<QString>                   l_setInputs;
+        QString                         l_sInput;
+        QStringList                     l_lCycle;
+        size_t                          l_s;
+        int                             l_iFrom;
+        int                             l_iTo;
+        int                             l_iNode;
+
+        m_vSchedule.clear();
+
+        for (l_s = 0; l_s < m_vNodes.size(); l_s++)
+        {
+            if (m_vNodes[l_s].m_sName.isEmpty() ||
+                m_vNodes[l_s].m_sType.isEmpty())
+            {
+                p_rsError = QString("module %1 has no name or type")
+                                .arg(static_cast<int>(l_s) + 1);
+
+                return RET_ERROR;
+            }
+
+            if (!p_rlTypes.isEmpty() &&
+                !p_rlTypes.contains(m_vNodes[l_s].m_sType))
+            {
+                p_rsError = QString("unknown type %1 of module %2")
+                                .arg(m_vNodes[l_s].m_sType)
+                                .arg(m_vNodes[l_s].m_sName);
+
+                return RET_ERROR;
+            }
+
+            if (l_setNames.contains(m_vNodes[l_s].m_sName))
+            {
+                p_rsError = QString("duplicated module %1")
+                                .arg(m_vNodes[l_s].m_sName);
+
+                return RET_ERROR;
+            }
+
+            l_setNames.insert(m_vNodes[l_s].m_sName);
+        }
+
+        l_vvNext.resize(m_vNodes.size());
+        l_vInDegree.resize(m_vNodes.size(), 0);
+
+        for (l_s = 0; l_s < m_vLinks.size(); l_s++)
+        {
+            l_iFrom = FindNode(m_vLinks[l_s].m_sFrom);
+            l_iTo = FindNode(m_vLinks[l_s].m_sTo);
+
+            if (l_iFrom < 0 || l_iTo < 0 ||
+                m_vLinks[l_s].m_iOutPort < 0 || m_vLinks[l_s].m_iInPort < 0)
+            {
+                p_rsError = QString("invalid link %1:%2 -> %3:%4")
+                                .arg(m_vLinks[l_s].m_sFrom)
+                                .arg(m_vLinks[l_s].m_iOutPort)
+                                .arg(m_vLinks[l_s].m_sTo)
+                                .arg(m_vLinks[l_s].m_iInPort);
+
+                return RET_ERROR;
+            }
+
+            l_sInput = QString("%1:%2").arg(m_vLinks[l_s].m_sTo)
+                                       .arg(m_vLinks[l_s].m_iInPort);
+
+            if (l_setInputs.contains(l_sInput))
+            {
+                p_rsError = QString("input port %1 linked twice")
+                                .arg(l_sInput);
+
+                return RET_ERROR;
+            }
+
+            l_setInputs.insert(l_sInput);
+
+            l_vvNext[l_iFrom].push_back(l_iTo);
+            l_vInDegree[l_iTo]++;
+        }
+
+        /* Kahn's algorithm. The ready nodes are kept sorted, so that the
+         * independent nodes keep their loading order. */
+        for (l_s = 0; l_s < m_vNodes.size(); l_s++)
+        {
+            if (l_vInDegree[l_s] == 0)
+            {
+                l_vReady.push_back(static_cast<int>(l_s));
+            }
+        }
+
+        while (!l_vReady.empty())
+        {
+            l_iNode = l_vReady.front();
+            l_vReady.erase(l_vReady.begin());
+
+            m_vSchedule.push_back(l_iNode);
+
+            for (l_s = 0; l_s < l_vvNext[l_iNode].size(); l_s++)
+            {
+                l_iTo = l_vvNext[l_iNode][l_s];
+
+                if (--l_vInDegree[l_iTo] == 0)
+                {
+                    l_vReady.insert(std::lower_bound(l_vReady.begin(),
+                                                     l_vReady.end(),
+                                                     l_iTo),
+                                    l_iTo);
+                }
+            }
+        }
+
+        if (m_vSchedule.size() != m_vNodes.size())
+        {
+            for (l_s = 0; l_s < m_vNodes.size(); l_s++)
+            {
+                if (l_vInDegree[l_s] > 0)
+                {
+                    l_lCycle << m_vNodes[l_s].m_sName;
+                }
+            }
+
+            p_rsError = QString("cycle through %1").arg(l_lCycle.join(", "));
+
+            m_vSchedule.clear();
+
+            return RET_ERROR;
+        }
+
+        return RET_SUCCESS;
+    }
+
+protected:
+
+    /**
+     * @brief _ParseEndpoint splits a link endpoint of the form "name:port".
+     * The port defaults to 0 if it is omitted.
+     *
+     * @return false if the port is not a valid number.
+     */
+    static bool _ParseEndpoint(const QString&   p_rsEndpoint,
+                               QString&         p_rsName,
+                               int&             p_riPort)
+    {
+        int     l_iSep;
+        bool    l_bOk;
+
+        l_iSep = p_rsEndpoint.lastIndexOf(':');
+
+        if (l_iSep < 0)
+        {
+            p_rsName = p_rsEndpoint.trimmed();
+            p_riPort = 0;
+
+            return !p_rsName.isEmpty();
+        }
+
+        p_rsName = p_rsEndpoint.left(l_iSep).trimmed();
+        p_riPort = p_rsEndpoint.mid(l_iSep + 1).trimmed().toInt(&l_bOk);
+
+        return l_bOk && !p_rsName.isEmpty();
+    }
+
+    /**
+     * @brief _ParseName converts a name into the value of an enum.
+     *
+     * @param[in]   p_rsName        Name to be converted.
+     * @param[in]   p_pfName        Returns the name of each value.
+     * @param[in]   p_iNumValues    Number of values of the enum.
+     * @param[in]   p_iDefault      Value returned for an empty or unknown
+     *                              name.
+     */
+    static int _ParseName(const QString&    p_rsName,
+                          const char*       (*p_pfName)(const int),
+                          const int         p_iNumValues,
+                          const int         p_iDefault)
+    {
+        int     l_i;
+
+        if (p_rsName.isEmpty())
+        {
+            return p_iDefault;
+        }
+
+        for (l_i = 0; l_i < p_iNumValues; l_i++)
+        {
+            if (p_rsName.trimmed() == QString(p_pfName(l_i)))
+            {
+                return l_i;
+            }
+        }
+
+        qWarning() << "PipelineGraph: unknown value" << p_rsName;
+
+        return p_iDefault;
+    }
+
+    /** @return the name of a ModulePriority value. */
+    static const char* _PriorityName(const int p_iPriority)
+    {
+        switch (p_iPriority)
+        {
+        case MODULE_PRIORITY_LOW:   return "Low";
+        case MODULE_PRIORITY_HIGH:  return "High";
+        default:                    return "Normal";
+        }
+    }
+
+    /** @return the name of a ModuleDeadlinePolicy value. */
+    static const char* _ShedName(const int p_iPolicy)
+    {
+        switch (p_iPolicy)
+        {
+        case MODULE_DEADLINE_SKIP:      return "Skip";
+        case MODULE_DEADLINE_DECIMATE:  return "Decimate";
+        default:                        return "Report";
+        }
+    }
+
+protected:
+
+    std::vector<PipelineNode>   m_vNodes; /**< Nodes, in loading order. */
+
+    std::vector<PipelineLink>   m_vLinks; /**< Links. */
+
+    std::vector<int>    m_vSchedule; /**< Topological order of the nodes. */
+
+    QString     m_sModulesPath; /**< Path of the Module libraries. */
+
+    QString     m_sWorkDir; /**< Working directory of the Modules. */
+
+    int     m_iNumThreads; /**< Number of executor threads, < 0 to run each
+                            * Module in its own thread. */
+
+    bool    m_bScheduled; /**< True to run the static schedule. */
+
+}; // end class PipelineGraph.
+
+} // end namespace fby.
+
+#endif // PIPELINE_GRAPH_H
@@ -25,7 +25,9 @@
 #define SETTING_KEY_CENTER_LATITUDE                 QString("CenterLatitude")
 #define SETTING_KEY_CENTER_LONGITUDE                QString("CenterLongitude")
 #define SETTING_KEY_CHARACTER_SIZE                  QString("CharacterSize")
+#define SETTING_KEY_COALESCE                        QString("Coalesce")
 #define SETTING_KEY_COL_STRETCH                     QString("ColStretch")
+#define SETTING_KEY_DEADLINE                        QString("Deadline")
 #define SETTING_KEY_DECIMATION_VALUE                QString("DecimationValue")
 #define SETTING_KEY_DELTA_TIME                      QString("DeltaTime")
 #define SETTING_KEY_DTED_LEVEL                      QString("DTEDLevel")
@@ -33,9 +35,11 @@
 #define SETTING_KEY_ELEVATION_LAYERS                QString("ElevationLayers")
 #define SETTING_KEY_ELEVATION_LAYERS_NUM            QString("ElevationLayersNum")
 #define SETTING_KEY_ENABLED                         QString("Enabled")
+#define SETTING_KEY_FILE                            QString("File")
 #define SETTING_KEY_FLOATING                        QString("Floating")
 #define SETTING_KEY_FOOTPRINT_COLOR                 QString("FootprintColor")
 #define SETTING_KEY_FRAMED                          QString("Framed")
+#define SETTING_KEY_FROM                            QString("From")
 #define SETTING_KEY_GEOMETRY                        QString("Geometry")
 #define SETTING_KEY_HEADING                         QString("Heading")
 #define SETTING_KEY_ICON_FILE                       QString("IconFile")
@@ -50,8 +54,13 @@
 #define SETTING_KEY_LONGITUDE                       QString("Longitude")
 #define SETTING_KEY_LONGITUDE_MAX                   QString("LongitudeMax")
 #define SETTING_KEY_LONGITUDE_MIN                   QString("LongitudeMin")
+#define SETTING_KEY_LOOP_TIME                       QString("LoopTime")
 #define SETTING_KEY_MAX_BANK_ANGLE                  QString("MaxBankAngle")
+#define SETTING_KEY_MODE                            QString("Mode")
+#define SETTING_KEY_MODIFIED                        QString("Modified")
+#define SETTING_KEY_MODULE                          QString("Module")
 #define SETTING_KEY_MODULES_PATH                    QString("ModulesPath")
+#define SETTING_KEY_NAME                            QString("Name")
 #define SETTING_KEY_NORTH                           QString("North")
 #define SETTING_KEY_OFFSET_X                        QString("OffsetX")
 #define SETTING_KEY_OFFSET_Y                        QString("OffsetY")
@@ -63,7 +72,9 @@
 #define SETTING_KEY_PATH_COLORS                     QString("PathColors")
 #define SETTING_KEY_PITCH                           QString("Pitch")
 #define SETTING_KEY_POINT_SIZE                      QString("PointSize")
+#define SETTING_KEY_PRIORITY                        QString("Priority")
 #define SETTING_KEY_RANGE                           QString("Range")
+#define SETTING_KEY_REPLICAS                        QString("Replicas")
 #define SETTING_KEY_ROAD_DISTANCE_THR               QString("RoadDistanceThr")
 #define SETTING_KEY_ROAD_FILES                      QString("RoadFiles")
 #define SETTING_KEY_ROAD_FILES_NUM                  QString("RoadFilesNum")
@@ -71,16 +82,24 @@
 #define SETTING_KEY_ROLL                            QString("Roll")
 #define SETTING_KEY_SCALE                           QString("Scale")
 #define SETTING_KEY_SCALE_TO_SCREEN                 QString("ScaleToScreen")
+#define SETTING_KEY_SCHEDULED                       QString("Scheduled")
 #define SETTING_KEY_SENSOR                          QString("Sensor")
 #define SETTING_KEY_SERIAL_PORT                     QString("SerialPort")
+#define SETTING_KEY_SHED                            QString("Shed")
 #define SETTING_KEY_SIDE                            QString("Side")
 #define SETTING_KEY_SIZE                            QString("Size")
 #define SETTING_KEY_SOUTH                           QString("South")
 #define SETTING_KEY_STATE                           QString("State")
 #define SETTING_KEY_THRESHOLD                       QString("Threshold")
+#define SETTING_KEY_THREADS                         QString("Threads")
 #define SETTING_KEY_TIME_DECIMATION                 QString("TimeDecimation")
 #define SETTING_KEY_TITLE                           QString("Title")
+#define SETTING_KEY_TO                              QString("To")
+#define SETTING_KEY_TRIGGER                         QString("Trigger")
+#define SETTING_KEY_TYPE                            QString("Type")
+#define SETTING_KEY_VALID                           QString("Valid")
 #define SETTING_KEY_VEHICLE                         QString("Vehicle")
+#define SETTING_KEY_VERSION                         QString("Version")
 #define SETTING_KEY_VISIBLE                         QString("Visible")
 #define SETTING_KEY_WEIGHT                          QString("Weight")
 #define SETTING_KEY_WEST                            QString("West")
@@ -90,9 +109,13 @@
 
 
 /* QSettings groups common keys. **********************************************/
+#define SETTING_GROUP_LIBRARIES     QString("Libraries")
+#define SETTING_GROUP_LINKS         QString("Links")
 #define SETTING_GROUP_MAINWINDOW    QString("MainWindow")
+#define SETTING_GROUP_MANIFEST      QString("Manifest")
 #define SETTING_GROUP_MENU          QString("Menu")
 #define SETTING_GROUP_MODULES       QString("Modules")
+#define SETTING_GROUP_PIPELINE      QString("Pipeline")
 #define SETTING_GROUP_TOOLBAR       QString("ToolBar")
 #define SETTING_GROUP_STATUSBAR     QString("StatusBar")
 #define SETTING_GROUP_VIEWPOINT     QString("Viewpoint")
@@ -136,7 +136,108 @@ typedef QMap<QString, QVariant>     Options;
 /* Threads ********************************************************************/
 
 #define CURRENT_THREAD_IS_MAIN \
-    (QThread::currentThread() == QApplication::instance()->thread())
+    (QThread::currentThread() == QCoreApplication::instance()->thread())
+
+
+/* Attached objects ***********************************************************/
+
+/**
+ * @brief g_GetAttachedLock returns the lock that protects the children lists
+ * of the owners of attached objects: g_FindAttached() read-locks it, while
+ * g_Attach() write-locks it to add a child, so that a lookup never reads a
+ * children list being modified by another thread.
+ */
+inline QReadWriteLock* g_GetAttachedLock()
+{
+    static QReadWriteLock   s_Lock;
+
+    return &s_Lock;
+}
+
+/**
+ * @brief g_ScanAttached scans the children of a QObject, starting from the
+ * last one, for an object of type _Attached.
+ *
+ * @warning g_GetAttachedLock() must be locked by the caller.
+ */
+template <typename _Attached>
+_Attached*  g_ScanAttached(const QObject* p_pOwner)
+{
+    _Attached*  l_pResult;
+    int         l_i;
+
+    const QObjectList&  l_rlChildren = p_pOwner->children();
+
+    for (l_i = l_rlChildren.size() - 1; l_i >= 0; l_i--)
+    {
+        l_pResult = dynamic_cast<_Attached*>(l_rlChildren[l_i]);
+
+        if (l_pResult)
+        {
+            return l_pResult;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief g_FindAttached returns the object of type _Attached that has been
+ * attached to a QObject by g_Attach(), or NULL.
+ */
+template <typename _Attached>
+_Attached*  g_FindAttached(const QObject* p_pOwner)
+{
+    LOCK_READ(g_GetAttachedLock(), l_Lock);
+
+    return g_ScanAttached<_Attached>(p_pOwner);
+}
+
+/**
+ * @brief g_Attach returns the object of type _Attached attached to a QObject,
+ * creating it if needed. The attached object is built as _Attached(p_pOwner)
+ * and becomes a child of its owner: it is destroyed by ~QObject(), after the
+ * destructor of the owner class, and it follows the owner when the owner is
+ * moved to another thread. This gives the classes exported by the core_app
+ * library a place for the state of their inline methods, without changing
+ * their layout.
+ *
+ * @note An object attached from a thread other than the thread of its owner
+ * is moved to that thread before being parented, so that Qt accepts it, and
+ * the ChildAdded event is delivered to the owner from the calling thread: the
+ * classes that use attached objects create them when they are built (see
+ * MODULE_ALLOC_FUN_IMPL) whenever they can.
+ */
+template <typename _Attached, typename _Owner>
+_Attached*  g_Attach(_Owner* p_pOwner)
+{
+    _Attached*  l_pResult;
+
+    l_pResult = g_FindAttached<_Attached>(p_pOwner);
+
+    if (l_pResult)
+    {
+        return l_pResult;
+    }
+
+    LOCK_WRITE(g_GetAttachedLock(), l_Lock);
+
+    l_pResult = g_ScanAttached<_Attached>(p_pOwner);
+
+    if (!l_pResult)
+    {
+        l_pResult = new _Attached(p_pOwner);
+
+        if (l_pResult->thread() != p_pOwner->thread())
+        {
+            l_pResult->moveToThread(p_pOwner->thread());
+        }
+
+        l_pResult->setParent(p_pOwner);
+    }
+
+    return l_pResult;
+}
 
 /******************************************************************************/
 /**
@@ -3,13 +3,39 @@
 #include <osg/CoordinateSystemNode>
 #include <osg/PositionAttitudeTransform>
 
+/* Property keys set on every execution, hashed once. */
+static const DataPropertyKey   s_KeyCenterLatitude(
+        SETTING_KEY_CENTER_LATITUDE);
+static const DataPropertyKey   s_KeyCenterLongitude(
+        SETTING_KEY_CENTER_LONGITUDE);
+static const DataPropertyKey   s_KeyCenterAltitude(
+        SETTING_KEY_CENTER_ALTITUDE);
+
+void LoadNodeJob::_Run()
+{
+    m_pNode = osgDB::readRefNodeFile(m_sFileName);
+}
+
 modSimple::modSimple(ModuleExecMode p_Mode)
     : Module(p_Mode),
-      m_pMyRender(new DataGISSimple)
+      m_pMyRender(new DataGISSimple),
+      m_Async(this)
 {
     /* Empty. */
 }
 
+modSimple::~modSimple()
+{
+    _CloseExecution();
+}
+
+bool modSimple::Close()
+{
+    m_Async.Close();
+
+    return Module::Close();
+}
+
 RetFlag modSimple::Init(ModuleExecMode p_Mode)
 {
     RetFlag    l_Result;
@@ -24,10 +50,9 @@ RetFlag modSimple::Init(ModuleExecMode p_Mode)
     return l_Result;
 }
 
-bool modSimple::_CreateRootNode()
+bool modSimple::_CreateRootNode(osg::ref_ptr<osg::Node> p_pNode)
 {
     osg::ref_ptr<osg::PositionAttitudeTransform>    l_pTransf;
-    osg::ref_ptr<osg::Node>                         l_pNode;
     osg::EllipsoidModel                             l_Ell;
     osg::Vec3d                                      l_vCenter;
     osg::Quat                                       l_qAttitude;
@@ -56,11 +81,9 @@ bool modSimple::_CreateRootNode()
 
                 m_pMyRender->m_pRoot = l_pTransf;
 
-                l_pNode = osgDB::readRefNodeFile("c:/Flyby/Data/3dModels/cessna.osg");
-
-                if (l_pNode)
+                if (p_pNode)
                 {
-                    m_pMyRender->m_pRoot->addChild(l_pNode);
+                    m_pMyRender->m_pRoot->addChild(p_pNode);
 
                     l_bNotify = true;
                 }
@@ -100,13 +123,13 @@ bool modSimple::_CreateRootNode()
 
         m_pMyRender->SetId("MyRender Id");
 
-        m_pMyRender->AddProperty(SETTING_KEY_CENTER_LATITUDE.toStdString(),
+        m_pMyRender->AddProperty(s_KeyCenterLatitude,
                                  l_dLatitude_deg);
 
-        m_pMyRender->AddProperty(SETTING_KEY_CENTER_LONGITUDE.toStdString(),
+        m_pMyRender->AddProperty(s_KeyCenterLongitude,
                                  l_dLongitude_deg);
 
-        m_pMyRender->AddProperty(SETTING_KEY_CENTER_ALTITUDE.toStdString(),
+        m_pMyRender->AddProperty(s_KeyCenterAltitude,
                                  l_dAltitude_m);
     }
 
@@ -115,18 +138,40 @@ bool modSimple::_CreateRootNode()
 
 RetFlag modSimple::_ThreadFunction(const int p_iPortId)
 {
-    RetFlag     l_Result;
-    bool        l_bNotify;
+    ModuleAsyncJobPtr   l_pJob;
+    RetFlag             l_Result;
+    bool                l_bNotify;
 
     l_Result = RET_SUCCESS;
     l_bNotify = false;
 
     switch (p_iPortId)
     {
+    case ASYNC_EVENT_PORT_ID:
+        while (m_Async.TakeCompleted(l_pJob))
+        {
+            l_bNotify = _CreateRootNode(
+                        STATIC_PTR_CAST<LoadNodeJob>(l_pJob)->m_pNode);
+
+            /* Retry on the next execution if the model was not loaded. */
+            if (!l_bNotify)
+            {
+                m_pLoad.reset();
+            }
+        }
+        break;
+
     case TIMER_EVENT_PORT_ID:
     case TRIGGERED_EVENT_PORT_ID:
     default:
-        l_bNotify = _CreateRootNode();
+        /* Read the model outside of the locks and of this thread. */
+        if (!m_pLoad)
+        {
+            m_pLoad.reset(new LoadNodeJob(
+                              "c:/Flyby/Data/3dModels/cessna.osg"));
+
+            m_Async.Start(m_pLoad);
+        }
         break;
     } // end switch.
 
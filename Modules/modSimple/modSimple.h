@@ -5,6 +5,7 @@
 #include <core_app>
 
 #include <osg/Group>
+#include <osg/Node>
 
 #define MODSIMPLE_EXPORT   __declspec(dllexport)
 
@@ -20,6 +21,28 @@ public:
 
 DEF_PTR(DataGISSimple);
 
+class LoadNodeJob : public ModuleAsyncJob
+{
+public:
+
+    LoadNodeJob(const std::string& p_sFileName)
+        : m_sFileName(p_sFileName)
+    {
+        /* Empty. */
+    }
+
+    const std::string           m_sFileName;
+
+    osg::ref_ptr<osg::Node>     m_pNode;
+
+protected:
+
+    void _Run();
+
+}; // end class LoadNodeJob.
+
+DEF_PTR(LoadNodeJob);
+
 class modSimple : public Module
 {
     Q_OBJECT
@@ -27,17 +50,25 @@ class modSimple : public Module
 public:
     modSimple(ModuleExecMode p_Mode);
 
+    ~modSimple();
+
+    bool Close();
+
     RetFlag Init(ModuleExecMode p_Mode);
 
 protected:
 
-    bool _CreateRootNode();
+    bool _CreateRootNode(osg::ref_ptr<osg::Node> p_pNode);
 
     RetFlag _ThreadFunction(const int p_iPortId);
 
 protected:
 
     DataGISSimplePtr    m_pMyRender;
+
+    ModuleAsync         m_Async;
+
+    LoadNodeJobPtr      m_pLoad;
 };
 
 MODULE_ALLOC_FUN_DEC(modSimple, MODSIMPLE_EXPORT)
@@ -0,0 +1,55 @@
+#include "testMetadata.h"
+#include <QCoreApplication>
+
+/*
+ * Usage: testMetadata
+ *
+ * Runs the checks of the metadata codecs and prints one line per check. The
+ * exit code is the number of failed checks.
+ */
+
+#define TEST_ARRAY_SIZE(a)      (sizeof(a) / sizeof(a[0]))
+
+static const struct
+{
+    const char*     m_pcName;
+    QString         (*m_pfnTest)();
+} g_aTests[] =
+{
+    { "klv_example", g_TestKlvExample },
+    { "klv_round_trip", g_TestKlvRoundTrip },
+    { "log_round_trip", g_TestLogRoundTrip }
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication    a(argc, argv);
+    QString             l_sError;
+    size_t              l_s;
+    int                 l_iNumFailed;
+
+    l_iNumFailed = 0;
+
+    for (l_s = 0; l_s < TEST_ARRAY_SIZE(g_aTests); l_s++)
+    {
+        l_sError = g_aTests[l_s].m_pfnTest();
+
+        if (l_sError.isEmpty())
+        {
+            fprintf(stdout, "%s: ok\n", g_aTests[l_s].m_pcName);
+        }
+        else
+        {
+            fprintf(stdout,
+                    "%s: FAILED (%s)\n",
+                    g_aTests[l_s].m_pcName,
+                    l_sError.toLocal8Bit().constData());
+
+            l_iNumFailed++;
+        }
+    }
+
+    fflush(stdout);
+
+    return l_iNumFailed;
+}
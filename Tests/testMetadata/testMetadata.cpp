@@ -0,0 +1,643 @@
+#include "testMetadata.h"
+
+/** Size of the chunks of the stream pushed to the decoder (bytes). */
+#define TEST_METADATA_CHUNK_SIZE    7
+
+/** Number of records of the track encoded by the KLV round trip. */
+#define TEST_METADATA_TRACK_SIZE    64
+
+/** Packets between two complete packets in the KLV round trip. */
+#define TEST_METADATA_KEY_INTERVAL  16
+
+/** Number of records written by each session of the log round trip. */
+static const size_t g_asLogSessions[] = { 5000, 3000, 2240 };
+
+/******************************************************************************/
+static bool _Expect(QString&        p_rsError,
+                    const bool      p_bCondition,
+                    const char*     p_pcWhat)
+{
+    if (!p_bCondition && p_rsError.isEmpty())
+    {
+        p_rsError = p_pcWhat;
+    }
+
+    return p_bCondition;
+}
+
+/******************************************************************************/
+static bool _Near(const double p_dValue,
+                  const double p_dExpected,
+                  const double p_dTolerance)
+{
+    return fabs(p_dValue - p_dExpected) <= p_dTolerance;
+}
+
+/******************************************************************************/
+static void _BuildExample(std::vector<uint8_t>& p_rvPacket)
+{
+    /* Items of the example of ST 0601, except the checksum. */
+    static const uint8_t    s_aucItems[] =
+    {
+        2, 8, 0x00, 0x04, 0x59, 0xF4, 0xA6, 0xAA, 0x4A, 0xA8,
+        3, 9, 'M', 'I', 'S', 'S', 'I', 'O', 'N', '0', '1',
+        4, 6, 'A', 'F', '-', '1', '0', '1',
+        5, 2, 0x71, 0xC2,
+        6, 2, 0xFD, 0x3D,
+        7, 2, 0x08, 0xB8,
+        8, 1, 0x93,
+        10, 5, 'M', 'Q', '1', '-', 'B',
+        11, 2, 'E', 'O',
+        12, 6, 'W', 'G', 'S', '-', '8', '4',
+        13, 4, 0x55, 0x95, 0xB6, 0x6D,
+        14, 4, 0x5B, 0x53, 0x60, 0xC4,
+        15, 2, 0xC2, 0x21,
+        16, 2, 0xCD, 0x9C,
+        17, 2, 0xD9, 0x17,
+        18, 4, 0x72, 0x4A, 0x0A, 0x20,
+        19, 4, 0x87, 0xF8, 0x4B, 0x86,
+        20, 4, 0x7D, 0xC5, 0x5E, 0xCE,
+        21, 4, 0x03, 0x83, 0x09, 0x26,
+        22, 2, 0x12, 0x81,
+        23, 4, 0xF1, 0x01, 0xA2, 0x29,
+        24, 4, 0x14, 0xBC, 0x08, 0x2B,
+        25, 2, 0x34, 0xF3,
+        35, 2, 0xA7, 0xC4,
+        36, 1, 0xB2,
+        65, 1, 0x08
+    };
+    uint8_t     l_aucLength[8];
+    size_t      l_sLengthSize;
+    uint16_t    l_usChecksum;
+
+    l_sLengthSize = Klv::WriteBerLength(sizeof(s_aucItems) + 4, l_aucLength);
+
+    p_rvPacket.assign(Klv::GetKey(), Klv::GetKey() + KLV_KEY_SIZE);
+    p_rvPacket.insert(p_rvPacket.end(),
+                      l_aucLength,
+                      l_aucLength + l_sLengthSize);
+    p_rvPacket.insert(p_rvPacket.end(),
+                      s_aucItems,
+                      s_aucItems + sizeof(s_aucItems));
+    p_rvPacket.push_back(KLV_TAG_CHECKSUM);
+    p_rvPacket.push_back(2);
+
+    l_usChecksum = Klv::Checksum(&p_rvPacket[0], p_rvPacket.size());
+
+    p_rvPacket.push_back(static_cast<uint8_t>(l_usChecksum >> 8));
+    p_rvPacket.push_back(static_cast<uint8_t>(l_usChecksum & 0xFF));
+}
+
+/******************************************************************************/
+static bool _CheckExampleValues(QString&        p_rsError,
+                                const Metadata& p_rMetadata)
+{
+    /* Values published by the standard. They have been quantized by the
+     * encoding, so each one is compared within a step of its tag (or of a
+     * float, for the 4-byte angles). */
+    return
+        _Expect(p_rsError,
+                p_rMetadata.m_llTimestamp == 1224807209913000LL,
+                "timestamp") &&
+        _Expect(p_rsError,
+                p_rMetadata.m_sMissionID == "MISSION01",
+                "mission id") &&
+        _Expect(p_rsError,
+                p_rMetadata.m_sPlatformTailNumber == "AF-101",
+                "platform tail number") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fPlatformHeading_deg, 159.9744, 6e-3),
+                "platform heading") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fPlatformPitch_deg, -0.4315251, 7e-4),
+                "platform pitch") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fPlatformRoll_deg, 3.405814, 2e-3),
+                "platform roll") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fPlatformTrueAirSpeed_m_s, 147, 1),
+                "platform true airspeed") &&
+        _Expect(p_rsError,
+                p_rMetadata.m_sPlatformDesignation == "MQ1-B",
+                "platform designation") &&
+        _Expect(p_rsError,
+                p_rMetadata.m_sImageSourceSensor == "EO",
+                "image source sensor") &&
+        _Expect(p_rsError,
+                p_rMetadata.m_sImageCoordinateSystem == "WGS-84",
+                "image coordinate system") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_dSensorLat_deg, 60.17682296, 5e-8),
+                "sensor latitude") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_dSensorLon_deg, 128.42675904, 9e-8),
+                "sensor longitude") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_dSensorAlt_m, 14190.72, 0.4),
+                "sensor altitude") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fSensorHFOV_deg, 144.5713, 3e-3),
+                "sensor horizontal fov") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fSensorVFOV_deg, 152.6436, 3e-3),
+                "sensor vertical fov") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fSensorAzimuth_deg, 160.71921147, 2e-5),
+                "sensor azimuth") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fSensorElevation_deg, -168.79232483, 2e-5),
+                "sensor elevation") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fSensorRoll_deg, 176.86543764, 2e-5),
+                "sensor roll") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fSlantRange_m, 68590.98, 1e-2),
+                "slant range") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fTargetWidth_m, 722.8199, 0.2),
+                "target width") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_dFrameCenterLat_deg, -10.54238863, 5e-8),
+                "frame center latitude") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_dFrameCenterLon_deg, 29.15789012, 9e-8),
+                "frame center longitude") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_dFrameCenterAlt_m, 3216.037, 0.4),
+                "frame center altitude") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fWindDirection_deg, 235.924, 6e-3),
+                "wind direction") &&
+        _Expect(p_rsError,
+                _Near(p_rMetadata.m_fWindSpeed_m_s, 69.80392, 0.4),
+                "wind speed");
+}
+
+/******************************************************************************/
+static void _BuildTrack(std::vector<Metadata>&  p_rvTrack,
+                        const size_t            p_sSize)
+{
+    Metadata*   l_pMetadata;
+    size_t      l_s;
+
+    p_rvTrack.resize(p_sSize);
+
+    /* A platform flying straight, with a slowly turning sensor. */
+    for (l_s = 0; l_s < p_rvTrack.size(); l_s++)
+    {
+        l_pMetadata = &p_rvTrack[l_s];
+
+        l_pMetadata->m_llTimestamp = 1224807209913000LL +
+                                     40000LL * static_cast<long long>(l_s);
+        l_pMetadata->m_sMissionID = "MISSION01";
+        l_pMetadata->m_sPlatformTailNumber = "AF-101";
+        l_pMetadata->m_fPlatformHeading_deg = 159.97f;
+        l_pMetadata->m_fPlatformPitch_deg = -0.43f + 0.01f * (l_s % 8);
+        l_pMetadata->m_fPlatformRoll_deg = 3.4f;
+        l_pMetadata->m_fPlatformTrueAirSpeed_m_s = 147.0f;
+        l_pMetadata->m_sPlatformDesignation = "MQ1-B";
+        l_pMetadata->m_sImageSourceSensor = "EO";
+        l_pMetadata->m_sImageCoordinateSystem = "WGS-84";
+        l_pMetadata->m_dSensorLat_deg = 60.17682296 - 2.5e-6 * l_s;
+        l_pMetadata->m_dSensorLon_deg = 128.42675904 + 1.1e-6 * l_s;
+        l_pMetadata->m_dSensorAlt_m = 14190.72;
+        l_pMetadata->m_fSensorHFOV_deg = 144.57f;
+        l_pMetadata->m_fSensorVFOV_deg = 152.64f;
+        l_pMetadata->m_fSensorAzimuth_deg = 160.7192f + 0.05f * l_s;
+        l_pMetadata->m_fSensorElevation_deg = -168.7923f;
+        l_pMetadata->m_fSensorRoll_deg = 176.8654f;
+        l_pMetadata->m_fSlantRange_m = 68590.98f - 1.5f * l_s;
+        l_pMetadata->m_fTargetWidth_m = 722.82f;
+        l_pMetadata->m_dFrameCenterLat_deg = -10.54238863 - 2.5e-6 * l_s;
+        l_pMetadata->m_dFrameCenterLon_deg = 29.15789012 + 1.1e-6 * l_s;
+        l_pMetadata->m_dFrameCenterAlt_m = 3216.04;
+        l_pMetadata->m_fWindDirection_deg = 235.92f;
+        l_pMetadata->m_fWindSpeed_m_s = 69.8f;
+        l_pMetadata->m_sPlatformCallSign = "FLYSIGHT";
+    }
+}
+
+/******************************************************************************/
+static bool _CheckSame(QString&         p_rsError,
+                       const Metadata&  p_rValue,
+                       const Metadata&  p_rExpected)
+{
+    /* Each value is compared within a step of its tag (or of a float, for
+     * the 4-byte angles and the slant range). */
+    return
+        _Expect(p_rsError,
+                p_rValue.m_llTimestamp == p_rExpected.m_llTimestamp,
+                "timestamp") &&
+        _Expect(p_rsError,
+                p_rValue.m_sMissionID == p_rExpected.m_sMissionID &&
+                p_rValue.m_sPlatformTailNumber ==
+                    p_rExpected.m_sPlatformTailNumber &&
+                p_rValue.m_sPlatformDesignation ==
+                    p_rExpected.m_sPlatformDesignation &&
+                p_rValue.m_sImageSourceSensor ==
+                    p_rExpected.m_sImageSourceSensor &&
+                p_rValue.m_sImageCoordinateSystem ==
+                    p_rExpected.m_sImageCoordinateSystem &&
+                p_rValue.m_sPlatformCallSign ==
+                    p_rExpected.m_sPlatformCallSign,
+                "strings") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_fPlatformHeading_deg,
+                      p_rExpected.m_fPlatformHeading_deg,
+                      6e-3) &&
+                _Near(p_rValue.m_fPlatformPitch_deg,
+                      p_rExpected.m_fPlatformPitch_deg,
+                      7e-4) &&
+                _Near(p_rValue.m_fPlatformRoll_deg,
+                      p_rExpected.m_fPlatformRoll_deg,
+                      2e-3) &&
+                _Near(p_rValue.m_fPlatformTrueAirSpeed_m_s,
+                      p_rExpected.m_fPlatformTrueAirSpeed_m_s,
+                      1),
+                "platform attitude") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_dSensorLat_deg,
+                      p_rExpected.m_dSensorLat_deg,
+                      5e-8) &&
+                _Near(p_rValue.m_dSensorLon_deg,
+                      p_rExpected.m_dSensorLon_deg,
+                      9e-8) &&
+                _Near(p_rValue.m_dSensorAlt_m,
+                      p_rExpected.m_dSensorAlt_m,
+                      0.4),
+                "sensor position") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_fSensorHFOV_deg,
+                      p_rExpected.m_fSensorHFOV_deg,
+                      3e-3) &&
+                _Near(p_rValue.m_fSensorVFOV_deg,
+                      p_rExpected.m_fSensorVFOV_deg,
+                      3e-3) &&
+                _Near(p_rValue.m_fSensorAzimuth_deg,
+                      p_rExpected.m_fSensorAzimuth_deg,
+                      2e-5) &&
+                _Near(p_rValue.m_fSensorElevation_deg,
+                      p_rExpected.m_fSensorElevation_deg,
+                      2e-5) &&
+                _Near(p_rValue.m_fSensorRoll_deg,
+                      p_rExpected.m_fSensorRoll_deg,
+                      2e-5),
+                "sensor attitude") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_fSlantRange_m,
+                      p_rExpected.m_fSlantRange_m,
+                      1e-2) &&
+                _Near(p_rValue.m_fTargetWidth_m,
+                      p_rExpected.m_fTargetWidth_m,
+                      0.2),
+                "ranges") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_dFrameCenterLat_deg,
+                      p_rExpected.m_dFrameCenterLat_deg,
+                      5e-8) &&
+                _Near(p_rValue.m_dFrameCenterLon_deg,
+                      p_rExpected.m_dFrameCenterLon_deg,
+                      9e-8) &&
+                _Near(p_rValue.m_dFrameCenterAlt_m,
+                      p_rExpected.m_dFrameCenterAlt_m,
+                      0.4),
+                "frame center") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_fWindDirection_deg,
+                      p_rExpected.m_fWindDirection_deg,
+                      6e-3) &&
+                _Near(p_rValue.m_fWindSpeed_m_s,
+                      p_rExpected.m_fWindSpeed_m_s,
+                      0.4),
+                "wind");
+}
+
+/******************************************************************************/
+static bool _CheckLogged(QString&           p_rsError,
+                         const Metadata&    p_rValue,
+                         const Metadata&    p_rExpected)
+{
+    /* The positions are rounded to 1e-9 deg and 1 mm, the other fields are
+     * kept as they are. */
+    return
+        _Expect(p_rsError,
+                p_rValue.m_llTimestamp == p_rExpected.m_llTimestamp,
+                "timestamp") &&
+        _Expect(p_rsError,
+                p_rValue.m_sMissionID == p_rExpected.m_sMissionID &&
+                p_rValue.m_sPlatformTailNumber ==
+                    p_rExpected.m_sPlatformTailNumber &&
+                p_rValue.m_sPlatformDesignation ==
+                    p_rExpected.m_sPlatformDesignation &&
+                p_rValue.m_sImageSourceSensor ==
+                    p_rExpected.m_sImageSourceSensor &&
+                p_rValue.m_sImageCoordinateSystem ==
+                    p_rExpected.m_sImageCoordinateSystem &&
+                p_rValue.m_sPlatformCallSign ==
+                    p_rExpected.m_sPlatformCallSign,
+                "strings") &&
+        _Expect(p_rsError,
+                _Near(p_rValue.m_dSensorLat_deg,
+                      p_rExpected.m_dSensorLat_deg,
+                      1e-9) &&
+                _Near(p_rValue.m_dSensorLon_deg,
+                      p_rExpected.m_dSensorLon_deg,
+                      1e-9) &&
+                _Near(p_rValue.m_dSensorAlt_m,
+                      p_rExpected.m_dSensorAlt_m,
+                      1e-3) &&
+                _Near(p_rValue.m_dFrameCenterLat_deg,
+                      p_rExpected.m_dFrameCenterLat_deg,
+                      1e-9) &&
+                _Near(p_rValue.m_dFrameCenterLon_deg,
+                      p_rExpected.m_dFrameCenterLon_deg,
+                      1e-9) &&
+                _Near(p_rValue.m_dFrameCenterAlt_m,
+                      p_rExpected.m_dFrameCenterAlt_m,
+                      1e-3),
+                "positions") &&
+        _Expect(p_rsError,
+                p_rValue.m_fPlatformHeading_deg ==
+                    p_rExpected.m_fPlatformHeading_deg &&
+                p_rValue.m_fPlatformPitch_deg ==
+                    p_rExpected.m_fPlatformPitch_deg &&
+                p_rValue.m_fPlatformRoll_deg ==
+                    p_rExpected.m_fPlatformRoll_deg &&
+                p_rValue.m_fPlatformTrueAirSpeed_m_s ==
+                    p_rExpected.m_fPlatformTrueAirSpeed_m_s &&
+                p_rValue.m_fSensorHFOV_deg == p_rExpected.m_fSensorHFOV_deg &&
+                p_rValue.m_fSensorVFOV_deg == p_rExpected.m_fSensorVFOV_deg &&
+                p_rValue.m_fSensorAzimuth_deg ==
+                    p_rExpected.m_fSensorAzimuth_deg &&
+                p_rValue.m_fSensorElevation_deg ==
+                    p_rExpected.m_fSensorElevation_deg &&
+                p_rValue.m_fSensorRoll_deg == p_rExpected.m_fSensorRoll_deg &&
+                p_rValue.m_fSlantRange_m == p_rExpected.m_fSlantRange_m &&
+                p_rValue.m_fTargetWidth_m == p_rExpected.m_fTargetWidth_m &&
+                p_rValue.m_fWindDirection_deg ==
+                    p_rExpected.m_fWindDirection_deg &&
+                p_rValue.m_fWindSpeed_m_s == p_rExpected.m_fWindSpeed_m_s,
+                "floats");
+}
+
+/******************************************************************************/
+QString g_TestKlvExample()
+{
+    MetadataKlvDecoder      l_Decoder;
+    Metadata                l_Metadata;
+    Metadata                l_Streamed;
+    QString                 l_sError;
+    std::vector<uint8_t>    l_vPacket;
+    std::vector<uint8_t>    l_vStream;
+    size_t                  l_sConsumed;
+    size_t                  l_s;
+    int                     l_iNumStreamed;
+
+    _BuildExample(l_vPacket);
+
+    /* Single packet. */
+    if (!_Expect(l_sError,
+                 l_Decoder.Decode(&l_vPacket[0],
+                                  l_vPacket.size(),
+                                  l_Metadata,
+                                  l_sConsumed) == KLV_OK &&
+                 l_sConsumed == l_vPacket.size(),
+                 "decode") ||
+        !_CheckExampleValues(l_sError, l_Metadata))
+    {
+        return l_sError;
+    }
+
+    /* Stream: garbage, then the packet twice, pushed in small chunks. */
+    l_vStream.assign(5, 0x06);
+    l_vStream.insert(l_vStream.end(), l_vPacket.begin(), l_vPacket.end());
+    l_vStream.insert(l_vStream.end(), l_vPacket.begin(), l_vPacket.end());
+    l_iNumStreamed = 0;
+
+    for (l_s = 0; l_s < l_vStream.size(); l_s += TEST_METADATA_CHUNK_SIZE)
+    {
+        l_Decoder.Push(&l_vStream[l_s],
+                       std::min(static_cast<size_t>(TEST_METADATA_CHUNK_SIZE),
+                                l_vStream.size() - l_s));
+
+        while (l_Decoder.Next(l_Streamed))
+        {
+            l_iNumStreamed++;
+        }
+    }
+
+    if (!_Expect(l_sError, l_iNumStreamed == 2, "stream") ||
+        !_CheckExampleValues(l_sError, l_Streamed))
+    {
+        return l_sError;
+    }
+
+    /* A single bit flipped must be caught by the checksum. */
+    l_vStream = l_vPacket;
+    l_vStream[KLV_KEY_SIZE + 8] ^= 0x10;
+
+    _Expect(l_sError,
+            l_Decoder.Decode(&l_vStream[0],
+                             l_vStream.size(),
+                             l_Metadata,
+                             l_sConsumed) == KLV_INVALID_CHECKSUM,
+            "checksum");
+
+    return l_sError;
+}
+
+/******************************************************************************/
+QString g_TestKlvRoundTrip()
+{
+    MetadataKlvEncoder      l_Encoder;
+    MetadataKlvDecoder      l_Decoder;
+    Metadata                l_Metadata;
+    QString                 l_sError;
+    std::vector<Metadata>   l_vTrack;
+    std::vector<uint8_t>    l_vStream;
+    std::vector<uint8_t>    l_vBuffer;
+    size_t                  l_sKeySize;
+    size_t                  l_sDeltaSize;
+    size_t                  l_sPacket;
+    size_t                  l_s;
+
+    _BuildTrack(l_vTrack, TEST_METADATA_TRACK_SIZE);
+
+    l_Encoder.SetDeltaEnabled(true);
+    l_Encoder.SetKeyInterval(TEST_METADATA_KEY_INTERVAL);
+
+    l_vBuffer.resize(KLV_MAX_ENCODED_SIZE);
+    l_sKeySize = 0;
+    l_sDeltaSize = 0;
+
+    for (l_s = 0; l_s < l_vTrack.size(); l_s++)
+    {
+        l_sPacket = l_Encoder.Encode(l_vTrack[l_s],
+                                     &l_vBuffer[0],
+                                     l_vBuffer.size());
+
+        /* The version is the item before the checksum. */
+        if (!_Expect(l_sError, l_sPacket > 7, "encode") ||
+            !_Expect(l_sError,
+                     l_vBuffer[l_sPacket - 7] == KLV_TAG_VERSION &&
+                     l_vBuffer[l_sPacket - 6] == 1 &&
+                     l_vBuffer[l_sPacket - 5] == KLV_LS_VERSION,
+                     "version"))
+        {
+            return l_sError;
+        }
+
+        if (l_s % TEST_METADATA_KEY_INTERVAL == 0)
+        {
+            l_sKeySize = std::max(l_sKeySize, l_sPacket);
+        }
+        else
+        {
+            l_sDeltaSize = std::max(l_sDeltaSize, l_sPacket);
+        }
+
+        l_vStream.insert(l_vStream.end(),
+                         l_vBuffer.begin(),
+                         l_vBuffer.begin() + l_sPacket);
+    }
+
+    if (!_Expect(l_sError, l_sDeltaSize < l_sKeySize, "delta size"))
+    {
+        return l_sError;
+    }
+
+    /* The fields absent from the delta packets keep their values. */
+    l_Decoder.Push(&l_vStream[0], l_vStream.size());
+
+    for (l_s = 0; l_s < l_vTrack.size(); l_s++)
+    {
+        if (!_Expect(l_sError, l_Decoder.Next(l_Metadata), "decode") ||
+            !_CheckSame(l_sError, l_Metadata, l_vTrack[l_s]))
+        {
+            return l_sError;
+        }
+    }
+
+    _Expect(l_sError, !l_Decoder.Next(l_Metadata), "extra packet");
+
+    return l_sError;
+}
+
+/******************************************************************************/
+QString g_TestLogRoundTrip()
+{
+    MetadataLogWriter       l_Writer;
+    MetadataLogWriter       l_Crashed;
+    MetadataLogReader       l_Reader;
+    Metadata                l_Metadata;
+    QString                 l_sError;
+    std::vector<Metadata>   l_vTrack;
+    std::string             l_sFileName;
+    std::string             l_sCopyName;
+    QString                 l_sFilePath;
+    QString                 l_sCopyPath;
+    size_t                  l_sSession;
+    size_t                  l_sSize;
+    size_t                  l_s;
+    bool                    l_bOk;
+
+    l_sSize = 0;
+
+    for (l_sSession = 0;
+         l_sSession < sizeof(g_asLogSessions) / sizeof(g_asLogSessions[0]);
+         l_sSession++)
+    {
+        l_sSize += g_asLogSessions[l_sSession];
+    }
+
+    _BuildTrack(l_vTrack, l_sSize);
+
+    /* A string first used after the log has been reopened. */
+    for (l_s = l_vTrack.size() / 2; l_s < l_vTrack.size(); l_s++)
+    {
+        l_vTrack[l_s].m_sMissionID = "MISSION02";
+    }
+
+    l_sFilePath = QDir::temp().filePath("testMetadata.log");
+    l_sCopyPath = QDir::temp().filePath("testMetadataCrashed.log");
+    l_sFileName = l_sFilePath.toLocal8Bit().constData();
+    l_sCopyName = l_sCopyPath.toLocal8Bit().constData();
+
+    QFile::remove(l_sCopyPath);
+
+    /* First session: a new log, closed. */
+    l_bOk = l_Writer.Open(l_sFileName);
+    l_s = 0;
+
+    while (l_bOk && l_s < g_asLogSessions[0])
+    {
+        l_bOk = l_Writer.Append(l_vTrack[l_s++]);
+    }
+
+    l_bOk = l_Writer.Close() && l_bOk;
+
+    /* Second session: appended to the closed log and only flushed. The
+     * file is copied before the writer closes it. */
+    l_bOk = l_bOk && l_Writer.Open(l_sFileName, true);
+
+    while (l_bOk && l_s < g_asLogSessions[0] + g_asLogSessions[1])
+    {
+        l_bOk = l_Writer.Append(l_vTrack[l_s++]);
+    }
+
+    l_bOk = l_bOk && l_Writer.Flush() && QFile::copy(l_sFilePath, l_sCopyPath);
+
+    l_Writer.Close();
+
+    /* The copy has no index: it is read by walking the blocks. */
+    if (!_Expect(l_sError, l_bOk, "write") ||
+        !_Expect(l_sError,
+                 l_Reader.Open(l_sCopyName) &&
+                 l_Reader.GetNumRecords() == l_s,
+                 "unclosed log"))
+    {
+        return l_sError;
+    }
+
+    l_Reader.Close();
+
+    /* Third session: appended to the unclosed log. */
+    l_bOk = l_Crashed.Open(l_sCopyName, true) &&
+            l_Crashed.GetNumRecords() == static_cast<long long>(l_s);
+
+    while (l_bOk && l_s < l_vTrack.size())
+    {
+        l_bOk = l_Crashed.Append(l_vTrack[l_s++]);
+    }
+
+    l_bOk = l_Crashed.Close() && l_bOk;
+
+    if (!_Expect(l_sError, l_bOk, "append") ||
+        !_Expect(l_sError,
+                 l_Reader.Open(l_sCopyName) &&
+                 l_Reader.GetNumRecords() == l_vTrack.size() &&
+                 l_Reader.GetBlocks().size() == 4,
+                 "closed log"))
+    {
+        return l_sError;
+    }
+
+    for (l_s = 0; l_s < l_vTrack.size(); l_s++)
+    {
+        if (!_Expect(l_sError, l_Reader.Read(l_s, l_Metadata), "read") ||
+            !_CheckLogged(l_sError, l_Metadata, l_vTrack[l_s]) ||
+            !_Expect(l_sError,
+                     l_Reader.Seek(l_vTrack[l_s].m_llTimestamp) == l_s,
+                     "seek"))
+        {
+            return l_sError;
+        }
+    }
+
+    l_Reader.Close();
+
+    QFile::remove(l_sFilePath);
+    QFile::remove(l_sCopyPath);
+
+    return l_sError;
+}
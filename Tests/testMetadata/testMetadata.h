@@ -0,0 +1,49 @@
+#ifndef TESTMETADATA_H
+#define TESTMETADATA_H
+
+/** @file testMetadata.h
+ *
+ * @brief Checks the metadata codecs of the core library against the example
+ * packet of MISB ST 0601 and against round trips. Their throughput is
+ * measured by benchPipeline (see benchMetadata.h).
+ */
+
+#include <core>
+
+#include <QtCore>
+
+using namespace fby;
+
+/******************************************************************************/
+/**
+ * @brief g_TestKlvExample decodes the example packet of ST 0601, both as a
+ * single packet and as a stream split in small chunks after some garbage,
+ * compares the values with the ones published by the standard, and checks
+ * that a corrupt packet is rejected.
+ *
+ * @return the first mismatch, or an empty string if the check passed.
+ */
+QString g_TestKlvExample();
+
+/**
+ * @brief g_TestKlvRoundTrip encodes a track of Metadata with the delta
+ * encoding, checks that every packet carries the version of the Local Set and
+ * that the delta packets are smaller than the complete ones, then decodes the
+ * stream and compares each record with its source.
+ *
+ * @return the first mismatch, or an empty string if the check passed.
+ */
+QString g_TestKlvRoundTrip();
+
+/**
+ * @brief g_TestLogRoundTrip writes a track of Metadata to a log in three
+ * sessions: a new log that is closed, then an append to the closed log that
+ * is only flushed, as if its writer had crashed, then an append to that log.
+ * It reads the log back, compares each record with its source and seeks each
+ * time stamp.
+ *
+ * @return the first mismatch, or an empty string if the check passed.
+ */
+QString g_TestLogRoundTrip();
+
+#endif // TESTMETADATA_H
@@ -0,0 +1,16 @@
+QT       += core
+
+TARGET = testMetadata
+TEMPLATE = app
+
+CONFIG *= test console
+CONFIG -= app_bundle
+
+FLYSIGHT_DEPEND *= core
+
+include($$PWD/../../FlysightConfig.pri)
+
+SOURCES += main.cpp\
+        testMetadata.cpp
+
+HEADERS  += testMetadata.h